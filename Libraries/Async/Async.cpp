@@ -12,6 +12,7 @@
 #include "Internal/AsyncEmscripten.inl"
 #endif
 
+#include "../Foundation/Memory.h"
 #include "../Threading/ThreadPool.h"
 #include "../Threading/Threading.h" // EventObject
 
@@ -42,11 +43,14 @@ const char* SC::AsyncRequest::TypeToString(Type type)
     case Type::SocketConnect: return "SocketConnect";
     case Type::SocketSend: return "SocketSend";
     case Type::SocketReceive: return "SocketReceive";
+    case Type::SocketSendTo: return "SocketSendTo";
+    case Type::SocketReceiveFrom: return "SocketReceiveFrom";
     case Type::SocketClose: return "SocketClose";
     case Type::FileRead: return "FileRead";
     case Type::FileWrite: return "FileWrite";
     case Type::FileClose: return "FileClose";
     case Type::FilePoll: return "FilePoll";
+    case Type::FileSend: return "FileSend";
     }
     Assert::unreachable();
 }
@@ -73,9 +77,25 @@ SC::Result SC::AsyncRequest::validateAsync()
 
 void SC::AsyncRequest::markAsFree()
 {
+    AsyncEventLoop*       loop      = eventLoop;
+    AsyncRequestPoolBase* ownerPool = pool;
+
+    if (trackingSlot != nullptr and loop != nullptr)
+    {
+        loop->internal.releaseTrackingSlot(*this);
+    }
+    if ((flags & AsyncEventLoop::Internal::Flag_WaitsCancellation) and loop != nullptr)
+    {
+        loop->internal.cancellations.remove(*this);
+    }
     state     = AsyncRequest::State::Free;
     eventLoop = nullptr;
     flags     = 0;
+    if (ownerPool != nullptr and loop != nullptr)
+    {
+        // Give back the request to the AsyncRequestPool it has been acquired from
+        ownerPool->recycleRequest(*this);
+    }
 }
 
 SC::Result SC::AsyncRequest::queueSubmission(AsyncEventLoop& loop)
@@ -118,7 +138,12 @@ SC::Result SC::AsyncLoopWakeUp::start(AsyncEventLoop& loop, EventObject* eo)
     return SC::Result(true);
 }
 
-SC::Result SC::AsyncLoopWakeUp::wakeUp() { return getEventLoop()->wakeUpFromExternalThread(*this); }
+SC::Result SC::AsyncLoopWakeUp::wakeUp()
+{
+    // Stopped wake ups don't refer to their event loop anymore
+    SC_TRY_MSG(eventLoop != nullptr, "AsyncLoopWakeUp::wakeUp - Not started");
+    return eventLoop->wakeUpFromExternalThread(*this);
+}
 
 SC::Result SC::AsyncLoopWork::start(AsyncEventLoop& loop, ThreadPool& threadPool)
 {
@@ -152,13 +177,152 @@ SC::Result SC::AsyncSocketConnect::start(AsyncEventLoop& loop, const SocketDescr
     return SC::Result(true);
 }
 
+SC::Result SC::AsyncDNSResolver::create(AsyncEventLoop& loop, ThreadPool& pool)
+{
+    SC_TRY_MSG(eventLoop == nullptr, "AsyncDNSResolver::create - Already created");
+    eventLoop  = &loop;
+    threadPool = &pool;
+    return SC::Result(true);
+}
+
+bool SC::AsyncDNSResolver::resolveLocal(StringView host, uint16_t port, Span<SocketIPAddress> addresses,
+                                        size_t& numAddresses)
+{
+    numAddresses = 0;
+    if (addresses.empty())
+        return false;
+    if (addresses[0].fromAddressPort(host, port))
+    {
+        numAddresses = 1;
+        return true;
+    }
+    if (host != "localhost")
+        return false;
+    for (const StringView loopback : {StringView("127.0.0.1"), StringView("::1")})
+    {
+        if (numAddresses < addresses.sizeInElements() and addresses[numAddresses].fromAddressPort(loopback, port))
+        {
+            numAddresses++;
+        }
+    }
+    return numAddresses > 0;
+}
+
+SC::AsyncDNSResolver::CacheEntry* SC::AsyncDNSResolver::findCacheEntry(StringView host, uint16_t port)
+{
+    for (CacheEntry& entry : cache)
+    {
+        if (entry.numAddresses > 0 and entry.port == port and entry.hostLength == host.sizeInBytes() and
+            ::memcmp(entry.host, host.bytesWithoutTerminator(), entry.hostLength) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool SC::AsyncDNSResolver::lookup(StringView host, uint16_t port, Span<SocketIPAddress> addresses,
+                                  size_t& numAddresses)
+{
+    if (resolveLocal(host, port, addresses, numAddresses))
+        return true;
+    CacheEntry* entry = eventLoop ? findCacheEntry(host, port) : nullptr;
+    if (entry == nullptr or eventLoop->getLoopTime().isLaterThanOrEqualTo(entry->resolveTime.offsetBy(cacheTimeout)))
+        return false;
+    for (numAddresses = 0; numAddresses < entry->numAddresses and numAddresses < addresses.sizeInElements();
+         ++numAddresses)
+    {
+        addresses[numAddresses] = entry->addresses[numAddresses];
+    }
+    return numAddresses > 0;
+}
+
+SC::Result SC::AsyncDNSResolver::resolve(Request& request, StringView host, uint16_t port)
+{
+    SC_TRY_MSG(eventLoop != nullptr, "AsyncDNSResolver::resolve - Resolver has not been created");
+    SC_TRY_MSG(request.callback.isValid(), "AsyncDNSResolver::resolve - Invalid callback");
+    SC_TRY_MSG(host.sizeInBytes() > 0 and host.sizeInBytes() <= MaxHostLength,
+               "AsyncDNSResolver::resolve - Invalid host length");
+    // Thread pool could still be writing the request fields of a resolution in progress
+    SC_TRY_MSG(request.isFree(), "AsyncDNSResolver::resolve - Request already in use");
+    ::memcpy(request.host, host.bytesWithoutTerminator(), host.sizeInBytes());
+    request.host[host.sizeInBytes()] = 0;
+
+    request.hostLength = host.sizeInBytes();
+    request.port       = port;
+    request.resolver   = this;
+    request.result     = SC::Result(true);
+    request.cached     = lookup(host, port, {request.addresses, MaxAddresses}, request.numAddresses);
+
+    // Only the thread pool thread accesses the request until the callback is invoked on the event loop thread
+    request.work.work = [&request]()
+    {
+        if (request.cached)
+            return SC::Result(true);
+        const StringView hostName({request.host, request.hostLength}, true, StringEncoding::Ascii);
+        return SocketNetworking::resolveDNS(hostName, request.port, {request.addresses, MaxAddresses},
+                                            request.numAddresses);
+    };
+    request.work.callback = [&request](AsyncLoopWork::Result& result)
+    { request.resolver->onResolved(request, result); };
+    return request.work.start(*eventLoop, *threadPool);
+}
+
+void SC::AsyncDNSResolver::onResolved(Request& request, AsyncLoopWork::Result& result)
+{
+    request.result = result.isValid();
+    if (request.result and not request.cached)
+    {
+        // Replace previous entry for the same host, or the least recently resolved one (unused entries come first)
+        const StringView host({request.host, request.hostLength}, true, StringEncoding::Ascii);
+        CacheEntry*      entry = findCacheEntry(host, request.port);
+        for (size_t idx = 0; entry == nullptr and idx < NumCacheEntries; ++idx)
+        {
+            if (cache[idx].numAddresses == 0)
+                entry = &cache[idx];
+        }
+        if (entry == nullptr)
+        {
+            entry = &cache[0];
+            for (CacheEntry& other : cache)
+            {
+                if (entry->resolveTime.isLaterThanOrEqualTo(other.resolveTime))
+                    entry = &other;
+            }
+        }
+        ::memcpy(entry->host, request.host, request.hostLength + 1);
+        entry->hostLength   = request.hostLength;
+        entry->port         = request.port;
+        entry->resolveTime  = eventLoop->getLoopTime();
+        entry->numAddresses = request.numAddresses;
+        for (size_t idx = 0; idx < request.numAddresses; ++idx)
+        {
+            entry->addresses[idx] = request.addresses[idx];
+        }
+    }
+    request.callback(request);
+}
+
 SC::Result SC::AsyncSocketSend::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
                                       Span<const char> dataToSend)
 {
 
     SC_TRY(validateAsync());
     SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
-    buffer = dataToSend;
+    buffer  = dataToSend;
+    buffers = {};
+    SC_TRY(queueSubmission(loop));
+    return SC::Result(true);
+}
+
+SC::Result SC::AsyncSocketSend::startVectored(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                              Span<const Span<const char>> dataToSend)
+{
+    SC_TRY_MSG(not dataToSend.empty(), "AsyncSocketSend::startVectored - Empty buffers");
+    SC_TRY(validateAsync());
+    SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
+    buffer  = {};
+    buffers = dataToSend;
     SC_TRY(queueSubmission(loop));
     return SC::Result(true);
 }
@@ -168,7 +332,57 @@ SC::Result SC::AsyncSocketReceive::start(AsyncEventLoop& loop, const SocketDescr
 {
     SC_TRY(validateAsync());
     SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
-    buffer = receiveData;
+    buffer     = receiveData;
+    bufferPool = nullptr;
+    SC_TRY(queueSubmission(loop));
+    return SC::Result(true);
+}
+
+SC::Result SC::AsyncSocketReceive::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                         AsyncBufferPool& receivePool)
+{
+    SC_TRY_MSG(receivePool.eventLoop == &loop, "AsyncSocketReceive::start - AsyncBufferPool belongs to another loop");
+    SC_TRY(validateAsync());
+    SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
+    buffer     = {};
+    bufferPool = &receivePool;
+    SC_TRY(queueSubmission(loop));
+    return SC::Result(true);
+}
+
+SC::Result SC::AsyncSocketSendTo::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                        const SocketIPAddress& address, Span<const char> data)
+{
+    datagram.address = address;
+    datagram.data    = data;
+    return start(loop, socketDescriptor, {&datagram, 1});
+}
+
+SC::Result SC::AsyncSocketSendTo::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                        Span<Datagram> datagramsToSend)
+{
+    SC_TRY_MSG(not datagramsToSend.empty(), "AsyncSocketSendTo::start - Empty datagrams");
+    SC_TRY(validateAsync());
+    SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
+    datagrams = datagramsToSend;
+    SC_TRY(queueSubmission(loop));
+    return SC::Result(true);
+}
+
+SC::Result SC::AsyncSocketReceiveFrom::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                             Span<char> data)
+{
+    datagram.data = data;
+    return start(loop, socketDescriptor, {&datagram, 1});
+}
+
+SC::Result SC::AsyncSocketReceiveFrom::start(AsyncEventLoop& loop, const SocketDescriptor& socketDescriptor,
+                                             Span<Datagram> datagramsToReceive)
+{
+    SC_TRY_MSG(not datagramsToReceive.empty(), "AsyncSocketReceiveFrom::start - Empty datagrams");
+    SC_TRY(validateAsync());
+    SC_TRY(socketDescriptor.get(handle, SC::Result::Error("Invalid handle")));
+    datagrams = datagramsToReceive;
     SC_TRY(queueSubmission(loop));
     return SC::Result(true);
 }
@@ -183,7 +397,15 @@ SC::Result SC::AsyncSocketClose::start(AsyncEventLoop& loop, const SocketDescrip
 
 SC::Result SC::AsyncFileRead::start(AsyncEventLoop& loop)
 {
-    SC_TRY_MSG(buffer.sizeInBytes() > 0, "AsyncFileRead::start - Zero sized read buffer");
+    if (bufferPool)
+    {
+        SC_TRY_MSG(bufferPool->eventLoop == &loop, "AsyncFileRead::start - AsyncBufferPool belongs to another loop");
+        buffer = {};
+    }
+    else
+    {
+        SC_TRY_MSG(buffer.sizeInBytes() > 0, "AsyncFileRead::start - Zero sized read buffer");
+    }
     SC_TRY_MSG(fileDescriptor != FileDescriptor::Invalid, "AsyncFileRead::start - Invalid file descriptor");
     SC_TRY(validateAsync());
     SC_TRY(queueSubmission(loop));
@@ -192,6 +414,7 @@ SC::Result SC::AsyncFileRead::start(AsyncEventLoop& loop)
 
 SC::Result SC::AsyncFileRead::start(AsyncEventLoop& loop, ThreadPool& threadPool, Task& task)
 {
+    SC_TRY_MSG(bufferPool == nullptr, "AsyncFileRead::start - AsyncBufferPool cannot be used with a Task");
     SC_TRY_MSG(buffer.sizeInBytes() > 0, "AsyncFileRead::start - Zero sized read buffer");
     SC_TRY_MSG(fileDescriptor != FileDescriptor::Invalid, "AsyncFileRead::start - Invalid file descriptor");
     SC_TRY(validateAsync());
@@ -207,7 +430,7 @@ SC::Result SC::AsyncFileRead::start(AsyncEventLoop& loop, ThreadPool& threadPool
 
 SC::Result SC::AsyncFileWrite::start(AsyncEventLoop& loop)
 {
-    SC_TRY_MSG(buffer.sizeInBytes() > 0, "AsyncFileWrite::start - Zero sized write buffer");
+    SC_TRY_MSG(buffer.sizeInBytes() > 0 or not buffers.empty(), "AsyncFileWrite::start - Zero sized write buffer");
     SC_TRY_MSG(fileDescriptor != FileDescriptor::Invalid, "AsyncFileWrite::start - Invalid file descriptor");
     SC_TRY(validateAsync());
     SC_TRY(queueSubmission(loop));
@@ -216,7 +439,7 @@ SC::Result SC::AsyncFileWrite::start(AsyncEventLoop& loop)
 
 SC::Result SC::AsyncFileWrite::start(AsyncEventLoop& loop, ThreadPool& threadPool, Task& task)
 {
-    SC_TRY_MSG(buffer.sizeInBytes() > 0, "AsyncFileWrite::start - Zero sized write buffer");
+    SC_TRY_MSG(buffer.sizeInBytes() > 0 or not buffers.empty(), "AsyncFileWrite::start - Zero sized write buffer");
     SC_TRY_MSG(fileDescriptor != FileDescriptor::Invalid, "AsyncFileWrite::start - Invalid file descriptor");
     SC_TRY(validateAsync());
     if (loop.internal.kernelQueue.get().makesSenseToRunInThreadPool(*this))
@@ -245,6 +468,308 @@ SC::Result SC::AsyncFilePoll::start(AsyncEventLoop& loop, FileDescriptor::Handle
     return SC::Result(true);
 }
 
+SC::Result SC::AsyncFileSend::start(AsyncEventLoop& loop, const FileDescriptor& file, const SocketDescriptor& socket,
+                                    uint64_t fileOffset, size_t numBytes)
+{
+    SC_TRY_MSG(numBytes > 0, "AsyncFileSend::start - Zero bytes to send");
+    SC_TRY(validateAsync());
+    SC_TRY(file.get(fileHandle, SC::Result::Error("AsyncFileSend::start - Invalid file descriptor")));
+    SC_TRY(socket.get(socketHandle, SC::Result::Error("AsyncFileSend::start - Invalid socket descriptor")));
+    offset = fileOffset;
+    length = numBytes;
+    SC_TRY(queueSubmission(loop));
+    return SC::Result(true);
+}
+
+//-------------------------------------------------------------------------------------------------------
+// AsyncBufferPool
+//-------------------------------------------------------------------------------------------------------
+
+SC::Result SC::AsyncBufferPool::create(AsyncEventLoop& loop, Span<char> poolMemory, size_t poolBufferSize)
+{
+    SC_TRY_MSG(eventLoop == nullptr, "AsyncBufferPool::create - Already created");
+    SC_TRY_MSG(poolBufferSize >= sizeof(int32_t) and poolBufferSize <= 0xffffffff,
+               "AsyncBufferPool::create - Invalid buffer size");
+    const size_t numPoolBuffers = poolMemory.sizeInBytes() / poolBufferSize;
+    // io_uring buffer ids are 16 bits
+    SC_TRY_MSG(numPoolBuffers > 0 and numPoolBuffers <= 65536, "AsyncBufferPool::create - Invalid number of buffers");
+
+    memory          = poolMemory;
+    bufferSize      = static_cast<uint32_t>(poolBufferSize);
+    numBuffers      = static_cast<uint32_t>(numPoolBuffers);
+    numFreeBuffers  = 0;
+    firstFreeBuffer = -1;
+    kernelSelects   = false;
+    for (uint32_t idx = numBuffers; idx > 0; --idx)
+    {
+        SC_TRY(release(static_cast<int32_t>(idx - 1)));
+    }
+    eventLoop = &loop;
+    // Backends selecting buffers in kernel will take ownership of all free buffers
+    Result res = loop.internal.kernelQueue.get().createBufferPool(*this);
+    if (not res)
+    {
+        eventLoop = nullptr;
+    }
+    return res;
+}
+
+SC::Result SC::AsyncBufferPool::close()
+{
+    SC_TRY_MSG(eventLoop != nullptr, "AsyncBufferPool::close - Not created");
+    SC_TRY_MSG(numFreeBuffers == numBuffers, "AsyncBufferPool::close - Some buffers are still in use");
+    Result res = eventLoop->internal.kernelQueue.get().closeBufferPool(*this);
+    eventLoop  = nullptr;
+    return res;
+}
+
+SC::Result SC::AsyncBufferPool::acquire(Span<char>& buffer, int32_t& bufferIndex)
+{
+    SC_TRY_MSG(firstFreeBuffer >= 0, "AsyncBufferPool - No free buffers");
+    bufferIndex = firstFreeBuffer;
+    char* data  = memory.data() + static_cast<size_t>(bufferIndex) * bufferSize;
+    ::memcpy(&firstFreeBuffer, data, sizeof(firstFreeBuffer));
+    numFreeBuffers -= 1;
+    buffer = {data, bufferSize};
+    return Result(true);
+}
+
+SC::Result SC::AsyncBufferPool::acquireSelected(uint32_t bufferIndex, Span<char>& buffer)
+{
+    SC_TRY_MSG(bufferIndex < numBuffers, "AsyncBufferPool - Invalid buffer selected");
+    numFreeBuffers -= 1;
+    buffer = {memory.data() + static_cast<size_t>(bufferIndex) * bufferSize, bufferSize};
+    return Result(true);
+}
+
+SC::Result SC::AsyncBufferPool::release(int32_t bufferIndex)
+{
+    if (kernelSelects)
+    {
+        // Buffer is counted as free only once the kernel can select it again
+        SC_TRY(eventLoop->internal.kernelQueue.get().provideBuffers(*this, static_cast<uint32_t>(bufferIndex), 1));
+        numFreeBuffers += 1;
+        return Result(true);
+    }
+    ::memcpy(memory.data() + static_cast<size_t>(bufferIndex) * bufferSize, &firstFreeBuffer, sizeof(firstFreeBuffer));
+    firstFreeBuffer = bufferIndex;
+    numFreeBuffers += 1;
+    return Result(true);
+}
+
+//-------------------------------------------------------------------------------------------------------
+// AsyncRequestPool
+//-------------------------------------------------------------------------------------------------------
+
+SC::AsyncRequestPoolBase::~AsyncRequestPoolBase()
+{
+    // Requests still in use would be left dangling inside the event loop (and keys would be left dangling too)
+    SC_ASSERT_RELEASE(numFreeRequests == capacity);
+}
+
+SC::Result SC::AsyncRequestPoolBase::registerPool(AsyncEventLoop& loop, void* requestsMemory, size_t sizeOfRequest,
+                                                  Slot* slotsMemory, uint32_t numRequests)
+{
+    requests        = requestsMemory;
+    slots           = slotsMemory;
+    requestSize     = sizeOfRequest;
+    capacity        = numRequests;
+    numFreeRequests = numRequests;
+    firstFree       = 0;
+    for (uint32_t idx = 0; idx < numRequests; ++idx)
+    {
+        slots[idx].used       = 0;
+        slots[idx].generation = 0;
+        slots[idx].nextFree   = idx + 1;
+    }
+    eventLoop = &loop;
+    loop.internal.requestPools.queueBack(*this);
+    return Result(true);
+}
+
+SC::Result SC::AsyncRequestPoolBase::unregisterPool()
+{
+    SC_TRY_MSG(numFreeRequests == capacity, "AsyncRequestPool::close - Some requests are still in use");
+    if (eventLoop != nullptr)
+    {
+        eventLoop->internal.requestPools.remove(*this);
+    }
+    eventLoop       = nullptr;
+    capacity        = 0;
+    numFreeRequests = 0;
+    return Result(true);
+}
+
+SC::Result SC::AsyncRequestPoolBase::acquireSlot(uint32_t& index)
+{
+    SC_TRY_MSG(numFreeRequests > 0, "AsyncRequestPool::acquire - No free requests");
+    index      = firstFree;
+    Slot& slot = slots[index];
+    firstFree  = slot.nextFree;
+    slot.used  = 1;
+    numFreeRequests -= 1;
+    return Result(true);
+}
+
+SC::Result SC::AsyncRequestPoolBase::releaseSlot(uint32_t index)
+{
+    Slot& slot = slots[index];
+    SC_TRY_MSG(slot.used != 0, "AsyncRequestPool - Request has already been released");
+    slot.used       = 0;
+    slot.generation = slot.generation + 1; // Invalidates all keys to this request (wrapping at 31 bits)
+    slot.nextFree   = firstFree;
+    firstFree       = index;
+    numFreeRequests += 1;
+    return Result(true);
+}
+
+SC::Result SC::AsyncRequestPoolBase::releaseRequest(AsyncRequest& request, uint32_t index)
+{
+    request.pool = nullptr;
+    return releaseSlot(index);
+}
+
+void SC::AsyncRequestPoolBase::recycleRequest(AsyncRequest& request)
+{
+    const size_t offset = static_cast<size_t>(reinterpret_cast<char*>(&request) - static_cast<char*>(requests));
+    SC_TRUST_RESULT(releaseRequest(request, static_cast<uint32_t>(offset / requestSize)));
+}
+
+void SC::AsyncRequestPoolBase::markAsPooled(AsyncRequest& request) { request.pool = this; }
+
+//-------------------------------------------------------------------------------------------------------
+// AsyncEventLoopStats
+//-------------------------------------------------------------------------------------------------------
+
+// Stats have a single writer (the event loop thread), so a relaxed load / store pair is enough to update them
+// without paying for read-modify-write atomic instructions.
+static void addRelaxed(SC::Atomic<SC::uint64_t>& counter, SC::uint64_t value)
+{
+    counter.store(counter.load(SC::memory_order_relaxed) + value, SC::memory_order_relaxed);
+}
+
+static void maxRelaxed(SC::Atomic<SC::uint64_t>& counter, SC::uint64_t value)
+{
+    if (value > counter.load(SC::memory_order_relaxed))
+    {
+        counter.store(value, SC::memory_order_relaxed);
+    }
+}
+
+SC::uint32_t SC::AsyncLatencyHistogram::getBucketIndex(uint64_t nanoseconds)
+{
+    constexpr uint64_t NumSubBuckets = 1 << SubBucketBits;
+    if (nanoseconds < NumSubBuckets)
+    {
+        return static_cast<uint32_t>(nanoseconds);
+    }
+    // Find the most significant bit with a binary search
+    uint32_t exponent = 0;
+    uint64_t value    = nanoseconds;
+    for (uint32_t shift = 32; shift > 0; shift /= 2)
+    {
+        if (value >= (uint64_t(1) << shift))
+        {
+            value >>= shift;
+            exponent += shift;
+        }
+    }
+    if (exponent > MaxExponent)
+    {
+        return NumBuckets - 1;
+    }
+    // Bits following the most significant one select the linear sub-bucket
+    const uint64_t subBucket = (nanoseconds >> (exponent - SubBucketBits)) & (NumSubBuckets - 1);
+    return ((exponent - SubBucketBits + 1) << SubBucketBits) + static_cast<uint32_t>(subBucket);
+}
+
+SC::uint64_t SC::AsyncLatencyHistogram::getBucketLowerBound(uint32_t bucketIndex)
+{
+    constexpr uint32_t NumSubBuckets = 1 << SubBucketBits;
+    if (bucketIndex < NumSubBuckets)
+    {
+        return bucketIndex;
+    }
+    const uint32_t exponent  = (bucketIndex >> SubBucketBits) + SubBucketBits - 1;
+    const uint64_t subBucket = bucketIndex & (NumSubBuckets - 1);
+    return (NumSubBuckets + subBucket) << (exponent - SubBucketBits);
+}
+
+void SC::AsyncLatencyHistogram::record(uint64_t nanoseconds)
+{
+    addRelaxed(buckets[getBucketIndex(nanoseconds)], 1);
+    addRelaxed(count, 1);
+    addRelaxed(sum, nanoseconds);
+    maxRelaxed(maximum, nanoseconds);
+}
+
+void SC::AsyncLatencyHistogram::takeSnapshot(Snapshot& snapshot) const
+{
+    for (uint32_t idx = 0; idx < NumBuckets; ++idx)
+    {
+        snapshot.buckets[idx] = buckets[idx].load(memory_order_relaxed);
+    }
+    snapshot.count   = count.load(memory_order_relaxed);
+    snapshot.sum     = sum.load(memory_order_relaxed);
+    snapshot.maximum = maximum.load(memory_order_relaxed);
+}
+
+SC::uint64_t SC::AsyncLatencyHistogram::Snapshot::getPercentile(double percentile) const
+{
+    // Buckets are summed again (instead of using count), as they could have been copied while being recorded
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets)
+    {
+        total += bucket;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    const double   clamped   = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    const uint64_t threshold = static_cast<uint64_t>(clamped * static_cast<double>(total) / 100.0);
+
+    uint64_t counted = 0;
+    for (uint32_t idx = 0; idx < NumBuckets; ++idx)
+    {
+        counted += buckets[idx];
+        if (counted > threshold or (counted == total))
+        {
+            if (idx + 1 == NumBuckets)
+            {
+                return maximum;
+            }
+            const uint64_t upperBound = getBucketLowerBound(idx + 1) - 1;
+            return upperBound < maximum ? upperBound : maximum;
+        }
+    }
+    return maximum;
+}
+
+void SC::AsyncEventLoopStats::takeSnapshot(Snapshot& snapshot) const
+{
+    for (size_t idx = 0; idx < NumRequestTypes; ++idx)
+    {
+        Snapshot::RequestStats& dst = snapshot.requests[idx];
+        const RequestStats&     src = requests[idx];
+
+        dst.numStarted   = src.numStarted.load(memory_order_relaxed);
+        dst.numCompleted = src.numCompleted.load(memory_order_relaxed);
+        dst.numErrors    = src.numErrors.load(memory_order_relaxed);
+        src.completionLatency.takeSnapshot(dst.completionLatency);
+        src.callbackDuration.takeSnapshot(dst.callbackDuration);
+    }
+    pollDuration.takeSnapshot(snapshot.pollDuration);
+    dispatchDuration.takeSnapshot(snapshot.dispatchDuration);
+
+    snapshot.numSteps          = numSteps.load(memory_order_relaxed);
+    snapshot.numKernelEvents   = numKernelEvents.load(memory_order_relaxed);
+    snapshot.numSubmissions    = numSubmissions.load(memory_order_relaxed);
+    snapshot.maxSubmissions    = maxSubmissions.load(memory_order_relaxed);
+    snapshot.numActiveRequests = numActiveRequests.load(memory_order_relaxed);
+    snapshot.maxActiveRequests = maxActiveRequests.load(memory_order_relaxed);
+}
+
 //-------------------------------------------------------------------------------------------------------
 // AsyncEventLoop
 //-------------------------------------------------------------------------------------------------------
@@ -253,6 +778,11 @@ SC::AsyncEventLoop::AsyncEventLoop() : internal(internalOpaque.get()) { internal
 
 SC::Result SC::AsyncEventLoop::create(Options options)
 {
+    const size_t capacity = options.postQueueCapacity;
+    SC_TRY_MSG(capacity >= 2 and (capacity & (capacity - 1)) == 0,
+               "AsyncEventLoop::create - postQueueCapacity must be a power of two");
+    internal.postQueueCapacity = capacity;
+    SC_TRY(internal.createKernelEventsMemory(options.kernelEventsMemorySize));
     SC_TRY(internal.kernelQueue.get().createEventLoop(options));
     SC_TRY(internal.kernelQueue.get().createSharedWatchers(*this));
     return SC::Result(true);
@@ -269,7 +799,8 @@ SC::Result SC::AsyncEventLoop::run()
     // It may happen that getTotalNumberOfActiveHandle() < 0 when re-activating an async that has been calling
     // decreaseActiveCount() during initial setup. Now that async would be in the submissions.
     // One example that matches this case is re-activation of the FilePoll used for shared wakeups.
-    while (internal.getTotalNumberOfActiveHandle() != 0 or not internal.submissions.isEmpty())
+    while (internal.getTotalNumberOfActiveHandle() != 0 or not internal.submissions.isEmpty() or
+           not internal.cancellations.isEmpty() or internal.numPostedFunctions.load(memory_order_relaxed) != 0)
     {
         SC_TRY(runOnce());
     };
@@ -310,6 +841,13 @@ SC::Result SC::AsyncEventLoop::createAsyncTCPSocket(SocketFlags::AddressFamily f
     return associateExternallyCreatedTCPSocket(outDescriptor);
 }
 
+SC::Result SC::AsyncEventLoop::createAsyncUDPSocket(SocketFlags::AddressFamily family, SocketDescriptor& outDescriptor)
+{
+    SC_TRY(outDescriptor.create(family, SocketFlags::SocketDgram, SocketFlags::ProtocolUdp, SocketFlags::NonBlocking,
+                                SocketFlags::NonInheritable));
+    return associateExternallyCreatedTCPSocket(outDescriptor);
+}
+
 SC::Result SC::AsyncEventLoop::wakeUpFromExternalThread()
 {
     if (not internal.wakeUpPending.exchange(true))
@@ -321,6 +859,8 @@ SC::Result SC::AsyncEventLoop::wakeUpFromExternalThread()
     return Result(true);
 }
 
+SC::Result SC::AsyncEventLoop::post(Function<void()>&& func) { return internal.post(move(func)); }
+
 SC::Result SC::AsyncEventLoop::associateExternallyCreatedTCPSocket(SocketDescriptor& outDescriptor)
 {
     return internal.kernelQueue.get().associateExternallyCreatedTCPSocket(outDescriptor);
@@ -333,6 +873,10 @@ SC::Result SC::AsyncEventLoop::associateExternallyCreatedFileDescriptor(FileDesc
 /// Get Loop time
 SC::Time::HighResolutionCounter SC::AsyncEventLoop::getLoopTime() const { return internal.loopTime; }
 
+void SC::AsyncEventLoop::enableStats(AsyncEventLoopStats& stats) { internal.stats = &stats; }
+
+void SC::AsyncEventLoop::disableStats() { internal.stats = nullptr; }
+
 #if SC_PLATFORM_LINUX
 #else
 bool SC::AsyncEventLoop::tryLoadingLiburing() { return false; }
@@ -348,62 +892,263 @@ SC::Result SC::AsyncEventLoop::Internal::queueSubmission(AsyncRequest& async, As
     {
         if (task->async != nullptr)
         {
-            return Result::Error("AsyncTask is bound to a different async being started");
+            return Result::Error("AsyncTask is bound to a different async being started");
+        }
+    }
+    async.eventLoop = loop;
+    async.state     = AsyncRequest::State::Setup;
+    if (stats)
+    {
+        statsRequestStarted(async);
+    }
+
+    // Only set the async tasks for operations and backends that are not io_uring
+    if (task)
+    {
+        async.asyncTask = task;
+        task->async     = &async;
+    }
+    else
+    {
+        async.asyncTask = nullptr;
+    }
+
+    submissions.queueBack(async);
+    return Result(true);
+}
+
+SC::AsyncLoopTimeout* SC::AsyncEventLoop::Internal::findEarliestLoopTimeout() const
+{
+    return activeLoopTimeouts.peekEarliest();
+}
+
+const SC::Time::HighResolutionCounter* SC::AsyncEventLoop::Internal::findEarliestExpirationTime() const
+{
+    const AsyncLoopTimeout* loopTimeout = activeLoopTimeouts.peekEarliest();
+    const AsyncRequest*     deadline    = activeDeadlines.peekEarliest();
+    if (deadline == nullptr)
+    {
+        return loopTimeout ? &loopTimeout->expirationTime : nullptr;
+    }
+    const Time::HighResolutionCounter& deadlineTime = deadline->trackingSlot->deadlineTime;
+    if (loopTimeout == nullptr or loopTimeout->expirationTime.isLaterThanOrEqualTo(deadlineTime))
+    {
+        return &deadlineTime;
+    }
+    return &loopTimeout->expirationTime;
+}
+
+void SC::AsyncEventLoop::Internal::invokeExpiredTimers(Time::HighResolutionCounter currentTime)
+{
+    // Reactivated or newly started timeouts go through submissions, so they will not be visited again here
+    while (AsyncLoopTimeout* async = activeLoopTimeouts.peekEarliest())
+    {
+        if (not currentTime.isLaterThanOrEqualTo(async->expirationTime))
+        {
+            break;
+        }
+        removeActiveHandle(*async);
+        AsyncLoopTimeout::Result result(*async, Result(true));
+        const uint64_t           callbackBeginTime = statsCallbackBegin(*async);
+        async->callback(result);
+        statsCallbackEnd(*async, callbackBeginTime, false);
+
+        if (result.shouldBeReactivated)
+        {
+            async->state = AsyncRequest::State::Submitting;
+            submissions.queueBack(*async);
+        }
+        else
+        {
+            async->markAsFree(); // Allows starting the timeout again after its callback
+        }
+    }
+}
+
+bool SC::AsyncEventLoop::Internal::supportsDeadline(const AsyncRequest& async)
+{
+    switch (async.type)
+    {
+    case AsyncRequest::Type::LoopTimeout:
+    case AsyncRequest::Type::LoopWakeUp:
+    case AsyncRequest::Type::LoopWork: return false;
+    default: break;
+    }
+    return async.deadline.ms > 0 and async.asyncTask == nullptr and (async.flags & Flag_ManualCompletion) == 0;
+}
+
+void SC::AsyncEventLoop::Internal::invokeExpiredDeadlines(KernelEvents&               kernelEvents,
+                                                          Time::HighResolutionCounter currentTime)
+{
+    while (AsyncRequest* async = activeDeadlines.peekEarliest())
+    {
+        if (not currentTime.isLaterThanOrEqualTo(async->trackingSlot->deadlineTime))
+        {
+            break;
+        }
+        // Unlike AsyncRequest::stop the request is cancelled right away, as no kernel event must complete it after
+        // its callback has received the deadline error (cancelAsync also removes it from activeDeadlines)
+        async->flags |= Flag_DeadlineExpired;
+        Result res = cancelAsync(kernelEvents, *async);
+        if (async->state == AsyncRequest::State::Active)
+        {
+            removeActiveHandle(*async); // cancelAsync failed before removing it
+        }
+        if (res)
+        {
+            res = teardownAsync(kernelEvents, *async);
+        }
+        if (not res)
+        {
+            SC_LOG_MESSAGE("Error cancelling {} after deadline ({})", async->debugName, res.message);
+        }
+        bool reactivate = false;
+        (void)completeAsync(kernelEvents, *async, Result::Error("AsyncRequest deadline expired"), reactivate);
+        if (waitsCancellationCompletion(kernelEvents, *async))
+        {
+            // Will be freed (or restarted if reactivated) by its cancelled kernel completion
+            waitCancellationCompletion(*async);
+            if (reactivate)
+            {
+                async->flags |= Flag_DeadlineRestart;
+            }
+        }
+        else if (reactivate)
+        {
+            restartAfterDeadline(*async);
+        }
+        else
+        {
+            async->markAsFree();
+        }
+    }
+}
+
+void SC::AsyncEventLoop::Internal::restartAfterDeadline(AsyncRequest& async)
+{
+    // Request has already been torn down, so it's setup again like when it's started (getting a new deadline)
+    if (async.flags & Flag_WaitsCancellation)
+    {
+        cancellations.remove(async);
+    }
+    async.flags = 0;
+    async.state = AsyncRequest::State::Setup;
+    submissions.queueBack(async);
+}
+
+// PairingHeap
+template <typename T, typename Links>
+void SC::AsyncEventLoop::Internal::PairingHeap<T, Links>::insert(T& request)
+{
+    Node& node = Links::node(request);
+    SC_ASSERT_DEBUG(Links::next(node) == nullptr and Links::prev(node) == nullptr and Links::child(node) == nullptr);
+    root = root == nullptr ? &node : meld(root, &node);
+}
+
+template <typename T, typename Links>
+void SC::AsyncEventLoop::Internal::PairingHeap<T, Links>::remove(T& request)
+{
+    Node&  node  = Links::node(request);
+    Node*& next  = Links::next(node);
+    Node*& prev  = Links::prev(node);
+    Node*& child = Links::child(node);
+    if (&node == root)
+    {
+        root = mergePairs(child);
+    }
+    else
+    {
+        // Detach the sub-heap rooted at request from its parent / siblings
+        if (Links::next(*prev) == &node)
+        {
+            Links::next(*prev) = next;
+        }
+        else
+        {
+            Links::child(*prev) = next;
+        }
+        if (next)
+        {
+            Links::prev(*next) = prev;
+        }
+        Node* children = mergePairs(child);
+        if (children)
+        {
+            root = meld(root, children);
         }
     }
-    async.eventLoop = loop;
-    async.state     = AsyncRequest::State::Setup;
+    next  = nullptr;
+    prev  = nullptr;
+    child = nullptr;
+}
 
-    // Only set the async tasks for operations and backends that are not io_uring
-    if (task)
+template <typename T, typename Links>
+typename SC::AsyncEventLoop::Internal::PairingHeap<T, Links>::Node* SC::AsyncEventLoop::Internal::PairingHeap<
+    T, Links>::meld(Node* first, Node* second)
+{
+    // On equal expiration time the first heap stays on top, preserving start order for requests started together
+    if (not Links::time(*second).isLaterThanOrEqualTo(Links::time(*first)))
     {
-        async.asyncTask = task;
-        task->async     = &async;
+        Node* temp = first;
+        first      = second;
+        second     = temp;
     }
-    else
+    Node*& firstChild    = Links::child(*first);
+    Links::prev(*second) = first;
+    Links::next(*second) = firstChild;
+    if (firstChild)
     {
-        async.asyncTask = nullptr;
+        Links::prev(*firstChild) = second;
     }
-
-    submissions.queueBack(async);
-    return Result(true);
+    firstChild = second;
+    return first;
 }
 
-SC::AsyncLoopTimeout* SC::AsyncEventLoop::Internal::findEarliestLoopTimeout() const
+template <typename T, typename Links>
+typename SC::AsyncEventLoop::Internal::PairingHeap<T, Links>::Node* SC::AsyncEventLoop::Internal::PairingHeap<
+    T, Links>::mergePairs(Node* first)
 {
-    AsyncLoopTimeout* earliestTime = nullptr;
-    for (AsyncRequest* async = activeLoopTimeouts.front; async != nullptr; async = async->next)
+    // Standard two-pass pairing: meld siblings pairwise from left to right, then meld the pairs from right to left.
+    // The first pass builds a list of melded pairs (linked through next) in reverse order, ready for the second pass.
+    Node* pairs = nullptr;
+    while (first != nullptr)
     {
-        SC_ASSERT_DEBUG(async->type == AsyncRequest::Type::LoopTimeout);
-        const auto& expirationTime = static_cast<AsyncLoopTimeout*>(async)->expirationTime;
-        if (earliestTime == nullptr or earliestTime->expirationTime.isLaterThanOrEqualTo(expirationTime))
+        Node* second = Links::next(*first);
+        Node* melded = first;
+        if (second != nullptr)
         {
-            earliestTime = static_cast<AsyncLoopTimeout*>(async);
-        }
-    };
-    return earliestTime;
-}
+            Node* remaining = Links::next(*second);
 
-void SC::AsyncEventLoop::Internal::invokeExpiredTimers(Time::HighResolutionCounter currentTime)
-{
-    AsyncLoopTimeout* async;
-    for (async = activeLoopTimeouts.front; //
-         async != nullptr;                 //
-         async = static_cast<AsyncLoopTimeout*>(async->next))
+            Links::next(*first)  = nullptr;
+            Links::prev(*first)  = nullptr;
+            Links::next(*second) = nullptr;
+            Links::prev(*second) = nullptr;
+
+            melded = meld(first, second);
+            first  = remaining;
+        }
+        else
+        {
+            first = nullptr;
+        }
+        Links::prev(*melded) = nullptr;
+        Links::next(*melded) = pairs;
+        pairs                = melded;
+    }
+    Node* result = pairs;
+    if (result != nullptr)
     {
-        if (currentTime.isLaterThanOrEqualTo(async->expirationTime))
+        pairs                = Links::next(*result);
+        Links::next(*result) = nullptr;
+        while (pairs != nullptr)
         {
-            removeActiveHandle(*async);
-            AsyncLoopTimeout::Result result(*async, Result(true));
-            async->callback(result);
-
-            if (result.shouldBeReactivated)
-            {
-                async->state = AsyncRequest::State::Submitting;
-                submissions.queueBack(*async);
-            }
+            Node* current         = pairs;
+            pairs                 = Links::next(*current);
+            Links::next(*current) = nullptr;
+            result                = meld(result, current);
         }
     }
+    return result;
 }
 
 template <typename T>
@@ -451,28 +1196,53 @@ SC::Result SC::AsyncEventLoop::Internal::close()
 
     while (AsyncRequest* async = manualThreadPoolCompletions.pop())
     {
-        async->state     = AsyncRequest::State::Free;
-        async->eventLoop = nullptr;
+        async->markAsFree();
     }
 
+    releasePostQueue();
+
     freeAsyncRequests(submissions);
 
-    freeAsyncRequests(activeLoopTimeouts);
+    while (AsyncLoopTimeout* async = activeLoopTimeouts.peekEarliest())
+    {
+        activeLoopTimeouts.remove(*async);
+        async->markAsFree();
+    }
+    while (AsyncRequest* async = activeDeadlines.peekEarliest())
+    {
+        activeDeadlines.remove(*async); // Requests are freed below, together with their active list
+    }
     freeAsyncRequests(activeLoopWakeUps);
     freeAsyncRequests(activeProcessExits);
     freeAsyncRequests(activeSocketAccepts);
     freeAsyncRequests(activeSocketConnects);
     freeAsyncRequests(activeSocketSends);
     freeAsyncRequests(activeSocketReceives);
+    freeAsyncRequests(activeSocketSendTos);
+    freeAsyncRequests(activeSocketReceiveFroms);
     freeAsyncRequests(activeSocketCloses);
     freeAsyncRequests(activeFileReads);
     freeAsyncRequests(activeFileWrites);
     freeAsyncRequests(activeFileCloses);
     freeAsyncRequests(activeFilePolls);
+    freeAsyncRequests(activeFileSends);
 
     freeAsyncRequests(manualCompletions);
+    while (AsyncRequest* async = cancellations.front)
+    {
+        async->markAsFree(); // Also removes it from cancellations
+    }
     numberOfActiveHandles = 0;
     numberOfExternals     = 0;
+    wakeUpPending.exchange(false); // A wake up not yet received must not block wake ups after re-creating the loop
+    releaseKernelEventsMemory();
+    releaseTrackingSlots();
+    // Pools can be closed (or destroyed) after the loop, so they must not keep pointing to it
+    for (AsyncRequestPoolBase* pool = requestPools.front; pool != nullptr; pool = pool->next)
+    {
+        pool->eventLoop = nullptr;
+    }
+    requestPools.clear();
     SC_TRY(loop->internal.kernelQueue.get().close());
     return res;
 }
@@ -499,10 +1269,22 @@ SC::Result SC::AsyncEventLoop::Internal::stageSubmission(KernelEvents& kernelEve
     case AsyncRequest::State::Cancelling: {
         SC_TRY(cancelAsync(kernelEvents, async));
         SC_TRY(teardownAsync(kernelEvents, async));
+        if (waitsCancellationCompletion(kernelEvents, async))
+        {
+            waitCancellationCompletion(async);
+        }
+        else
+        {
+            async.markAsFree(); // Allows starting the request again
+        }
     }
     break;
     case AsyncRequest::State::Teardown: {
         SC_TRY(teardownAsync(kernelEvents, async));
+        if (async.state == AsyncRequest::State::Teardown)
+        {
+            async.markAsFree(); // Not in flight (unless teardownAsync has cancelled a multishot kernel request)
+        }
     }
     break;
     case AsyncRequest::State::Active: {
@@ -533,11 +1315,25 @@ SC::Result SC::AsyncEventLoop::Internal::completeAndEventuallyReactivate(KernelE
     if (reactivate)
     {
         async.state = AsyncRequest::State::Submitting;
-        submissions.queueBack(async);
+        if (async.flags & Internal::Flag_Multishot)
+        {
+            // Kernel request is still armed and it will deliver next completion without a new submission
+            addActiveHandle(async);
+        }
+        else
+        {
+            submissions.queueBack(async);
+        }
     }
     else
     {
+        async.state = AsyncRequest::State::Teardown;
         SC_TRY(teardownAsync(kernelEvents, async));
+        if (async.state == AsyncRequest::State::Teardown)
+        {
+            // Detach from the loop, so that the request can be started again after its completion
+            async.markAsFree();
+        }
     }
     if (not returnCode)
     {
@@ -546,11 +1342,147 @@ SC::Result SC::AsyncEventLoop::Internal::completeAndEventuallyReactivate(KernelE
     return Result(true);
 }
 
+SC::Result SC::AsyncEventLoop::Internal::createKernelEventsMemory(size_t memorySize)
+{
+    SC_TRY_MSG(memorySize >= 1024, "AsyncEventLoop::create - kernelEventsMemorySize must be at least 1 KB");
+    releaseKernelEventsMemory();
+    if (memorySize > DefaultKernelEventsMemorySize)
+    {
+        kernelEventsMemory = Memory::allocate(memorySize);
+        SC_TRY_MSG(kernelEventsMemory != nullptr, "AsyncEventLoop::create - Cannot allocate kernel events memory");
+    }
+    kernelEventsMemorySize = memorySize;
+    return Result(true);
+}
+
+void SC::AsyncEventLoop::Internal::releaseKernelEventsMemory()
+{
+    if (kernelEventsMemory != nullptr)
+    {
+        Memory::release(kernelEventsMemory);
+        kernelEventsMemory = nullptr;
+    }
+    kernelEventsMemorySize = DefaultKernelEventsMemorySize;
+}
+
+SC::uint64_t SC::AsyncEventLoop::Internal::getStatsTime()
+{
+    Time::HighResolutionCounter now;
+    now.snap();
+    return static_cast<uint64_t>(now.toNanoseconds());
+}
+
+void SC::AsyncEventLoop::Internal::statsRequestStarted(AsyncRequest& async)
+{
+    detail::AsyncTrackingSlot* slot = acquireTrackingSlot(async);
+    if (slot != nullptr) // Completion latency is not measured if the slot cannot be allocated
+    {
+        slot->statsStartTime = getStatsTime();
+    }
+    addRelaxed(stats->requests[static_cast<size_t>(async.type)].numStarted, 1);
+}
+
+SC::uint64_t SC::AsyncEventLoop::Internal::statsCallbackBegin(AsyncRequest& async)
+{
+    if (stats == nullptr)
+    {
+        return 0;
+    }
+    const uint64_t                   now  = getStatsTime();
+    const detail::AsyncTrackingSlot* slot = async.trackingSlot;
+    // Start time is zero if the request has been started before enabling stats
+    if (slot != nullptr and slot->statsStartTime != 0 and now >= slot->statsStartTime)
+    {
+        stats->requests[static_cast<size_t>(async.type)].completionLatency.record(now - slot->statsStartTime);
+    }
+    return now;
+}
+
+void SC::AsyncEventLoop::Internal::statsCallbackEnd(AsyncRequest& async, uint64_t callbackBeginTime, bool failed)
+{
+    if (stats == nullptr or callbackBeginTime == 0)
+    {
+        return; // Stats are disabled, or they've been enabled during the callback
+    }
+    const uint64_t now = getStatsTime();
+
+    AsyncEventLoopStats::RequestStats& requestStats = stats->requests[static_cast<size_t>(async.type)];
+    requestStats.callbackDuration.record(now - callbackBeginTime);
+    addRelaxed(requestStats.numCompleted, 1);
+    if (failed)
+    {
+        addRelaxed(requestStats.numErrors, 1);
+    }
+    // A reactivated request measures its next completion latency from the end of this callback
+    if (async.trackingSlot != nullptr)
+    {
+        async.trackingSlot->statsStartTime = now;
+    }
+}
+
+SC::detail::AsyncTrackingSlot* SC::AsyncEventLoop::Internal::acquireTrackingSlot(AsyncRequest& async)
+{
+    if (async.trackingSlot != nullptr)
+    {
+        return async.trackingSlot;
+    }
+    if (freeTrackingSlots == nullptr)
+    {
+        TrackingSlotsBlock* block = reinterpret_cast<TrackingSlotsBlock*>(Memory::allocate(sizeof(TrackingSlotsBlock)));
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+        block->next         = trackingSlotsBlocks;
+        trackingSlotsBlocks = block;
+        for (size_t idx = 0; idx < NumTrackingSlotsPerBlock; ++idx)
+        {
+            detail::AsyncTrackingSlot* slot = new (&block->slots[idx], PlacementNew()) detail::AsyncTrackingSlot();
+            slot->nextFree                  = freeTrackingSlots;
+            freeTrackingSlots               = slot;
+        }
+    }
+    detail::AsyncTrackingSlot* slot = freeTrackingSlots;
+    freeTrackingSlots               = slot->nextFree;
+    *slot                           = detail::AsyncTrackingSlot();
+    slot->request                   = &async;
+    async.trackingSlot              = slot;
+    return slot;
+}
+
+void SC::AsyncEventLoop::Internal::releaseTrackingSlot(AsyncRequest& async)
+{
+    SC_ASSERT_DEBUG((async.flags & Flag_DeadlineArmed) == 0); // Must have been removed from activeDeadlines
+    detail::AsyncTrackingSlot* slot = async.trackingSlot;
+    async.trackingSlot              = nullptr;
+    slot->request                   = nullptr;
+    slot->nextFree                  = freeTrackingSlots;
+    freeTrackingSlots               = slot;
+}
+
+void SC::AsyncEventLoop::Internal::releaseTrackingSlots()
+{
+    while (trackingSlotsBlocks != nullptr)
+    {
+        TrackingSlotsBlock* next = trackingSlotsBlocks->next;
+        Memory::release(trackingSlotsBlocks);
+        trackingSlotsBlocks = next;
+    }
+    freeTrackingSlots = nullptr;
+}
+
 SC::Result SC::AsyncEventLoop::Internal::runStep(SyncMode syncMode)
 {
-    alignas(uint64_t) uint8_t buffer[8 * 1024]; // 8 Kb of kernel events
+    alignas(uint64_t) uint8_t buffer[DefaultKernelEventsMemorySize];
     AsyncKernelEvents         kernelEvents;
-    kernelEvents.eventsMemory = buffer;
+    if (kernelEventsMemory != nullptr)
+    {
+        kernelEvents.eventsMemory = {static_cast<uint8_t*>(kernelEventsMemory), kernelEventsMemorySize};
+    }
+    else
+    {
+        kernelEvents.eventsMemory = {buffer, kernelEventsMemorySize};
+    }
     SC_TRY(submitRequests(kernelEvents));
     SC_TRY(blockingPoll(syncMode, kernelEvents));
     return dispatchCompletions(syncMode, kernelEvents);
@@ -559,19 +1491,26 @@ SC::Result SC::AsyncEventLoop::Internal::runStep(SyncMode syncMode)
 SC::Result SC::AsyncEventLoop::Internal::submitRequests(AsyncKernelEvents& asyncKernelEvents)
 {
     KernelEvents kernelEvents(loop->internal.kernelQueue.get(), asyncKernelEvents);
+    // Only the first numberOfEvents kernel events are ever read, so their memory is not cleared (avoiding to pull the
+    // entire buffer in cache at every step)
     asyncKernelEvents.numberOfEvents = 0;
-    // TODO: Check if it's possible to avoid zeroing kernel events memory
-    memset(asyncKernelEvents.eventsMemory.data(), 0, asyncKernelEvents.eventsMemory.sizeInBytes());
     SC_LOG_MESSAGE("---------------\n");
 
+    uint64_t numSubmissions = 0;
     while (AsyncRequest* async = submissions.dequeueFront())
     {
+        numSubmissions++;
         auto res = stageSubmission(kernelEvents, *async);
         if (not res)
         {
             reportError(kernelEvents, *async, move(res));
         }
     }
+    if (stats)
+    {
+        stats->numSubmissions.store(numSubmissions, memory_order_relaxed);
+        maxRelaxed(stats->maxSubmissions, numSubmissions);
+    }
 
     return SC::Result(true);
 }
@@ -579,17 +1518,26 @@ SC::Result SC::AsyncEventLoop::Internal::submitRequests(AsyncKernelEvents& async
 SC::Result SC::AsyncEventLoop::Internal::blockingPoll(SyncMode syncMode, AsyncKernelEvents& asyncKernelEvents)
 {
     KernelEvents kernelEvents(loop->internal.kernelQueue.get(), asyncKernelEvents);
-    if (getTotalNumberOfActiveHandle() <= 0 and numberOfManualCompletions == 0)
+    const bool hasPostedFunctions = numPostedFunctions.load(memory_order_relaxed) != 0;
+    const bool hasCancellations   = not cancellations.isEmpty();
+    if (getTotalNumberOfActiveHandle() <= 0 and numberOfManualCompletions == 0 and not hasPostedFunctions and
+        not hasCancellations)
     {
         // happens when we do cancelAsync on the last active async for example
         return SC::Result(true);
     }
 
-    if (getTotalNumberOfActiveHandle() != 0)
+    // Posted functions are executed by the shared wake up watcher, that will be signaled by their post
+    if (getTotalNumberOfActiveHandle() != 0 or hasPostedFunctions or hasCancellations)
     {
         // We may have some manualCompletions queued (for SocketClose for example) but no active handles
         SC_LOG_MESSAGE("Active Requests Before Poll = {}\n", getTotalNumberOfActiveHandle());
+        const uint64_t pollBeginTime = stats ? getStatsTime() : 0;
         SC_TRY(kernelEvents.syncWithKernel(*loop, syncMode));
+        if (stats)
+        {
+            stats->pollDuration.record(getStatsTime() - pollBeginTime);
+        }
         SC_LOG_MESSAGE("Active Requests After Poll = {}\n", getTotalNumberOfActiveHandle());
     }
     return SC::Result(true);
@@ -597,7 +1545,8 @@ SC::Result SC::AsyncEventLoop::Internal::blockingPoll(SyncMode syncMode, AsyncKe
 
 SC::Result SC::AsyncEventLoop::Internal::dispatchCompletions(SyncMode syncMode, AsyncKernelEvents& asyncKernelEvents)
 {
-    KernelEvents kernelEvents(loop->internal.kernelQueue.get(), asyncKernelEvents);
+    KernelEvents   kernelEvents(loop->internal.kernelQueue.get(), asyncKernelEvents);
+    const uint64_t dispatchBeginTime = stats ? getStatsTime() : 0;
     switch (syncMode)
     {
     case SyncMode::NoWait: {
@@ -606,17 +1555,31 @@ SC::Result SC::AsyncEventLoop::Internal::dispatchCompletions(SyncMode syncMode,
     }
     break;
     case SyncMode::ForcedForwardProgress: {
+        // Refresh loop time after blocking, so that timeouts reactivated in callbacks don't expire in the past
+        updateTime();
         if (expiredTimer)
         {
-            invokeExpiredTimers(expiredTimer->expirationTime);
+            invokeExpiredTimers(loopTime);
             expiredTimer = nullptr;
         }
     }
     break;
     }
+    const uint32_t numKernelEvents = kernelEvents.getNumEvents();
     runStepExecuteCompletions(kernelEvents);
     runStepExecuteManualCompletions(kernelEvents);
     runStepExecuteManualThreadPoolCompletions(kernelEvents);
+    // After completions, so that requests completed in this step are not cancelled even if their deadline has expired
+    invokeExpiredDeadlines(kernelEvents, loopTime);
+    if (stats and dispatchBeginTime != 0) // Callbacks could have enabled (or disabled) stats
+    {
+        const uint64_t numActiveRequests = static_cast<uint64_t>(getTotalNumberOfActiveHandle());
+        stats->dispatchDuration.record(getStatsTime() - dispatchBeginTime);
+        addRelaxed(stats->numSteps, 1);
+        addRelaxed(stats->numKernelEvents, numKernelEvents);
+        stats->numActiveRequests.store(numActiveRequests, memory_order_relaxed);
+        maxRelaxed(stats->maxActiveRequests, numActiveRequests);
+    }
 
     SC_LOG_MESSAGE("Active Requests After Completion = {} ( + {} manual)\n", getTotalNumberOfActiveHandle(),
                    numberOfManualCompletions);
@@ -647,8 +1610,18 @@ void SC::AsyncEventLoop::Internal::runStepExecuteManualThreadPoolCompletions(Ker
 
 void SC::AsyncEventLoop::Internal::runStepExecuteCompletions(KernelEvents& kernelEvents)
 {
+    // Requests are scattered in memory (owned by callers) so they're likely not in cache. Their addresses are known
+    // from the kernel events, so loading them can start a few events before they're dispatched.
+    for (uint32_t idx = 0; idx < kernelEvents.getNumEvents() and idx < CompletionsPrefetchDistance; ++idx)
+    {
+        SC_COMPILER_PREFETCH(kernelEvents.getAsyncRequest(idx));
+    }
     for (uint32_t idx = 0; idx < kernelEvents.getNumEvents(); ++idx)
     {
+        if (idx + CompletionsPrefetchDistance < kernelEvents.getNumEvents())
+        {
+            SC_COMPILER_PREFETCH(kernelEvents.getAsyncRequest(idx + CompletionsPrefetchDistance));
+        }
         SC_LOG_MESSAGE(" Iteration = {}\n", idx);
         SC_LOG_MESSAGE(" Active Requests = {}\n", getTotalNumberOfActiveHandle());
         bool continueProcessing = true;
@@ -679,6 +1652,10 @@ void SC::AsyncEventLoop::Internal::runStepExecuteCompletions(KernelEvents& kerne
                 SC_LOG_MESSAGE("Error completing {}", async.debugName);
             }
         }
+        else if (async.state == AsyncRequest::State::Cancelling and (async.flags & Flag_DeadlineRestart))
+        {
+            restartAfterDeadline(async); // Reactivated by the callback receiving its deadline error
+        }
         else
         {
             SC_ASSERT_RELEASE(async.state != AsyncRequest::State::Free);
@@ -779,6 +1756,7 @@ struct SC::AsyncEventLoop::Internal::TeardownAsyncPhase
     template <typename T>
     SC::Result operator()(T& async)
     {
+        SC_TRY(releasePoolBuffer(async));
         return Result(kernelEvents.teardownAsync(async));
     }
 };
@@ -801,6 +1779,7 @@ struct SC::AsyncEventLoop::Internal::CompleteAsyncPhase
         using AsyncResultType = typename AsyncType::Result;
         using AsyncCompletion = typename AsyncType::CompletionData;
         AsyncResultType result(async, forward<Result>(returnCode));
+        result.deadlineExpired = (async.flags & Internal::Flag_DeadlineExpired) != 0;
         if (result.returnCode)
         {
             if (result.getAsync().asyncTask)
@@ -817,12 +1796,15 @@ struct SC::AsyncEventLoop::Internal::CompleteAsyncPhase
                 result.returnCode = Result(kernelEvents.completeAsync(result));
             }
         }
+        AsyncEventLoop::Internal& internal          = async.eventLoop->internal;
+        const uint64_t            callbackBeginTime = internal.statsCallbackBegin(async);
         if (result.getAsync().callback.isValid())
         {
             result.getAsync().callback(result);
         }
+        internal.statsCallbackEnd(async, callbackBeginTime, not result.returnCode);
         reactivate = result.shouldBeReactivated;
-        return SC::Result(true);
+        return releasePoolBuffer(async);
     }
 };
 
@@ -836,6 +1818,15 @@ SC::Result SC::AsyncEventLoop::Internal::activateAsync(KernelEvents& kernelEvent
 {
     SC_LOG_MESSAGE("{} {} ACTIVATE\n", async.debugName, AsyncRequest::TypeToString(async.type));
     SC_ASSERT_RELEASE(async.state == AsyncRequest::State::Submitting);
+    if (supportsDeadline(async))
+    {
+        detail::AsyncTrackingSlot* slot = acquireTrackingSlot(async);
+        SC_TRY_MSG(slot != nullptr, "AsyncEventLoop::activateAsync - Cannot allocate deadline");
+        // loopTime is only refreshed after polling, so it can be stale when activating in a fresh run
+        Time::HighResolutionCounter activationTime;
+        activationTime.snap();
+        slot->deadlineTime = activationTime.offsetBy(async.deadline);
+    }
     SC_TRY(Internal::applyOnAsync(async, ActivateAsyncPhase(kernelEvents)));
     async.eventLoop->internal.addActiveHandle(async);
     return Result(true);
@@ -851,13 +1842,25 @@ SC::Result SC::AsyncEventLoop::Internal::teardownAsync(KernelEvents& kernelEvent
 void SC::AsyncEventLoop::Internal::reportError(KernelEvents& kernelEvents, AsyncRequest& async, Result&& returnCode)
 {
     SC_LOG_MESSAGE("{} ERROR {}\n", async.debugName, AsyncRequest::TypeToString(async.type));
-    bool reactivate = false;
-    if (async.state == AsyncRequest::State::Active)
+    bool       reactivate = false;
+    const bool wasActive  = async.state == AsyncRequest::State::Active;
+    if (wasActive)
     {
         removeActiveHandle(async);
     }
     (void)completeAsync(kernelEvents, async, forward<Result>(returnCode), reactivate);
-    async.state = AsyncRequest::State::Free;
+    if (wasActive)
+    {
+        // Stop monitoring the failed descriptor (for example after EPOLLERR), as it's not going to be re-armed
+        (void)teardownAsync(kernelEvents, async);
+        if (reactivate and (async.flags & Flag_DeadlineExpired))
+        {
+            restartAfterDeadline(async); // Cancelled by its linked timeout (io_uring)
+            return;
+        }
+    }
+    // Detach from the loop, so that the request can be started again after the error
+    async.markAsFree();
 }
 
 SC::Result SC::AsyncEventLoop::Internal::completeAsync(KernelEvents& kernelEvents, AsyncRequest& async,
@@ -875,6 +1878,26 @@ SC::Result SC::AsyncEventLoop::Internal::completeAsync(KernelEvents& kernelEvent
     return Internal::applyOnAsync(async, CompleteAsyncPhase(kernelEvents, move(returnCode), reactivate));
 }
 
+bool SC::AsyncEventLoop::Internal::waitsCancellationCompletion(KernelEvents& kernelEvents, AsyncRequest& async)
+{
+    if (async.asyncTask != nullptr or (async.flags & Flag_ManualCompletion) != 0)
+    {
+        return false; // Thread pool tasks and manual completions are removed from their queues by CancelAsyncPhase
+    }
+    return kernelEvents.receivesCancellationCompletion(async);
+}
+
+void SC::AsyncEventLoop::Internal::waitCancellationCompletion(AsyncRequest& async)
+{
+    // The loop keeps polling the kernel until the completion arrives, even if there are no more active requests
+    async.state = AsyncRequest::State::Cancelling;
+    if ((async.flags & Flag_WaitsCancellation) == 0)
+    {
+        async.flags |= Flag_WaitsCancellation;
+        cancellations.queueBack(async);
+    }
+}
+
 SC::Result SC::AsyncEventLoop::Internal::cancelAsync(KernelEvents& kernelEvents, AsyncRequest& async)
 {
     SC_LOG_MESSAGE("{} {} CANCEL\n", async.debugName, AsyncRequest::TypeToString(async.type));
@@ -907,6 +1930,7 @@ SC::Result SC::AsyncEventLoop::Internal::cancelAsync(AsyncRequest& async)
     }
     case AsyncRequest::State::Setup: {
         submissions.remove(async);
+        async.markAsFree(); // Nothing has been setup yet, so it can be started again right away
         break;
     }
     case AsyncRequest::State::Teardown: //
@@ -919,6 +1943,112 @@ SC::Result SC::AsyncEventLoop::Internal::cancelAsync(AsyncRequest& async)
     return Result(true);
 }
 
+// Matches requests operating on a socket or file descriptor (the other one is left Invalid)
+struct SC::AsyncEventLoop::Internal::HandleMatcher
+{
+    SocketDescriptor::Handle socketHandle = SocketDescriptor::Invalid;
+    FileDescriptor::Handle   fileHandle   = FileDescriptor::Invalid;
+
+    bool cancelledByKernel = false; // Kernel cancels all requests of the descriptor (io_uring)
+    bool matches           = false;
+
+    // clang-format off
+    Result operator()(AsyncSocketAccept& async)      { return match(async.handle == socketHandle); }
+    Result operator()(AsyncSocketConnect& async)     { return match(async.handle == socketHandle); }
+    Result operator()(AsyncSocketSend& async)        { return match(async.handle == socketHandle); }
+    Result operator()(AsyncSocketReceive& async)     { return match(async.handle == socketHandle); }
+    Result operator()(AsyncSocketSendTo& async)      { return match(async.handle == socketHandle); }
+    Result operator()(AsyncSocketReceiveFrom& async) { return match(async.handle == socketHandle); }
+    Result operator()(AsyncFileRead& async)          { return match(async.fileDescriptor == fileHandle); }
+    Result operator()(AsyncFileWrite& async)         { return match(async.fileDescriptor == fileHandle); }
+    Result operator()(AsyncFilePoll& async)          { return match(async.fileDescriptor == fileHandle); }
+    Result operator()(AsyncFileSend& async)
+    {
+        return match(async.fileHandle == fileHandle or async.socketHandle == socketHandle);
+    }
+    // Loop requests, process exits and close requests are never cancelled
+    template <typename T> Result operator()(T&)      { return match(false); }
+    // clang-format on
+
+  private:
+    Result match(bool value)
+    {
+        matches = value;
+        return Result(true);
+    }
+};
+
+SC::Result SC::AsyncEventLoop::cancelAllRequestsFor(const SocketDescriptor& descriptor)
+{
+    Internal::HandleMatcher matcher;
+    SC_TRY(descriptor.get(matcher.socketHandle, Result::Error("AsyncEventLoop::cancelAllRequestsFor - Invalid")));
+    return internal.cancelAllRequestsFor(matcher, matcher.socketHandle);
+}
+
+SC::Result SC::AsyncEventLoop::cancelAllRequestsFor(const FileDescriptor& descriptor)
+{
+    Internal::HandleMatcher matcher;
+    SC_TRY(descriptor.get(matcher.fileHandle, Result::Error("AsyncEventLoop::cancelAllRequestsFor - Invalid")));
+    return internal.cancelAllRequestsFor(matcher, matcher.fileHandle);
+}
+
+template <typename HandleType>
+SC::Result SC::AsyncEventLoop::Internal::cancelAllRequestsFor(HandleMatcher& matcher, HandleType handle)
+{
+    SC_TRY(kernelQueue.get().cancelAllRequestsFor(handle, matcher.cancelledByKernel));
+
+    // Requests queued for cancellation are added at the end of submissions, so they're visited first to avoid
+    // visiting again the active requests being cancelled
+    AsyncRequest* next;
+    for (AsyncRequest* async = submissions.front; async != nullptr; async = next)
+    {
+        next = async->next;
+        SC_TRY(cancelIfMatching(*async, matcher));
+    }
+    SC_TRY(cancelMatchingRequests(activeSocketAccepts, matcher));
+    SC_TRY(cancelMatchingRequests(activeSocketConnects, matcher));
+    SC_TRY(cancelMatchingRequests(activeSocketSends, matcher));
+    SC_TRY(cancelMatchingRequests(activeSocketReceives, matcher));
+    SC_TRY(cancelMatchingRequests(activeSocketSendTos, matcher));
+    SC_TRY(cancelMatchingRequests(activeSocketReceiveFroms, matcher));
+    SC_TRY(cancelMatchingRequests(activeFileReads, matcher));
+    SC_TRY(cancelMatchingRequests(activeFileWrites, matcher));
+    SC_TRY(cancelMatchingRequests(activeFilePolls, matcher));
+    SC_TRY(cancelMatchingRequests(activeFileSends, matcher));
+    return Result(true);
+}
+
+template <typename T>
+SC::Result SC::AsyncEventLoop::Internal::cancelMatchingRequests(IntrusiveDoubleLinkedList<T>& linkedList,
+                                                                HandleMatcher&                matcher)
+{
+    T* next;
+    for (T* async = linkedList.front; async != nullptr; async = next)
+    {
+        next = static_cast<T*>(async->next); // Cancelled requests are moved to submissions
+        SC_TRY(cancelIfMatching(*async, matcher));
+    }
+    return Result(true);
+}
+
+SC::Result SC::AsyncEventLoop::Internal::cancelIfMatching(AsyncRequest& async, HandleMatcher& matcher)
+{
+    if (async.state == AsyncRequest::State::Cancelling or async.state == AsyncRequest::State::Teardown)
+    {
+        return Result(true);
+    }
+    SC_TRY(applyOnAsync(async, matcher));
+    if (not matcher.matches)
+    {
+        return Result(true);
+    }
+    if (matcher.cancelledByKernel and async.state == AsyncRequest::State::Active)
+    {
+        async.flags |= Flag_KernelCancelled; // No need for a cancellation submission for each request
+    }
+    return cancelAsync(async);
+}
+
 void SC::AsyncEventLoop::Internal::updateTime() { loopTime.snap(); }
 
 SC::Result SC::AsyncEventLoop::wakeUpFromExternalThread(AsyncLoopWakeUp& async)
@@ -936,27 +2066,123 @@ SC::Result SC::AsyncEventLoop::wakeUpFromExternalThread(AsyncLoopWakeUp& async)
 
 void SC::AsyncEventLoop::Internal::executeWakeUps(AsyncResult& result)
 {
-    AsyncLoopWakeUp* async;
-    for (async = activeLoopWakeUps.front; //
-         async != nullptr;                //
-         async = static_cast<AsyncLoopWakeUp*>(async->next))
+    // Reset before executing, so that a wake up happening while executing them is not lost
+    wakeUpPending.exchange(false);
+
+    AsyncLoopWakeUp* next;
+    for (AsyncLoopWakeUp* async = activeLoopWakeUps.front; async != nullptr; async = next)
     {
+        // Callback can stop the wake up, moving it from active list to submissions list
+        next = static_cast<AsyncLoopWakeUp*>(async->next);
         SC_ASSERT_DEBUG(async->type == AsyncRequest::Type::LoopWakeUp);
         AsyncLoopWakeUp* notifier = async;
         if (notifier->pending.load() == true)
         {
             AsyncLoopWakeUp::Result asyncResult(*notifier, Result(true));
+            const uint64_t          callbackBeginTime = statsCallbackBegin(*notifier);
             asyncResult.getAsync().callback(asyncResult);
+            statsCallbackEnd(*notifier, callbackBeginTime, false);
+            result.reactivateRequest(asyncResult.shouldBeReactivated);
+            // Allow executing the notification again before signaling, or a wake up issued by the thread
+            // waiting on the event object could be lost.
+            notifier->pending.exchange(false);
             if (notifier->eventObject)
             {
                 notifier->eventObject->signal();
             }
-            result.reactivateRequest(asyncResult.shouldBeReactivated);
-            notifier->pending.exchange(false); // allow executing the notification again
         }
     }
 
-    wakeUpPending.exchange(false);
+    executePostedFunctions();
+}
+
+SC::Result SC::AsyncEventLoop::Internal::post(Function<void()>&& func)
+{
+    SC_TRY_MSG(func.isValid(), "AsyncEventLoop::post - Invalid function");
+    PostQueue* queue = postQueue.load(memory_order_acquire);
+    if (queue == nullptr)
+    {
+        // Allocated by the first thread posting a function, winning the race with other threads posting
+        const size_t capacity = postQueueCapacity;
+        using Cell            = PostQueue::Queue::Cell;
+        void* memory = Memory::allocate(sizeof(PostQueue) + capacity * sizeof(Cell) + CacheLineSize);
+        SC_TRY_MSG(memory != nullptr, "AsyncEventLoop::post - Cannot allocate queue");
+        const size_t address  = (reinterpret_cast<size_t>(memory) + CacheLineSize - 1) & ~(CacheLineSize - 1);
+        Cell*        cells    = reinterpret_cast<Cell*>(address + sizeof(PostQueue));
+        PostQueue*   newQueue = new (reinterpret_cast<PostQueue*>(address), PlacementNew())
+            PostQueue(cells, capacity, memory);
+        if (postQueue.compare_exchange_strong(queue, newQueue, memory_order_acq_rel))
+        {
+            queue = newQueue;
+        }
+        else
+        {
+            newQueue->~PostQueue();
+            Memory::release(memory);
+        }
+    }
+    numPostedFunctions.fetch_add(1, memory_order_relaxed);
+    if (not queue->functions.tryPush(move(func)))
+    {
+        numPostedFunctions.fetch_sub(1, memory_order_relaxed);
+        return Result::Error("AsyncEventLoop::post - Queue is full");
+    }
+    // Only the first post after the loop has been woken up sends a notification to the kernel
+    return loop->wakeUpFromExternalThread();
+}
+
+void SC::AsyncEventLoop::Internal::executePostedFunctions()
+{
+    PostQueue* queue = postQueue.load(memory_order_acquire);
+    if (queue == nullptr)
+    {
+        return;
+    }
+    // Bounded number of executions, so that threads posting continuously cannot starve other requests
+    size_t           numExecuted = 0;
+    Function<void()> func;
+    const size_t     capacity    = queue->functions.capacity();
+    while (numExecuted < capacity and queue->functions.tryPop(func))
+    {
+        func();
+        numExecuted++;
+    }
+    numPostedFunctions.fetch_sub(numExecuted, memory_order_relaxed);
+    if (numExecuted == capacity)
+    {
+        (void)loop->wakeUpFromExternalThread(); // Execute remaining ones on next loop step
+    }
+}
+
+SC::AsyncEventLoop::Internal::PostQueue::PostQueue(Queue::Cell* cells, size_t capacity, void* memory)
+    : cells(cells), memory(memory)
+{
+    for (size_t idx = 0; idx < capacity; ++idx)
+    {
+        new (&cells[idx], PlacementNew()) Queue::Cell();
+    }
+    SC_ASSERT_RELEASE(functions.create({cells, capacity})); // Capacity already validated by AsyncEventLoop::create
+}
+
+SC::AsyncEventLoop::Internal::PostQueue::~PostQueue()
+{
+    const size_t capacity = functions.capacity();
+    for (size_t idx = 0; idx < capacity; ++idx)
+    {
+        cells[idx].~Cell();
+    }
+}
+
+void SC::AsyncEventLoop::Internal::releasePostQueue()
+{
+    PostQueue* queue = postQueue.exchange(nullptr);
+    if (queue != nullptr)
+    {
+        void* memory = queue->memory;
+        queue->~PostQueue(); // Functions not executed yet are just destroyed
+        Memory::release(memory);
+    }
+    numPostedFunctions.store(0);
 }
 
 void SC::AsyncEventLoop::Internal::removeActiveHandle(AsyncRequest& async)
@@ -976,6 +2202,11 @@ void SC::AsyncEventLoop::Internal::removeActiveHandle(AsyncRequest& async)
     {
         return; // Async flagged to be manually completed for thread pool, are not added to active handles
     }
+    if (async.flags & Internal::Flag_DeadlineArmed)
+    {
+        activeDeadlines.remove(async);
+        async.flags &= ~Internal::Flag_DeadlineArmed;
+    }
     // clang-format off
     switch (async.type)
     {
@@ -987,11 +2218,14 @@ void SC::AsyncEventLoop::Internal::removeActiveHandle(AsyncRequest& async)
         case AsyncRequest::Type::SocketConnect: activeSocketConnects.remove(*static_cast<AsyncSocketConnect*>(&async)); break;
         case AsyncRequest::Type::SocketSend:    activeSocketSends.remove(*static_cast<AsyncSocketSend*>(&async));       break;
         case AsyncRequest::Type::SocketReceive: activeSocketReceives.remove(*static_cast<AsyncSocketReceive*>(&async)); break;
+        case AsyncRequest::Type::SocketSendTo:  activeSocketSendTos.remove(*static_cast<AsyncSocketSendTo*>(&async));   break;
+        case AsyncRequest::Type::SocketReceiveFrom: activeSocketReceiveFroms.remove(*static_cast<AsyncSocketReceiveFrom*>(&async)); break;
         case AsyncRequest::Type::SocketClose:   activeSocketCloses.remove(*static_cast<AsyncSocketClose*>(&async));     break;
         case AsyncRequest::Type::FileRead:      activeFileReads.remove(*static_cast<AsyncFileRead*>(&async));           break;
         case AsyncRequest::Type::FileWrite:     activeFileWrites.remove(*static_cast<AsyncFileWrite*>(&async));         break;
         case AsyncRequest::Type::FileClose:     activeFileCloses.remove(*static_cast<AsyncFileClose*>(&async));         break;
         case AsyncRequest::Type::FilePoll:      activeFilePolls.remove(*static_cast<AsyncFilePoll*>(&async));           break;
+        case AsyncRequest::Type::FileSend:      activeFileSends.remove(*static_cast<AsyncFileSend*>(&async));           break;
     }
     // clang-format on
 }
@@ -1016,7 +2250,7 @@ void SC::AsyncEventLoop::Internal::addActiveHandle(AsyncRequest& async)
     // clang-format off
     switch (async.type)
     {
-        case AsyncRequest::Type::LoopTimeout:   activeLoopTimeouts.queueBack(*static_cast<AsyncLoopTimeout*>(&async));      break;
+        case AsyncRequest::Type::LoopTimeout:   activeLoopTimeouts.insert(*static_cast<AsyncLoopTimeout*>(&async));         break;
         case AsyncRequest::Type::LoopWakeUp:    activeLoopWakeUps.queueBack(*static_cast<AsyncLoopWakeUp*>(&async));        break;
         case AsyncRequest::Type::LoopWork:      activeLoopWork.queueBack(*static_cast<AsyncLoopWork*>(&async));             break;
         case AsyncRequest::Type::ProcessExit:   activeProcessExits.queueBack(*static_cast<AsyncProcessExit*>(&async));      break;
@@ -1024,13 +2258,21 @@ void SC::AsyncEventLoop::Internal::addActiveHandle(AsyncRequest& async)
         case AsyncRequest::Type::SocketConnect: activeSocketConnects.queueBack(*static_cast<AsyncSocketConnect*>(&async));  break;
         case AsyncRequest::Type::SocketSend:    activeSocketSends.queueBack(*static_cast<AsyncSocketSend*>(&async));        break;
         case AsyncRequest::Type::SocketReceive: activeSocketReceives.queueBack(*static_cast<AsyncSocketReceive*>(&async));  break;
+        case AsyncRequest::Type::SocketSendTo:  activeSocketSendTos.queueBack(*static_cast<AsyncSocketSendTo*>(&async));    break;
+        case AsyncRequest::Type::SocketReceiveFrom: activeSocketReceiveFroms.queueBack(*static_cast<AsyncSocketReceiveFrom*>(&async)); break;
         case AsyncRequest::Type::SocketClose:   activeSocketCloses.queueBack(*static_cast<AsyncSocketClose*>(&async));      break;
         case AsyncRequest::Type::FileRead:      activeFileReads.queueBack(*static_cast<AsyncFileRead*>(&async));            break;
         case AsyncRequest::Type::FileWrite:     activeFileWrites.queueBack(*static_cast<AsyncFileWrite*>(&async));          break;
         case AsyncRequest::Type::FileClose:     activeFileCloses.queueBack(*static_cast<AsyncFileClose*>(&async));          break;
         case AsyncRequest::Type::FilePoll: 	    activeFilePolls.queueBack(*static_cast<AsyncFilePoll*>(&async));            break;
+        case AsyncRequest::Type::FileSend:      activeFileSends.queueBack(*static_cast<AsyncFileSend*>(&async));            break;
     }
     // clang-format on
+    if (supportsDeadline(async) and (async.flags & Internal::Flag_DeadlineLinked) == 0)
+    {
+        activeDeadlines.insert(async);
+        async.flags |= Internal::Flag_DeadlineArmed;
+    }
 }
 
 void SC::AsyncEventLoop::Internal::scheduleManualCompletion(AsyncRequest& async)
@@ -1039,6 +2281,40 @@ void SC::AsyncEventLoop::Internal::scheduleManualCompletion(AsyncRequest& async)
     async.eventLoop->internal.manualCompletions.queueBack(async);
 }
 
+SC::Result SC::AsyncEventLoop::Internal::releasePoolBuffer(AsyncSocketReceive& async)
+{
+    if (async.bufferIndex < 0)
+    {
+        return Result(true);
+    }
+    const int32_t bufferIndex = async.bufferIndex;
+    async.bufferIndex         = -1;
+    async.buffer              = {};
+    return async.bufferPool->release(bufferIndex);
+}
+
+SC::Result SC::AsyncEventLoop::Internal::releasePoolBuffer(AsyncFileRead& async)
+{
+    if (async.bufferIndex < 0)
+    {
+        return Result(true);
+    }
+    const int32_t bufferIndex = async.bufferIndex;
+    async.bufferIndex         = -1;
+    async.buffer              = {};
+    return async.bufferPool->release(bufferIndex);
+}
+
+size_t SC::AsyncEventLoop::Internal::sizeOfBuffers(Span<const Span<const char>> buffers)
+{
+    size_t totalBytes = 0;
+    for (const Span<const char>& buffer : buffers)
+    {
+        totalBytes += buffer.sizeInBytes();
+    }
+    return totalBytes;
+}
+
 template <typename Lambda>
 SC::Result SC::AsyncEventLoop::Internal::applyOnAsync(AsyncRequest& async, Lambda&& lambda)
 {
@@ -1052,11 +2328,14 @@ SC::Result SC::AsyncEventLoop::Internal::applyOnAsync(AsyncRequest& async, Lambd
     case AsyncRequest::Type::SocketConnect: SC_TRY(lambda(*static_cast<AsyncSocketConnect*>(&async))); break;
     case AsyncRequest::Type::SocketSend: SC_TRY(lambda(*static_cast<AsyncSocketSend*>(&async))); break;
     case AsyncRequest::Type::SocketReceive: SC_TRY(lambda(*static_cast<AsyncSocketReceive*>(&async))); break;
+    case AsyncRequest::Type::SocketSendTo: SC_TRY(lambda(*static_cast<AsyncSocketSendTo*>(&async))); break;
+    case AsyncRequest::Type::SocketReceiveFrom: SC_TRY(lambda(*static_cast<AsyncSocketReceiveFrom*>(&async))); break;
     case AsyncRequest::Type::SocketClose: SC_TRY(lambda(*static_cast<AsyncSocketClose*>(&async))); break;
     case AsyncRequest::Type::FileRead: SC_TRY(lambda(*static_cast<AsyncFileRead*>(&async))); break;
     case AsyncRequest::Type::FileWrite: SC_TRY(lambda(*static_cast<AsyncFileWrite*>(&async))); break;
     case AsyncRequest::Type::FileClose: SC_TRY(lambda(*static_cast<AsyncFileClose*>(&async))); break;
     case AsyncRequest::Type::FilePoll: SC_TRY(lambda(*static_cast<AsyncFilePoll*>(&async))); break;
+    case AsyncRequest::Type::FileSend: SC_TRY(lambda(*static_cast<AsyncFileSend*>(&async))); break;
     }
     return SC::Result(true);
 }
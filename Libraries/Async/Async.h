@@ -3,6 +3,7 @@
 #pragma once
 
 #include "../Foundation/Function.h"
+#include "../Foundation/Memory.h"
 #include "../Foundation/OpaqueObject.h"
 #include "../Foundation/Span.h"
 #include "../Threading/Atomic.h"
@@ -57,12 +58,18 @@ struct AsyncCompletionData;
 struct AsyncTask;
 template <typename AsyncType>
 struct AsyncTaskOf;
+
+struct AsyncRequestPoolBase;
+
+struct AsyncLatencyHistogram;
+struct AsyncEventLoopStats;
 } // namespace SC
 
 namespace SC
 {
 namespace detail
 {
+struct AsyncTrackingSlot;
 struct AsyncWinOverlapped;
 struct AsyncWinOverlappedDefinition
 {
@@ -136,19 +143,22 @@ struct SC::AsyncRequest
     /// @brief Type of async request
     enum class Type : uint8_t
     {
-        LoopTimeout,   ///< Request is an AsyncLoopTimeout object
-        LoopWakeUp,    ///< Request is an AsyncLoopWakeUp object
-        LoopWork,      ///< Request is an AsyncLoopWork object
-        ProcessExit,   ///< Request is an AsyncProcessExit object
-        SocketAccept,  ///< Request is an AsyncSocketAccept object
-        SocketConnect, ///< Request is an AsyncSocketConnect object
-        SocketSend,    ///< Request is an AsyncSocketSend object
-        SocketReceive, ///< Request is an AsyncSocketReceive object
-        SocketClose,   ///< Request is an AsyncSocketClose object
-        FileRead,      ///< Request is an AsyncFileRead object
-        FileWrite,     ///< Request is an AsyncFileWrite object
-        FileClose,     ///< Request is an AsyncFileClose object
-        FilePoll,      ///< Request is an AsyncFilePoll object
+        LoopTimeout,       ///< Request is an AsyncLoopTimeout object
+        LoopWakeUp,        ///< Request is an AsyncLoopWakeUp object
+        LoopWork,          ///< Request is an AsyncLoopWork object
+        ProcessExit,       ///< Request is an AsyncProcessExit object
+        SocketAccept,      ///< Request is an AsyncSocketAccept object
+        SocketConnect,     ///< Request is an AsyncSocketConnect object
+        SocketSend,        ///< Request is an AsyncSocketSend object
+        SocketReceive,     ///< Request is an AsyncSocketReceive object
+        SocketSendTo,      ///< Request is an AsyncSocketSendTo object
+        SocketReceiveFrom, ///< Request is an AsyncSocketReceiveFrom object
+        SocketClose,       ///< Request is an AsyncSocketClose object
+        FileRead,          ///< Request is an AsyncFileRead object
+        FileWrite,         ///< Request is an AsyncFileWrite object
+        FileClose,         ///< Request is an AsyncFileClose object
+        FilePoll,          ///< Request is an AsyncFilePoll object
+        FileSend,          ///< Request is an AsyncFileSend object
     };
 
     /// @brief Constructs a free async request of given type
@@ -158,9 +168,26 @@ struct SC::AsyncRequest
     /// Stops the async operation
 
     /// @brief Ask to stop current async operation
+    /// The request becomes free (and it can be started again) once the loop has processed its cancellation.
+    /// This happens on next loop step, or when its cancelled kernel operation completes (`io_uring` and IOCP).
     /// @return `true` if the stop request has been successfully queued
     [[nodiscard]] Result stop();
 
+    /// @brief Sets a deadline for the request to complete, measured from every time it's activated (when it's started
+    /// and when it's reactivated). If the deadline expires, the request is cancelled and its callback receives an
+    /// error Result, with AsyncResult::hasDeadlineExpired returning `true`.
+    /// Deadlines are linked timeouts (`IORING_OP_LINK_TIMEOUT`) on `io_uring` and event loop timers on other backends.
+    /// Calling AsyncResult::reactivateRequest from the callback receiving the deadline error starts the request again,
+    /// with a new deadline, after its cancellation has completed.
+    /// Deadline expiration time is tracked by the event loop, in a slot that it allocates on first activation.
+    /// @param relativeDeadline Deadline in milliseconds (zero removes the deadline)
+    /// @note Ignored by AsyncLoopTimeout, AsyncLoopWakeUp, AsyncLoopWork and by requests executed on a thread pool
+    /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncRequestDeadlineSnippet
+    void setDeadline(Time::Milliseconds relativeDeadline) { deadline = relativeDeadline; }
+
+    /// @brief Gets the deadline set with AsyncRequest::setDeadline (zero if no deadline has been set)
+    [[nodiscard]] Time::Milliseconds getDeadline() const { return deadline; }
+
   protected:
     [[nodiscard]] Result validateAsync();
     [[nodiscard]] Result queueSubmission(AsyncEventLoop& eventLoop);
@@ -173,6 +200,7 @@ struct SC::AsyncRequest
 
   private:
     friend struct AsyncEventLoop;
+    friend struct AsyncRequestPoolBase;
 
     void markAsFree();
 
@@ -194,6 +222,13 @@ struct SC::AsyncRequest
     Type    type;       // 1 byte
     int16_t flags;      // 2 bytes
     int32_t eventIndex; // 4 bytes
+
+    Time::Milliseconds deadline; // Relative deadline set with setDeadline (zero means no deadline)
+
+    // Owned by the loop, only while the request has a deadline or AsyncEventLoopStats are enabled
+    detail::AsyncTrackingSlot* trackingSlot = nullptr;
+
+    AsyncRequestPoolBase* pool = nullptr; // Pool where the request is given back when it's free (if acquired from it)
 };
 
 /// @brief Empty base struct for all AsyncRequest-derived CompletionData (internal) structs.
@@ -218,12 +253,16 @@ struct SC::AsyncResult
     /// @brief Check if the returnCode of this result is valid
     [[nodiscard]] const SC::Result& isValid() const { return returnCode; }
 
+    /// @brief Check if the request has been cancelled because its deadline has expired (see AsyncRequest::setDeadline)
+    [[nodiscard]] bool hasDeadlineExpired() const { return deadlineExpired; }
+
     AsyncRequest& async;
 
   protected:
     friend struct AsyncEventLoop;
 
     bool       shouldBeReactivated = false;
+    bool       deadlineExpired     = false;
     SC::Result returnCode          = SC::Result(true);
 };
 
@@ -308,6 +347,8 @@ struct AsyncLoopTimeout : public AsyncRequest
   private:
     friend struct AsyncEventLoop;
     Time::HighResolutionCounter expirationTime;
+
+    AsyncRequest* heapChild = nullptr; // Leftmost child in the event loop pairing heap of active timeouts
 };
 
 /// @brief Starts a wake-up operation, allowing threads to execute callbacks on loop thread. @n
@@ -429,6 +470,8 @@ struct AsyncProcessExit : public AsyncRequest
 /// SC::AsyncEventLoop::associateExternallyCreatedTCPSocket. @n
 /// Alternatively SC::AsyncEventLoop::createAsyncTCPSocket creates and associates the socket to the loop.
 /// @note To continue accepting new socket SC::AsyncResult::reactivateRequest must be called.
+/// On `io_uring` (Linux 5.19+) a single multishot accept is kept armed in the kernel while the request
+/// keeps being reactivated, avoiding one submission for each accepted socket.
 ///
 /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncSocketAcceptSnippet
 struct AsyncSocketAccept : public AsyncRequest
@@ -515,6 +558,100 @@ struct AsyncSocketConnect : public AsyncRequest
 #endif
 };
 
+/// @brief Resolves host names to ip addresses (of all families) without blocking the event loop. @n
+/// Resolution runs SocketNetworking::resolveDNS on a ThreadPool thread through an SC::AsyncLoopWork. @n
+/// Resolved addresses are cached for AsyncDNSResolver::cacheTimeout, so that following resolutions of the same
+/// host don't query the system resolver again. Ip address literals and `localhost` never reach the ThreadPool.
+struct AsyncDNSResolver
+{
+    static constexpr size_t MaxAddresses    = 4;   ///< Maximum number of addresses kept for an host
+    static constexpr size_t MaxHostLength   = 255; ///< Maximum length of an host name
+    static constexpr size_t NumCacheEntries = 16;  ///< Number of cached hosts (oldest resolution is evicted)
+
+    /// @brief A single resolution. It must be valid until its callback is called.
+    struct Request
+    {
+        /// @brief Called on the event loop thread after the host has been resolved (or if resolution failed)
+        Function<void(Request&)> callback;
+
+        SC::Result result = SC::Result(true); ///< Valid Result if the host has been resolved
+
+        /// @brief Addresses resolved for the host, in order of preference
+        [[nodiscard]] Span<const SocketIPAddress> getAddresses() const { return {addresses, numAddresses}; }
+
+        /// @brief Checks if the request is not being used by a resolution, so that it can be started again
+        [[nodiscard]] bool isFree() const { return work.getEventLoop() == nullptr; }
+
+      private:
+        friend struct AsyncDNSResolver;
+
+        AsyncLoopWork     work;
+        AsyncDNSResolver* resolver = nullptr;
+
+        char     host[MaxHostLength + 1];
+        size_t   hostLength = 0;
+        uint16_t port       = 0;
+        bool     cached     = false; // Addresses have been found without using the system resolver
+
+        SocketIPAddress addresses[MaxAddresses];
+        size_t          numAddresses = 0;
+    };
+
+    /// @brief Time after which cached addresses are resolved again
+    Time::Milliseconds cacheTimeout = Time::Milliseconds(60000);
+
+    /// @brief Setups the resolver
+    /// @param eventLoop The event loop where resolution callbacks will be invoked
+    /// @param threadPool The ThreadPool that will supply threads for blocking system resolver calls
+    /// @return Valid Result if the resolver has been setup successfully
+    [[nodiscard]] SC::Result create(AsyncEventLoop& eventLoop, ThreadPool& threadPool);
+
+    /// @brief Starts resolving an host. Callback is always invoked asynchronously, even if addresses are cached.
+    /// @param request The request that will receive resolved addresses (it must be Request::isFree)
+    /// @param host The host name (example.com)
+    /// @param port The port assigned to all resolved addresses
+    /// @return Valid Result if the resolution has been started successfully
+    [[nodiscard]] SC::Result resolve(Request& request, StringView host, uint16_t port);
+
+    /// @brief Finds addresses of an host without blocking, in cache or if host is an ip address or `localhost`
+    /// @param host The host name (example.com)
+    /// @param port The port assigned to all resolved addresses
+    /// @param addresses Receives addresses of the given host
+    /// @param numAddresses Number of addresses written to `addresses`
+    /// @return `true` if addresses have been found
+    [[nodiscard]] bool lookup(StringView host, uint16_t port, Span<SocketIPAddress> addresses, size_t& numAddresses);
+
+    /// @brief Resolves ip address literals and `localhost` (to both IPV4 and IPV6 loopback addresses)
+    /// @param host The host name or ip address
+    /// @param port The port assigned to all resolved addresses
+    /// @param addresses Receives addresses of the given host
+    /// @param numAddresses Number of addresses written to `addresses`
+    /// @return `true` if the host can be resolved without querying the system resolver
+    [[nodiscard]] static bool resolveLocal(StringView host, uint16_t port, Span<SocketIPAddress> addresses,
+                                           size_t& numAddresses);
+
+  private:
+    struct CacheEntry
+    {
+        char     host[MaxHostLength + 1];
+        size_t   hostLength = 0;
+        uint16_t port       = 0;
+
+        SocketIPAddress addresses[MaxAddresses];
+        size_t          numAddresses = 0;
+
+        Time::HighResolutionCounter resolveTime;
+    };
+    CacheEntry cache[NumCacheEntries];
+
+    AsyncEventLoop* eventLoop  = nullptr;
+    ThreadPool*     threadPool = nullptr;
+
+    [[nodiscard]] CacheEntry* findCacheEntry(StringView host, uint16_t port);
+
+    void onResolved(Request& request, AsyncLoopWork::Result& result);
+};
+
 /// @brief Starts a socket send operation, sending bytes to a remote endpoint.
 /// Callback will be called when the given socket is ready to send more data. @n
 /// @ref library_socket library can be used to create a Socket but the socket should be created with
@@ -545,25 +682,100 @@ struct AsyncSocketSend : public AsyncRequest
     [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
                                    Span<const char> data);
 
+    /// @brief Starts a vectored socket send operation, sending multiple buffers with a single syscall.
+    /// Useful to send headers and body (or slices of it) without first copying them into a contiguous buffer.
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The socket to send data to
+    /// @param data The buffers to be sent in order (the span of buffers must also be valid until callback is called)
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result startVectored(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                           Span<const Span<const char>> data);
+
     Function<void(Result&)> callback; ///< Called when socket is ready to send more data.
 
+    /// @brief Sends data without copying it into kernel socket buffers (opt-in). @n
+    /// Callback is invoked only after data has been sent AND the kernel has released the buffer, so data must be
+    /// kept alive and unmodified until then (but it can be freed or reused inside the callback).
+    /// - On `io_uring` (Linux 6.0+) it uses `IORING_OP_SEND_ZC` (falling back to a regular send on older kernels).
+    ///   Vectored sends (AsyncSocketSend::start with multiple buffers) are always copied on `io_uring`.
+    /// - On `epoll` it uses `MSG_ZEROCOPY`, waiting for the completion notification on socket error queue
+    /// - Other backends ignore it, as their completions already imply that the buffer can be reused
+    /// @note It makes sense only for large payloads, as page pinning and notifications cost more than copying
+    /// small ones. Stopping the request while waiting for buffer release does not make the buffer reusable.
+    bool zeroCopy = false;
+
   private:
     friend struct AsyncEventLoop;
 
-    SocketDescriptor::Handle handle = SocketDescriptor::Invalid;
-    Span<const char>         buffer;
+    SocketDescriptor::Handle     handle = SocketDescriptor::Invalid;
+    Span<const char>             buffer;
+    Span<const Span<const char>> buffers; // Used instead of buffer when non empty (vectored send)
+
+    int64_t zeroCopyResult = 0; // Send result kept while waiting for the kernel to release the buffer
 #if SC_PLATFORM_WINDOWS
     detail::WinOverlappedOpaque overlapped;
 #endif
 };
 struct AsyncSocketReceive;
 
+/// @brief Fixed size buffers carved out of caller provided memory, lent by the event loop to SC::AsyncSocketReceive
+/// and SC::AsyncFileRead only when data is ready to be read. @n
+/// Requests using a pool do not pin a dedicated buffer while waiting, so memory usage grows with the number of reads
+/// in flight instead of with the number of open sockets or files.
+/// - On `io_uring` buffers are given to the kernel as a provided buffer group (`IORING_OP_PROVIDE_BUFFERS`) and the
+///   kernel selects one when data arrives
+/// - On `epoll` / `kqueue` a free buffer is picked when the descriptor becomes readable
+/// - On `IOCP` a free buffer is picked when the request is activated
+///
+/// @note The buffer is given back to the pool right after the completion callback returns, so received data must be
+/// consumed (or copied) inside the callback. If no buffer is free, the request completes with an error.
+///
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncBufferPoolSnippet
+struct AsyncBufferPool
+{
+    /// @brief Splits memory in buffers of bufferSize bytes and registers them with the event loop
+    /// @param eventLoop The event loop where requests using this pool will be started
+    /// @param memory Memory that will be split in buffers. It must be valid until AsyncBufferPool::close is called.
+    /// @param bufferSize Size of each buffer (at least 4 bytes). Trailing memory not fitting a buffer is unused.
+    /// @return Valid Result if the pool has been registered successfully
+    [[nodiscard]] SC::Result create(AsyncEventLoop& eventLoop, Span<char> memory, size_t bufferSize);
+
+    /// @brief Unregisters the pool from the event loop
+    /// @return Valid Result if the pool has been unregistered successfully
+    /// @warning All requests using this pool must have been completed or stopped before calling this method
+    [[nodiscard]] SC::Result close();
+
+    /// @brief Number of buffers not currently lent to a request
+    [[nodiscard]] uint32_t getNumFreeBuffers() const { return numFreeBuffers; }
+
+  private:
+    friend struct AsyncEventLoop;
+    friend struct AsyncSocketReceive;
+    friend struct AsyncFileRead;
+
+    [[nodiscard]] SC::Result acquire(Span<char>& buffer, int32_t& bufferIndex);
+    [[nodiscard]] SC::Result acquireSelected(uint32_t bufferIndex, Span<char>& buffer);
+    [[nodiscard]] SC::Result release(int32_t bufferIndex);
+
+    AsyncEventLoop* eventLoop = nullptr;
+    Span<char>      memory;
+
+    uint32_t bufferSize      = 0;
+    uint32_t numBuffers      = 0;
+    uint32_t numFreeBuffers  = 0;
+    int32_t  firstFreeBuffer = -1; // Free list head, with links stored inside free buffers (if not kernel selected)
+    uint16_t groupId         = 0;  // io_uring provided buffers group id
+    bool     kernelSelects   = false;
+};
+
 /// @brief Starts a socket receive operation, receiving bytes from a remote endpoint.
 /// Callback will be called when some data is read from socket. @n
 /// @ref library_socket library can be used to create a Socket but the socket should be created with
 /// SC::SocketFlags::NonBlocking and associated to the event loop with
 /// SC::AsyncEventLoop::associateExternallyCreatedTCPSocket or though AsyncSocketAccept. @n
 /// Alternatively SC::AsyncEventLoop::createAsyncTCPSocket creates and associates the socket to the loop.
+/// @note On `io_uring` (Linux 6.0+) a receive using an SC::AsyncBufferPool is submitted as multishot receive, that
+/// stays armed in the kernel while the request keeps being reactivated.
 ///
 /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncSocketReceiveSnippet
 struct AsyncSocketReceive : public AsyncRequest
@@ -600,6 +812,15 @@ struct AsyncSocketReceive : public AsyncRequest
     [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
                                    Span<char> data);
 
+    /// @brief Starts a socket receive operation, into a buffer lent by the pool only when data is available.
+    /// Callback will be called when some data is read from socket.
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The socket from which to receive data
+    /// @param bufferPool Pool lending the buffer where received bytes are written (see SC::AsyncBufferPool)
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                   AsyncBufferPool& bufferPool);
+
     Function<void(Result&)> callback; ///< Called after data has been received
 
   private:
@@ -607,11 +828,190 @@ struct AsyncSocketReceive : public AsyncRequest
 
     SocketDescriptor::Handle handle = SocketDescriptor::Invalid;
     Span<char>               buffer;
+    AsyncBufferPool*         bufferPool  = nullptr;
+    int32_t                  bufferIndex = -1;
 #if SC_PLATFORM_WINDOWS
     detail::WinOverlappedOpaque overlapped;
 #endif
 };
 
+/// @brief Starts sending one or more datagrams (UDP), each one to its own remote endpoint.
+/// Callback will be called when all datagrams have been sent. @n
+/// @ref library_socket library can be used to create a Socket but the socket should be created with
+/// SC::SocketFlags::SocketDgram, SC::SocketFlags::ProtocolUdp and SC::SocketFlags::NonBlocking and associated to the
+/// event loop with SC::AsyncEventLoop::associateExternallyCreatedTCPSocket. @n
+/// Alternatively SC::AsyncEventLoop::createAsyncUDPSocket creates and associates the socket to the loop.
+/// - On `epoll` a batch of datagrams is sent with a single `sendmmsg` syscall
+/// - On `io_uring` each datagram of a batch is an `IORING_OP_SENDMSG`, all of them submitted together
+/// - On `kqueue` datagrams of a batch are sent one after the other when the socket becomes writable
+/// - On `IOCP` a batch must contain a single datagram (`WSASendTo`)
+///
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncSocketSendToSnippet
+struct AsyncSocketSendTo : public AsyncRequest
+{
+    AsyncSocketSendTo() : AsyncRequest(Type::SocketSendTo) {}
+
+    /// @brief A datagram to be sent together with the address of its destination
+    struct Datagram
+    {
+        SocketIPAddress  address; ///< Address of the remote endpoint receiving the datagram
+        Span<const char> data;    ///< Payload of the datagram (must be valid until callback is called)
+
+      private:
+        friend struct AsyncEventLoop;
+#if SC_PLATFORM_LINUX
+        AlignedStorage<96> message; // Native message header kept alive until the kernel has consumed it
+#endif
+    };
+
+    /// @brief Completion data for AsyncSocketSendTo
+    struct CompletionData : public AsyncCompletionData
+    {
+        /// @brief Sum of bytes sent for all datagrams. @n
+        /// On epoll / kqueue, when the request fails it holds the bytes of the datagrams sent before the error.
+        size_t numBytes = 0;
+    };
+
+    /// @brief Callback result for AsyncSocketSendTo
+    using Result = AsyncResultOf<AsyncSocketSendTo, CompletionData>;
+
+    /// @brief Starts sending a single datagram to a remote endpoint.
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The (UDP) socket used to send the datagram
+    /// @param address Address of the remote endpoint
+    /// @param data Payload of the datagram
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                   const SocketIPAddress& address, Span<const char> data);
+
+    /// @brief Starts sending a batch of datagrams, each one to its own remote endpoint, with as few syscalls as possible
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The (UDP) socket used to send the datagrams
+    /// @param datagrams The datagrams to send (the span of datagrams must also be valid until callback is called)
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                   Span<Datagram> datagrams);
+
+    Function<void(Result&)> callback; ///< Called when all datagrams have been sent
+
+    /// @brief If not zero, payload of each datagram is split by the kernel in datagrams of segmentSize bytes
+    /// (the last one can be shorter), with a single traversal of the network stack (UDP GSO). @n
+    /// Supported only on Linux (4.18+), on all other backends the request fails if it's not zero.
+    uint16_t segmentSize = 0;
+
+  private:
+    friend struct AsyncEventLoop;
+
+    SocketDescriptor::Handle handle = SocketDescriptor::Invalid;
+    Datagram                 datagram; // Used by the single datagram start overload
+    Span<Datagram>           datagrams;
+
+    uint32_t pendingCompletions = 0; // Completions still to be received for a batch (io_uring)
+    uint32_t numSentDatagrams   = 0; // Datagrams of a batch already sent (epoll / kqueue)
+    int64_t  batchResult        = 0; // Bytes sent or first error of a batch (io_uring), error only (epoll / kqueue)
+#if SC_PLATFORM_WINDOWS
+    detail::WinOverlappedOpaque overlapped;
+#endif
+};
+
+/// @brief Starts receiving one or more datagrams (UDP), together with the address of their sender.
+/// Callback will be called when at least one datagram has been received. @n
+/// @ref library_socket library can be used to create a Socket but the socket should be created with
+/// SC::SocketFlags::SocketDgram, SC::SocketFlags::ProtocolUdp and SC::SocketFlags::NonBlocking, bound with
+/// SC::SocketServer::bind and associated to the event loop with SC::AsyncEventLoop::associateExternallyCreatedTCPSocket.
+/// @n Alternatively SC::AsyncEventLoop::createAsyncUDPSocket creates and associates the socket to the loop.
+/// - On `epoll` all datagrams already queued on the socket are received with a single `recvmmsg` syscall
+/// - On `kqueue` all datagrams already queued on the socket are received with one `recvfrom` each
+/// - On `io_uring` (`IORING_OP_RECVMSG`) and `IOCP` (`WSARecvFrom`) a single datagram is received at a time
+///
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncSocketReceiveFromSnippet
+struct AsyncSocketReceiveFrom : public AsyncRequest
+{
+    AsyncSocketReceiveFrom() : AsyncRequest(Type::SocketReceiveFrom) {}
+
+    /// @brief Memory receiving a datagram, filled with the address of its sender and its size when received
+    struct Datagram
+    {
+        Span<char>      data;            ///< Memory where the datagram will be written
+        SocketIPAddress address;         ///< Address of the sender (written when received)
+        size_t          numBytes    = 0; ///< Size of the received datagram (written when received)
+        uint16_t        segmentSize = 0; ///< Size of the coalesced datagrams (see AsyncSocketReceiveFrom::coalesce)
+
+      private:
+        friend struct AsyncEventLoop;
+#if SC_PLATFORM_LINUX
+        AlignedStorage<96> message; // Native message header kept alive until the kernel has filled it
+#endif
+    };
+
+    /// @brief Completion data for AsyncSocketReceiveFrom
+    struct CompletionData : public AsyncCompletionData
+    {
+        size_t numDatagrams = 0; ///< Number of datagrams received (at the beginning of the datagrams span)
+    };
+
+    /// @brief Callback result for AsyncSocketReceiveFrom
+    struct Result : public AsyncResultOf<AsyncSocketReceiveFrom, CompletionData>
+    {
+        using AsyncResultOf<AsyncSocketReceiveFrom, CompletionData>::AsyncResultOf;
+
+        /// @brief Get a Span of the first received datagram
+        /// @param outData The span of data actually received from socket
+        /// @param outAddress Address of the sender of the datagram
+        /// @return Valid Result if the datagram was received without errors
+        [[nodiscard]] SC::Result get(Span<char>& outData, SocketIPAddress& outAddress)
+        {
+            SC_TRY(returnCode);
+            SC_TRY_MSG(completionData.numDatagrams > 0, "AsyncSocketReceiveFrom - No datagram received");
+            const Datagram& first = getAsync().datagrams[0];
+            outAddress            = first.address;
+            return SC::Result(first.data.sliceStartLength(0, first.numBytes, outData));
+        }
+
+        /// @brief Get all received datagrams
+        /// @return The span of received datagrams (a prefix of the span passed to start)
+        [[nodiscard]] Span<Datagram> getDatagrams()
+        {
+            return {getAsync().datagrams.data(), returnCode ? completionData.numDatagrams : 0};
+        }
+    };
+
+    /// @brief Starts receiving a single datagram.
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The (UDP) socket from which to receive the datagram
+    /// @param data Span of memory where to write the datagram (larger datagrams are truncated)
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                   Span<char> data);
+
+    /// @brief Starts receiving a batch of datagrams, with as few syscalls as possible.
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param socketDescriptor The (UDP) socket from which to receive the datagrams
+    /// @param datagrams Memory for the datagrams (the span of datagrams must also be valid until callback is called)
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const SocketDescriptor& socketDescriptor,
+                                   Span<Datagram> datagrams);
+
+    Function<void(Result&)> callback; ///< Called after at least one datagram has been received
+
+    /// @brief Allows the kernel to coalesce consecutive datagrams from the same sender in a single one (UDP GRO).
+    /// Datagram::segmentSize is the size of each of the coalesced datagrams (the last one can be shorter). @n
+    /// Supported only on Linux (5.0+), where it enables `UDP_GRO` on the socket. It's ignored by all other backends
+    /// (where Datagram::segmentSize is always zero).
+    bool coalesce = false;
+
+  private:
+    friend struct AsyncEventLoop;
+
+    SocketDescriptor::Handle handle = SocketDescriptor::Invalid;
+    Datagram                 datagram; // Used by the single datagram start overload
+    Span<Datagram>           datagrams;
+#if SC_PLATFORM_WINDOWS
+    int                         addressLength = 0;
+    detail::WinOverlappedOpaque overlapped;
+#endif
+};
+
 /// @brief Starts a socket close operation.
 /// Callback will be called when the socket has been fully closed.
 ///
@@ -707,9 +1107,13 @@ struct AsyncFileRead : public AsyncRequest
                                            /// Use SC::FileDescriptor or SC::PipeDescriptor to open it, with
                                            /// SC::FileDescriptorOpenOptions::blocking == false
 
+    AsyncBufferPool* bufferPool = nullptr; /// If set, buffer is lent by this pool when data is ready (not on Task)
+
   private:
     friend struct AsyncEventLoop;
 
+    int32_t bufferIndex = -1;
+
 #if SC_PLATFORM_WINDOWS
     detail::WinOverlappedOpaque overlapped;
 #endif
@@ -773,11 +1177,14 @@ struct AsyncFileWrite : public AsyncRequest
 
     Function<void(Result&)> callback; /// Callback called when descriptor is ready to be written with more data
 
-    Span<const char>       buffer;         /// The read-only span of memory where to read the data from
-    uint64_t               offset = 0;     /// Offset to start writing from. Not supported on pipes.
-    FileDescriptor::Handle fileDescriptor; /// The file/pipe descriptor to write data to.
-                                           /// Use SC::FileDescriptor or SC::PipeDescriptor to open it, with
-                                           /// SC::FileDescriptorOpenOptions::blocking == false
+    Span<const char>             buffer;         /// The read-only span of memory where to read the data from
+    Span<const Span<const char>> buffers;        /// If non empty, buffers are written in order with a single
+                                                 /// vectored write (instead of AsyncFileWrite::buffer).
+                                                 /// Not supported on Windows.
+    uint64_t                     offset = 0;     /// Offset to start writing from. Not supported on pipes.
+    FileDescriptor::Handle       fileDescriptor; /// The file/pipe descriptor to write data to.
+                                                 /// Use SC::FileDescriptor or SC::PipeDescriptor to open it, with
+                                                 /// SC::FileDescriptorOpenOptions::blocking == false
 
   private:
     friend struct AsyncEventLoop;
@@ -845,6 +1252,275 @@ struct AsyncFilePoll : public AsyncRequest
 #endif
 };
 
+/// @brief Starts sending a range of a file to a socket, with the kernel moving data without copying it through user
+/// space buffers. @n
+/// Callback is called every time some data has been sent, reporting partial progress. The request keeps track of the
+/// sent range, so calling SC::AsyncResult::reactivateRequest continues from where it stopped, until
+/// AsyncFileSend::CompletionData::remainingBytes is zero.
+/// - On `io_uring` it uses `IORING_OP_SPLICE` (file to pipe to socket), so reading the file never blocks the loop
+/// - On `epoll` it uses `sendfile` when the socket becomes writable
+/// - On `kqueue` it uses `sendfile` when the socket becomes writable
+/// - On `IOCP` it uses `TransmitFile`
+///
+/// @note File must be a regular file and socket must be associated with the loop. File must be at least
+/// `offset + length` bytes long.
+///
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncFileSendSnippet
+struct AsyncFileSend : public AsyncRequest
+{
+    AsyncFileSend() : AsyncRequest(Type::FileSend) {}
+
+    /// @brief Completion data for AsyncFileSend
+    struct CompletionData : public AsyncCompletionData
+    {
+        size_t numBytes       = 0; ///< Number of bytes sent by this completion
+        size_t remainingBytes = 0; ///< Number of bytes still to be sent (reactivate the request to send them)
+    };
+
+    /// @brief Callback result for AsyncFileSend
+    struct Result : public AsyncResultOf<AsyncFileSend, CompletionData>
+    {
+        using AsyncResultOf<AsyncFileSend, CompletionData>::AsyncResultOf;
+
+        [[nodiscard]] SC::Result get(size_t& sentBytes)
+        {
+            sentBytes = completionData.numBytes;
+            return returnCode;
+        }
+    };
+
+    /// @brief Starts sending a range of a file to a socket
+    /// @param eventLoop The event loop where queuing this async request
+    /// @param file The (regular) file to read data from
+    /// @param socket The socket to send data to
+    /// @param offset Offset in the file where to start reading data
+    /// @param length Number of bytes to send
+    /// @return Valid Result if the request has been successfully queued
+    [[nodiscard]] SC::Result start(AsyncEventLoop& eventLoop, const FileDescriptor& file, const SocketDescriptor& socket,
+                                   uint64_t offset, size_t length);
+
+    Function<void(Result&)> callback; ///< Called when some data has been sent
+
+  private:
+    friend struct AsyncEventLoop;
+
+    FileDescriptor::Handle   fileHandle   = FileDescriptor::Invalid;
+    SocketDescriptor::Handle socketHandle = SocketDescriptor::Invalid;
+
+    uint64_t offset = 0; // Offset of next byte to read from file
+    size_t   length = 0; // Number of bytes not yet read from file
+#if SC_PLATFORM_LINUX
+    PipeDescriptor splicePipe;          // io_uring only: file -> pipe -> socket splices (kept across restarts)
+    size_t         splicePipeBytes = 0; // io_uring only: bytes read from file but not yet sent to socket
+#endif
+#if SC_PLATFORM_WINDOWS
+    detail::WinOverlappedOpaque overlapped;
+#endif
+};
+
+template <typename T>
+struct AsyncRequestPool;
+
+/// @brief Generation checked handle to a request acquired from an SC::AsyncRequestPool (like SC::ArenaMapKey).
+/// A key becomes stale as soon as its request is given back to the pool, even if the same memory is reused.
+/// @tparam T Type of the request (derived from SC::AsyncRequest)
+template <typename T>
+struct AsyncRequestKey
+{
+    AsyncRequestKey()
+    {
+        used       = 0;
+        generation = 0;
+        index      = 0;
+    }
+
+    /// @brief Check if this key has been obtained from AsyncRequestPool::acquire
+    [[nodiscard]] bool isValid() const { return used != 0; }
+
+    bool operator==(AsyncRequestKey other) const
+    {
+        return index == other.index and used == other.used and generation == other.generation;
+    }
+
+  private:
+    friend struct AsyncRequestPool<T>;
+    uint32_t used       : 1;
+    uint32_t generation : 31;
+    uint32_t index;
+};
+
+/// @brief Type independent part of SC::AsyncRequestPool
+struct AsyncRequestPoolBase
+{
+    AsyncRequestPoolBase* next = nullptr;
+    AsyncRequestPoolBase* prev = nullptr;
+
+    /// @brief Number of requests that can still be acquired from the pool
+    [[nodiscard]] uint32_t getNumFreeRequests() const { return numFreeRequests; }
+
+    /// @brief Maximum number of requests that can be acquired at the same time
+    [[nodiscard]] uint32_t getCapacity() const { return capacity; }
+
+  protected:
+    ~AsyncRequestPoolBase();
+
+    struct Slot
+    {
+        uint32_t used       : 1;
+        uint32_t generation : 31;
+        uint32_t nextFree; // Free list link (valid only if not used)
+    };
+
+    [[nodiscard]] SC::Result registerPool(AsyncEventLoop& eventLoop, void* requestsMemory, size_t requestSize,
+                                          Slot* slotsMemory, uint32_t numRequests);
+    [[nodiscard]] SC::Result unregisterPool();
+
+    [[nodiscard]] SC::Result acquireSlot(uint32_t& index);
+    [[nodiscard]] SC::Result releaseSlot(uint32_t index);
+    [[nodiscard]] SC::Result releaseRequest(AsyncRequest& request, uint32_t index);
+
+    void markAsPooled(AsyncRequest& request);
+
+    [[nodiscard]] bool isCreated() const { return requests != nullptr; }
+
+    void* requests = nullptr;
+    Slot* slots    = nullptr;
+
+  private:
+    friend struct AsyncEventLoop;
+    friend struct AsyncRequest;
+
+    void recycleRequest(AsyncRequest& request);
+
+    // Cleared when the event loop is closed before the pool
+    AsyncEventLoop* eventLoop       = nullptr;
+    size_t          requestSize     = 0;
+    uint32_t        capacity        = 0;
+    uint32_t        numFreeRequests = 0;
+    uint32_t        firstFree       = 0;
+};
+
+/// @brief Fixed capacity pool of requests of a given type, recycled by the event loop on completion. @n
+/// Instead of embedding one request of each type for every connection (whether it's in use or not), requests can be
+/// acquired from a pool only when an operation must be started, so that memory grows with the number of operations in
+/// flight instead of with the worst case for every connection.
+/// - Requests live at a stable address for the entire lifetime of the pool (allocated once in
+///   AsyncRequestPool::create)
+/// - AsyncRequestPool::acquire returns a request together with a generation checked SC::AsyncRequestKey, that can be
+///   used to safely look it up (AsyncRequestPool::get) after it could have been recycled
+/// - The event loop gives a request back to the pool when its callback returns without reactivating it, when it fails
+///   or when the loop is closed. A request acquired but never started must be given back with
+///   AsyncRequestPool::release.
+/// - Closing the event loop detaches it from the pool, that can then be closed (or destroyed) later. Destroying a pool
+///   while some of its requests are still in use asserts.
+///
+/// @note Request fields (including callback) are reset when the request is acquired again, not when it's recycled.
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncRequestPoolSnippet
+/// @tparam T Type of the request (derived from SC::AsyncRequest)
+template <typename T>
+struct AsyncRequestPool : public AsyncRequestPoolBase
+{
+    using Key = AsyncRequestKey<T>;
+
+    AsyncRequestPool() = default;
+    AsyncRequestPool(const AsyncRequestPool&)            = delete;
+    AsyncRequestPool& operator=(const AsyncRequestPool&) = delete;
+    ~AsyncRequestPool() { (void)close(); }
+
+    /// @brief Allocates memory for numRequests requests and registers the pool with the event loop
+    /// @param eventLoop The event loop where requests acquired from this pool will be started
+    /// @param numRequests Maximum number of requests that can be acquired at the same time
+    /// @return Valid Result if the pool has been allocated and registered successfully
+    [[nodiscard]] SC::Result create(AsyncEventLoop& eventLoop, uint32_t numRequests)
+    {
+        SC_TRY_MSG(not isCreated(), "AsyncRequestPool::create - Already created");
+        SC_TRY_MSG(numRequests > 0, "AsyncRequestPool::create - Invalid number of requests");
+        T*    newRequests = reinterpret_cast<T*>(Memory::allocate(numRequests * sizeof(T)));
+        Slot* newSlots    = reinterpret_cast<Slot*>(Memory::allocate(numRequests * sizeof(Slot)));
+        if (newRequests == nullptr or newSlots == nullptr)
+        {
+            Memory::release(newRequests);
+            Memory::release(newSlots);
+            return SC::Result::Error("AsyncRequestPool::create - Allocation failed");
+        }
+        for (uint32_t idx = 0; idx < numRequests; ++idx)
+        {
+            new (&newRequests[idx], PlacementNew()) T();
+        }
+        return registerPool(eventLoop, newRequests, sizeof(T), newSlots, numRequests);
+    }
+
+    /// @brief Unregisters the pool from the event loop (if still open) and releases its memory
+    /// @return Valid Result if the pool has been closed successfully
+    /// @warning All requests acquired from this pool must have been given back before calling this method (this is
+    /// asserted when destroying the pool)
+    [[nodiscard]] SC::Result close()
+    {
+        if (not isCreated())
+        {
+            return SC::Result(true);
+        }
+        const uint32_t numRequests = getCapacity();
+        SC_TRY(unregisterPool());
+        T* typedRequests = reinterpret_cast<T*>(requests);
+        for (uint32_t idx = 0; idx < numRequests; ++idx)
+        {
+            typedRequests[idx].~T();
+        }
+        Memory::release(requests);
+        Memory::release(slots);
+        requests = nullptr;
+        slots    = nullptr;
+        return SC::Result(true);
+    }
+
+    /// @brief Acquires a free request (reset to its default state), to be started by the caller
+    /// @param[out] request The acquired request
+    /// @param[out] key Generation checked key of the acquired request
+    /// @return Error if all requests are already in use
+    [[nodiscard]] SC::Result acquire(T*& request, Key& key)
+    {
+        SC_TRY_MSG(isCreated(), "AsyncRequestPool::acquire - Not created");
+        uint32_t index;
+        SC_TRY(acquireSlot(index));
+        T* typedRequest = reinterpret_cast<T*>(requests) + index;
+        typedRequest->~T(); // Drops state (and callback captures) left by the previous user of the request
+        new (typedRequest, PlacementNew()) T();
+        markAsPooled(*typedRequest);
+        request        = typedRequest;
+        key.used       = 1;
+        key.generation = slots[index].generation;
+        key.index      = index;
+        return SC::Result(true);
+    }
+
+    /// @brief Gets the request associated to a key
+    /// @return The request or `nullptr` if it has already been given back to the pool
+    [[nodiscard]] T* get(Key key)
+    {
+        if (key.used == 0 or key.index >= getCapacity())
+        {
+            return nullptr;
+        }
+        const Slot& slot = slots[key.index];
+        if (slot.used == 0 or slot.generation != key.generation)
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(requests) + key.index;
+    }
+
+    /// @brief Gives back a request that has been acquired but not started (or whose start has failed)
+    /// @return Error if the key is stale or if the request is in use by the event loop
+    [[nodiscard]] SC::Result release(Key key)
+    {
+        T* request = get(key);
+        SC_TRY_MSG(request != nullptr, "AsyncRequestPool::release - Invalid key");
+        SC_TRY_MSG(request->getEventLoop() == nullptr, "AsyncRequestPool::release - Request is in use");
+        return releaseRequest(*request, key.index);
+    }
+};
+
 //! @}
 
 } // namespace SC
@@ -861,12 +1537,139 @@ struct SC::AsyncKernelEvents
     friend struct AsyncEventLoop;
 };
 
+/// @brief Histogram of durations in nanoseconds, with logarithmic buckets split in linear sub-buckets (like HDR
+/// histograms), so that the relative error stays bounded across the entire range of recorded values. @n
+/// A single thread records values (without locks or allocations) while other threads can take copies of it.
+/// @see AsyncEventLoopStats
+struct SC::AsyncLatencyHistogram
+{
+    static constexpr uint32_t SubBucketBits = 2;  ///< Each power of two is split in (1 << SubBucketBits) sub-buckets
+    static constexpr uint32_t MaxExponent   = 36; ///< Durations from 2^(MaxExponent + 1) ns (~2 min) go in last bucket
+    static constexpr uint32_t NumBuckets    = (MaxExponent - SubBucketBits + 2) << SubBucketBits;
+
+    /// @brief Plain copy of an AsyncLatencyHistogram obtained with AsyncLatencyHistogram::takeSnapshot
+    struct Snapshot
+    {
+        uint64_t buckets[NumBuckets] = {0}; ///< Number of durations counted in each bucket
+        uint64_t count               = 0;   ///< Number of recorded durations
+        uint64_t sum                 = 0;   ///< Sum of recorded durations (in nanoseconds)
+        uint64_t maximum             = 0;   ///< Longest recorded duration (in nanoseconds)
+
+        /// @brief Gets an upper bound of the given percentile of recorded durations
+        /// @param percentile A value between 0 and 100 (for example 99.9)
+        /// @return Upper bound (in nanoseconds) of the bucket holding the given percentile
+        [[nodiscard]] uint64_t getPercentile(double percentile) const;
+
+        /// @brief Gets the average of recorded durations (in nanoseconds)
+        [[nodiscard]] uint64_t getMean() const { return count > 0 ? sum / count : 0; }
+    };
+
+    /// @brief Records a duration (must always be called from the same thread)
+    void record(uint64_t nanoseconds);
+
+    /// @brief Copies all counters to a Snapshot (can be called from any thread)
+    void takeSnapshot(Snapshot& snapshot) const;
+
+    /// @brief Gets the index of the bucket counting a given duration
+    [[nodiscard]] static uint32_t getBucketIndex(uint64_t nanoseconds);
+
+    /// @brief Gets the shortest duration (in nanoseconds) counted by a given bucket
+    [[nodiscard]] static uint64_t getBucketLowerBound(uint32_t bucketIndex);
+
+  private:
+    Atomic<uint64_t> buckets[NumBuckets];
+    Atomic<uint64_t> count;
+    Atomic<uint64_t> sum;
+    Atomic<uint64_t> maximum;
+};
+
+/// @brief Opt-in statistics collected by an AsyncEventLoop (see AsyncEventLoop::enableStats). @n
+/// Counters and histograms are updated by the thread running the loop with relaxed atomic stores, so they're cheap
+/// enough to be left enabled, and a consistent enough copy can be taken from any thread with
+/// AsyncEventLoopStats::takeSnapshot. @n
+/// All counters are cumulative, so that rates can be obtained by subtracting two snapshots.
+/// Long callbacks starving the loop show up in AsyncEventLoopStats::Snapshot::RequestStats::callbackDuration of their
+/// request type and in AsyncEventLoopStats::Snapshot::dispatchDuration.
+///
+/// @note This is a big object (tens of KB) that must outlive the event loop it's been enabled on
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncEventLoopStatsSnippet
+struct SC::AsyncEventLoopStats
+{
+    static constexpr size_t NumRequestTypes = static_cast<size_t>(AsyncRequest::Type::FileSend) + 1;
+
+    /// @brief Plain copy of AsyncEventLoopStats obtained with AsyncEventLoopStats::takeSnapshot
+    struct Snapshot
+    {
+        /// @brief Statistics of requests of a given AsyncRequest::Type
+        struct RequestStats
+        {
+            uint64_t numStarted   = 0; ///< Number of requests started (not counting reactivations)
+            uint64_t numCompleted = 0; ///< Number of callbacks invoked (including errors and reactivations)
+            uint64_t numErrors    = 0; ///< Number of callbacks invoked with an error
+
+            AsyncLatencyHistogram::Snapshot completionLatency; ///< From start (or reactivation) to callback
+            AsyncLatencyHistogram::Snapshot callbackDuration;  ///< Time spent executing callbacks
+        };
+        RequestStats requests[NumRequestTypes]; ///< Indexed by AsyncRequest::Type
+
+        AsyncLatencyHistogram::Snapshot pollDuration;     ///< Time spent blocked waiting for kernel events
+        AsyncLatencyHistogram::Snapshot dispatchDuration; ///< Time spent dispatching completions of each step
+
+        uint64_t numSteps        = 0; ///< Number of dispatched steps (run / runOnce / runNoWait iterations)
+        uint64_t numKernelEvents = 0; ///< Number of kernel events dispatched
+
+        uint64_t numSubmissions    = 0; ///< Requests submitted by last step (submission queue depth)
+        uint64_t maxSubmissions    = 0; ///< Maximum number of requests submitted by a single step
+        uint64_t numActiveRequests = 0; ///< Requests active at the end of last step
+        uint64_t maxActiveRequests = 0; ///< Maximum number of requests active at the end of a step
+
+        /// @brief Gets statistics for a given request type
+        [[nodiscard]] const RequestStats& get(AsyncRequest::Type type) const
+        {
+            return requests[static_cast<size_t>(type)];
+        }
+    };
+
+    /// @brief Copies all statistics to a Snapshot (can be called from any thread)
+    void takeSnapshot(Snapshot& snapshot) const;
+
+  private:
+    friend struct AsyncEventLoop;
+
+    struct RequestStats
+    {
+        Atomic<uint64_t> numStarted;
+        Atomic<uint64_t> numCompleted;
+        Atomic<uint64_t> numErrors;
+
+        AsyncLatencyHistogram completionLatency;
+        AsyncLatencyHistogram callbackDuration;
+    };
+    RequestStats requests[NumRequestTypes];
+
+    AsyncLatencyHistogram pollDuration;
+    AsyncLatencyHistogram dispatchDuration;
+
+    Atomic<uint64_t> numSteps;
+    Atomic<uint64_t> numKernelEvents;
+    Atomic<uint64_t> numSubmissions;
+    Atomic<uint64_t> maxSubmissions;
+    Atomic<uint64_t> numActiveRequests;
+    Atomic<uint64_t> maxActiveRequests;
+};
+
 /// @brief Asynchronous I/O (files, sockets, timers, processes, fs events, threads wake-up) (see @ref library_async)
 /// AsyncEventLoop pushes all AsyncRequest derived classes to I/O queues in the OS.
 /// Basic lifetime for an event loop is:
 /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncEventLoopSnippet
 struct SC::AsyncEventLoop
 {
+    /// Default size in bytes of the memory storing kernel events read by each step (see Options::kernelEventsMemorySize)
+    static constexpr size_t DefaultKernelEventsMemorySize = 8 * 1024;
+
+    /// Default maximum number of functions posted with AsyncEventLoop::post waiting to be executed
+    static constexpr size_t DefaultPostQueueCapacity = 1024;
+
     /// @brief Options given to AsyncEventLoop::create
     struct Options
     {
@@ -878,7 +1681,48 @@ struct SC::AsyncEventLoop
         };
         ApiType apiType; ///< Criteria to choose Async IO API
 
-        Options() { apiType = ApiType::Automatic; }
+        /// (Linux `io_uring` only) Number of entries of the submission queue.
+        /// Submissions exceeding it are flushed to the kernel before queuing more of them.
+        uint32_t ioUringQueueDepth;
+
+        /// (Linux `io_uring` only) If non zero enables `IORING_SETUP_SQPOLL`, where a kernel thread polls the
+        /// submission queue, going to sleep after being idle for the given number of milliseconds.
+        /// @note Requires Linux 5.11+ (or `CAP_SYS_NICE` on older kernels)
+        uint32_t ioUringSQPollIdleMilliseconds;
+
+        /// (Linux `io_uring` only) Enables `IORING_SETUP_COOP_TASKRUN`, avoiding interrupting the thread running the
+        /// loop to process completions. Ignored on kernels older than 5.19.
+        bool ioUringCooperativeTaskRun;
+
+        /// (Linux `io_uring` only) Enables `IORING_SETUP_SINGLE_ISSUER`, hinting the kernel that only the thread
+        /// creating the loop will submit requests. Ignored on kernels older than 6.0.
+        bool ioUringSingleIssuer;
+
+        /// (Linux `io_uring` only) Maximum number of completions dispatched for each loop step.
+        /// Zero means as many as they fit the step kernel events buffer.
+        uint32_t ioUringCompletionBatchSize;
+
+        /// Size in bytes of the memory storing kernel events read by each AsyncEventLoop::run / runOnce / runNoWait
+        /// step, bounding the number of completions dispatched for each step (8 KB by default, on stack). @n
+        /// Bigger values are allocated once by AsyncEventLoop::create, and can reduce the number of syscalls when
+        /// many requests complete together.
+        size_t kernelEventsMemorySize;
+
+        /// Maximum number of functions posted with AsyncEventLoop::post waiting to be executed (must be a power of
+        /// two). AsyncEventLoop::post fails when the queue is full. Its memory is allocated on first post.
+        size_t postQueueCapacity;
+
+        Options()
+        {
+            apiType                       = ApiType::Automatic;
+            ioUringQueueDepth             = 64;
+            ioUringSQPollIdleMilliseconds = 0;
+            ioUringCooperativeTaskRun     = false;
+            ioUringSingleIssuer           = false;
+            ioUringCompletionBatchSize    = 0;
+            kernelEventsMemorySize        = DefaultKernelEventsMemorySize;
+            postQueueCapacity             = DefaultPostQueueCapacity;
+        }
     };
 
     AsyncEventLoop();
@@ -953,19 +1797,58 @@ struct SC::AsyncEventLoop
     /// Wake up the event loop from a thread different than the one where run() is called (and potentially blocked)
     [[nodiscard]] Result wakeUpFromExternalThread();
 
+    /// Queues a function to be executed on the thread running the event loop (can be called from any thread).
+    /// Functions are stored in a lock-free queue and executed in the same order they've been posted by each thread.
+    /// Wake ups of the loop are coalesced, so that a single notification is sent for each batch of posted functions.
+    /// Posted functions keep AsyncEventLoop::run alive until they're executed.
+    /// Requests can be started from other threads by posting a function calling their `start` method.
+    /// @param func The function to execute on the event loop thread
+    /// @return Error if the loop has not been created or if the queue is full, holding Options::postQueueCapacity
+    /// functions not executed yet (the loop is not keeping up). The function is not queued in such case.
+    ///
+    /// Example:
+    /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncEventLoopPostSnippet
+    [[nodiscard]] Result post(Function<void()>&& func);
+
     /// Helper to creates a TCP socket with AsyncRequest flags of the given family (IPV4 / IPV6).
     /// It also automatically registers the socket with the eventLoop (associateExternallyCreatedTCPSocket)
     [[nodiscard]] Result createAsyncTCPSocket(SocketFlags::AddressFamily family, SocketDescriptor& outDescriptor);
 
-    /// Associates a TCP Socket created externally (without using createAsyncTCPSocket) with the eventLoop.
+    /// Helper to creates a UDP socket with AsyncRequest flags of the given family (IPV4 / IPV6).
+    /// It also automatically registers the socket with the eventLoop (associateExternallyCreatedTCPSocket)
+    [[nodiscard]] Result createAsyncUDPSocket(SocketFlags::AddressFamily family, SocketDescriptor& outDescriptor);
+
+    /// Associates a TCP (or UDP) Socket created externally (without using createAsyncTCPSocket) with the eventLoop.
     [[nodiscard]] Result associateExternallyCreatedTCPSocket(SocketDescriptor& outDescriptor);
 
     /// Associates a File descriptor created externally with the eventLoop.
     [[nodiscard]] Result associateExternallyCreatedFileDescriptor(FileDescriptor& outDescriptor);
 
+    /// Cancels all requests operating on the given socket, as if AsyncRequest::stop was called on each of them.
+    /// Cancelled requests will not receive their callbacks, and they become free once the loop has processed their
+    /// cancellation (usually on its next step).
+    /// On `io_uring` (Linux 5.19+) all of them are cancelled with a single `IORING_OP_ASYNC_CANCEL` submission.
+    /// @note On `io_uring` a receive can still consume data arriving before the kernel processes its cancellation
+    /// @note AsyncSocketClose requests are not cancelled
+    /// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncEventLoopCancelAllSnippet
+    [[nodiscard]] Result cancelAllRequestsFor(const SocketDescriptor& descriptor);
+
+    /// Cancels all requests operating on the given file descriptor, as if AsyncRequest::stop was called on them.
+    /// @see AsyncEventLoop::cancelAllRequestsFor(const SocketDescriptor&)
+    [[nodiscard]] Result cancelAllRequestsFor(const FileDescriptor& descriptor);
+
     /// Get Loop time
     [[nodiscard]] Time::HighResolutionCounter getLoopTime() const;
 
+    /// Starts collecting statistics (latencies, callback durations, poll durations, queue depths) into given object.
+    /// Must be called from the thread running the loop (or before running it).
+    /// Completion latency is not recorded for requests started before enabling stats.
+    /// @param stats Statistics object that can be read by any thread (must outlive the loop or disableStats call)
+    void enableStats(AsyncEventLoopStats& stats);
+
+    /// Stops collecting statistics (must be called from the thread running the loop)
+    void disableStats();
+
     /// Check if liburing is loadable (only on Linux)
     /// @return true if liburing has been loaded, false otherwise (and on any non-Linux os)
     [[nodiscard]] static bool tryLoadingLiburing();
@@ -975,9 +1858,9 @@ struct SC::AsyncEventLoop
   private:
     struct InternalDefinition
     {
-        static constexpr int Windows = 528;
-        static constexpr int Apple   = 472;
-        static constexpr int Default = 688;
+        static constexpr int Windows = 712;
+        static constexpr int Apple   = 648;
+        static constexpr int Default = 864;
 
         static constexpr size_t Alignment = 8;
 
@@ -994,6 +1877,8 @@ struct SC::AsyncEventLoop
     friend struct AsyncRequest;
     friend struct AsyncFileWrite;
     friend struct AsyncFileRead;
+    friend struct AsyncBufferPool;
+    friend struct AsyncRequestPoolBase;
 };
 
 //! @}
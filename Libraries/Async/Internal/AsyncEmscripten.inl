@@ -13,6 +13,10 @@ struct SC::AsyncEventLoop::KernelQueue
     [[nodiscard]] Result associateExternallyCreatedTCPSocket(SocketDescriptor&) { return Result(true); }
     [[nodiscard]] Result associateExternallyCreatedFileDescriptor(FileDescriptor&) { return Result(true); }
     [[nodiscard]] Result makesSenseToRunInThreadPool(AsyncRequest&) { return Result(true); }
+    [[nodiscard]] Result createBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] Result closeBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] Result provideBuffers(AsyncBufferPool&, uint32_t, uint32_t) { return Result(true); }
+    [[nodiscard]] Result cancelAllRequestsFor(int, bool&) { return Result(true); }
 };
 
 struct SC::AsyncEventLoop::KernelEvents
@@ -22,6 +26,7 @@ struct SC::AsyncEventLoop::KernelEvents
 
     [[nodiscard]] Result syncWithKernel(AsyncEventLoop&, Internal::SyncMode) { return Result(true); }
     [[nodiscard]] Result validateEvent(uint32_t, bool&) { return Result(true); }
+    [[nodiscard]] bool   receivesCancellationCompletion(AsyncRequest&) { return false; }
 
     [[nodiscard]] AsyncRequest* getAsyncRequest(uint32_t) const { return nullptr; }
 
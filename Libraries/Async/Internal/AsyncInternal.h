@@ -2,8 +2,26 @@
 #include "../Async.h"
 
 #include "../../Containers/IntrusiveDoubleLinkedList.h"
+#include "../../Threading/LockFreeQueue.h"
 #include "ThreadSafeLinkedList.h"
 
+// Data tracked by the event loop for some requests, kept outside of AsyncRequest to avoid growing all of them
+struct SC::detail::AsyncTrackingSlot
+{
+    AsyncRequest* request = nullptr; // Request owning this slot
+
+    uint64_t statsStartTime = 0; // Start (or reactivation) time in nanoseconds, only if AsyncEventLoopStats are enabled
+
+    Time::HighResolutionCounter deadlineTime; // Absolute deadline of the active request (see AsyncRequest::setDeadline)
+
+    // Links in the event loop pairing heap of active deadlines
+    AsyncTrackingSlot* deadlineChild = nullptr;
+    AsyncTrackingSlot* deadlineNext  = nullptr;
+    AsyncTrackingSlot* deadlinePrev  = nullptr;
+
+    AsyncTrackingSlot* nextFree = nullptr;
+};
+
 struct SC::AsyncEventLoop::Internal
 {
 #if SC_PLATFORM_LINUX
@@ -28,9 +46,9 @@ struct SC::AsyncEventLoop::Internal
 
     struct KernelQueueDefinition
     {
-        static constexpr int Windows = 184;
-        static constexpr int Apple   = 104;
-        static constexpr int Default = 336;
+        static constexpr int Windows = 216;
+        static constexpr int Apple   = 128;
+        static constexpr int Default = 360;
 
         static constexpr size_t Alignment = alignof(void*);
 
@@ -46,6 +64,24 @@ struct SC::AsyncEventLoop::Internal
 
     Atomic<bool> wakeUpPending = false;
 
+    // Functions posted from any thread with AsyncEventLoop::post (allocated on first post).
+    // Capacity is chosen at runtime (Options::postQueueCapacity), so cells are allocated together with the queue.
+    struct PostQueue
+    {
+        using Queue = MPSCQueue<Function<void()>, 0>;
+
+        PostQueue(Queue::Cell* cells, size_t capacity, void* memory);
+        ~PostQueue();
+
+        Queue        functions;
+        Queue::Cell* cells  = nullptr; // Placed right after this object
+        void*        memory = nullptr; // Allocation holding this object (aligned to cache line size) and its cells
+    };
+
+    Atomic<PostQueue*> postQueue;
+    size_t             postQueueCapacity = DefaultPostQueueCapacity;
+    Atomic<size_t>     numPostedFunctions; // Counted before being pushed, to keep the loop alive
+
     int numberOfActiveHandles     = 0;
     int numberOfManualCompletions = 0;
     int numberOfExternals         = 0;
@@ -53,32 +89,144 @@ struct SC::AsyncEventLoop::Internal
     // Submitting phase
     IntrusiveDoubleLinkedList<AsyncRequest> submissions;
 
+    // Stopped requests that will be freed by the completion of their cancelled kernel operation
+    IntrusiveDoubleLinkedList<AsyncRequest> cancellations;
+
+    // Intrusive pairing heap ordering requests by expiration time.
+    // Insert is O(1), removal (expiration or cancellation) is O(log n) amortized.
+    // Links tells which Node of a request stores its expiration time and its heap links: siblings are linked through
+    // next, prev points to the previous sibling (or to the parent for the leftmost child), child to the leftmost child.
+    template <typename T, typename Links>
+    struct PairingHeap
+    {
+        using Node = typename Links::Node;
+
+        [[nodiscard]] T* peekEarliest() const { return root == nullptr ? nullptr : Links::request(*root); }
+
+        [[nodiscard]] bool isEmpty() const { return root == nullptr; }
+
+        void insert(T& request);
+        void remove(T& request);
+
+      private:
+        Node* root = nullptr;
+
+        static Node* meld(Node* first, Node* second);
+        static Node* mergePairs(Node* first);
+    };
+
+    // Active timeouts are linked through AsyncRequest::next / prev and AsyncLoopTimeout::heapChild
+    struct LoopTimeoutLinks
+    {
+        using Node = AsyncRequest;
+
+        static Node&             node(AsyncLoopTimeout& async) { return async; }
+        static AsyncLoopTimeout* request(Node& node) { return static_cast<AsyncLoopTimeout*>(&node); }
+
+        static Node*& next(Node& node) { return node.next; }
+        static Node*& prev(Node& node) { return node.prev; }
+        static Node*& child(Node& node) { return static_cast<AsyncLoopTimeout&>(node).heapChild; }
+
+        static Time::HighResolutionCounter time(Node& node)
+        {
+            return static_cast<AsyncLoopTimeout&>(node).expirationTime;
+        }
+    };
+
+    // Active deadlines are linked through the tracking slot of their request
+    struct DeadlineLinks
+    {
+        using Node = detail::AsyncTrackingSlot;
+
+        static Node&         node(AsyncRequest& async) { return *async.trackingSlot; }
+        static AsyncRequest* request(Node& node) { return node.request; }
+
+        static Node*& next(Node& node) { return node.deadlineNext; }
+        static Node*& prev(Node& node) { return node.deadlinePrev; }
+        static Node*& child(Node& node) { return node.deadlineChild; }
+
+        static Time::HighResolutionCounter time(Node& node) { return node.deadlineTime; }
+    };
+
+    using LoopTimeoutHeap = PairingHeap<AsyncLoopTimeout, LoopTimeoutLinks>;
+    using DeadlineHeap    = PairingHeap<AsyncRequest, DeadlineLinks>;
+
     // Active phase
-    IntrusiveDoubleLinkedList<AsyncLoopTimeout>   activeLoopTimeouts;
-    IntrusiveDoubleLinkedList<AsyncLoopWakeUp>    activeLoopWakeUps;
-    IntrusiveDoubleLinkedList<AsyncLoopWork>      activeLoopWork;
-    IntrusiveDoubleLinkedList<AsyncProcessExit>   activeProcessExits;
-    IntrusiveDoubleLinkedList<AsyncSocketAccept>  activeSocketAccepts;
-    IntrusiveDoubleLinkedList<AsyncSocketConnect> activeSocketConnects;
-    IntrusiveDoubleLinkedList<AsyncSocketSend>    activeSocketSends;
-    IntrusiveDoubleLinkedList<AsyncSocketReceive> activeSocketReceives;
-    IntrusiveDoubleLinkedList<AsyncSocketClose>   activeSocketCloses;
-    IntrusiveDoubleLinkedList<AsyncFileRead>      activeFileReads;
-    IntrusiveDoubleLinkedList<AsyncFileWrite>     activeFileWrites;
-    IntrusiveDoubleLinkedList<AsyncFileClose>     activeFileCloses;
-    IntrusiveDoubleLinkedList<AsyncFilePoll>      activeFilePolls;
+    LoopTimeoutHeap                                   activeLoopTimeouts;
+    DeadlineHeap                                      activeDeadlines;
+    IntrusiveDoubleLinkedList<AsyncLoopWakeUp>        activeLoopWakeUps;
+    IntrusiveDoubleLinkedList<AsyncLoopWork>          activeLoopWork;
+    IntrusiveDoubleLinkedList<AsyncProcessExit>       activeProcessExits;
+    IntrusiveDoubleLinkedList<AsyncSocketAccept>      activeSocketAccepts;
+    IntrusiveDoubleLinkedList<AsyncSocketConnect>     activeSocketConnects;
+    IntrusiveDoubleLinkedList<AsyncSocketSend>        activeSocketSends;
+    IntrusiveDoubleLinkedList<AsyncSocketReceive>     activeSocketReceives;
+    IntrusiveDoubleLinkedList<AsyncSocketSendTo>      activeSocketSendTos;
+    IntrusiveDoubleLinkedList<AsyncSocketReceiveFrom> activeSocketReceiveFroms;
+    IntrusiveDoubleLinkedList<AsyncSocketClose>       activeSocketCloses;
+    IntrusiveDoubleLinkedList<AsyncFileRead>          activeFileReads;
+    IntrusiveDoubleLinkedList<AsyncFileWrite>         activeFileWrites;
+    IntrusiveDoubleLinkedList<AsyncFileClose>         activeFileCloses;
+    IntrusiveDoubleLinkedList<AsyncFilePoll>          activeFilePolls;
+    IntrusiveDoubleLinkedList<AsyncFileSend>          activeFileSends;
 
     // Manual completions
     IntrusiveDoubleLinkedList<AsyncRequest> manualCompletions;
 
+    // Registered AsyncRequestPool (detached when the loop is closed)
+    IntrusiveDoubleLinkedList<AsyncRequestPoolBase> requestPools;
+
     ThreadSafeLinkedList<AsyncRequest> manualThreadPoolCompletions;
 
     Time::HighResolutionCounter loopTime;
 
+    // Kernel events memory used by runStep (allocated only if bigger than DefaultKernelEventsMemorySize)
+    void*  kernelEventsMemory     = nullptr;
+    size_t kernelEventsMemorySize = DefaultKernelEventsMemorySize;
+
+    // Number of kernel events ahead of the one being dispatched whose requests are prefetched
+    static constexpr uint32_t CompletionsPrefetchDistance = 4;
+
     AsyncLoopTimeout* expiredTimer = nullptr;
 
+    AsyncEventLoopStats* stats = nullptr; // Enabled with AsyncEventLoop::enableStats
+
+    // Per request data stored outside of AsyncRequest, acquired only by requests needing it (and released when the
+    // request is freed). Slots are allocated in blocks that are never moved, and released by close.
+    static constexpr size_t NumTrackingSlotsPerBlock = 64;
+    struct TrackingSlotsBlock
+    {
+        TrackingSlotsBlock*       next;
+        detail::AsyncTrackingSlot slots[NumTrackingSlotsPerBlock];
+    };
+    TrackingSlotsBlock*        trackingSlotsBlocks = nullptr;
+    detail::AsyncTrackingSlot* freeTrackingSlots   = nullptr;
+
     // AsyncRequest flags
-    static constexpr int16_t Flag_ManualCompletion = 1 << 0;
+    static constexpr int16_t Flag_ManualCompletion  = 1 << 0;
+    static constexpr int16_t Flag_Multishot         = 1 << 1; // Kernel keeps generating completions until cancelled
+    static constexpr int16_t Flag_ZeroCopyPending   = 1 << 2; // Data has been sent, waiting for buffer release
+    static constexpr int16_t Flag_WaitsCancellation = 1 << 3; // Stopped, waiting completion of its cancelled operation
+    static constexpr int16_t Flag_DeadlineArmed     = 1 << 4; // Deadline is tracked by activeDeadlines
+    static constexpr int16_t Flag_DeadlineLinked    = 1 << 5; // Deadline is tracked by kernel (io_uring linked timeout)
+    static constexpr int16_t Flag_DeadlineExpired   = 1 << 6; // Request is being cancelled because of its deadline
+    static constexpr int16_t Flag_KernelCancelled   = 1 << 7; // Cancelled by kernel with all requests of its descriptor
+    static constexpr int16_t Flag_DeadlineRestart   = 1 << 8; // Reactivated after deadline, once cancellation completes
+    static constexpr int16_t Flag_FileSendFilling   = 1 << 9; // AsyncFileSend is splicing file data into its pipe
+
+    [[nodiscard]] static uint64_t getStatsTime();
+
+    void     statsRequestStarted(AsyncRequest& async);
+    uint64_t statsCallbackBegin(AsyncRequest& async);
+    void     statsCallbackEnd(AsyncRequest& async, uint64_t callbackBeginTime, bool failed);
+
+    [[nodiscard]] detail::AsyncTrackingSlot* acquireTrackingSlot(AsyncRequest& async);
+
+    void releaseTrackingSlot(AsyncRequest& async);
+    void releaseTrackingSlots();
+
+    [[nodiscard]] Result createKernelEventsMemory(size_t memorySize);
+    void                 releaseKernelEventsMemory();
 
     [[nodiscard]] Result close();
 
@@ -93,14 +241,49 @@ struct SC::AsyncEventLoop::Internal
     // Timers
     [[nodiscard]] AsyncLoopTimeout* findEarliestLoopTimeout() const;
 
+    [[nodiscard]] const Time::HighResolutionCounter* findEarliestExpirationTime() const;
+
     void invokeExpiredTimers(Time::HighResolutionCounter currentTime);
     void updateTime();
 
+    // Deadlines
+    [[nodiscard]] static bool supportsDeadline(const AsyncRequest& async);
+
+    void invokeExpiredDeadlines(KernelEvents& kernelEvents, Time::HighResolutionCounter currentTime);
+    void restartAfterDeadline(AsyncRequest& async);
+
     [[nodiscard]] Result cancelAsync(AsyncRequest& async);
 
+    // Cancel all requests of a descriptor
+    struct HandleMatcher;
+
+    template <typename HandleType>
+    [[nodiscard]] Result cancelAllRequestsFor(HandleMatcher& matcher, HandleType handle);
+
+    template <typename T>
+    [[nodiscard]] Result cancelMatchingRequests(IntrusiveDoubleLinkedList<T>& linkedList, HandleMatcher& matcher);
+
+    [[nodiscard]] Result cancelIfMatching(AsyncRequest& async, HandleMatcher& matcher);
+
     // LoopWakeUp
     void executeWakeUps(AsyncResult& result);
 
+    // Post
+    [[nodiscard]] Result post(Function<void()>&& func);
+    void                 executePostedFunctions();
+    void                 releasePostQueue();
+
+    // AsyncBufferPool (give back buffers lent to requests)
+    template <typename T>
+    [[nodiscard]] static Result releasePoolBuffer(T&)
+    {
+        return Result(true);
+    }
+    [[nodiscard]] static Result releasePoolBuffer(AsyncSocketReceive& async);
+    [[nodiscard]] static Result releasePoolBuffer(AsyncFileRead& async);
+
+    [[nodiscard]] static size_t sizeOfBuffers(Span<const Span<const char>> buffers);
+
     // Setup
     [[nodiscard]] Result queueSubmission(AsyncRequest& async, AsyncTask* task);
 
@@ -110,6 +293,8 @@ struct SC::AsyncEventLoop::Internal
     [[nodiscard]] Result teardownAsync(KernelEvents& kernelEvents, AsyncRequest& async);
     [[nodiscard]] Result activateAsync(KernelEvents& kernelEvents, AsyncRequest& async);
     [[nodiscard]] Result cancelAsync(KernelEvents& kernelEvents, AsyncRequest& async);
+    [[nodiscard]] bool   waitsCancellationCompletion(KernelEvents& kernelEvents, AsyncRequest& async);
+    void                 waitCancellationCompletion(AsyncRequest& async);
     [[nodiscard]] Result completeAsync(KernelEvents& kernelEvents, AsyncRequest& async, Result&& returnCode,
                                        bool& reactivate);
 
@@ -5,13 +5,14 @@
 #include <arpa/inet.h>   // sockaddr_in
 #include <stdint.h>      // uint32_t
 #include <sys/eventfd.h> // eventfd
+#include <sys/ioctl.h>   // FIONREAD
 #include <sys/poll.h>    // POLLIN
-#include <sys/syscall.h> // SYS_pidfd_open
+#include <sys/syscall.h> // SYS_pidfd_open, __NR_io_uring_register
 #include <sys/wait.h>    // waitpid
 
 struct SC::AsyncEventLoop::Internal::KernelQueue
 {
-    AlignedStorage<320> storage;
+    AlignedStorage<352> storage;
 
     bool isEpoll = true;
 
@@ -29,6 +30,12 @@ struct SC::AsyncEventLoop::Internal::KernelQueue
     [[nodiscard]] Result wakeUpFromExternalThread();
     [[nodiscard]] Result associateExternallyCreatedTCPSocket(SocketDescriptor&) { return Result(true); }
     [[nodiscard]] Result associateExternallyCreatedFileDescriptor(FileDescriptor&) { return Result(true); }
+
+    [[nodiscard]] Result createBufferPool(AsyncBufferPool& pool);
+    [[nodiscard]] Result closeBufferPool(AsyncBufferPool& pool);
+    [[nodiscard]] Result provideBuffers(AsyncBufferPool& pool, uint32_t firstBuffer, uint32_t numBuffers);
+
+    [[nodiscard]] Result cancelAllRequestsFor(int handle, bool& cancelledByKernel);
 };
 
 struct SC::AsyncEventLoop::Internal::KernelEvents
@@ -47,6 +54,7 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
     [[nodiscard]] uint32_t getNumEvents() const;
     [[nodiscard]] Result   syncWithKernel(AsyncEventLoop&, Internal::SyncMode);
     [[nodiscard]] Result   validateEvent(uint32_t&, bool&);
+    [[nodiscard]] bool     receivesCancellationCompletion(AsyncRequest&);
 
     [[nodiscard]] AsyncRequest* getAsyncRequest(uint32_t);
 
@@ -73,11 +81,17 @@ bool SC::AsyncEventLoop::tryLoadingLiburing() { return globalLibURing.init(); }
 
 struct SC::AsyncEventLoop::Internal::KernelQueueIoURing
 {
-    static constexpr int QueueDepth = 64;
-
-    bool     ringInited = false;
+    bool     ringInited          = false;
+    uint32_t completionBatchSize = 0;
     io_uring ring;
 
+    uint16_t nextBufferGroup = 0;
+
+    bool supportsMultishotAccept  = false; // Linux 5.19+
+    bool supportsMultishotReceive = false; // Linux 6.0+
+    bool supportsZeroCopySend     = false; // Linux 6.0+
+    bool supportsCancelDescriptor = false; // Linux 5.19+
+
     AsyncFilePoll  wakeUpPoll;
     FileDescriptor wakeUpEventFd;
 
@@ -96,7 +110,7 @@ struct SC::AsyncEventLoop::Internal::KernelQueueIoURing
         return Result(true);
     }
 
-    [[nodiscard]] Result createEventLoop()
+    [[nodiscard]] Result createEventLoop(const AsyncEventLoop::Options& options)
     {
         if (not globalLibURing.init())
         {
@@ -107,15 +121,67 @@ struct SC::AsyncEventLoop::Internal::KernelQueueIoURing
         {
             return Result::Error("ring already inited");
         }
-        const auto uringFd = globalLibURing.io_uring_queue_init(QueueDepth, &ring, 0);
+        SC_TRY_MSG(options.ioUringQueueDepth > 0, "ioUringQueueDepth must be greater than zero");
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        if (options.ioUringSQPollIdleMilliseconds > 0)
+        {
+            params.flags |= IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = options.ioUringSQPollIdleMilliseconds;
+        }
+        const unsigned requiredFlags = params.flags;
+        if (options.ioUringCooperativeTaskRun)
+        {
+            params.flags |= IORING_SETUP_COOP_TASKRUN;
+        }
+        if (options.ioUringSingleIssuer)
+        {
+            params.flags |= IORING_SETUP_SINGLE_ISSUER;
+        }
+        int uringFd = globalLibURing.io_uring_queue_init_params(options.ioUringQueueDepth, &ring, &params);
+        if (uringFd == -EINVAL and params.flags != requiredFlags)
+        {
+            // Older kernels reject COOP_TASKRUN / SINGLE_ISSUER, that are just optimization hints
+            memset(&ring, 0, sizeof(ring));
+            params.flags = requiredFlags;
+            uringFd      = globalLibURing.io_uring_queue_init_params(options.ioUringQueueDepth, &ring, &params);
+        }
         if (uringFd < 0)
         {
             return Result::Error("io_uring_setup failed");
         }
-        ringInited = true;
+        ringInited          = true;
+        completionBatchSize = options.ioUringCompletionBatchSize;
+        detectKernelFeatures();
         return Result(true);
     }
 
+    void detectKernelFeatures()
+    {
+        // IORING_REGISTER_PROBE lists supported opcodes, but flags of existing opcodes (multishot, cancel by fd)
+        // cannot be probed. They are inferred from opcodes added in the same kernel release: IORING_OP_SOCKET (5.19)
+        // and IORING_OP_SEND_ZC (6.0). Multishot submissions rejected anyway fall back to single shot (see
+        // validateMultishotEvent).
+        constexpr unsigned maxOps = 256; // Opcodes are 8 bits
+        union
+        {
+            io_uring_probe probe;
+            char           storage[sizeof(io_uring_probe) + maxOps * sizeof(io_uring_probe_op)];
+        } probe;
+        memset(&probe, 0, sizeof(probe));
+        if (::syscall(__NR_io_uring_register, ring.ring_fd, IORING_REGISTER_PROBE, &probe.probe, maxOps) != 0)
+        {
+            return; // Kernels older than 5.6 don't support probing, nor any of these features
+        }
+        const auto supportsOperation = [&probe](unsigned operation)
+        { return operation <= probe.probe.last_op and (probe.probe.ops[operation].flags & IO_URING_OP_SUPPORTED); };
+
+        supportsMultishotAccept  = supportsOperation(IORING_OP_SOCKET);
+        supportsCancelDescriptor = supportsOperation(IORING_OP_SOCKET);
+        supportsMultishotReceive = supportsOperation(IORING_OP_SEND_ZC);
+        supportsZeroCopySend     = supportsOperation(IORING_OP_SEND_ZC);
+    }
+
     [[nodiscard]] Result createSharedWatchers(AsyncEventLoop& eventLoop)
     {
         SC_TRY(createWakeup(eventLoop));
@@ -166,6 +232,68 @@ struct SC::AsyncEventLoop::Internal::KernelQueueIoURing
 
     static Result associateExternallyCreatedTCPSocket(SocketDescriptor&) { return Result(true); }
     static Result associateExternallyCreatedFileDescriptor(FileDescriptor&) { return Result(true); }
+
+    //-------------------------------------------------------------------------------------------------------
+    // AsyncBufferPool
+    //-------------------------------------------------------------------------------------------------------
+    // Buffers are handed to the kernel as a provided buffers group, that will select one of them when data arrives.
+    // Provide / remove completions have nullptr user_data so they're skipped (see validateEvent).
+    [[nodiscard]] Result getSubmission(io_uring_sqe*& submission)
+    {
+        submission = globalLibURing.io_uring_get_sqe(&ring);
+        if (submission == nullptr)
+        {
+            // No space in the submission queue, let's try to flush submissions and try again
+            SC_TRY_MSG(globalLibURing.io_uring_submit(&ring) >= 0, "io_uring_submit");
+            submission = globalLibURing.io_uring_get_sqe(&ring);
+            SC_TRY_MSG(submission != nullptr, "io_uring_get_sqe");
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result createBufferPool(AsyncBufferPool& pool)
+    {
+        pool.groupId       = nextBufferGroup++;
+        pool.kernelSelects = true;
+        return provideBuffers(pool, 0, pool.numBuffers);
+    }
+
+    [[nodiscard]] Result closeBufferPool(AsyncBufferPool& pool)
+    {
+        io_uring_sqe* submission;
+        SC_TRY(getSubmission(submission));
+        globalLibURing.io_uring_prep_remove_buffers(submission, static_cast<int>(pool.numBuffers), pool.groupId);
+        globalLibURing.io_uring_sqe_set_data(submission, nullptr);
+        return Result(true);
+    }
+
+    [[nodiscard]] Result provideBuffers(AsyncBufferPool& pool, uint32_t firstBuffer, uint32_t numBuffers)
+    {
+        io_uring_sqe* submission;
+        SC_TRY(getSubmission(submission));
+        globalLibURing.io_uring_prep_provide_buffers(
+            submission, pool.memory.data() + static_cast<size_t>(firstBuffer) * pool.bufferSize,
+            static_cast<int>(pool.bufferSize), static_cast<int>(numBuffers), pool.groupId, static_cast<int>(firstBuffer));
+        globalLibURing.io_uring_sqe_set_data(submission, nullptr);
+        return Result(true);
+    }
+
+    // Cancels all requests of the descriptor with a single submission, whose completion has nullptr user_data.
+    // Completions of cancelled requests will free them, as they will be in State::Cancelling (see validateEvent).
+    [[nodiscard]] Result cancelAllRequestsFor(int handle, bool& cancelledByKernel)
+    {
+        cancelledByKernel = false;
+        if (not supportsCancelDescriptor)
+        {
+            return Result(true); // Every request will submit its own IORING_OP_ASYNC_CANCEL
+        }
+        io_uring_sqe* submission;
+        SC_TRY(getSubmission(submission));
+        globalLibURing.io_uring_prep_cancel_fd(submission, handle, IORING_ASYNC_CANCEL_ALL);
+        globalLibURing.io_uring_sqe_set_data(submission, nullptr);
+        cancelledByKernel = true;
+        return Result(true);
+    }
 };
 
 struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
@@ -194,7 +322,18 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
 
     uint32_t getNumEvents() const { return static_cast<uint32_t>(newEvents); }
 
-    static io_uring& getRing(AsyncEventLoop& eventLoop) { return eventLoop.internal.kernelQueue.get().getUring().ring; }
+    // Cancelled requests submissions still in flight are completed (usually with ECANCELED), freeing the request
+    [[nodiscard]] static bool receivesCancellationCompletion(AsyncRequest& async)
+    {
+        return async.type != AsyncRequest::Type::LoopWakeUp;
+    }
+
+    static KernelQueueIoURing& getQueue(AsyncEventLoop& eventLoop)
+    {
+        return eventLoop.internal.kernelQueue.get().getUring();
+    }
+
+    static io_uring& getRing(AsyncEventLoop& eventLoop) { return getQueue(eventLoop).ring; }
 
     [[nodiscard]] Result getNewSubmission(AsyncRequest& async, io_uring_sqe*& newSubmission)
     {
@@ -216,23 +355,43 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
         return Result(true);
     }
 
-    void copyReadyCompletions(io_uring& ring)
+    void copyReadyCompletions(KernelQueueIoURing& queue)
     {
-        // Read up to totalNumEvents completions, copy them into a local array and
+        // Read up to totalNumEvents (or completionBatchSize) completions, copy them into a local array and
         // advance the ring buffer pointers to free ring slots.
-        io_uring_cqe* eventPointers[totalNumEvents];
-        newEvents = globalLibURing.io_uring_peek_batch_cqe(&ring, &eventPointers[0], totalNumEvents);
-        for (int idx = 0; idx < newEvents; ++idx)
+        unsigned batchSize = static_cast<unsigned>(totalNumEvents);
+        if (queue.completionBatchSize > 0 and queue.completionBatchSize < batchSize)
+        {
+            batchSize = queue.completionBatchSize;
+        }
+        // Completions are peeked in chunks, so that stack usage doesn't grow with kernel events memory size
+        constexpr unsigned ChunkSize = 64;
+
+        io_uring&     ring = queue.ring;
+        io_uring_cqe* eventPointers[ChunkSize];
+        newEvents = 0;
+        while (static_cast<unsigned>(newEvents) < batchSize)
         {
-            events[idx] = *eventPointers[idx];
+            const unsigned numRemaining = batchSize - static_cast<unsigned>(newEvents);
+            const unsigned numToPeek    = numRemaining < ChunkSize ? numRemaining : ChunkSize;
+            const unsigned numPeeked    = globalLibURing.io_uring_peek_batch_cqe(&ring, &eventPointers[0], numToPeek);
+            for (unsigned idx = 0; idx < numPeeked; ++idx)
+            {
+                events[newEvents + static_cast<int>(idx)] = *eventPointers[idx];
+            }
+            globalLibURing.io_uring_cq_advance(&ring, numPeeked);
+            newEvents += static_cast<int>(numPeeked);
+            if (numPeeked < numToPeek)
+            {
+                break; // No more ready completions
+            }
         }
-        globalLibURing.io_uring_cq_advance(&ring, newEvents);
     }
 
     [[nodiscard]] Result syncWithKernel(AsyncEventLoop& eventLoop, Internal::SyncMode syncMode)
     {
         SC_TRY(flushSubmissions(eventLoop, syncMode));
-        copyReadyCompletions(getRing(eventLoop));
+        copyReadyCompletions(getQueue(eventLoop));
         return Result(true);
     }
 
@@ -263,7 +422,7 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
                 {
                     // OMG the completion kernelEvents is full, so we can't submit
                     // anything until we free some of the completions slots :-|
-                    copyReadyCompletions(ring);
+                    copyReadyCompletions(getQueue(eventLoop));
                     if (newEvents > 0)
                     {
                         // We've freed some slots, let's try again
@@ -292,9 +451,52 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
         io_uring_cqe& completion = events[idx];
         // Cancellation completions have nullptr user_data
         continueProcessing = completion.user_data != 0;
+        if (not continueProcessing)
+        {
+            return Result(true);
+        }
+        AsyncRequest* request = getAsyncRequest(idx);
+        if (request->type == AsyncRequest::Type::SocketSendTo)
+        {
+            SC_TRY(validateSendToEvent(*static_cast<AsyncSocketSendTo*>(request), completion, continueProcessing));
+            if (not continueProcessing)
+            {
+                return Result(true);
+            }
+        }
+        if (request->flags & Internal::Flag_FileSendFilling)
+        {
+            SC_TRY(validateFileSendFill(*static_cast<AsyncFileSend*>(request), completion, continueProcessing));
+            if (not continueProcessing)
+            {
+                return Result(true);
+            }
+        }
+        if (request->flags & Internal::Flag_Multishot)
+        {
+            SC_TRY(validateMultishotEvent(*request, completion, continueProcessing));
+            if (continueProcessing and (completion.flags & IORING_CQE_F_MORE) != 0 and
+                request->type == AsyncRequest::Type::SocketSend)
+            {
+                // Zero-copy send result is delivered when buffer release notification (IORING_CQE_F_NOTIF) arrives
+                static_cast<AsyncSocketSend*>(request)->zeroCopyResult = completion.res;
+                continueProcessing = false;
+                return Result(true);
+            }
+        }
         if (continueProcessing and completion.res < 0)
         {
-            const AsyncRequest* request = getAsyncRequest(idx);
+            if (request->state == AsyncRequest::State::Cancelling)
+            {
+                return Result(true); // Completion of a stopped request, that will just be marked as free
+            }
+            if (completion.res == -ECANCELED and (request->flags & Internal::Flag_DeadlineLinked))
+            {
+                // Request has been cancelled by its linked timeout (see linkDeadline)
+                request->flags |= Internal::Flag_DeadlineExpired;
+                continueProcessing = false;
+                return Result::Error("AsyncRequest deadline expired");
+            }
             // Expired LoopTimeout are reported with ETIME errno, but we do not consider it an error...
             if (request->type != AsyncRequest::Type::LoopTimeout or completion.res != -ETIME)
             {
@@ -305,6 +507,114 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
         return Result(true);
     }
 
+    [[nodiscard]] Result validateMultishotEvent(AsyncRequest& request, const io_uring_cqe& completion,
+                                                bool& continueProcessing)
+    {
+        // A completion without IORING_CQE_F_MORE is the last one, as the kernel is not armed anymore
+        const bool isLastCompletion = (completion.flags & IORING_CQE_F_MORE) == 0;
+        if (isLastCompletion)
+        {
+            request.flags &= ~Internal::Flag_Multishot;
+        }
+        if (request.state == AsyncRequest::State::Active)
+        {
+            if (isLastCompletion and completion.res == -EINVAL)
+            {
+                return resubmitAsSingleShot(request, continueProcessing);
+            }
+            return Result(true);
+        }
+        // Request has been stopped or not reactivated, so completions still in flight must be dropped
+        continueProcessing = false;
+        if (request.type == AsyncRequest::Type::SocketReceive and (completion.flags & IORING_CQE_F_BUFFER) != 0)
+        {
+            // Give back to the kernel the buffer it has selected for a receive that will never be delivered
+            AsyncBufferPool& pool = *static_cast<AsyncSocketReceive&>(request).bufferPool;
+            SC_TRY(getQueue(*request.eventLoop).provideBuffers(pool, completion.flags >> IORING_CQE_BUFFER_SHIFT, 1));
+        }
+        else if (request.type == AsyncRequest::Type::SocketAccept and completion.res >= 0)
+        {
+            ::close(completion.res); // Connection accepted by the kernel after the request has been stopped
+        }
+        if (isLastCompletion)
+        {
+            request.markAsFree();
+        }
+        return Result(true);
+    }
+
+    // Multishot flags are not probed (see detectKernelFeatures), so kernels rejecting them disable multishot for
+    // the loop and the request is submitted again as single shot, without the caller noticing.
+    [[nodiscard]] Result resubmitAsSingleShot(AsyncRequest& request, bool& continueProcessing)
+    {
+        KernelQueueIoURing& queue = getQueue(*request.eventLoop);
+        switch (request.type)
+        {
+        case AsyncRequest::Type::SocketAccept:
+            queue.supportsMultishotAccept = false;
+            continueProcessing            = false;
+            return activateAsync(static_cast<AsyncSocketAccept&>(request));
+        case AsyncRequest::Type::SocketReceive:
+            queue.supportsMultishotReceive = false;
+            continueProcessing             = false;
+            return activateAsync(static_cast<AsyncSocketReceive&>(request));
+        default: break;
+        }
+        return Result(true); // Zero-copy send is probed reliably, so EINVAL is a genuine error
+    }
+
+    // A batch of datagrams generates one completion for each datagram, so only the last one is processed
+    [[nodiscard]] static Result validateSendToEvent(AsyncSocketSendTo& async, const io_uring_cqe& completion,
+                                                    bool& continueProcessing)
+    {
+        if (async.batchResult >= 0)
+        {
+            async.batchResult = completion.res < 0 ? completion.res : async.batchResult + completion.res;
+        }
+        SC_TRY_MSG(async.pendingCompletions > 0, "AsyncSocketSendTo - Unexpected completion");
+        async.pendingCompletions -= 1;
+        continueProcessing = async.pendingCompletions == 0;
+        return Result(true);
+    }
+
+    template <typename T>
+    [[nodiscard]] Result teardownMultishot(T& async)
+    {
+        if ((async.flags & Internal::Flag_Multishot) and async.state != AsyncRequest::State::Cancelling)
+        {
+            // Request has not been reactivated but kernel is still armed: cancel it and keep the request busy
+            // until its last completion arrives (see validateMultishotEvent)
+            SC_TRY(cancelAsync(async));
+            async.eventLoop->internal.waitCancellationCompletion(async);
+        }
+        return Result(true);
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    // AsyncBufferPool
+    //-------------------------------------------------------------------------------------------------------
+    static void selectBufferFrom(AsyncBufferPool& pool, io_uring_sqe* submission)
+    {
+        submission->flags |= IOSQE_BUFFER_SELECT;
+        submission->buf_group = pool.groupId;
+    }
+
+    [[nodiscard]] Result acquireSelectedBuffer(AsyncBufferPool& pool, int32_t eventIndex, Span<char>& buffer,
+                                               int32_t& bufferIndex)
+    {
+        const io_uring_cqe& completion = events[eventIndex];
+        if ((completion.flags & IORING_CQE_F_BUFFER) == 0)
+        {
+            // No buffer is consumed when no data has been read (for example on socket / file EOF)
+            buffer = {};
+            return Result(true);
+        }
+        const uint32_t selectedBuffer = completion.flags >> IORING_CQE_BUFFER_SHIFT;
+        SC_TRY(pool.acquireSelected(selectedBuffer, buffer));
+        bufferIndex = static_cast<int32_t>(selectedBuffer);
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // TIMEOUT
     //-------------------------------------------------------------------------------------------------------
@@ -362,13 +672,24 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        struct sockaddr* sockAddr = &async.sockAddrHandle.reinterpret_as<struct sockaddr>();
-        async.sockAddrLen         = sizeof(struct sockaddr);
-        globalLibURing.io_uring_prep_accept(submission, async.handle, sockAddr, &async.sockAddrLen, SOCK_CLOEXEC);
+        if (getQueue(*async.eventLoop).supportsMultishotAccept and not Internal::supportsDeadline(async))
+        {
+            // A single submission accepts all incoming connections (peer address is not needed by completeAsync)
+            globalLibURing.io_uring_prep_multishot_accept(submission, async.handle, nullptr, nullptr, SOCK_CLOEXEC);
+            async.flags |= Internal::Flag_Multishot;
+        }
+        else
+        {
+            struct sockaddr* sockAddr = &async.sockAddrHandle.reinterpret_as<struct sockaddr>();
+            async.sockAddrLen         = sizeof(struct sockaddr);
+            globalLibURing.io_uring_prep_accept(submission, async.handle, sockAddr, &async.sockAddrLen, SOCK_CLOEXEC);
+        }
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
 
+    [[nodiscard]] Result teardownAsync(AsyncSocketAccept& async) { return teardownMultishot(async); }
+
     [[nodiscard]] Result completeAsync(AsyncSocketAccept::Result& res)
     {
         return res.completionData.acceptedClient.assign(events[res.getAsync().eventIndex].res);
@@ -400,16 +721,45 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        globalLibURing.io_uring_prep_send(submission, async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+        if (not async.buffers.empty())
+        {
+            // IORING_OP_WRITEV works on sockets too, avoiding keeping a msghdr alive until completion.
+            // It has no zero-copy variant, so zeroCopy is ignored for vectored sends (see AsyncSocketSend::zeroCopy)
+            const struct iovec* iov;
+            int                 iovCount;
+            SC_TRY(KernelEventsPosix::toIOVec(async.buffers, iov, iovCount));
+            globalLibURing.io_uring_prep_writev(submission, async.handle, iov, static_cast<unsigned>(iovCount), 0);
+        }
+        else if (async.zeroCopy and getQueue(*async.eventLoop).supportsZeroCopySend and
+                 not Internal::supportsDeadline(async))
+        {
+            // Generates two completions: the send result and the buffer release notification (IORING_CQE_F_NOTIF),
+            // reusing multishot logic to wait for the last one (see validateEvent)
+            globalLibURing.io_uring_prep_send_zc(submission, async.handle, async.buffer.data(),
+                                                 async.buffer.sizeInBytes(), 0, 0);
+            async.flags |= Internal::Flag_Multishot;
+        }
+        else
+        {
+            globalLibURing.io_uring_prep_send(submission, async.handle, async.buffer.data(),
+                                              async.buffer.sizeInBytes(), 0);
+        }
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
 
     [[nodiscard]] Result completeAsync(AsyncSocketSend::Result& result)
     {
-        result.completionData.numBytes = static_cast<size_t>(events[result.getAsync().eventIndex].res);
-        SC_TRY_MSG(result.completionData.numBytes == result.getAsync().buffer.sizeInBytes(),
-                   "send didn't send all data");
+        const io_uring_cqe& completion = events[result.getAsync().eventIndex];
+        const bool          notification = (completion.flags & IORING_CQE_F_NOTIF) != 0;
+        const int64_t       res          = notification ? result.getAsync().zeroCopyResult : completion.res;
+        SC_TRY_MSG(res >= 0, "error in send");
+        result.completionData.numBytes = static_cast<size_t>(res);
+
+        const AsyncSocketSend& async      = result.getAsync();
+        const size_t           totalBytes = async.buffers.empty() ? async.buffer.sizeInBytes()
+                                                                   : Internal::sizeOfBuffers(async.buffers);
+        SC_TRY_MSG(result.completionData.numBytes == totalBytes, "send didn't send all data");
         return Result(true);
     }
 
@@ -420,14 +770,117 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        globalLibURing.io_uring_prep_recv(submission, async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+        if (async.bufferPool and getQueue(*async.eventLoop).supportsMultishotReceive and
+            not Internal::supportsDeadline(async))
+        {
+            // Multishot receive requires provided buffers and a zero length (kernel uses the selected buffer size)
+            globalLibURing.io_uring_prep_recv_multishot(submission, async.handle, nullptr, 0, 0);
+            selectBufferFrom(*async.bufferPool, submission);
+            async.flags |= Internal::Flag_Multishot;
+        }
+        else if (async.bufferPool)
+        {
+            globalLibURing.io_uring_prep_recv(submission, async.handle, nullptr, async.bufferPool->bufferSize, 0);
+            selectBufferFrom(*async.bufferPool, submission);
+        }
+        else
+        {
+            globalLibURing.io_uring_prep_recv(submission, async.handle, async.buffer.data(),
+                                              async.buffer.sizeInBytes(), 0);
+        }
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
 
     [[nodiscard]] Result completeAsync(AsyncSocketReceive::Result& result)
     {
-        result.completionData.numBytes = static_cast<size_t>(events[result.getAsync().eventIndex].res);
+        AsyncSocketReceive& async = result.getAsync();
+        if (async.bufferPool)
+        {
+            SC_TRY(acquireSelectedBuffer(*async.bufferPool, async.eventIndex, async.buffer, async.bufferIndex));
+        }
+        result.completionData.numBytes = static_cast<size_t>(events[async.eventIndex].res);
+        return Result(true);
+    }
+
+    [[nodiscard]] Result teardownAsync(AsyncSocketReceive& async) { return teardownMultishot(async); }
+
+    //-------------------------------------------------------------------------------------------------------
+    // Socket SEND TO
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] Result activateAsync(AsyncSocketSendTo& async)
+    {
+        // io_uring has no sendmmsg equivalent, but all datagrams are pushed to the kernel with a single submit
+        async.batchResult        = 0;
+        async.pendingCompletions = 0;
+        for (AsyncSocketSendTo::Datagram& datagram : async.datagrams)
+        {
+            io_uring_sqe* submission;
+            SC_TRY(getNewSubmission(async, submission));
+            globalLibURing.io_uring_prep_sendmsg(submission, async.handle,
+                                                 &KernelEventsPosix::prepareMessage(datagram, async.segmentSize), 0);
+            globalLibURing.io_uring_sqe_set_data(submission, &async);
+            async.pendingCompletions += 1;
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result cancelAsync(AsyncSocketSendTo& async)
+    {
+        io_uring_sqe* submission;
+        SC_TRY(getNewSubmission(async, submission));
+        // Cancels all datagrams of the batch still in flight
+        globalLibURing.io_uring_prep_cancel(submission, &async, IORING_ASYNC_CANCEL_ALL);
+        return Result(true);
+    }
+
+    [[nodiscard]] Result completeAsync(AsyncSocketSendTo::Result& result)
+    {
+        const AsyncSocketSendTo& async = result.getAsync();
+        SC_TRY_MSG(async.batchResult >= 0, "error in sendmsg");
+        result.completionData.numBytes = static_cast<size_t>(async.batchResult);
+
+        size_t totalBytes = 0;
+        for (const AsyncSocketSendTo::Datagram& datagram : async.datagrams)
+        {
+            totalBytes += datagram.data.sizeInBytes();
+        }
+        SC_TRY_MSG(result.completionData.numBytes == totalBytes, "sendmsg didn't send all data");
+        return Result(true);
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    // Socket RECEIVE FROM
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] Result setupAsync(AsyncSocketReceiveFrom& async)
+    {
+        if (async.coalesce)
+        {
+            SC_TRY(KernelEventsPosix::enableCoalescing(async.handle));
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result activateAsync(AsyncSocketReceiveFrom& async)
+    {
+        io_uring_sqe* submission;
+        SC_TRY(getNewSubmission(async, submission));
+        // A single datagram is received for each completion, unless coalesced by GRO
+        AsyncSocketReceiveFrom::Datagram& datagram = async.datagrams[0];
+        globalLibURing.io_uring_prep_recvmsg(submission, async.handle,
+                                             &KernelEventsPosix::prepareMessage(datagram, async.coalesce), 0);
+        globalLibURing.io_uring_sqe_set_data(submission, &async);
+        return Result(true);
+    }
+
+    [[nodiscard]] Result completeAsync(AsyncSocketReceiveFrom::Result& result)
+    {
+        AsyncSocketReceiveFrom&           async    = result.getAsync();
+        AsyncSocketReceiveFrom::Datagram& datagram = async.datagrams[0];
+
+        const struct msghdr& header = datagram.message.reinterpret_as<KernelEventsPosix::DatagramMessage>().header;
+        KernelEventsPosix::completeMessage(datagram, header, static_cast<size_t>(events[async.eventIndex].res));
+        result.completionData.numDatagrams = 1;
         return Result(true);
     }
 
@@ -456,15 +909,29 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        globalLibURing.io_uring_prep_read(submission, async.fileDescriptor, async.buffer.data(),
-                                          async.buffer.sizeInBytes(), async.offset);
+        if (async.bufferPool)
+        {
+            globalLibURing.io_uring_prep_read(submission, async.fileDescriptor, nullptr, async.bufferPool->bufferSize,
+                                              async.offset);
+            selectBufferFrom(*async.bufferPool, submission);
+        }
+        else
+        {
+            globalLibURing.io_uring_prep_read(submission, async.fileDescriptor, async.buffer.data(),
+                                              async.buffer.sizeInBytes(), async.offset);
+        }
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
 
     [[nodiscard]] Result completeAsync(AsyncFileRead::Result& result)
     {
-        result.completionData.numBytes = static_cast<size_t>(events[result.getAsync().eventIndex].res);
+        AsyncFileRead& async = result.getAsync();
+        if (async.bufferPool)
+        {
+            SC_TRY(acquireSelectedBuffer(*async.bufferPool, async.eventIndex, async.buffer, async.bufferIndex));
+        }
+        result.completionData.numBytes = static_cast<size_t>(events[async.eventIndex].res);
         return Result(true);
     }
 
@@ -475,17 +942,33 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        globalLibURing.io_uring_prep_write(submission, async.fileDescriptor, async.buffer.data(),
-                                           async.buffer.sizeInBytes(), 0);
+        // Like on epoll, a zero offset means writing at (and advancing) the current file position
+        const uint64_t offset = async.offset == 0 ? static_cast<uint64_t>(-1) : async.offset;
+        if (not async.buffers.empty())
+        {
+            const struct iovec* iov;
+            int                 iovCount;
+            SC_TRY(KernelEventsPosix::toIOVec(async.buffers, iov, iovCount));
+            globalLibURing.io_uring_prep_writev(submission, async.fileDescriptor, iov, static_cast<unsigned>(iovCount),
+                                                offset);
+        }
+        else
+        {
+            globalLibURing.io_uring_prep_write(submission, async.fileDescriptor, async.buffer.data(),
+                                               async.buffer.sizeInBytes(), offset);
+        }
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
 
     [[nodiscard]] Result completeAsync(AsyncFileWrite::Result& result)
     {
-        const size_t numBytes          = static_cast<size_t>(events[result.getAsync().eventIndex].res);
+        const AsyncFileWrite& async      = result.getAsync();
+        const size_t          numBytes   = static_cast<size_t>(events[async.eventIndex].res);
+        const size_t          totalBytes = async.buffers.empty() ? async.buffer.sizeInBytes()
+                                                                 : Internal::sizeOfBuffers(async.buffers);
         result.completionData.numBytes = numBytes;
-        return Result(numBytes == result.getAsync().buffer.sizeInBytes());
+        return Result(numBytes == totalBytes);
     }
 
     //-------------------------------------------------------------------------------------------------------
@@ -530,6 +1013,89 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
         return Result(true);
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    // File SEND
+    //-------------------------------------------------------------------------------------------------------
+    static constexpr size_t SplicePipeSize = 64 * 1024; // Default Linux pipe capacity
+
+    [[nodiscard]] Result setupAsync(AsyncFileSend& async)
+    {
+        // Splicing past end of file would leave the pipe -> socket splice blocked forever waiting for data
+        struct stat fileStat;
+        SC_TRY_MSG(::fstat(async.fileHandle, &fileStat) == 0, "AsyncFileSend - fstat failed");
+        SC_TRY_MSG(async.offset + async.length <= static_cast<uint64_t>(fileStat.st_size),
+                   "AsyncFileSend - Range exceeds file size");
+        async.splicePipeBytes = 0;
+        // The pipe is kept across restarts of the request, unless a stopped send has left some data in it
+        int pipeRead;
+        if (async.splicePipe.readPipe.get(pipeRead, Result(false)))
+        {
+            int pipeBytes = 0;
+            SC_TRY_MSG(::ioctl(pipeRead, FIONREAD, &pipeBytes) == 0, "AsyncFileSend - FIONREAD failed");
+            if (pipeBytes == 0)
+            {
+                return Result(true);
+            }
+            SC_TRY(async.splicePipe.close());
+        }
+        return async.splicePipe.createPipe();
+    }
+
+    [[nodiscard]] Result activateAsync(AsyncFileSend& async)
+    {
+        io_uring_sqe* submission;
+        SC_TRY(getNewSubmission(async, submission));
+        if (async.splicePipeBytes == 0)
+        {
+            // Read next chunk from file into the pipe. The pipe -> socket splice is submitted when this one completes
+            // (see validateFileSendFill), as linking them would cancel the send after a short read.
+            int pipeWrite;
+            SC_TRY(async.splicePipe.writePipe.get(pipeWrite, Result::Error("AsyncFileSend - Invalid pipe")));
+            const size_t numBytes = async.length < SplicePipeSize ? async.length : SplicePipeSize;
+            globalLibURing.io_uring_prep_splice(submission, async.fileHandle, static_cast<int64_t>(async.offset),
+                                                pipeWrite, -1, static_cast<unsigned>(numBytes), 0);
+            async.flags |= Internal::Flag_FileSendFilling;
+        }
+        else
+        {
+            // Send data read from file (or left in the pipe by a partial send) from the pipe to the socket
+            int pipeRead;
+            SC_TRY(async.splicePipe.readPipe.get(pipeRead, Result::Error("AsyncFileSend - Invalid pipe")));
+            globalLibURing.io_uring_prep_splice(submission, pipeRead, -1, async.socketHandle, -1,
+                                                static_cast<unsigned>(async.splicePipeBytes), 0);
+        }
+        globalLibURing.io_uring_sqe_set_data(submission, &async);
+        return Result(true);
+    }
+
+    [[nodiscard]] Result validateFileSendFill(AsyncFileSend& async, const io_uring_cqe& completion,
+                                              bool& continueProcessing)
+    {
+        async.flags &= ~Internal::Flag_FileSendFilling;
+        if (completion.res < 0 or async.state != AsyncRequest::State::Active)
+        {
+            return Result(true); // Errors and completions of stopped requests are handled by validateEvent
+        }
+        SC_TRY_MSG(completion.res > 0, "AsyncFileSend - splice reached end of file");
+        async.offset += static_cast<size_t>(completion.res);
+        async.splicePipeBytes = static_cast<size_t>(completion.res);
+        continueProcessing    = false; // Callback is invoked when the pipe -> socket splice completes
+        return activateWithDeadline(async);
+    }
+
+    [[nodiscard]] Result completeAsync(AsyncFileSend::Result& result)
+    {
+        AsyncFileSend& async     = result.getAsync();
+        const size_t   sentBytes = static_cast<size_t>(events[async.eventIndex].res);
+        SC_TRY_MSG(sentBytes > 0, "AsyncFileSend - splice sent no data");
+        async.splicePipeBytes -= sentBytes;
+        async.length -= sentBytes;
+
+        result.completionData.numBytes       = sentBytes;
+        result.completionData.remainingBytes = async.length;
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // Process EXIT
     //-------------------------------------------------------------------------------------------------------
@@ -558,9 +1124,58 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     //-------------------------------------------------------------------------------------------------------
     // Templates
     //-------------------------------------------------------------------------------------------------------
+    template <typename T>
+    [[nodiscard]] Result activateWithDeadline(T& async)
+    {
+        async.flags &= ~Internal::Flag_DeadlineLinked;
+        if (not Internal::supportsDeadline(async))
+        {
+            return activateAsync(async);
+        }
+        // The linked timeout must be submitted in the same batch of the request, so enough space must be reserved
+        // for the request submission plus the IORING_OP_LINK_TIMEOUT.
+        io_uring&      ring      = getRing(*async.eventLoop);
+        const unsigned ringUsed  = ring.sq.sqe_tail - __atomic_load_n(ring.sq.khead, __ATOMIC_ACQUIRE);
+        const unsigned spaceLeft = *ring.sq.kring_entries - ringUsed;
+        if (spaceLeft < 2)
+        {
+            SC_TRY(flushSubmissions(*async.eventLoop, Internal::SyncMode::NoWait));
+        }
+        const unsigned firstTail = ring.sq.sqe_tail;
+        SC_TRY(activateAsync(async));
+        const unsigned numSubmissions = ring.sq.sqe_tail - firstTail;
+        if (numSubmissions == 0 or (async.type == AsyncRequest::Type::SocketSendTo and numSubmissions > 1))
+        {
+            // A link timeout can only cancel the submission preceding it, so deadline of multiple datagrams sent
+            // independently is checked by the loop each time it wakes up (see invokeExpiredDeadlines)
+            return Result(true);
+        }
+        io_uring_sqe& lastSubmission = ring.sq.sqes[(ring.sq.sqe_tail - 1) & *ring.sq.kring_mask];
+        if (lastSubmission.user_data != reinterpret_cast<__u64>(&async))
+        {
+            return Result(true);
+        }
+        // Flags must be set after io_uring_prep_xxx, that clears them
+        lastSubmission.flags |= IOSQE_IO_LINK;
+        io_uring_sqe* submission;
+        SC_TRY(getNewSubmission(async, submission));
+        // Like AsyncLoopTimeout, deadlineTime layout is the same as __kernel_timespec and lives in the tracking slot
+        // of the request (that is never moved). When it expires the request completes with ECANCELED, otherwise the
+        // timeout itself is cancelled. Both completions of the timeout have nullptr user_data so they're skipped.
+        struct __kernel_timespec* ts = reinterpret_cast<struct __kernel_timespec*>(&async.trackingSlot->deadlineTime);
+        globalLibURing.io_uring_prep_link_timeout(submission, ts, IORING_TIMEOUT_ABS);
+        globalLibURing.io_uring_sqe_set_data(submission, nullptr);
+        async.flags |= Internal::Flag_DeadlineLinked;
+        return Result(true);
+    }
+
     template <typename T>
     [[nodiscard]] Result cancelAsync(T& async)
     {
+        if (async.flags & Internal::Flag_KernelCancelled)
+        {
+            return Result(true); // Already cancelled with all requests of its descriptor (see cancelAllRequestsFor)
+        }
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
         globalLibURing.io_uring_prep_cancel(submission, &async, 0);
@@ -616,13 +1231,13 @@ SC::Result SC::AsyncEventLoop::Internal::KernelQueue::createEventLoop(AsyncEvent
         isEpoll = true;
         placementNew(storage.reinterpret_as<KernelQueuePosix>());
     }
-    else if (options.apiType == AsyncEventLoop::Options::ApiType::ForceUseEpoll and isEpoll)
+    else if (options.apiType == AsyncEventLoop::Options::ApiType::ForceUseIOURing and isEpoll)
     {
         storage.reinterpret_as<KernelQueuePosix>().~KernelQueuePosix();
         isEpoll = false;
         placementNew(storage.reinterpret_as<KernelQueueIoURing>());
     }
-    return isEpoll ? getPosix().createEventLoop() : getUring().createEventLoop();
+    return isEpoll ? getPosix().createEventLoop() : getUring().createEventLoop(options);
 }
 
 SC::Result SC::AsyncEventLoop::Internal::KernelQueue::createSharedWatchers(AsyncEventLoop& eventLoop)
@@ -635,6 +1250,29 @@ SC::Result SC::AsyncEventLoop::Internal::KernelQueue::wakeUpFromExternalThread()
     return isEpoll ? getPosix().wakeUpFromExternalThread() : getUring().wakeUpFromExternalThread();
 }
 
+SC::Result SC::AsyncEventLoop::Internal::KernelQueue::createBufferPool(AsyncBufferPool& pool)
+{
+    return isEpoll ? getPosix().createBufferPool(pool) : getUring().createBufferPool(pool);
+}
+
+SC::Result SC::AsyncEventLoop::Internal::KernelQueue::closeBufferPool(AsyncBufferPool& pool)
+{
+    return isEpoll ? getPosix().closeBufferPool(pool) : getUring().closeBufferPool(pool);
+}
+
+SC::Result SC::AsyncEventLoop::Internal::KernelQueue::provideBuffers(AsyncBufferPool& pool, uint32_t firstBuffer,
+                                                                     uint32_t numBuffers)
+{
+    return isEpoll ? getPosix().provideBuffers(pool, firstBuffer, numBuffers)
+                   : getUring().provideBuffers(pool, firstBuffer, numBuffers);
+}
+
+SC::Result SC::AsyncEventLoop::Internal::KernelQueue::cancelAllRequestsFor(int handle, bool& cancelledByKernel)
+{
+    return isEpoll ? getPosix().cancelAllRequestsFor(handle, cancelledByKernel)
+                   : getUring().cancelAllRequestsFor(handle, cancelledByKernel);
+}
+
 //----------------------------------------------------------------------------------------
 // AsyncEventLoop::Internal::KernelEvents
 //----------------------------------------------------------------------------------------
@@ -689,6 +1327,12 @@ SC::Result SC::AsyncEventLoop::Internal::KernelEvents::validateEvent(uint32_t& i
                    : getUring().validateEvent(idx, continueProcessing);
 }
 
+bool SC::AsyncEventLoop::Internal::KernelEvents::receivesCancellationCompletion(AsyncRequest& async)
+{
+    return isEpoll ? getPosix().receivesCancellationCompletion(async)
+                   : getUring().receivesCancellationCompletion(async);
+}
+
 SC::AsyncRequest* SC::AsyncEventLoop::Internal::KernelEvents::getAsyncRequest(uint32_t idx)
 {
     return isEpoll ? getPosix().getAsyncRequest(idx) : getUring().getAsyncRequest(idx);
@@ -697,7 +1341,7 @@ SC::AsyncRequest* SC::AsyncEventLoop::Internal::KernelEvents::getAsyncRequest(ui
 // clang-format off
 template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::setupAsync(T& async)    { return isEpoll ? getPosix().setupAsync(async) : getUring().setupAsync(async); }
 template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::teardownAsync(T& async) { return isEpoll ? getPosix().teardownAsync(async) : getUring().teardownAsync(async); }
-template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::activateAsync(T& async) { return isEpoll ? getPosix().activateAsync(async) : getUring().activateAsync(async); }
+template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::activateAsync(T& async) { return isEpoll ? getPosix().activateAsync(async) : getUring().activateWithDeadline(async); }
 template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::completeAsync(T& async) { return isEpoll ? getPosix().completeAsync(async) : getUring().completeAsync(async); }
 template <typename T>  SC::Result SC::AsyncEventLoop::Internal::KernelEvents::cancelAsync(T& async)   { return isEpoll ? getPosix().cancelAsync(async) : getUring().cancelAsync(async); }
 
@@ -9,6 +9,7 @@ struct AsyncLinuxAPI
 
     void (*io_uring_queue_exit)(struct io_uring* ring)                                                     = nullptr;
     int (*io_uring_queue_init)(unsigned entries, struct io_uring* ring, unsigned flags)                    = nullptr;
+    int (*io_uring_queue_init_params)(unsigned entries, struct io_uring* ring, struct io_uring_params* p)  = nullptr;
     struct io_uring_sqe* (*io_uring_get_sqe)(struct io_uring* ring)                                        = nullptr;
     unsigned (*io_uring_peek_batch_cqe)(struct io_uring* ring, struct io_uring_cqe** cqes, unsigned count) = nullptr;
     int (*io_uring_submit)(struct io_uring* ring)                                                          = nullptr;
@@ -29,6 +30,7 @@ struct AsyncLinuxAPI
         // clang-format off
         io_uring_queue_exit = reinterpret_cast<decltype(io_uring_queue_exit)>(::dlsym(liburingHandle, "io_uring_queue_exit"));
         io_uring_queue_init = reinterpret_cast<decltype(io_uring_queue_init)>(::dlsym(liburingHandle, "io_uring_queue_init"));
+        io_uring_queue_init_params = reinterpret_cast<decltype(io_uring_queue_init_params)>(::dlsym(liburingHandle, "io_uring_queue_init_params"));
         io_uring_get_sqe = reinterpret_cast<decltype(io_uring_get_sqe)>(::dlsym(liburingHandle, "io_uring_get_sqe"));
         io_uring_peek_batch_cqe = reinterpret_cast<decltype(io_uring_peek_batch_cqe)>(::dlsym(liburingHandle, "io_uring_peek_batch_cqe"));
         io_uring_submit = reinterpret_cast<decltype(io_uring_submit)>(::dlsym(liburingHandle, "io_uring_submit"));
@@ -86,16 +88,29 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
                                            
     void (*io_uring_prep_connect)(struct io_uring_sqe* sqe, int fd, const struct sockaddr* addr, socklen_t addrlen) = nullptr;
     void (*io_uring_prep_send)(struct io_uring_sqe* sqe, int sockfd, const void* buf, size_t len, int flags) = nullptr;
+    void (*io_uring_prep_send_zc)(struct io_uring_sqe* sqe, int sockfd, const void* buf, size_t len, int flags, unsigned zc_flags) = nullptr;
     void (*io_uring_prep_recv)(struct io_uring_sqe* sqe, int sockfd, void* buf, size_t len, int flags) = nullptr;
+    void (*io_uring_prep_sendmsg)(struct io_uring_sqe* sqe, int fd, const struct msghdr* msg, unsigned flags) = nullptr;
+    void (*io_uring_prep_recvmsg)(struct io_uring_sqe* sqe, int fd, struct msghdr* msg, unsigned flags) = nullptr;
 
     void (*io_uring_prep_close)(struct io_uring_sqe* sqe, int fd) = nullptr;
 
     void (*io_uring_prep_read)(struct io_uring_sqe* sqe, int fd, void* buf, unsigned nbytes, __u64 offset) = nullptr;
     void (*io_uring_prep_write)(struct io_uring_sqe* sqe, int fd, const void* buf, unsigned nbytes, __u64 offset) = nullptr;
+    void (*io_uring_prep_writev)(struct io_uring_sqe* sqe, int fd, const struct iovec* iovecs, unsigned nr_vecs, __u64 offset) = nullptr;
+    void (*io_uring_prep_splice)(struct io_uring_sqe* sqe, int fd_in, int64_t off_in, int fd_out, int64_t off_out, unsigned nbytes, unsigned splice_flags) = nullptr;
 
     void (*io_uring_prep_poll_add)(struct io_uring_sqe* sqe, int fd, unsigned poll_mask) = nullptr;
     void (*io_uring_prep_poll_remove)(struct io_uring_sqe* sqe, void* user_data) = nullptr;
     void (*io_uring_prep_cancel)(struct io_uring_sqe* sqe, void* user_data, int flags) = nullptr;
+    void (*io_uring_prep_cancel_fd)(struct io_uring_sqe* sqe, int fd, unsigned int flags) = nullptr;
+    void (*io_uring_prep_link_timeout)(struct io_uring_sqe* sqe, struct __kernel_timespec* ts, unsigned flags) = nullptr;
+
+    void (*io_uring_prep_multishot_accept)(struct io_uring_sqe* sqe, int fd, struct sockaddr* addr, socklen_t* addrlen, int flags) = nullptr;
+    void (*io_uring_prep_recv_multishot)(struct io_uring_sqe* sqe, int sockfd, void* buf, size_t len, int flags) = nullptr;
+
+    void (*io_uring_prep_provide_buffers)(struct io_uring_sqe* sqe, void* addr, int len, int nr, int bgid, int bid) = nullptr;
+    void (*io_uring_prep_remove_buffers)(struct io_uring_sqe* sqe, int nr, int bgid) = nullptr;
     // clang-format on
     AsyncLinuxLibURingLoader()
     {
@@ -107,13 +122,26 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
         this->io_uring_prep_accept         = &::io_uring_prep_accept;
         this->io_uring_prep_connect        = &::io_uring_prep_connect;
         this->io_uring_prep_send           = &::io_uring_prep_send;
+        this->io_uring_prep_send_zc        = &::io_uring_prep_send_zc;
         this->io_uring_prep_recv           = &::io_uring_prep_recv;
+        this->io_uring_prep_sendmsg        = &::io_uring_prep_sendmsg;
+        this->io_uring_prep_recvmsg        = &::io_uring_prep_recvmsg;
         this->io_uring_prep_close          = &::io_uring_prep_close;
         this->io_uring_prep_read           = &::io_uring_prep_read;
         this->io_uring_prep_write          = &::io_uring_prep_write;
+        this->io_uring_prep_writev         = &::io_uring_prep_writev;
+        this->io_uring_prep_splice         = &::io_uring_prep_splice;
         this->io_uring_prep_poll_add       = &::io_uring_prep_poll_add;
         this->io_uring_prep_poll_remove    = &::io_uring_prep_poll_remove;
         this->io_uring_prep_cancel         = &::io_uring_prep_cancel;
+        this->io_uring_prep_cancel_fd      = &::io_uring_prep_cancel_fd;
+        this->io_uring_prep_link_timeout   = &::io_uring_prep_link_timeout;
+
+        this->io_uring_prep_multishot_accept = &::io_uring_prep_multishot_accept;
+        this->io_uring_prep_recv_multishot   = &::io_uring_prep_recv_multishot;
+
+        this->io_uring_prep_provide_buffers = &::io_uring_prep_provide_buffers;
+        this->io_uring_prep_remove_buffers  = &::io_uring_prep_remove_buffers;
     }
 };
 
@@ -131,6 +159,29 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
 #include <linux/io_uring.h>   // io_uring
 #include <linux/time_types.h> // __kernel_timespec
 
+// Defined only by kernel headers >= 5.19 / 6.0 (multishot accept / recv, coop taskrun / single issuer)
+#ifndef IORING_SETUP_COOP_TASKRUN
+#define IORING_SETUP_COOP_TASKRUN (1U << 8)
+#endif
+#ifndef IORING_SETUP_SINGLE_ISSUER
+#define IORING_SETUP_SINGLE_ISSUER (1U << 12)
+#endif
+#ifndef IORING_CQE_F_NOTIF
+#define IORING_CQE_F_NOTIF (1U << 3)
+#endif
+#ifndef IORING_ACCEPT_MULTISHOT
+#define IORING_ACCEPT_MULTISHOT (1U << 0)
+#endif
+#ifndef IORING_RECV_MULTISHOT
+#define IORING_RECV_MULTISHOT (1U << 1)
+#endif
+#ifndef IORING_ASYNC_CANCEL_ALL
+#define IORING_ASYNC_CANCEL_ALL (1U << 0)
+#endif
+#ifndef IORING_ASYNC_CANCEL_FD
+#define IORING_ASYNC_CANCEL_FD (1U << 1)
+#endif
+
 struct io_uring_sq
 {
     unsigned* khead;
@@ -246,6 +297,13 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
         sqe->accept_flags = (__u32)flags;
     }
 
+    static inline void io_uring_prep_multishot_accept(struct io_uring_sqe* sqe, int fd, struct sockaddr* addr,
+                                                      socklen_t* addrlen, int flags)
+    {
+        io_uring_prep_accept(sqe, fd, addr, addrlen, flags);
+        sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+    }
+
     static inline void io_uring_prep_connect(struct io_uring_sqe* sqe, int fd, const struct sockaddr* addr,
                                              socklen_t addrlen)
     {
@@ -258,12 +316,40 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
         sqe->msg_flags = (__u32)flags;
     }
 
+    static inline void io_uring_prep_send_zc(struct io_uring_sqe* sqe, int sockfd, const void* buf, size_t len,
+                                             int flags, unsigned zc_flags)
+    {
+        io_uring_prep_rw(IORING_OP_SEND_ZC, sqe, sockfd, buf, (__u32)len, 0);
+        sqe->msg_flags = (__u32)flags;
+        sqe->ioprio    = (__u16)zc_flags;
+    }
+
     static inline void io_uring_prep_recv(struct io_uring_sqe* sqe, int sockfd, void* buf, size_t len, int flags)
     {
         io_uring_prep_rw(IORING_OP_RECV, sqe, sockfd, buf, (__u32)len, 0);
         sqe->msg_flags = (__u32)flags;
     }
 
+    static inline void io_uring_prep_sendmsg(struct io_uring_sqe* sqe, int fd, const struct msghdr* msg,
+                                             unsigned flags)
+    {
+        io_uring_prep_rw(IORING_OP_SENDMSG, sqe, fd, msg, 1, 0);
+        sqe->msg_flags = flags;
+    }
+
+    static inline void io_uring_prep_recvmsg(struct io_uring_sqe* sqe, int fd, struct msghdr* msg, unsigned flags)
+    {
+        io_uring_prep_rw(IORING_OP_RECVMSG, sqe, fd, msg, 1, 0);
+        sqe->msg_flags = flags;
+    }
+
+    static inline void io_uring_prep_recv_multishot(struct io_uring_sqe* sqe, int sockfd, void* buf, size_t len,
+                                                    int flags)
+    {
+        io_uring_prep_recv(sqe, sockfd, buf, len, flags);
+        sqe->ioprio |= IORING_RECV_MULTISHOT;
+    }
+
     static inline void io_uring_prep_close(struct io_uring_sqe* sqe, int fd)
     {
         io_uring_prep_rw(IORING_OP_CLOSE, sqe, fd, NULL, 0, 0);
@@ -280,6 +366,21 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
         io_uring_prep_rw(IORING_OP_WRITE, sqe, fd, buf, nbytes, offset);
     }
 
+    static inline void io_uring_prep_writev(struct io_uring_sqe* sqe, int fd, const struct iovec* iovecs,
+                                            unsigned nr_vecs, __u64 offset)
+    {
+        io_uring_prep_rw(IORING_OP_WRITEV, sqe, fd, iovecs, nr_vecs, offset);
+    }
+
+    static inline void io_uring_prep_splice(struct io_uring_sqe* sqe, int fd_in, int64_t off_in, int fd_out,
+                                            int64_t off_out, unsigned nbytes, unsigned splice_flags)
+    {
+        io_uring_prep_rw(IORING_OP_SPLICE, sqe, fd_out, NULL, nbytes, (__u64)off_out);
+        sqe->splice_off_in = (__u64)off_in;
+        sqe->splice_fd_in  = fd_in;
+        sqe->splice_flags  = splice_flags;
+    }
+
     static inline unsigned static__io_uring_prep_poll_mask(unsigned poll_mask)
     {
 #if __BYTE_ORDER == __BIG_ENDIAN
@@ -304,6 +405,32 @@ struct AsyncLinuxLibURingLoader : public AsyncLinuxAPI
         io_uring_prep_rw(IORING_OP_ASYNC_CANCEL, sqe, -1, user_data, 0, 0);
         sqe->cancel_flags = (__u32)flags;
     }
+
+    static inline void io_uring_prep_cancel_fd(struct io_uring_sqe* sqe, int fd, unsigned int flags)
+    {
+        io_uring_prep_rw(IORING_OP_ASYNC_CANCEL, sqe, fd, NULL, 0, 0);
+        sqe->cancel_flags = (__u32)flags | IORING_ASYNC_CANCEL_FD;
+    }
+
+    static inline void io_uring_prep_link_timeout(struct io_uring_sqe* sqe, struct __kernel_timespec* ts,
+                                                  unsigned flags)
+    {
+        io_uring_prep_rw(IORING_OP_LINK_TIMEOUT, sqe, -1, ts, 1, 0);
+        sqe->timeout_flags = flags;
+    }
+
+    static inline void io_uring_prep_provide_buffers(struct io_uring_sqe* sqe, void* addr, int len, int nr, int bgid,
+                                                     int bid)
+    {
+        io_uring_prep_rw(IORING_OP_PROVIDE_BUFFERS, sqe, nr, addr, (unsigned)len, (__u64)bid);
+        sqe->buf_group = (__u16)bgid;
+    }
+
+    static inline void io_uring_prep_remove_buffers(struct io_uring_sqe* sqe, int nr, int bgid)
+    {
+        io_uring_prep_rw(IORING_OP_REMOVE_BUFFERS, sqe, nr, NULL, 0, 0);
+        sqe->buf_group = (__u16)bgid;
+    }
 };
 
 #endif
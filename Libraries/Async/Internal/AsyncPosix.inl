@@ -5,14 +5,21 @@
 
 #include "../../Foundation/Deferred.h"
 
+#include <limits.h>  // IOV_MAX
+#include <sys/uio.h> // writev / pwritev
+
 #if SC_ASYNC_USE_EPOLL
 
-#include <errno.h>        // For error handling
-#include <fcntl.h>        // For fcntl function (used for setting non-blocking mode)
-#include <signal.h>       // For signal-related functions
-#include <sys/epoll.h>    // For epoll functions
-#include <sys/signalfd.h> // For signalfd functions
-#include <sys/socket.h>   // For socket-related functions
+#include <errno.h>          // For error handling
+#include <fcntl.h>          // For fcntl function (used for setting non-blocking mode)
+#include <linux/errqueue.h> // For sock_extended_err (MSG_ZEROCOPY notifications)
+#include <netinet/in.h>     // For IP_RECVERR / IPV6_RECVERR
+#include <netinet/udp.h>    // For UDP_SEGMENT / UDP_GRO
+#include <signal.h>         // For signal-related functions
+#include <sys/epoll.h>      // For epoll functions
+#include <sys/sendfile.h>   // For sendfile
+#include <sys/signalfd.h>   // For signalfd functions
+#include <sys/socket.h>     // For socket-related functions
 #include <sys/stat.h>
 
 #else
@@ -20,6 +27,7 @@
 #include <errno.h>     // For error handling
 #include <netdb.h>     // socketlen_t/getsocketopt/send/recv
 #include <sys/event.h> // kqueue
+#include <sys/socket.h> // sendfile
 #include <sys/time.h>  // timespec
 #include <sys/wait.h>  // WIFEXITED / WEXITSTATUS
 #include <unistd.h>    // read/write/pread/pwrite
@@ -224,8 +232,11 @@ struct SC::AsyncEventLoop::Internal::KernelQueuePosix
                 {
                     AsyncProcessExit::Result processResult(*current, Result(true));
                     processResult.completionData.exitStatus.status = WEXITSTATUS(status);
-                    result.getAsync().eventLoop->internal.removeActiveHandle(*current);
+                    AsyncEventLoop::Internal& internal = result.getAsync().eventLoop->internal;
+                    internal.removeActiveHandle(*current);
+                    const uint64_t callbackBeginTime = internal.statsCallbackBegin(*current);
                     current->callback(processResult);
+                    internal.statsCallbackEnd(*current, callbackBeginTime, false);
                     break;
                 }
                 current = static_cast<AsyncProcessExit*>(current->next);
@@ -249,6 +260,22 @@ struct SC::AsyncEventLoop::Internal::KernelQueuePosix
         return Result(true);
     }
 
+    [[nodiscard]] static Result modifyEventWatcher(AsyncRequest& async, int fileDescriptor, int32_t filter)
+    {
+        struct epoll_event event = {0};
+        event.events             = filter;
+        event.data.ptr           = &async;
+        FileDescriptor::Handle loopFd;
+        SC_TRY(async.eventLoop->internal.kernelQueue.get().getPosix().loopFd.get(loopFd, Result::Error("loop")));
+
+        int res = ::epoll_ctl(loopFd, EPOLL_CTL_MOD, fileDescriptor, &event);
+        if (res == -1)
+        {
+            return Result::Error("epoll_ctl");
+        }
+        return Result(true);
+    }
+
 #endif
 
     [[nodiscard]] static Result stopSingleWatcherImmediate(AsyncRequest& async, SocketDescriptor::Handle handle,
@@ -276,6 +303,21 @@ struct SC::AsyncEventLoop::Internal::KernelQueuePosix
 
     [[nodiscard]] static Result associateExternallyCreatedTCPSocket(SocketDescriptor&) { return Result(true); }
     [[nodiscard]] static Result associateExternallyCreatedFileDescriptor(FileDescriptor&) { return Result(true); }
+
+    // Buffers are picked from the pool free list in user space, when descriptor becomes readable
+    [[nodiscard]] static Result createBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] static Result closeBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] static Result provideBuffers(AsyncBufferPool&, uint32_t, uint32_t)
+    {
+        return Result::Error("provideBuffers not supported");
+    }
+
+    // Requests of the descriptor are cancelled one by one, removing their watchers
+    [[nodiscard]] static Result cancelAllRequestsFor(int, bool& cancelledByKernel)
+    {
+        cancelledByKernel = false;
+        return Result(true);
+    }
 };
 
 struct SC::AsyncEventLoop::Internal::KernelEventsPosix
@@ -307,6 +349,20 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
 
     uint32_t getNumEvents() const { return static_cast<uint32_t>(newEvents); }
 
+    // Watchers of cancelled requests are removed by teardownAsync, so no event will be received for them
+    [[nodiscard]] static constexpr bool receivesCancellationCompletion(AsyncRequest&) { return false; }
+
+    // Span<const char> (pointer + size in bytes) has the same binary layout of struct iovec, so it can be passed as is
+    [[nodiscard]] static Result toIOVec(Span<const Span<const char>> buffers, const struct iovec*& iov, int& iovCount)
+    {
+        static_assert(sizeof(Span<const char>) == sizeof(struct iovec), "Span<const char> / iovec layout mismatch");
+        static_assert(alignof(Span<const char>) == alignof(struct iovec), "Span<const char> / iovec layout mismatch");
+        SC_TRY_MSG(buffers.sizeInElements() <= IOV_MAX, "Too many buffers (exceeding IOV_MAX)");
+        iov      = reinterpret_cast<const struct iovec*>(buffers.data());
+        iovCount = static_cast<int>(buffers.sizeInElements());
+        return Result(true);
+    }
+
     [[nodiscard]] AsyncRequest* getAsyncRequest(uint32_t idx) const
     {
 #if SC_ASYNC_USE_EPOLL
@@ -344,6 +400,16 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         const epoll_event& event = events[idx];
         continueProcessing       = true;
 
+        AsyncRequest* request = getAsyncRequest(idx);
+        if (request->type == AsyncRequest::Type::SocketSend and static_cast<AsyncSocketSend*>(request)->zeroCopy)
+        {
+            return validateZeroCopySend(*static_cast<AsyncSocketSend*>(request), event.events, continueProcessing);
+        }
+        if (request->type == AsyncRequest::Type::SocketSendTo and request->state == AsyncRequest::State::Active)
+        {
+            // A socket error (EPOLLERR) is reported by sendmmsg together with the datagrams sent before it
+            return validateSendTo(*static_cast<AsyncSocketSendTo*>(request), continueProcessing);
+        }
         if ((event.events & EPOLLERR) != 0 || (event.events & EPOLLHUP) != 0)
         {
             continueProcessing = false;
@@ -352,6 +418,73 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return Result(true);
     }
 
+    // MSG_ZEROCOPY data is sent as soon as the socket is writable, but the request is completed only after the
+    // kernel notifies (on socket error queue, signaled with EPOLLERR) that it's not using the buffer anymore.
+    [[nodiscard]] static Result validateZeroCopySend(AsyncSocketSend& async, uint32_t events, bool& continueProcessing)
+    {
+        continueProcessing = false;
+        if ((async.flags & Internal::Flag_ZeroCopyPending) == 0)
+        {
+            if ((events & EPOLLERR) != 0 || (events & EPOLLHUP) != 0)
+            {
+                return Result::Error("Error in processing event (epoll EPOLLERR or EPOLLHUP)");
+            }
+            ssize_t res;
+            SC_TRY(sendBuffers(async, MSG_ZEROCOPY, res));
+            async.zeroCopyResult = res;
+            if (res == 0)
+            {
+                continueProcessing = true; // Nothing has been sent, so no notification will be generated
+                return Result(true);
+            }
+            async.flags |= Internal::Flag_ZeroCopyPending;
+            // Stop watching for EPOLLOUT, as EPOLLERR is always reported and it will signal the notification
+            return KernelQueuePosix::modifyEventWatcher(async, async.handle, 0);
+        }
+        bool released = false;
+        SC_TRY(readZeroCopyNotifications(async.handle, released));
+        SC_TRY_MSG(released, "Error in processing event (epoll EPOLLERR or EPOLLHUP)");
+        async.flags &= ~Internal::Flag_ZeroCopyPending;
+        continueProcessing = true;
+        // Watch EPOLLOUT again, in case the request will be reactivated
+        return KernelQueuePosix::modifyEventWatcher(async, async.handle, OUTPUT_EVENTS_MASK);
+    }
+
+    [[nodiscard]] static Result readZeroCopyNotifications(int handle, bool& released)
+    {
+        while (true)
+        {
+            char          control[128];
+            struct msghdr message = {};
+            message.msg_control    = control;
+            message.msg_controllen = sizeof(control);
+
+            ssize_t res;
+            do
+            {
+                res = ::recvmsg(handle, &message, MSG_ERRQUEUE);
+            } while (res == -1 and errno == EINTR);
+            if (res == -1)
+            {
+                SC_TRY_MSG(errno == EAGAIN or errno == EWOULDBLOCK, "recvmsg MSG_ERRQUEUE failed");
+                return Result(true); // Error queue has been drained
+            }
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+            {
+                const bool isIPV4Error = cmsg->cmsg_level == SOL_IP and cmsg->cmsg_type == IP_RECVERR;
+                const bool isIPV6Error = cmsg->cmsg_level == SOL_IPV6 and cmsg->cmsg_type == IPV6_RECVERR;
+                if (isIPV4Error or isIPV6Error)
+                {
+                    const sock_extended_err* error = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+                    SC_TRY_MSG(error->ee_errno == 0 and error->ee_origin == SO_EE_ORIGIN_ZEROCOPY,
+                               "send error (MSG_ERRQUEUE)");
+                    // Only one zero-copy send can be in flight on a given socket, so any notification releases it
+                    released = true;
+                }
+            }
+        }
+    }
+
 #else
     static constexpr short INPUT_EVENTS_MASK = EVFILT_READ;
     static constexpr short OUTPUT_EVENTS_MASK = EVFILT_WRITE;
@@ -405,6 +538,12 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
                 return Result::Error("Error in processing event (kqueue EV_ERROR)");
             }
         }
+        AsyncRequest* request = getAsyncRequest(idx);
+        if (continueProcessing and request->type == AsyncRequest::Type::SocketSendTo and
+            request->state == AsyncRequest::State::Active)
+        {
+            return validateSendTo(*static_cast<AsyncSocketSendTo*>(request), continueProcessing);
+        }
         return Result(true);
     }
 #endif
@@ -436,10 +575,7 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         if (syncMode == Internal::SyncMode::ForcedForwardProgress)
         {
             loopTimeout = eventLoop.internal.findEarliestLoopTimeout();
-            if (loopTimeout)
-            {
-                nextTimer = &loopTimeout->expirationTime;
-            }
+            nextTimer   = eventLoop.internal.findEarliestExpirationTime(); // Includes request deadlines
         }
         static constexpr Result errorResult = Result::Error("syncWithKernel() - Invalid Handle");
         FileDescriptor::Handle  loopFd;
@@ -580,6 +716,14 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
     //-------------------------------------------------------------------------------------------------------
     [[nodiscard]] Result setupAsync(AsyncSocketSend& async)
     {
+#if SC_ASYNC_USE_EPOLL
+        if (async.zeroCopy)
+        {
+            const int enable = 1;
+            SC_TRY_MSG(::setsockopt(async.handle, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0,
+                       "SO_ZEROCOPY not supported by socket");
+        }
+#endif
         return Result(setEventWatcher(async, async.handle, OUTPUT_EVENTS_MASK));
     }
 
@@ -588,13 +732,48 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return KernelQueuePosix::stopSingleWatcherImmediate(async, async.handle, OUTPUT_EVENTS_MASK);
     }
 
+    [[nodiscard]] static Result sendBuffers(AsyncSocketSend& async, int flags, ssize_t& res)
+    {
+#if defined(MSG_NOSIGNAL)
+        flags |= MSG_NOSIGNAL; // Report EPIPE instead of raising SIGPIPE when peer has closed the connection
+#endif
+        if (async.buffers.empty())
+        {
+            res = ::send(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), flags);
+        }
+        else
+        {
+            const struct iovec* iov;
+            int                 iovCount;
+            SC_TRY(toIOVec(async.buffers, iov, iovCount));
+            struct msghdr message = {};
+            message.msg_iov       = const_cast<struct iovec*>(iov); // msghdr is used for both sendmsg and recvmsg
+            message.msg_iovlen    = static_cast<decltype(message.msg_iovlen)>(iovCount);
+            res                   = ::sendmsg(async.handle, &message, flags);
+        }
+        SC_TRY_MSG(res >= 0, "error in send");
+        return Result(true);
+    }
+
     [[nodiscard]] static Result completeAsync(AsyncSocketSend::Result& result)
     {
         AsyncSocketSend& async = result.getAsync();
-        const ssize_t    res   = ::send(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+        ssize_t          res;
+#if SC_ASYNC_USE_EPOLL
+        if (async.zeroCopy)
+        {
+            res = static_cast<ssize_t>(async.zeroCopyResult); // Already sent (see validateZeroCopySend)
+        }
+        else
+#endif
+        {
+            SC_TRY(sendBuffers(async, 0, res));
+        }
         SC_TRY_MSG(res >= 0, "error in send");
         result.completionData.numBytes = static_cast<size_t>(res);
-        SC_TRY_MSG(result.completionData.numBytes == async.buffer.sizeInBytes(), "send didn't send all data");
+        const size_t totalBytes =
+            async.buffers.empty() ? async.buffer.sizeInBytes() : Internal::sizeOfBuffers(async.buffers);
+        SC_TRY_MSG(result.completionData.numBytes == totalBytes, "send didn't send all data");
         return Result(true);
     }
 
@@ -622,12 +801,302 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
     [[nodiscard]] static Result completeAsync(AsyncSocketReceive::Result& result)
     {
         AsyncSocketReceive& async = result.getAsync();
-        const ssize_t       res   = ::recv(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+        if (async.bufferPool)
+        {
+            SC_TRY(async.bufferPool->acquire(async.buffer, async.bufferIndex));
+        }
+        const ssize_t res = ::recv(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
         SC_TRY_MSG(res >= 0, "error in recv");
         result.completionData.numBytes = static_cast<size_t>(res);
         return Result(true);
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    // Socket SEND TO / RECEIVE FROM shared functions
+    //-------------------------------------------------------------------------------------------------------
+    // Sockaddr family of a received address is known only after the datagram has been received
+    static void updateAddressFamily(SocketIPAddress& address)
+    {
+        const bool      isIPV6 = address.handle.reinterpret_as<const struct sockaddr>().sa_family == AF_INET6;
+        SocketIPAddress received(isIPV6 ? SocketFlags::AddressFamilyIPV6 : SocketFlags::AddressFamilyIPV4);
+        received.handle = address.handle;
+        address         = received;
+    }
+#if SC_ASYNC_USE_EPOLL
+    // Max number of datagrams passed to a single sendmmsg / recvmmsg (using a stack allocated array)
+    static constexpr unsigned MaxDatagramsPerSyscall = 32;
+
+    // Layout of the storage inside AsyncSocketSendTo::Datagram and AsyncSocketReceiveFrom::Datagram
+    struct DatagramMessage
+    {
+        struct msghdr header;
+        struct iovec  iov;
+        alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))]; // UDP_SEGMENT (uint16_t) or UDP_GRO (int)
+    };
+
+    static struct msghdr& prepareMessage(AsyncSocketSendTo::Datagram& datagram, uint16_t segmentSize)
+    {
+        static_assert(sizeof(DatagramMessage) <= sizeof(datagram.message), "Increase Datagram::message size");
+        DatagramMessage& message = datagram.message.reinterpret_as<DatagramMessage>();
+        memset(&message, 0, sizeof(message));
+        message.iov.iov_base        = const_cast<char*>(datagram.data.data()); // iovec is used for send and receive
+        message.iov.iov_len         = datagram.data.sizeInBytes();
+        message.header.msg_name     = &datagram.address.handle.reinterpret_as<struct sockaddr>();
+        message.header.msg_namelen  = datagram.address.sizeOfHandle();
+        message.header.msg_iov      = &message.iov;
+        message.header.msg_iovlen   = 1;
+        if (segmentSize != 0)
+        {
+            message.header.msg_control    = message.control;
+            message.header.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+            struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message.header);
+            controlMessage->cmsg_level     = SOL_UDP;
+            controlMessage->cmsg_type      = UDP_SEGMENT;
+            controlMessage->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(controlMessage), &segmentSize, sizeof(uint16_t));
+        }
+        return message.header;
+    }
+
+    static struct msghdr& prepareMessage(AsyncSocketReceiveFrom::Datagram& datagram, bool coalesce)
+    {
+        static_assert(sizeof(DatagramMessage) <= sizeof(datagram.message), "Increase Datagram::message size");
+        DatagramMessage& message = datagram.message.reinterpret_as<DatagramMessage>();
+        memset(&message, 0, sizeof(message));
+        message.iov.iov_base       = datagram.data.data();
+        message.iov.iov_len        = datagram.data.sizeInBytes();
+        message.header.msg_name    = &datagram.address.handle.reinterpret_as<struct sockaddr>();
+        message.header.msg_namelen = sizeof(datagram.address.handle);
+        message.header.msg_iov     = &message.iov;
+        message.header.msg_iovlen  = 1;
+        if (coalesce)
+        {
+            message.header.msg_control    = message.control;
+            message.header.msg_controllen = sizeof(message.control);
+        }
+        return message.header;
+    }
+
+    // Fills datagram size, sender address and (eventual) GRO segment size from the header filled by the kernel
+    static void completeMessage(AsyncSocketReceiveFrom::Datagram& datagram, const struct msghdr& header,
+                                size_t numBytes)
+    {
+        datagram.numBytes    = numBytes;
+        datagram.segmentSize = 0;
+        updateAddressFamily(datagram.address);
+        if (header.msg_control == nullptr)
+        {
+            return;
+        }
+        for (struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&header); controlMessage != nullptr;
+             controlMessage                 = CMSG_NXTHDR(const_cast<struct msghdr*>(&header), controlMessage))
+        {
+            if (controlMessage->cmsg_level == SOL_UDP and controlMessage->cmsg_type == UDP_GRO)
+            {
+                int segmentSize;
+                memcpy(&segmentSize, CMSG_DATA(controlMessage), sizeof(segmentSize));
+                datagram.segmentSize = static_cast<uint16_t>(segmentSize);
+            }
+        }
+    }
+
+    [[nodiscard]] static Result enableCoalescing(SocketDescriptor::Handle handle)
+    {
+        const int enable = 1;
+        SC_TRY_MSG(::setsockopt(handle, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0,
+                   "AsyncSocketReceiveFrom - UDP_GRO not supported by socket");
+        return Result(true);
+    }
+#endif
+
+    //-------------------------------------------------------------------------------------------------------
+    // Socket SEND TO
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] Result setupAsync(AsyncSocketSendTo& async)
+    {
+#if !SC_ASYNC_USE_EPOLL
+        SC_TRY_MSG(async.segmentSize == 0, "AsyncSocketSendTo - segmentSize (UDP GSO) is supported only on Linux");
+#endif
+        return Result(setEventWatcher(async, async.handle, OUTPUT_EVENTS_MASK));
+    }
+
+    [[nodiscard]] static Result teardownAsync(AsyncSocketSendTo& async)
+    {
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.handle, OUTPUT_EVENTS_MASK);
+    }
+
+    [[nodiscard]] static Result activateAsync(AsyncSocketSendTo& async)
+    {
+        async.numSentDatagrams = 0;
+        async.batchResult      = 0;
+        return Result(true);
+    }
+
+    // Datagrams are sent when the socket is writable. If its buffer fills up midway through a batch, the watcher
+    // is kept armed and sending continues from the first unsent datagram on the next writable event.
+    [[nodiscard]] static Result validateSendTo(AsyncSocketSendTo& async, bool& continueProcessing)
+    {
+        const size_t numDatagrams = async.datagrams.sizeInElements();
+
+        int error = 0;
+#if SC_ASYNC_USE_EPOLL
+        struct mmsghdr messages[MaxDatagramsPerSyscall];
+        while (async.numSentDatagrams < numDatagrams)
+        {
+            const size_t   numRemaining = numDatagrams - async.numSentDatagrams;
+            const unsigned numMessages =
+                numRemaining < MaxDatagramsPerSyscall ? static_cast<unsigned>(numRemaining) : MaxDatagramsPerSyscall;
+            for (unsigned idx = 0; idx < numMessages; ++idx)
+            {
+                AsyncSocketSendTo::Datagram& datagram = async.datagrams[async.numSentDatagrams + idx];
+
+                messages[idx].msg_hdr = prepareMessage(datagram, async.segmentSize);
+                messages[idx].msg_len = 0;
+            }
+            int res;
+            do
+            {
+                res = ::sendmmsg(async.handle, messages, numMessages, 0);
+            } while (res < 0 and errno == EINTR);
+            if (res < 0)
+            {
+                error = errno;
+                break;
+            }
+            async.numSentDatagrams += static_cast<uint32_t>(res);
+        }
+#else
+        while (async.numSentDatagrams < numDatagrams)
+        {
+            const AsyncSocketSendTo::Datagram& datagram = async.datagrams[async.numSentDatagrams];
+
+            ssize_t res;
+            do
+            {
+                res = ::sendto(async.handle, datagram.data.data(), datagram.data.sizeInBytes(), 0,
+                               &datagram.address.handle.reinterpret_as<const struct sockaddr>(),
+                               datagram.address.sizeOfHandle());
+            } while (res < 0 and errno == EINTR);
+            if (res < 0)
+            {
+                error = errno;
+                break;
+            }
+            async.numSentDatagrams += 1;
+        }
+#endif
+        continueProcessing = error != EAGAIN and error != EWOULDBLOCK;
+        if (continueProcessing)
+        {
+            async.batchResult = -error; // Reported by completeAsync together with the bytes already sent
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncSocketSendTo::Result& result)
+    {
+        const AsyncSocketSendTo& async = result.getAsync();
+
+        size_t numBytes = 0;
+        for (uint32_t idx = 0; idx < async.numSentDatagrams; ++idx)
+        {
+            numBytes += async.datagrams[idx].data.sizeInBytes();
+        }
+        result.completionData.numBytes = numBytes;
+        SC_TRY_MSG(async.batchResult == 0, "AsyncSocketSendTo - error sending datagrams");
+        return Result(true);
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    // Socket RECEIVE FROM
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] Result setupAsync(AsyncSocketReceiveFrom& async)
+    {
+#if SC_ASYNC_USE_EPOLL
+        if (async.coalesce)
+        {
+            SC_TRY(enableCoalescing(async.handle));
+        }
+        return Result(setEventWatcher(async, async.handle, EPOLLIN));
+#else
+        return Result(setEventWatcher(async, async.handle, EVFILT_READ));
+#endif
+    }
+
+    [[nodiscard]] static Result teardownAsync(AsyncSocketReceiveFrom& async)
+    {
+#if SC_ASYNC_USE_EPOLL
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.handle, EPOLLIN);
+#else
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.handle, EVFILT_READ);
+#endif
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncSocketReceiveFrom::Result& result)
+    {
+        AsyncSocketReceiveFrom& async = result.getAsync();
+
+        // Receive all datagrams already queued on the socket, until the datagrams span is full
+        size_t numReceived = 0;
+#if SC_ASYNC_USE_EPOLL
+        struct mmsghdr messages[MaxDatagramsPerSyscall];
+        while (numReceived < async.datagrams.sizeInElements())
+        {
+            const size_t   numRemaining = async.datagrams.sizeInElements() - numReceived;
+            const unsigned numMessages =
+                numRemaining < MaxDatagramsPerSyscall ? static_cast<unsigned>(numRemaining) : MaxDatagramsPerSyscall;
+            for (unsigned idx = 0; idx < numMessages; ++idx)
+            {
+                messages[idx].msg_hdr = prepareMessage(async.datagrams[numReceived + idx], async.coalesce);
+                messages[idx].msg_len = 0;
+            }
+            int res;
+            do
+            {
+                res = ::recvmmsg(async.handle, messages, numMessages, MSG_DONTWAIT, nullptr);
+            } while (res < 0 and errno == EINTR);
+            if (res < 0 and (errno == EAGAIN or errno == EWOULDBLOCK) and numReceived > 0)
+            {
+                break;
+            }
+            SC_TRY_MSG(res > 0, "error in recvmmsg");
+            for (int idx = 0; idx < res; ++idx)
+            {
+                completeMessage(async.datagrams[numReceived + static_cast<size_t>(idx)], messages[idx].msg_hdr,
+                                messages[idx].msg_len);
+            }
+            numReceived += static_cast<size_t>(res);
+            if (static_cast<unsigned>(res) < numMessages)
+            {
+                break; // No more datagrams queued on the socket
+            }
+        }
+#else
+        for (AsyncSocketReceiveFrom::Datagram& datagram : async.datagrams)
+        {
+            socklen_t addressLength = sizeof(datagram.address.handle);
+            ssize_t   res;
+            do
+            {
+                res = ::recvfrom(async.handle, datagram.data.data(), datagram.data.sizeInBytes(), MSG_DONTWAIT,
+                                 &datagram.address.handle.reinterpret_as<struct sockaddr>(), &addressLength);
+            } while (res < 0 and errno == EINTR);
+            if (res < 0 and (errno == EAGAIN or errno == EWOULDBLOCK) and numReceived > 0)
+            {
+                break;
+            }
+            SC_TRY_MSG(res >= 0, "error in recvfrom");
+            datagram.numBytes    = static_cast<size_t>(res);
+            datagram.segmentSize = 0;
+            updateAddressFamily(datagram.address);
+            numReceived++;
+        }
+#endif
+        result.completionData.numDatagrams = numReceived;
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // Socket CLOSE
     //-------------------------------------------------------------------------------------------------------
@@ -660,7 +1129,12 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
 
     [[nodiscard]] static Result completeAsync(AsyncFileRead::Result& result)
     {
-        return executeOperation(result.getAsync(), result.completionData);
+        AsyncFileRead& async = result.getAsync();
+        if (async.bufferPool)
+        {
+            SC_TRY(async.bufferPool->acquire(async.buffer, async.bufferIndex));
+        }
+        return executeOperation(async, result.completionData);
     }
 
     [[nodiscard]] static Result cancelAsync(AsyncFileRead& async)
@@ -668,6 +1142,16 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return KernelQueuePosix::stopSingleWatcherImmediate(async, async.fileDescriptor, INPUT_EVENTS_MASK);
     }
 
+    [[nodiscard]] static Result teardownAsync(AsyncFileRead& async)
+    {
+        if (async.asyncTask or (async.flags & Internal::Flag_ManualCompletion))
+        {
+            return Result(true); // Thread pool operations and regular files are not watched
+        }
+        // Stop watching the descriptor, so that no stale event is delivered to a new request at same address
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.fileDescriptor, INPUT_EVENTS_MASK);
+    }
+
     [[nodiscard]] static Result executeOperation(AsyncFileRead& async, AsyncFileRead::CompletionData& completionData)
     {
         auto    span = async.buffer;
@@ -717,8 +1201,22 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return KernelQueuePosix::stopSingleWatcherImmediate(async, async.fileDescriptor, OUTPUT_EVENTS_MASK);
     }
 
+    [[nodiscard]] static Result teardownAsync(AsyncFileWrite& async)
+    {
+        if (async.asyncTask or (async.flags & Internal::Flag_ManualCompletion))
+        {
+            return Result(true); // Thread pool operations and regular files are not watched
+        }
+        // Stop watching the descriptor, so that no stale event is delivered to a new request at same address
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.fileDescriptor, OUTPUT_EVENTS_MASK);
+    }
+
     [[nodiscard]] static Result executeOperation(AsyncFileWrite& async, AsyncFileWrite::CompletionData& completionData)
     {
+        if (not async.buffers.empty())
+        {
+            return executeVectoredWrite(async, completionData);
+        }
         auto    span = async.buffer;
         ssize_t res;
         do
@@ -737,6 +1235,29 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return Result(true);
     }
 
+    [[nodiscard]] static Result executeVectoredWrite(AsyncFileWrite&                 async,
+                                                     AsyncFileWrite::CompletionData& completionData)
+    {
+        const struct iovec* iov;
+        int                 iovCount;
+        SC_TRY(toIOVec(async.buffers, iov, iovCount));
+        ssize_t res;
+        do
+        {
+            if (async.offset == 0)
+            {
+                res = ::writev(async.fileDescriptor, iov, iovCount);
+            }
+            else
+            {
+                res = ::pwritev(async.fileDescriptor, iov, iovCount, static_cast<off_t>(async.offset));
+            }
+        } while ((res == -1) and (errno == EINTR));
+        SC_TRY_MSG(res >= 0, "::writev failed");
+        completionData.numBytes = static_cast<size_t>(res);
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // File POLL
     //-------------------------------------------------------------------------------------------------------
@@ -750,6 +1271,52 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
         return KernelQueuePosix::stopSingleWatcherImmediate(async, async.fileDescriptor, INPUT_EVENTS_MASK);
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    // File SEND
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] Result setupAsync(AsyncFileSend& async)
+    {
+        return setEventWatcher(async, async.socketHandle, OUTPUT_EVENTS_MASK);
+    }
+
+    [[nodiscard]] static Result teardownAsync(AsyncFileSend& async)
+    {
+        return KernelQueuePosix::stopSingleWatcherImmediate(async, async.socketHandle, OUTPUT_EVENTS_MASK);
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncFileSend::Result& result)
+    {
+        AsyncFileSend& async = result.getAsync();
+        // Socket is writable, so send as much as the kernel accepts without blocking
+        size_t sentBytes = 0;
+#if SC_ASYNC_USE_EPOLL
+        off_t         fileOffset = static_cast<off_t>(async.offset);
+        const ssize_t res        = ::sendfile(async.socketHandle, async.fileHandle, &fileOffset, async.length);
+        if (res >= 0)
+        {
+            sentBytes = static_cast<size_t>(res);
+        }
+#else
+        off_t     numBytes = static_cast<off_t>(async.length); // in: bytes to send, out: bytes sent
+        const int res      = ::sendfile(async.fileHandle, async.socketHandle, static_cast<off_t>(async.offset),
+                                        &numBytes, nullptr, 0);
+        sentBytes          = static_cast<size_t>(numBytes); // set also for partial sends returning EAGAIN
+#endif
+        if (res < 0)
+        {
+            SC_TRY_MSG(errno == EAGAIN or errno == EWOULDBLOCK, "sendfile failed");
+        }
+        else
+        {
+            SC_TRY_MSG(sentBytes > 0, "sendfile reached end of file");
+        }
+        async.offset += sentBytes;
+        async.length -= sentBytes;
+        result.completionData.numBytes       = sentBytes;
+        result.completionData.remainingBytes = async.length;
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // File CLOSE
     //-------------------------------------------------------------------------------------------------------
@@ -39,6 +39,7 @@ struct SC::AsyncEventLoop::Internal::KernelQueue
     LPFN_CONNECTEX          pConnectEx            = nullptr;
     LPFN_ACCEPTEX           pAcceptEx             = nullptr;
     LPFN_DISCONNECTEX       pDisconnectEx         = nullptr;
+    LPFN_TRANSMITFILE       pTransmitFile         = nullptr;
 
     KernelQueue()
     {
@@ -71,6 +72,22 @@ struct SC::AsyncEventLoop::Internal::KernelQueue
         return Result(true);
     }
 
+    // Buffers are picked from the pool free list in user space, when the request is activated
+    [[nodiscard]] static Result createBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] static Result closeBufferPool(AsyncBufferPool&) { return Result(true); }
+    [[nodiscard]] static Result provideBuffers(AsyncBufferPool&, uint32_t, uint32_t)
+    {
+        return Result::Error("provideBuffers not supported");
+    }
+
+    // Requests of the descriptor are cancelled one by one
+    template <typename HandleType>
+    [[nodiscard]] static Result cancelAllRequestsFor(HandleType, bool& cancelledByKernel)
+    {
+        cancelledByKernel = false;
+        return Result(true);
+    }
+
     [[nodiscard]] Result ensureConnectFunction(SocketDescriptor::Handle sock)
     {
         if (pConnectEx == nullptr)
@@ -108,6 +125,20 @@ struct SC::AsyncEventLoop::Internal::KernelQueue
         return Result(true);
     }
 
+    [[nodiscard]] Result ensureTransmitFileFunction(SocketDescriptor::Handle sock)
+    {
+        if (pTransmitFile == nullptr)
+        {
+            DWORD dwBytes;
+            GUID  guid = WSAID_TRANSMITFILE;
+            int   rc   = WSAIoctl(sock, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid), &pTransmitFile,
+                                  sizeof(pTransmitFile), &dwBytes, NULL, NULL);
+            if (rc != 0)
+                return Result::Error("WSAIoctl failed");
+        }
+        return Result(true);
+    }
+
     ~KernelQueue() { SC_TRUST_RESULT(close()); }
 
     [[nodiscard]] Result close() { return loopFd.close(); }
@@ -217,10 +248,7 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
         if (syncMode == Internal::SyncMode::ForcedForwardProgress)
         {
             loopTimeout = eventLoop.internal.findEarliestLoopTimeout();
-            if (loopTimeout)
-            {
-                nextTimer = &loopTimeout->expirationTime;
-            }
+            nextTimer   = eventLoop.internal.findEarliestExpirationTime(); // Includes request deadlines
         }
         static constexpr Result errorResult = Result::Error("syncWithKernel() - Invalid Handle");
         FileDescriptor::Handle  loopFd;
@@ -264,6 +292,12 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
 
     [[nodiscard]] static bool validateEvent(uint32_t, bool&) { return Result(true); }
 
+    // Overlapped operations of cancelled requests are still dequeued from the completion port, freeing the request
+    [[nodiscard]] static bool receivesCancellationCompletion(AsyncRequest& async)
+    {
+        return async.type != AsyncRequest::Type::LoopTimeout and async.type != AsyncRequest::Type::LoopWakeUp;
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // TIMEOUT
     //-------------------------------------------------------------------------------------------------------
@@ -425,12 +459,29 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
     [[nodiscard]] static Result activateAsync(AsyncSocketSend& async)
     {
         OVERLAPPED& overlapped = async.overlapped.get().overlapped;
-        WSABUF      buffer;
+        // WSASend copies the WSABUF array before returning, so it can live on the stack
+        static constexpr size_t MaxBuffers = 64;
+
+        WSABUF buffers[MaxBuffers];
+        DWORD  numBuffers = 1;
         // this const_cast is caused by WSABUF being used for both send and receive
-        buffer.buf = const_cast<CHAR*>(async.buffer.data());
-        buffer.len = static_cast<ULONG>(async.buffer.sizeInBytes());
+        if (async.buffers.empty())
+        {
+            buffers[0].buf = const_cast<CHAR*>(async.buffer.data());
+            buffers[0].len = static_cast<ULONG>(async.buffer.sizeInBytes());
+        }
+        else
+        {
+            SC_TRY_MSG(async.buffers.sizeInElements() <= MaxBuffers, "WSASend - Too many buffers");
+            numBuffers = static_cast<DWORD>(async.buffers.sizeInElements());
+            for (DWORD idx = 0; idx < numBuffers; ++idx)
+            {
+                buffers[idx].buf = const_cast<CHAR*>(async.buffers[idx].data());
+                buffers[idx].len = static_cast<ULONG>(async.buffers[idx].sizeInBytes());
+            }
+        }
         DWORD     transferred;
-        const int res = ::WSASend(async.handle, &buffer, 1, &transferred, 0, &overlapped, nullptr);
+        const int res = ::WSASend(async.handle, buffers, numBuffers, &transferred, 0, &overlapped, nullptr);
         SC_TRY_MSG(res != SOCKET_ERROR or WSAGetLastError() == WSA_IO_PENDING, "WSASend failed");
         // TODO: when res == 0 we could avoid the additional GetOverlappedResult syscall
         return Result(true);
@@ -447,6 +498,10 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
     //-------------------------------------------------------------------------------------------------------
     [[nodiscard]] static Result activateAsync(AsyncSocketReceive& async)
     {
+        if (async.bufferPool)
+        {
+            SC_TRY(async.bufferPool->acquire(async.buffer, async.bufferIndex));
+        }
         OVERLAPPED& overlapped = async.overlapped.get().overlapped;
         WSABUF      buffer;
         buffer.buf = async.buffer.data();
@@ -465,6 +520,72 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
                                            &result.completionData.numBytes);
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    // Socket SEND TO
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] static Result activateAsync(AsyncSocketSendTo& async)
+    {
+        // There is no batched version of WSASendTo and a single OVERLAPPED can't be shared by multiple calls
+        SC_TRY_MSG(async.datagrams.sizeInElements() == 1, "AsyncSocketSendTo - IOCP supports a single datagram");
+        SC_TRY_MSG(async.segmentSize == 0, "AsyncSocketSendTo - segmentSize (UDP GSO) is supported only on Linux");
+        const AsyncSocketSendTo::Datagram& datagram = async.datagrams[0];
+
+        OVERLAPPED& overlapped = async.overlapped.get().overlapped;
+        WSABUF      buffer;
+        buffer.buf = const_cast<CHAR*>(datagram.data.data()); // WSABUF is used for both send and receive
+        buffer.len = static_cast<ULONG>(datagram.data.sizeInBytes());
+        DWORD     transferred;
+        const int res = ::WSASendTo(async.handle, &buffer, 1, &transferred, 0,
+                                    &datagram.address.handle.reinterpret_as<const struct sockaddr>(),
+                                    static_cast<int>(datagram.address.sizeOfHandle()), &overlapped, nullptr);
+        SC_TRY_MSG(res != SOCKET_ERROR or WSAGetLastError() == WSA_IO_PENDING, "WSASendTo failed");
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncSocketSendTo::Result& result)
+    {
+        return KernelQueue::checkWSAResult(result.getAsync().handle, result.getAsync().overlapped.get().overlapped,
+                                           &result.completionData.numBytes);
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    // Socket RECEIVE FROM
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] static Result activateAsync(AsyncSocketReceiveFrom& async)
+    {
+        // A single datagram is received for each completion (there is no batched version of WSARecvFrom)
+        AsyncSocketReceiveFrom::Datagram& datagram = async.datagrams[0];
+
+        OVERLAPPED& overlapped = async.overlapped.get().overlapped;
+        WSABUF      buffer;
+        buffer.buf          = datagram.data.data();
+        buffer.len          = static_cast<ULONG>(datagram.data.sizeInBytes());
+        async.addressLength = static_cast<int>(sizeof(datagram.address.handle));
+        DWORD     transferred;
+        DWORD     flags = 0;
+        const int res   = ::WSARecvFrom(async.handle, &buffer, 1, &transferred, &flags,
+                                        &datagram.address.handle.reinterpret_as<struct sockaddr>(),
+                                        &async.addressLength, &overlapped, nullptr);
+        SC_TRY_MSG(res != SOCKET_ERROR or WSAGetLastError() == WSA_IO_PENDING, "WSARecvFrom failed");
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncSocketReceiveFrom::Result& result)
+    {
+        AsyncSocketReceiveFrom&           async    = result.getAsync();
+        AsyncSocketReceiveFrom::Datagram& datagram = async.datagrams[0];
+        SC_TRY(KernelQueue::checkWSAResult(async.handle, async.overlapped.get().overlapped, &datagram.numBytes));
+
+        const bool isIPV6 = datagram.address.handle.reinterpret_as<const struct sockaddr>().sa_family == AF_INET6;
+        SocketIPAddress received(isIPV6 ? SocketFlags::AddressFamilyIPV6 : SocketFlags::AddressFamilyIPV4);
+        received.handle      = datagram.address.handle;
+        datagram.address     = received;
+        datagram.segmentSize = 0;
+
+        result.completionData.numDatagrams = 1;
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // Socket CLOSE
     //-------------------------------------------------------------------------------------------------------
@@ -545,6 +666,10 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
     //-------------------------------------------------------------------------------------------------------
     [[nodiscard]] static Result activateAsync(AsyncFileRead& async)
     {
+        if (async.bufferPool)
+        {
+            SC_TRY(async.bufferPool->acquire(async.buffer, async.bufferIndex));
+        }
         AsyncFileRead::CompletionData completionData;
         return executeOperation(async, completionData, false); // synchronous == false
     }
@@ -569,11 +694,46 @@ struct SC::AsyncEventLoop::Internal::KernelEvents
     [[nodiscard]] static Result executeOperation(AsyncFileWrite& async, AsyncFileWrite::CompletionData& completionData,
                                                  bool synchronous = true)
     {
+        // WriteFileGather requires page aligned and page sized buffers, so it can't be used for generic buffers
+        SC_TRY_MSG(async.buffers.empty(), "AsyncFileWrite - Vectored writes are not supported on Windows");
         return executeFileOperation(&::WriteFile, async, completionData, synchronous);
     }
 
     [[nodiscard]] static Result completeAsync(AsyncFileWrite::Result& result) { return completeFileOperation(result); }
 
+    //-------------------------------------------------------------------------------------------------------
+    // File SEND
+    //-------------------------------------------------------------------------------------------------------
+    [[nodiscard]] static Result activateAsync(AsyncFileSend& async)
+    {
+        KernelQueue& kernelQueue = async.eventLoop->internal.kernelQueue.get();
+        SC_TRY(kernelQueue.ensureTransmitFileFunction(async.socketHandle));
+
+        OVERLAPPED& overlapped = async.overlapped.get().overlapped;
+        overlapped.Offset      = static_cast<DWORD>(async.offset & 0xffffffff);
+        overlapped.OffsetHigh  = static_cast<DWORD>((async.offset >> 32) & 0xffffffff);
+
+        // TransmitFile can send at most 2^31 - 2 bytes, the rest will be sent when reactivating the request
+        static constexpr size_t MaxBytesPerSend = 0x7ffffffe;
+
+        const DWORD numBytes = static_cast<DWORD>(async.length < MaxBytesPerSend ? async.length : MaxBytesPerSend);
+        const BOOL  res      = kernelQueue.pTransmitFile(async.socketHandle, async.fileHandle, numBytes, 0,
+                                                         &overlapped, nullptr, 0);
+        SC_TRY_MSG(res == TRUE or WSAGetLastError() == WSA_IO_PENDING, "TransmitFile failed");
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result completeAsync(AsyncFileSend::Result& result)
+    {
+        AsyncFileSend& async = result.getAsync();
+        SC_TRY(KernelQueue::checkWSAResult(async.socketHandle, async.overlapped.get().overlapped,
+                                           &result.completionData.numBytes));
+        async.offset += result.completionData.numBytes;
+        async.length -= result.completionData.numBytes;
+        result.completionData.remainingBytes = async.length;
+        return Result(true);
+    }
+
     //-------------------------------------------------------------------------------------------------------
     // File CLOSE
     //-------------------------------------------------------------------------------------------------------
@@ -0,0 +1,369 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../Async.h"
+#include "../../Containers/Vector.h"
+#include "../../Testing/Testing.h"
+#include "../../Threading/Threading.h" // EventObject
+
+namespace SC
+{
+struct AsyncBenchmarkTest;
+}
+
+struct SC::AsyncBenchmarkTest : public SC::TestCase
+{
+    static constexpr int NumTimeouts    = 100000;
+    static constexpr int NumRoundTrips  = 20000;
+    static constexpr int NumWakeUps     = 20000;
+    static constexpr int NumPosts       = 100000;
+    static constexpr int NumExpirations = 200000;
+
+    AsyncEventLoop::Options options;
+    AsyncBenchmarkTest(SC::TestReport& report) : TestCase(report, "AsyncBenchmarkTest")
+    {
+        int numTestsToRun = 1;
+        if (AsyncEventLoop::tryLoadingLiburing())
+        {
+            // Run all benchmarks on epoll backend first, and then re-run them on io_uring
+            options.apiType = AsyncEventLoop::Options::ApiType::ForceUseEpoll;
+            numTestsToRun   = 2;
+        }
+        for (int i = 0; i < numTestsToRun; ++i)
+        {
+            if (test_section("loop timeout expire"))
+            {
+                loopTimeoutExpire();
+            }
+            if (test_section("loop timeout step cost"))
+            {
+                loopTimeoutStepCost();
+            }
+            if (test_section("loop timeout churn"))
+            {
+                loopTimeoutChurn();
+            }
+            if (test_section("loop wake up round trip"))
+            {
+                loopWakeUpRoundTrip();
+            }
+            if (test_section("loop post storm"))
+            {
+                loopPostStorm();
+            }
+            if (test_section("socket ping pong"))
+            {
+                socketPingPong(nullptr);
+            }
+            if (test_section("socket ping pong with stats"))
+            {
+                // Measures overhead of collecting AsyncEventLoopStats
+                AsyncEventLoopStats stats;
+                socketPingPong(&stats);
+            }
+            if (numTestsToRun == 2)
+            {
+                options.apiType = AsyncEventLoop::Options::ApiType::ForceUseIOURing;
+            }
+        }
+    }
+
+    void printElapsed(StringView what, Time::HighResolutionCounter start, int numOperations)
+    {
+        Time::HighResolutionCounter end;
+        end.snap();
+        const int64_t ms = end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+        report.console.print("{} x {} = {} ms ({} us each)\n", what, numOperations, ms,
+                             (ms * 1000) / (numOperations > 0 ? numOperations : 1));
+    }
+
+    void loopTimeoutExpire()
+    {
+        // Starts many timeouts with scrambled short expiration times, checking that they all expire in order
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        Vector<AsyncLoopTimeout> timeouts;
+        SC_TEST_EXPECT(timeouts.resize(NumTimeouts));
+
+        struct Context
+        {
+            int     numExpired      = 0;
+            int     numOutOfOrder   = 0;
+            int64_t lastExpiredTime = 0;
+        } context;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        for (int idx = 0; idx < NumTimeouts; ++idx)
+        {
+            timeouts[idx].callback = [&](AsyncLoopTimeout::Result& res)
+            {
+                const int64_t relative = res.getAsync().relativeTimeout.ms;
+                if (relative < context.lastExpiredTime)
+                {
+                    context.numOutOfOrder++;
+                }
+                context.lastExpiredTime = relative;
+                context.numExpired++;
+            };
+            // All timeouts are activated during the same loop step, so they share the same starting time
+            SC_TEST_EXPECT(timeouts[idx].start(eventLoop, Time::Milliseconds((idx * 7919) % 20)));
+        }
+        printElapsed("AsyncLoopTimeout::start", start, NumTimeouts);
+        start.snap();
+        SC_TEST_EXPECT(eventLoop.run());
+        printElapsed("AsyncLoopTimeout expire", start, NumTimeouts);
+        SC_TEST_EXPECT(context.numExpired == NumTimeouts);
+        SC_TEST_EXPECT(context.numOutOfOrder == 0);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void loopTimeoutStepCost()
+    {
+        // Measures loop step cost with many long timeouts active, then cancels half of them
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        Vector<AsyncLoopTimeout> timeouts;
+        SC_TEST_EXPECT(timeouts.resize(NumTimeouts));
+
+        int numExpired = 0;
+        for (int idx = 0; idx < NumTimeouts; ++idx)
+        {
+            timeouts[idx].callback = [&](AsyncLoopTimeout::Result&) { numExpired++; };
+            const int64_t timeout  = idx % 2 == 0 ? 100000 + (idx * 7919) % 1000 : 1 + idx % 10;
+            SC_TEST_EXPECT(timeouts[idx].start(eventLoop, Time::Milliseconds(timeout)));
+        }
+        SC_TEST_EXPECT(eventLoop.runNoWait()); // Activate all timeouts
+
+        constexpr int               NumSteps = 1000;
+        Time::HighResolutionCounter start;
+        start.snap();
+        for (int step = 0; step < NumSteps; ++step)
+        {
+            SC_TEST_EXPECT(eventLoop.runNoWait());
+        }
+        printElapsed("AsyncEventLoop::runNoWait", start, NumSteps);
+
+        start.snap();
+        for (int idx = 0; idx < NumTimeouts; idx += 2)
+        {
+            SC_TEST_EXPECT(timeouts[idx].stop());
+        }
+        printElapsed("AsyncLoopTimeout::stop", start, NumTimeouts / 2);
+
+        SC_TEST_EXPECT(eventLoop.run()); // Only the short timeouts are left to expire
+        SC_TEST_EXPECT(numExpired == NumTimeouts / 2);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void loopTimeoutChurn()
+    {
+        // Keeps a few thousands timeouts continuously expiring and reactivating with scrambled expiration times
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        constexpr int            NumActive = 4096;
+        Vector<AsyncLoopTimeout> timeouts;
+        SC_TEST_EXPECT(timeouts.resize(NumActive));
+
+        int numExpired = 0;
+        for (int idx = 0; idx < NumActive; ++idx)
+        {
+            timeouts[idx].callback = [&](AsyncLoopTimeout::Result& res)
+            {
+                numExpired++;
+                if (numExpired + NumActive <= NumExpirations)
+                {
+                    res.getAsync().relativeTimeout = Time::Milliseconds((numExpired * 7919) % 4);
+                    res.reactivateRequest(true);
+                }
+            };
+            SC_TEST_EXPECT(timeouts[idx].start(eventLoop, Time::Milliseconds(idx % 4)));
+        }
+        Time::HighResolutionCounter start;
+        start.snap();
+        SC_TEST_EXPECT(eventLoop.run());
+        printElapsed("AsyncLoopTimeout reactivate", start, numExpired);
+        SC_TEST_EXPECT(numExpired == NumExpirations);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void loopWakeUpRoundTrip()
+    {
+        // Another thread wakes up the loop and waits for the callback to run, many times in a row
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        struct Context
+        {
+            EventObject     eventObject;
+            AsyncLoopWakeUp wakeUp;
+            Result          threadResult = Result(true);
+            int             numWakeUps   = 0;
+        } context;
+
+        context.wakeUp.callback = [this, &context](AsyncLoopWakeUp::Result& res)
+        {
+            context.numWakeUps++;
+            if (context.numWakeUps == NumWakeUps)
+            {
+                SC_TEST_EXPECT(res.getAsync().stop());
+            }
+        };
+        SC_TEST_EXPECT(context.wakeUp.start(eventLoop, &context.eventObject));
+
+        Thread thread;
+        auto   threadLambda = [&context](Thread&)
+        {
+            for (int idx = 0; idx < NumWakeUps; ++idx)
+            {
+                context.threadResult = context.wakeUp.wakeUp();
+                if (not context.threadResult)
+                {
+                    break;
+                }
+                context.eventObject.wait();
+            }
+        };
+        Time::HighResolutionCounter start;
+        start.snap();
+        SC_TEST_EXPECT(thread.start(threadLambda));
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(thread.join());
+        printElapsed("AsyncLoopWakeUp round trip", start, NumWakeUps);
+        SC_TEST_EXPECT(context.threadResult);
+        SC_TEST_EXPECT(context.numWakeUps == NumWakeUps);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void loopPostStorm()
+    {
+        // Another thread posts functions as fast as possible, with wake ups coalesced by the loop
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        int numExecuted = 0;
+
+        Thread thread;
+        auto   threadLambda = [&eventLoop, &numExecuted](Thread&)
+        {
+            for (int idx = 0; idx < NumPosts; ++idx)
+            {
+                while (not eventLoop.post([&numExecuted] { numExecuted++; }))
+                {
+                    Thread::Sleep(0); // Queue is full, give the loop some time to catch up
+                }
+            }
+        };
+        Time::HighResolutionCounter start;
+        start.snap();
+        SC_TEST_EXPECT(thread.start(threadLambda));
+        while (numExecuted < NumPosts)
+        {
+            SC_TEST_EXPECT(eventLoop.run());
+        }
+        SC_TEST_EXPECT(thread.join());
+        printElapsed("AsyncEventLoop::post", start, NumPosts);
+        SC_TEST_EXPECT(numExecuted == NumPosts);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void socketPingPong(AsyncEventLoopStats* stats)
+    {
+        // Bounces a small message back and forth between the two ends of a TCP connection
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        if (stats)
+        {
+            eventLoop.enableStats(*stats);
+        }
+
+        SocketDescriptor serverSocket;
+        SocketIPAddress  nativeAddress;
+        SC_TEST_EXPECT(nativeAddress.fromAddressPort("127.0.0.1", 5060));
+        SC_TEST_EXPECT(serverSocket.create(nativeAddress.getAddressFamily()));
+        SC_TEST_EXPECT(SocketServer(serverSocket).listen(nativeAddress, 0));
+
+        struct Context
+        {
+            AsyncEventLoop&  eventLoop;
+            SocketDescriptor client, serverSideClient;
+
+            AsyncSocketSend    clientSend, serverSend;
+            AsyncSocketReceive clientReceive, serverReceive;
+
+            char ping[4] = {'p', 'i', 'n', 'g'};
+            char clientBuffer[4];
+            char serverBuffer[4];
+
+            int numRoundTrips = 0;
+        } context = {eventLoop};
+
+        SC_TEST_EXPECT(SocketClient(context.client).connect("127.0.0.1", 5060));
+        SC_TEST_EXPECT(SocketServer(serverSocket).accept(nativeAddress.getAddressFamily(), context.serverSideClient));
+        SC_TEST_EXPECT(context.client.setBlocking(false));
+        SC_TEST_EXPECT(context.serverSideClient.setBlocking(false));
+        SC_TEST_EXPECT(eventLoop.associateExternallyCreatedTCPSocket(context.client));
+        SC_TEST_EXPECT(eventLoop.associateExternallyCreatedTCPSocket(context.serverSideClient));
+
+        // Each socket alternates between send and receive, as some backends (epoll) can't watch the same socket
+        // descriptor for both reading and writing from two different requests at the same time.
+        context.clientSend.callback = [this, &context](AsyncSocketSend::Result& res)
+        {
+            SC_TEST_EXPECT(res.isValid());
+            SC_TEST_EXPECT(context.clientReceive.start(context.eventLoop, context.client, context.clientBuffer));
+        };
+        context.serverReceive.callback = [this, &context](AsyncSocketReceive::Result& res)
+        {
+            Span<char> data;
+            SC_TEST_EXPECT(res.get(data));
+            SC_TEST_EXPECT(context.serverSend.start(context.eventLoop, context.serverSideClient, data));
+        };
+        context.serverSend.callback = [this, &context](AsyncSocketSend::Result& res)
+        {
+            SC_TEST_EXPECT(res.isValid());
+            if (context.numRoundTrips + 1 < NumRoundTrips)
+            {
+                SC_TEST_EXPECT(
+                    context.serverReceive.start(context.eventLoop, context.serverSideClient, context.serverBuffer));
+            }
+        };
+        context.clientReceive.callback = [this, &context](AsyncSocketReceive::Result& res)
+        {
+            Span<char> data;
+            SC_TEST_EXPECT(res.get(data));
+            context.numRoundTrips++;
+            if (context.numRoundTrips < NumRoundTrips)
+            {
+                SC_TEST_EXPECT(context.clientSend.start(context.eventLoop, context.client, context.ping));
+            }
+        };
+        SC_TEST_EXPECT(context.serverReceive.start(eventLoop, context.serverSideClient, context.serverBuffer));
+        SC_TEST_EXPECT(context.clientSend.start(eventLoop, context.client, context.ping));
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        SC_TEST_EXPECT(eventLoop.run());
+        printElapsed(stats ? "AsyncSocket ping pong (stats)"_a8 : "AsyncSocket ping pong"_a8, start,
+                     context.numRoundTrips);
+        SC_TEST_EXPECT(context.numRoundTrips == NumRoundTrips);
+        if (stats)
+        {
+            AsyncEventLoopStats::Snapshot snapshot;
+            stats->takeSnapshot(snapshot);
+            const AsyncLatencyHistogram::Snapshot& latency =
+                snapshot.get(AsyncRequest::Type::SocketReceive).completionLatency;
+            report.console.print("AsyncSocketReceive latency p50 = {} us p99 = {} us max = {} us\n",
+                                 latency.getPercentile(50) / 1000, latency.getPercentile(99) / 1000,
+                                 latency.maximum / 1000);
+            SC_TEST_EXPECT(latency.count == 2 * NumRoundTrips);
+        }
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+};
+
+namespace SC
+{
+void runAsyncBenchmarkTest(SC::TestReport& report) { AsyncBenchmarkTest test(report); }
+} // namespace SC
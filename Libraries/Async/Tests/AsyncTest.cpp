@@ -35,17 +35,52 @@ struct SC::AsyncTest : public SC::TestCase
             {
                 loopTimeout();
             }
+            if (options.apiType == AsyncEventLoop::Options::ApiType::ForceUseIOURing and
+                test_section("loop io_uring options"))
+            {
+                loopIoUringOptions();
+            }
+            if (test_section("loop dns resolver"))
+            {
+                loopDNSResolver();
+            }
             loopWakeUpFromExternalThread();
             loopWakeUp();
+            if (test_section("loop post"))
+            {
+                loopPost();
+            }
+            if (test_section("loop request pool"))
+            {
+                loopRequestPool();
+            }
+            if (test_section("loop stats"))
+            {
+                loopStats();
+            }
+            if (test_section("loop kernel events memory"))
+            {
+                loopKernelEventsMemory();
+            }
             loopWakeUpEventObject();
             processExit();
             socketAccept();
             socketConnect();
             socketSendReceive();
+            socketStopRestart();
+            socketSendZeroCopy();
+            socketSendVectored();
             socketSendReceiveError();
+            socketReceiveBufferPool();
+            socketMultishot();
+            socketSendToReceiveFrom();
+            socketReceiveDeadline();
+            socketCancelAll();
             socketClose();
             fileReadWrite(false); // do not use thread-pool
             fileReadWrite(true);  // use thread-pool
+            fileWriteVectored();
+            fileSend();
             fileClose();
             loopFreeSubmittingOnClose();
             loopFreeActiveOnClose();
@@ -58,6 +93,41 @@ struct SC::AsyncTest : public SC::TestCase
     }
 
     void loopWork();
+    void loopDNSResolver();
+    void loopPost();
+    void loopStats();
+
+    void loopKernelEventsMemory()
+    {
+        // Smaller sizes use (a part of) the stack buffer, bigger ones are allocated on heap by create
+        const size_t sizes[] = {1024, AsyncEventLoop::DefaultKernelEventsMemorySize,
+                                4 * AsyncEventLoop::DefaultKernelEventsMemorySize};
+        for (const size_t size : sizes)
+        {
+            AsyncEventLoop::Options sizedOptions = options;
+            sizedOptions.kernelEventsMemorySize  = size;
+
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(sizedOptions));
+
+            int             numCalled = 0;
+            AsyncLoopWakeUp wakeUps[4];
+            for (AsyncLoopWakeUp& wakeUp : wakeUps)
+            {
+                wakeUp.callback = [&numCalled](AsyncLoopWakeUp::Result&) { numCalled++; };
+                SC_TEST_EXPECT(wakeUp.start(eventLoop));
+                SC_TEST_EXPECT(wakeUp.wakeUp());
+            }
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(numCalled == 4);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+        AsyncEventLoop::Options tooSmallOptions = options;
+        tooSmallOptions.kernelEventsMemorySize  = 512;
+
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(not eventLoop.create(tooSmallOptions));
+    }
 
     void loopFreeSubmittingOnClose()
     {
@@ -131,6 +201,48 @@ struct SC::AsyncTest : public SC::TestCase
         SC_TEST_EXPECT(eventLoop.close());
     }
 
+    void loopIoUringOptions()
+    {
+        enum Setup
+        {
+            SQPoll,
+            CooperativeTaskRun,
+            SingleIssuer,
+            NumSetups
+        };
+        for (int setup = 0; setup < NumSetups; ++setup)
+        {
+            AsyncEventLoop::Options ioUringOptions = options;
+            ioUringOptions.ioUringQueueDepth       = 8;
+            switch (setup)
+            {
+            case SQPoll: ioUringOptions.ioUringSQPollIdleMilliseconds = 10; break;
+            case CooperativeTaskRun: ioUringOptions.ioUringCooperativeTaskRun = true; break;
+            case SingleIssuer: ioUringOptions.ioUringSingleIssuer = true; break;
+            }
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(ioUringOptions));
+
+            int              timeoutCalled = 0;
+            AsyncLoopTimeout timeout;
+            timeout.callback = [&timeoutCalled](AsyncLoopTimeout::Result&) { timeoutCalled++; };
+            SC_TEST_EXPECT(timeout.start(eventLoop, Time::Milliseconds(1)));
+
+            int             wakeUpCalled = 0;
+            AsyncLoopWakeUp wakeUp;
+            wakeUp.callback = [this, &wakeUpCalled](AsyncLoopWakeUp::Result& res)
+            {
+                wakeUpCalled++;
+                SC_TEST_EXPECT(res.getAsync().stop());
+            };
+            SC_TEST_EXPECT(wakeUp.start(eventLoop));
+            SC_TEST_EXPECT(wakeUp.wakeUp());
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(timeoutCalled == 1 and wakeUpCalled == 1);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+
     void loopTimeout()
     {
         AsyncLoopTimeout timeout1, timeout2;
@@ -163,6 +275,79 @@ struct SC::AsyncTest : public SC::TestCase
         SC_TEST_EXPECT(timeout1Called == 1 and timeout2Called == 2); // Re-activated timeout2 fires again after 1 ms
     }
 
+    void loopRequestPool()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+
+        AsyncRequestPool<AsyncLoopTimeout> pool;
+        SC_TEST_EXPECT(pool.create(eventLoop, 2));
+        SC_TEST_EXPECT(pool.getCapacity() == 2);
+
+        AsyncLoopTimeout* timeout1 = nullptr;
+        AsyncLoopTimeout* timeout2 = nullptr;
+        AsyncLoopTimeout* timeout3 = nullptr;
+
+        AsyncRequestPool<AsyncLoopTimeout>::Key key1, key2, key3;
+        SC_TEST_EXPECT(not key1.isValid());
+        SC_TEST_EXPECT(pool.acquire(timeout1, key1));
+        SC_TEST_EXPECT(pool.acquire(timeout2, key2));
+        SC_TEST_EXPECT(not pool.acquire(timeout3, key3)); // Pool is exhausted
+        SC_TEST_EXPECT(key1.isValid() and key2.isValid() and not(key1 == key2));
+        SC_TEST_EXPECT(pool.get(key1) == timeout1 and pool.get(key2) == timeout2);
+        SC_TEST_EXPECT(pool.getNumFreeRequests() == 0);
+
+        int timeout1Called = 0;
+        int timeout2Called = 0;
+        timeout1->callback = [&](AsyncLoopTimeout::Result&) { timeout1Called++; };
+        timeout2->callback = [&](AsyncLoopTimeout::Result& res)
+        {
+            timeout2Called++;
+            res.reactivateRequest(timeout2Called < 2); // A reactivated request is not given back to the pool
+        };
+        SC_TEST_EXPECT(timeout1->start(eventLoop, Time::Milliseconds(1)));
+        SC_TEST_EXPECT(timeout2->start(eventLoop, Time::Milliseconds(1)));
+        SC_TEST_EXPECT(not pool.release(key1)); // Started requests are recycled by the loop
+        SC_TEST_EXPECT(not pool.close());       // Requests are still in use
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(timeout1Called == 1 and timeout2Called == 2);
+
+        // Completed requests have been given back to the pool and their keys are now stale
+        SC_TEST_EXPECT(pool.getNumFreeRequests() == 2);
+        SC_TEST_EXPECT(pool.get(key1) == nullptr and pool.get(key2) == nullptr);
+        SC_TEST_EXPECT(not pool.release(key1));
+
+        // Memory is reused, but the request is reset and old keys do not alias the new one
+        SC_TEST_EXPECT(pool.acquire(timeout3, key3));
+        SC_TEST_EXPECT(timeout3 == timeout1 or timeout3 == timeout2);
+        SC_TEST_EXPECT(not timeout3->callback.isValid());
+        SC_TEST_EXPECT(pool.get(key3) == timeout3);
+        SC_TEST_EXPECT(not(key3 == key1) and not(key3 == key2));
+
+        // Requests never started must be given back manually
+        SC_TEST_EXPECT(pool.release(key3));
+        SC_TEST_EXPECT(not pool.release(key3));
+
+        // Requests still active when the loop is closed are given back too
+        SC_TEST_EXPECT(pool.acquire(timeout3, key3));
+        SC_TEST_EXPECT(timeout3->start(eventLoop, Time::Milliseconds(1000)));
+        SC_TEST_EXPECT(eventLoop.close());
+        SC_TEST_EXPECT(pool.getNumFreeRequests() == 2);
+        SC_TEST_EXPECT(pool.close());
+
+        // A pool can outlive its event loop, as closing the loop detaches it
+        {
+            AsyncEventLoop shortLivedLoop;
+            SC_TEST_EXPECT(shortLivedLoop.create(options));
+            SC_TEST_EXPECT(pool.create(shortLivedLoop, 1));
+            SC_TEST_EXPECT(pool.acquire(timeout3, key3));
+            SC_TEST_EXPECT(timeout3->start(shortLivedLoop, Time::Milliseconds(1000)));
+            SC_TEST_EXPECT(shortLivedLoop.close());
+        }
+        SC_TEST_EXPECT(pool.getNumFreeRequests() == 1);
+        SC_TEST_EXPECT(pool.close());
+    }
+
     int  threadWasCalled = 0;
     int  wakeUpSucceeded = 0;
     void loopWakeUpFromExternalThread()
@@ -387,8 +572,12 @@ struct SC::AsyncTest : public SC::TestCase
             SC_TEST_EXPECT(SocketClient(client2).connect("127.0.0.1", tcpPort));
             SC_TEST_EXPECT(not acceptedClient[0].isValid());
             SC_TEST_EXPECT(not acceptedClient[1].isValid());
+            // A multishot accept (io_uring) can deliver both connections in the same step
             SC_TEST_EXPECT(eventLoop.runOnce()); // first connect
-            SC_TEST_EXPECT(eventLoop.runOnce()); // second connect
+            if (acceptedCount < 2)
+            {
+                SC_TEST_EXPECT(eventLoop.runOnce()); // second connect
+            }
             SC_TEST_EXPECT(acceptedClient[0].isValid());
             SC_TEST_EXPECT(acceptedClient[1].isValid());
             SC_TEST_EXPECT(client1.close());
@@ -564,6 +753,599 @@ struct SC::AsyncTest : public SC::TestCase
         }
     }
 
+    void socketStopRestart()
+    {
+        if (test_section("socket stop restart"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            char       receiveBuffer[1] = {0};
+            Span<char> receiveData      = {receiveBuffer, sizeof(receiveBuffer)};
+
+            int                receiveCount = 0;
+            AsyncSocketReceive receiveAsync;
+            receiveAsync.callback = [&receiveCount](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                if (res.get(readData) and readData.sizeInBytes() == 1)
+                {
+                    receiveCount++;
+                }
+            };
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, receiveData));
+            SC_TEST_EXPECT(eventLoop.runNoWait()); // Activates the receive
+            SC_TEST_EXPECT(receiveAsync.stop());
+
+            // A stopped request becomes free once the loop has processed its cancellation, that on io_uring and
+            // IOCP means receiving the completion of the cancelled kernel operation
+            for (int idx = 0; idx < 10 and receiveAsync.getEventLoop() != nullptr; ++idx)
+            {
+                SC_TEST_EXPECT(eventLoop.runNoWait());
+            }
+            SC_TEST_EXPECT(receiveAsync.getEventLoop() == nullptr);
+            SC_TEST_EXPECT(receiveCount == 0);
+
+            // ...and then it can be started again
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, receiveData));
+            const char sendBuffer[] = {42};
+            SC_TEST_EXPECT(SocketClient(client).write({sendBuffer, sizeof(sendBuffer)}));
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(receiveCount == 1);
+            SC_TEST_EXPECT(receiveBuffer[0] == 42);
+
+            // A request stopped before being activated is free immediately
+            int              timeoutCount = 0;
+            AsyncLoopTimeout timeout;
+            timeout.callback = [&timeoutCount](AsyncLoopTimeout::Result&) { timeoutCount++; };
+            SC_TEST_EXPECT(timeout.start(eventLoop, Time::Milliseconds(10000)));
+            SC_TEST_EXPECT(timeout.stop());
+            SC_TEST_EXPECT(timeout.getEventLoop() == nullptr);
+
+            // An active timeout is free after next loop step
+            SC_TEST_EXPECT(timeout.start(eventLoop, Time::Milliseconds(10000)));
+            SC_TEST_EXPECT(eventLoop.runNoWait());
+            SC_TEST_EXPECT(timeout.stop());
+            for (int idx = 0; idx < 10 and timeout.getEventLoop() != nullptr; ++idx)
+            {
+                SC_TEST_EXPECT(eventLoop.runNoWait());
+            }
+            SC_TEST_EXPECT(timeout.getEventLoop() == nullptr);
+            SC_TEST_EXPECT(timeout.start(eventLoop, Time::Milliseconds(1)));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(timeoutCount == 1);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+
+    void socketSendZeroCopy()
+    {
+        if (test_section("socket send zero copy"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            char sendBuffer[16 * 1024];
+            for (size_t idx = 0; idx < sizeof(sendBuffer); ++idx)
+            {
+                sendBuffer[idx] = static_cast<char>(idx % 251);
+            }
+
+            struct Params
+            {
+                int    sendCount     = 0;
+                size_t sentBytes     = 0;
+                size_t receivedBytes = 0;
+                char   receivedData[sizeof(sendBuffer)];
+            };
+            Params params;
+
+            AsyncSocketSend sendAsync;
+            sendAsync.zeroCopy = true;
+            sendAsync.callback = [this, &params](AsyncSocketSend::Result& res)
+            {
+                SC_TEST_EXPECT(res.isValid());
+                params.sendCount++;
+                params.sentBytes = res.completionData.numBytes;
+            };
+            SC_TEST_EXPECT(sendAsync.start(eventLoop, client, {sendBuffer, sizeof(sendBuffer)}));
+
+            char               receiveBuffer[4096];
+            AsyncSocketReceive receiveAsync;
+            receiveAsync.callback = [this, &params](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                SC_TEST_EXPECT(res.get(readData));
+                ::memcpy(params.receivedData + params.receivedBytes, readData.data(), readData.sizeInBytes());
+                params.receivedBytes += readData.sizeInBytes();
+                res.reactivateRequest(params.receivedBytes < sizeof(params.receivedData));
+            };
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(params.sendCount == 1);
+            SC_TEST_EXPECT(params.sentBytes == sizeof(sendBuffer));
+            SC_TEST_EXPECT(params.receivedBytes == sizeof(sendBuffer));
+            SC_TEST_EXPECT(memcmp(params.receivedData, sendBuffer, sizeof(sendBuffer)) == 0);
+        }
+    }
+
+    void socketSendVectored()
+    {
+        if (test_section("socket send vectored"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            // Header and body slices are sent with a single syscall, without concatenating them first
+            const Span<const char> buffers[] = {{"HEAD", 4}, {"body1", 5}, {"body2", 5}};
+
+            int             sendCount = 0;
+            AsyncSocketSend sendAsync;
+            sendAsync.callback = [&](AsyncSocketSend::Result& res)
+            {
+                SC_TEST_EXPECT(res.isValid());
+                SC_TEST_EXPECT(res.completionData.numBytes == 14);
+                sendCount++;
+            };
+            SC_TEST_EXPECT(not sendAsync.startVectored(eventLoop, client, {}));
+            SC_TEST_EXPECT(sendAsync.startVectored(eventLoop, client, buffers));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(sendCount == 1);
+
+            char       receiveBuffer[14];
+            Span<char> receivedData;
+            SC_TEST_EXPECT(SocketClient(serverSideClient).read({receiveBuffer, sizeof(receiveBuffer)}, receivedData));
+            SC_TEST_EXPECT(receivedData.sizeInBytes() == 14);
+            SC_TEST_EXPECT(memcmp(receiveBuffer, "HEADbody1body2", 14) == 0);
+        }
+    }
+
+    void socketReceiveBufferPool()
+    {
+        if (test_section("socket receive buffer pool"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client[2], serverSideClient[2];
+            createAndAssociateAsyncClientServerConnections(eventLoop, client[0], serverSideClient[0]);
+            createAndAssociateAsyncClientServerConnections(eventLoop, client[1], serverSideClient[1]);
+
+            char            poolMemory[2 * 4 + 3]; // trailing 3 bytes are not enough for another buffer
+            AsyncBufferPool bufferPool;
+            SC_TEST_EXPECT(not bufferPool.create(eventLoop, {poolMemory, sizeof(poolMemory)}, 2)); // too small
+            SC_TEST_EXPECT(bufferPool.create(eventLoop, {poolMemory, sizeof(poolMemory)}, 4));
+            SC_TEST_EXPECT(bufferPool.getNumFreeBuffers() == 2);
+
+            struct Params
+            {
+                AsyncBufferPool& bufferPool;
+                int              receiveCount = 0;
+                char             receivedData[2 * 3];
+            };
+            Params params = {bufferPool};
+
+            AsyncSocketReceive receiveAsync[2];
+            for (int idx = 0; idx < 2; ++idx)
+            {
+                receiveAsync[idx].callback = [this, &params](AsyncSocketReceive::Result& res)
+                {
+                    Span<char> readData;
+                    SC_TEST_EXPECT(res.get(readData));
+                    SC_TEST_EXPECT(readData.sizeInBytes() == 3);
+                    SC_TEST_EXPECT(params.bufferPool.getNumFreeBuffers() == 1); // returned after callback
+                    ::memcpy(params.receivedData + params.receiveCount * 3, readData.data(), 3);
+                    params.receiveCount++;
+                };
+                SC_TEST_EXPECT(receiveAsync[idx].start(eventLoop, serverSideClient[idx], bufferPool));
+            }
+            SC_TEST_EXPECT(eventLoop.runNoWait());
+            // Nothing has been received yet, so no buffer has been lent
+            SC_TEST_EXPECT(bufferPool.getNumFreeBuffers() == 2);
+
+            SC_TEST_EXPECT(SocketClient(client[0]).write({"abc", 3}));
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(params.receiveCount == 1);
+            SC_TEST_EXPECT(SocketClient(client[1]).write({"def", 3}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(params.receiveCount == 2);
+            SC_TEST_EXPECT(memcmp(params.receivedData, "abcdef", 6) == 0);
+            SC_TEST_EXPECT(bufferPool.getNumFreeBuffers() == 2);
+            SC_TEST_EXPECT(bufferPool.close());
+        }
+    }
+
+    void socketMultishot()
+    {
+        // On io_uring a reactivated accept / buffer pool receive keeps a single multishot submission armed
+        if (test_section("socket multishot"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+
+            SocketDescriptor serverSocket;
+            SocketIPAddress  serverAddress;
+            SC_TEST_EXPECT(serverAddress.fromAddressPort("127.0.0.1", 5050));
+            SC_TEST_EXPECT(eventLoop.createAsyncTCPSocket(serverAddress.getAddressFamily(), serverSocket));
+            SC_TEST_EXPECT(SocketServer(serverSocket).listen(serverAddress, 4));
+
+            struct Context
+            {
+                int              numAccepted = 0;
+                SocketDescriptor accepted[4];
+                int              numReceived  = 0;
+                char             lastReceived = 0;
+            } context;
+
+            AsyncSocketAccept accept;
+            accept.callback = [this, &context](AsyncSocketAccept::Result& res)
+            {
+                SC_TEST_EXPECT(res.moveTo(context.accepted[context.numAccepted++]));
+                res.reactivateRequest(context.numAccepted < 4);
+            };
+            SC_TEST_EXPECT(accept.start(eventLoop, serverSocket));
+            SocketDescriptor clients[5];
+            for (int idx = 0; idx < 3; ++idx)
+            {
+                SC_TEST_EXPECT(SocketClient(clients[idx]).connect("127.0.0.1", 5050));
+                SC_TEST_EXPECT(eventLoop.runOnce());
+                SC_TEST_EXPECT(context.numAccepted == idx + 1);
+            }
+
+            // Stop the accept while the kernel may have already accepted next connection
+            SC_TEST_EXPECT(SocketClient(clients[3]).connect("127.0.0.1", 5050));
+            SC_TEST_EXPECT(accept.stop());
+            for (int idx = 0; idx < 10 and accept.getEventLoop() != nullptr; ++idx)
+            {
+                SC_TEST_EXPECT(eventLoop.runNoWait());
+            }
+            SC_TEST_EXPECT(accept.getEventLoop() == nullptr);
+            SC_TEST_EXPECT(context.numAccepted == 3);
+
+            // Restarted accept gets either the pending connection or the new one
+            SC_TEST_EXPECT(accept.start(eventLoop, serverSocket));
+            SC_TEST_EXPECT(SocketClient(clients[4]).connect("127.0.0.1", 5050));
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(context.numAccepted == 4);
+            SC_TEST_EXPECT(eventLoop.run()); // Not reactivated, so it waits for the multishot cancellation
+            SC_TEST_EXPECT(accept.getEventLoop() == nullptr);
+
+            char            poolMemory[4 * 4];
+            AsyncBufferPool bufferPool;
+            SC_TEST_EXPECT(bufferPool.create(eventLoop, {poolMemory, sizeof(poolMemory)}, 4));
+
+            AsyncSocketReceive receive;
+            receive.callback = [this, &context](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                SC_TEST_EXPECT(res.get(readData) and not readData.empty());
+                context.lastReceived = readData[readData.sizeInBytes() - 1];
+                context.numReceived++;
+                res.reactivateRequest(true);
+            };
+            SC_TEST_EXPECT(receive.start(eventLoop, context.accepted[0], bufferPool));
+            for (char idx = 0; idx < 3; ++idx)
+            {
+                SC_TEST_EXPECT(SocketClient(clients[0]).write({&idx, 1}));
+                SC_TEST_EXPECT(eventLoop.runOnce());
+                SC_TEST_EXPECT(context.numReceived == idx + 1 and context.lastReceived == idx);
+            }
+
+            // Stop the receive while the kernel may have already received next data into one of the buffers
+            const char lost = 3;
+            SC_TEST_EXPECT(SocketClient(clients[0]).write({&lost, 1}));
+            SC_TEST_EXPECT(receive.stop());
+            for (int idx = 0; idx < 10 and receive.getEventLoop() != nullptr; ++idx)
+            {
+                SC_TEST_EXPECT(eventLoop.runNoWait());
+            }
+            SC_TEST_EXPECT(receive.getEventLoop() == nullptr);
+            SC_TEST_EXPECT(context.numReceived == 3);
+            SC_TEST_EXPECT(bufferPool.getNumFreeBuffers() == 4); // A buffer selected for dropped data is given back
+
+            // Restarted receive gets the new data (possibly after the pending one)
+            SC_TEST_EXPECT(receive.start(eventLoop, context.accepted[0], bufferPool));
+            const char last = 4;
+            SC_TEST_EXPECT(SocketClient(clients[0]).write({&last, 1}));
+            while (context.lastReceived != last)
+            {
+                SC_TEST_EXPECT(eventLoop.runOnce());
+            }
+            SC_TEST_EXPECT(receive.stop());
+            SC_TEST_EXPECT(eventLoop.run()); // Waits for the multishot cancellation
+            SC_TEST_EXPECT(receive.getEventLoop() == nullptr);
+            SC_TEST_EXPECT(bufferPool.close());
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+
+    void socketSendToReceiveFrom()
+    {
+        if (test_section("socket send to/receive from"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+
+            SocketIPAddress  receiverAddress, senderAddress;
+            SocketDescriptor receiver, sender;
+            SC_TEST_EXPECT(receiverAddress.fromAddressPort("127.0.0.1", 5070));
+            SC_TEST_EXPECT(senderAddress.fromAddressPort("127.0.0.1", 5071));
+            SC_TEST_EXPECT(eventLoop.createAsyncUDPSocket(receiverAddress.getAddressFamily(), receiver));
+            SC_TEST_EXPECT(eventLoop.createAsyncUDPSocket(senderAddress.getAddressFamily(), sender));
+            SC_TEST_EXPECT(SocketServer(receiver).bind(receiverAddress));
+            SC_TEST_EXPECT(SocketServer(sender).bind(senderAddress));
+
+            struct Context
+            {
+                SocketIPAddress& senderAddress;
+
+                size_t numSentBytes = 0;
+                int    numReceived  = 0;
+                char   received[16] = {0};
+                bool   sameAddress  = false;
+            } context = {senderAddress};
+
+            // Single datagram
+            AsyncSocketSendTo sendToAsync;
+            sendToAsync.callback = [this, &context](AsyncSocketSendTo::Result& res)
+            {
+                SC_TEST_EXPECT(res.isValid());
+                context.numSentBytes += res.completionData.numBytes;
+            };
+            SC_TEST_EXPECT(sendToAsync.start(eventLoop, sender, receiverAddress, {"ping", 4}));
+
+            char                   receiveBuffer[16];
+            AsyncSocketReceiveFrom receiveFromAsync;
+            receiveFromAsync.callback = [this, &context](AsyncSocketReceiveFrom::Result& res)
+            {
+                Span<char>      data;
+                SocketIPAddress from;
+                SC_TEST_EXPECT(res.get(data, from));
+                SC_TEST_EXPECT(res.completionData.numDatagrams == 1);
+                ::memcpy(context.received, data.data(), data.sizeInBytes());
+                context.numReceived++;
+                context.sameAddress = from.getAddressFamily() == context.senderAddress.getAddressFamily() and
+                                      ::memcmp(&from.handle, &context.senderAddress.handle, from.sizeOfHandle()) == 0;
+            };
+            SC_TEST_EXPECT(receiveFromAsync.start(eventLoop, receiver, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numSentBytes == 4);
+            SC_TEST_EXPECT(context.numReceived == 1);
+            SC_TEST_EXPECT(::memcmp(context.received, "ping", 4) == 0);
+            SC_TEST_EXPECT(context.sameAddress);
+
+            // Batch of datagrams
+            AsyncSocketSendTo::Datagram sendDatagrams[3];
+            const char*                 payloads[3] = {"one", "two", "six"};
+            for (int idx = 0; idx < 3; ++idx)
+            {
+                sendDatagrams[idx].address = receiverAddress;
+                sendDatagrams[idx].data    = {payloads[idx], 3};
+            }
+            context.numSentBytes = 0;
+            SC_TEST_EXPECT(not sendToAsync.start(eventLoop, sender, Span<AsyncSocketSendTo::Datagram>()));
+            SC_TEST_EXPECT(sendToAsync.start(eventLoop, sender, sendDatagrams));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numSentBytes == 9);
+
+            char                             batchMemory[4][8];
+            AsyncSocketReceiveFrom::Datagram receiveDatagrams[4];
+            for (int idx = 0; idx < 4; ++idx)
+            {
+                receiveDatagrams[idx].data = batchMemory[idx];
+            }
+            context.numReceived       = 0;
+            receiveFromAsync.callback = [this, &context](AsyncSocketReceiveFrom::Result& res)
+            {
+                // Backends not supporting batches receive a single datagram for each completion
+                for (const AsyncSocketReceiveFrom::Datagram& datagram : res.getDatagrams())
+                {
+                    SC_TEST_EXPECT(datagram.numBytes == 3);
+                    ::memcpy(context.received + context.numReceived * 3, datagram.data.data(), 3);
+                    context.numReceived++;
+                }
+                res.reactivateRequest(context.numReceived < 3);
+            };
+            SC_TEST_EXPECT(receiveFromAsync.start(eventLoop, receiver, receiveDatagrams));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numReceived == 3);
+            SC_TEST_EXPECT(::memcmp(context.received, "onetwosix", 9) == 0);
+#if SC_PLATFORM_LINUX
+            // Segmentation offload: a single send generates two datagrams of 4 bytes (GSO) ...
+            context.numSentBytes    = 0;
+            sendToAsync.segmentSize = 4;
+            SC_TEST_EXPECT(sendToAsync.start(eventLoop, sender, receiverAddress, {"abcdefgh", 8}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numSentBytes == 8);
+
+            context.numReceived       = 0;
+            receiveFromAsync.callback = [this, &context](AsyncSocketReceiveFrom::Result& res)
+            {
+                for (const AsyncSocketReceiveFrom::Datagram& datagram : res.getDatagrams())
+                {
+                    SC_TEST_EXPECT(datagram.numBytes == 4);
+                    ::memcpy(context.received + context.numReceived * 4, datagram.data.data(), 4);
+                    context.numReceived++;
+                }
+                res.reactivateRequest(context.numReceived < 2);
+            };
+            SC_TEST_EXPECT(receiveFromAsync.start(eventLoop, receiver, receiveDatagrams));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numReceived == 2);
+            SC_TEST_EXPECT(::memcmp(context.received, "abcdefgh", 8) == 0);
+
+            // ... that are received as a single coalesced datagram when GRO is enabled
+            SC_TEST_EXPECT(sendToAsync.start(eventLoop, sender, receiverAddress, {"ABCDEFGH", 8}));
+            receiveFromAsync.coalesce = true;
+            receiveFromAsync.callback = [this, &context](AsyncSocketReceiveFrom::Result& res)
+            {
+                Span<char>      data;
+                SocketIPAddress from;
+                SC_TEST_EXPECT(res.get(data, from));
+                SC_TEST_EXPECT(data.sizeInBytes() == 8);
+                SC_TEST_EXPECT(res.getDatagrams()[0].segmentSize == 4);
+                ::memcpy(context.received, data.data(), data.sizeInBytes());
+            };
+            SC_TEST_EXPECT(receiveFromAsync.start(eventLoop, receiver, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(::memcmp(context.received, "ABCDEFGH", 8) == 0);
+            sendToAsync.segmentSize = 0;
+#endif
+            // A datagram failing in the middle of a batch fails the request, reporting bytes already sent
+            SocketIPAddress wrongFamilyAddress;
+            SC_TEST_EXPECT(wrongFamilyAddress.fromAddressPort("::1", 5070));
+            sendDatagrams[1].address = wrongFamilyAddress;
+            context.numSentBytes     = 0;
+            sendToAsync.callback     = [this, &context](AsyncSocketSendTo::Result& res)
+            {
+                SC_TEST_EXPECT(not res.isValid());
+                context.numSentBytes = res.completionData.numBytes;
+            };
+            SC_TEST_EXPECT(sendToAsync.start(eventLoop, sender, sendDatagrams));
+            SC_TEST_EXPECT(eventLoop.run());
+            if (options.apiType != AsyncEventLoop::Options::ApiType::ForceUseIOURing)
+            {
+                SC_TEST_EXPECT(context.numSentBytes == 3);
+            }
+        }
+    }
+
+    void socketReceiveDeadline()
+    {
+        if (test_section("socket receive deadline"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            struct Context
+            {
+                int numReceived = 0;
+                int numExpired  = 0;
+
+                SocketDescriptor* client = nullptr;
+            } context;
+            context.client = &client;
+
+            //! [AsyncRequestDeadlineSnippet]
+            char               receiveBuffer[4];
+            AsyncSocketReceive receiveAsync;
+            // The peer must send something within 50 ms, without starting and stopping a separate AsyncLoopTimeout
+            receiveAsync.setDeadline(Time::Milliseconds(50));
+            receiveAsync.callback = [this, &context](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                if (res.get(readData))
+                {
+                    SC_TEST_EXPECT(not res.hasDeadlineExpired());
+                    context.numReceived++;
+                }
+                else
+                {
+                    // The receive has already been cancelled, so it can be started again right away if needed
+                    SC_TEST_EXPECT(res.hasDeadlineExpired());
+                    context.numExpired++;
+                }
+            };
+            //! [AsyncRequestDeadlineSnippet]
+            Time::HighResolutionCounter start;
+            start.snap();
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run()); // Nothing is sent, so run returns after the deadline
+            Time::HighResolutionCounter end;
+            end.snap();
+            SC_TEST_EXPECT(context.numExpired == 1 and context.numReceived == 0);
+            SC_TEST_EXPECT(end.subtractExact(start).toNanoseconds() >= 50 * 1000 * 1000);
+
+            // Data arriving before the deadline completes the request normally
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(SocketClient(client).write({"abc", 3}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numExpired == 1 and context.numReceived == 1);
+
+            // Reactivating after the deadline error starts the request again, with a new deadline
+            receiveAsync.callback = [this, &context](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                if (res.get(readData))
+                {
+                    context.numReceived++;
+                    return;
+                }
+                SC_TEST_EXPECT(res.hasDeadlineExpired());
+                context.numExpired++;
+                if (context.numExpired == 3)
+                {
+                    SC_TEST_EXPECT(SocketClient(*context.client).write({"def", 3})); // Received by the restarted request
+                }
+                res.reactivateRequest(true);
+            };
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.numExpired == 3 and context.numReceived == 2);
+            SC_TEST_EXPECT(receiveBuffer[0] == 'd');
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+
+    void socketCancelAll()
+    {
+        if (test_section("socket cancel all"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            int                numReceived[2] = {0, 0};
+            char               receiveBuffer[2][4];
+            AsyncSocketReceive receiveAsync[2];
+            for (int idx = 0; idx < 2; ++idx)
+            {
+                receiveAsync[idx].callback = [this, &count = numReceived[idx]](AsyncSocketReceive::Result& res)
+                {
+                    Span<char> readData;
+                    SC_TEST_EXPECT(res.get(readData));
+                    count++;
+                };
+            }
+            SC_TEST_EXPECT(receiveAsync[0].start(eventLoop, serverSideClient, {receiveBuffer[0], 4}));
+            SC_TEST_EXPECT(receiveAsync[1].start(eventLoop, client, {receiveBuffer[1], 4}));
+            SC_TEST_EXPECT(eventLoop.runNoWait()); // Both receives are now waiting for data
+
+            //! [AsyncEventLoopCancelAllSnippet]
+            // Stops all requests operating on serverSideClient (for example before closing it), without callbacks
+            SC_TEST_EXPECT(eventLoop.cancelAllRequestsFor(serverSideClient));
+            //! [AsyncEventLoopCancelAllSnippet]
+            SC_TEST_EXPECT(SocketClient(serverSideClient).write({"def", 3}));
+            SC_TEST_EXPECT(eventLoop.run()); // Requests of other descriptors are not affected
+            SC_TEST_EXPECT(numReceived[0] == 0 and numReceived[1] == 1);
+
+            // Cancelled requests can be started again, once the loop has processed their cancellation.
+            // Data is sent only now because on io_uring a receive can consume it before its cancellation is processed
+            SC_TEST_EXPECT(receiveAsync[0].start(eventLoop, serverSideClient, {receiveBuffer[0], 4}));
+            SC_TEST_EXPECT(SocketClient(client).write({"abc", 3}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(numReceived[0] == 1);
+            SC_TEST_EXPECT(memcmp(receiveBuffer[0], "abc", 3) == 0);
+
+            // Requests not yet submitted to the kernel are freed immediately
+            SC_TEST_EXPECT(receiveAsync[0].start(eventLoop, serverSideClient, {receiveBuffer[0], 4}));
+            SC_TEST_EXPECT(eventLoop.cancelAllRequestsFor(serverSideClient));
+            SC_TEST_EXPECT(receiveAsync[0].start(eventLoop, serverSideClient, {receiveBuffer[0], 4}));
+            SC_TEST_EXPECT(SocketClient(client).write({"ghi", 3}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(numReceived[0] == 2);
+            SC_TEST_EXPECT(memcmp(receiveBuffer[0], "ghi", 3) == 0);
+        }
+    }
+
     void socketClose()
     {
         if (test_section("socket close"))
@@ -720,6 +1502,152 @@ struct SC::AsyncTest : public SC::TestCase
         }
     }
 
+    void fileWriteVectored()
+    {
+#if !SC_PLATFORM_WINDOWS
+        if (test_section("file write vectored"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+
+            StringNative<255> filePath = StringEncoding::Native;
+            const StringView  fileName = "AsyncTestVectored.txt";
+            SC_TEST_EXPECT(Path::join(filePath, {report.applicationRootDirectory, fileName}));
+
+            FileDescriptor::OpenOptions openOptions;
+            openOptions.blocking = false;
+
+            FileDescriptor fd;
+            SC_TEST_EXPECT(fd.open(filePath.view(), FileDescriptor::WriteCreateTruncate, openOptions));
+            SC_TEST_EXPECT(eventLoop.associateExternallyCreatedFileDescriptor(fd));
+
+            const Span<const char> buffers[] = {{"te", 2}, {"st", 2}};
+
+            size_t         writtenBytes = 0;
+            AsyncFileWrite asyncWriteFile;
+            asyncWriteFile.callback = [&](AsyncFileWrite::Result& res) { SC_TEST_EXPECT(res.get(writtenBytes)); };
+            SC_TEST_EXPECT(fd.get(asyncWriteFile.fileDescriptor, Result::Error("invalid")));
+            asyncWriteFile.buffers = buffers;
+            SC_TEST_EXPECT(asyncWriteFile.start(eventLoop));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(writtenBytes == 4);
+
+            // Without an offset, next write appends at the current file position
+            const Span<const char> moreBuffers[] = {{"ab", 2}, {"cd", 2}};
+            asyncWriteFile.buffers               = moreBuffers;
+            SC_TEST_EXPECT(asyncWriteFile.start(eventLoop));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(fd.close());
+            SC_TEST_EXPECT(writtenBytes == 4);
+
+            FileSystem fs;
+            SC_TEST_EXPECT(fs.init(report.applicationRootDirectory));
+            String content;
+            SC_TEST_EXPECT(fs.read(fileName, content, StringEncoding::Ascii));
+            SC_TEST_EXPECT(content == "testabcd");
+            SC_TEST_EXPECT(fs.removeFile(fileName));
+        }
+#endif
+    }
+
+    void fileSend()
+    {
+        if (test_section("file send"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SocketDescriptor client, serverSideClient;
+            createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+            // Large enough to fill socket buffers, so that the send completes in multiple partial steps
+            constexpr size_t FileSize = 1024 * 1024;
+            constexpr size_t Offset   = 1000;
+            constexpr size_t Length   = FileSize - 2 * Offset;
+
+            Vector<char> fileData;
+            SC_TEST_EXPECT(fileData.resizeWithoutInitializing(FileSize));
+            for (size_t idx = 0; idx < FileSize; ++idx)
+            {
+                fileData[idx] = static_cast<char>(idx % 251);
+            }
+            const StringView fileName = "AsyncTestFileSend.bin";
+            FileSystem       fs;
+            SC_TEST_EXPECT(fs.init(report.applicationRootDirectory));
+            SC_TEST_EXPECT(fs.write(fileName, fileData.toSpanConst()));
+
+            StringNative<255> filePath = StringEncoding::Native;
+            SC_TEST_EXPECT(Path::join(filePath, {report.applicationRootDirectory, fileName}));
+            FileDescriptor::OpenOptions openOptions;
+            openOptions.blocking = false;
+            FileDescriptor fd;
+            SC_TEST_EXPECT(fd.open(filePath.view(), FileDescriptor::ReadOnly, openOptions));
+
+            struct Context
+            {
+                size_t sentBytes = 0;
+                int    sendCount = 0;
+            } context;
+            AsyncFileSend sendAsync;
+            sendAsync.callback = [&](AsyncFileSend::Result& res)
+            {
+                size_t numBytes = 0;
+                SC_TEST_EXPECT(res.get(numBytes));
+                context.sentBytes += numBytes;
+                context.sendCount++;
+                SC_TEST_EXPECT(res.completionData.remainingBytes == Length - context.sentBytes);
+                res.reactivateRequest(res.completionData.remainingBytes > 0);
+            };
+            SC_TEST_EXPECT(not sendAsync.start(eventLoop, fd, client, Offset, 0));
+            SC_TEST_EXPECT(sendAsync.start(eventLoop, fd, client, Offset, Length));
+
+            Vector<char> receivedData;
+            SC_TEST_EXPECT(receivedData.reserve(Length));
+            char               receiveBuffer[16 * 1024];
+            AsyncSocketReceive receiveAsync;
+            receiveAsync.callback = [&](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                SC_TEST_EXPECT(res.get(readData));
+                SC_TEST_EXPECT(receivedData.append(Span<const char>(readData)));
+                res.reactivateRequest(receivedData.size() < Length);
+            };
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+
+            SC_TEST_EXPECT(context.sentBytes == Length);
+            SC_TEST_EXPECT(context.sendCount >= 1);
+            SC_TEST_EXPECT(receivedData.size() == Length);
+            SC_TEST_EXPECT(memcmp(receivedData.data(), fileData.data() + Offset, Length) == 0);
+
+            // Restart the same request (reusing its splice pipe on io_uring) to send the file prefix
+            constexpr size_t PrefixLength = 1000;
+            sendAsync.callback            = [&](AsyncFileSend::Result& res)
+            {
+                size_t numBytes = 0;
+                SC_TEST_EXPECT(res.get(numBytes));
+                context.sentBytes += numBytes;
+                res.reactivateRequest(res.completionData.remainingBytes > 0);
+            };
+            context.sentBytes = 0;
+            receivedData.clear();
+            SC_TEST_EXPECT(sendAsync.start(eventLoop, fd, client, 0, PrefixLength));
+            receiveAsync.callback = [&](AsyncSocketReceive::Result& res)
+            {
+                Span<char> readData;
+                SC_TEST_EXPECT(res.get(readData));
+                SC_TEST_EXPECT(receivedData.append(Span<const char>(readData)));
+                res.reactivateRequest(receivedData.size() < PrefixLength);
+            };
+            SC_TEST_EXPECT(receiveAsync.start(eventLoop, serverSideClient, {receiveBuffer, sizeof(receiveBuffer)}));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(context.sentBytes == PrefixLength);
+            SC_TEST_EXPECT(receivedData.size() == PrefixLength);
+            SC_TEST_EXPECT(memcmp(receivedData.data(), fileData.data(), PrefixLength) == 0);
+            SC_TEST_EXPECT(fd.close());
+            SC_TEST_EXPECT(fs.removeFile(fileName));
+        }
+    }
+
     void fileClose()
     {
         if (test_section("file close"))
@@ -1099,6 +2027,146 @@ SC_TRY(eventLoop.run());
 return Result(true);
 }
 
+SC::Result snippetForBufferPool(AsyncEventLoop& eventLoop, Console& console)
+{
+SocketDescriptor clients[64];
+//! [AsyncBufferPoolSnippet]
+// Assuming an already created (and running) AsyncEventLoop named `eventLoop`
+// and 64 connected or accepted sockets named `clients`
+// ...
+// 8 buffers of 4 KB are shared by all receives, as they're lent only when data is available
+char poolMemory[8 * 4096];
+AsyncBufferPool bufferPool;
+SC_TRY(bufferPool.create(eventLoop, {poolMemory, sizeof(poolMemory)}, 4096));
+
+AsyncSocketReceive receives[64];
+for (int idx = 0; idx < 64; ++idx)
+{
+    receives[idx].callback = [&](AsyncSocketReceive::Result& res)
+    {
+        Span<char> readData;
+        if(res.get(readData))
+        {
+            // readData points to a pool buffer that is given back as soon as this callback returns
+            console.print("{} bytes have been read", readData.sizeInBytes());
+        }
+        res.reactivateRequest(true);
+    };
+    SC_TRY(receives[idx].start(eventLoop, clients[idx], bufferPool));
+}
+//! [AsyncBufferPoolSnippet]
+SC_TRY(eventLoop.run());
+return bufferPool.close();
+}
+
+SC::Result snippetForRequestPool(AsyncEventLoop& eventLoop, Console& console)
+{
+SocketDescriptor clients[64];
+//! [AsyncRequestPoolSnippet]
+// Assuming an already created (and running) AsyncEventLoop named `eventLoop`
+// and 64 connected or accepted sockets named `clients`
+// ...
+// Instead of one AsyncSocketSend per client, at most 8 sends can be in flight at the same time
+AsyncRequestPool<AsyncSocketSend> sendPool;
+SC_TRY(sendPool.create(eventLoop, 8));
+
+AsyncRequestPool<AsyncSocketSend>::Key sendKeys[64];
+for (int idx = 0; idx < 64; ++idx)
+{
+    AsyncSocketSend* send;
+    if (not sendPool.acquire(send, sendKeys[idx]))
+    {
+        break; // All requests are in flight, try again later
+    }
+    send->callback = [&](AsyncSocketSend::Result& res)
+    {
+        // The request is given back to the pool after this callback returns (unless reactivated)
+        console.print("Send completed {}", res.isValid() ? "successfully" : "with an error");
+    };
+    if (not send->start(eventLoop, clients[idx], {"Hello", 5}))
+    {
+        SC_TRY(sendPool.release(sendKeys[idx])); // Not started, so it must be given back manually
+    }
+}
+// A key can be used to check if its request is still in flight (get returns nullptr after it has been recycled)
+if (AsyncSocketSend* send = sendPool.get(sendKeys[0]))
+{
+    SC_TRY(send->stop());
+}
+//! [AsyncRequestPoolSnippet]
+SC_TRY(eventLoop.run());
+return sendPool.close();
+}
+
+SC::Result snippetForSocketSendTo(AsyncEventLoop& eventLoop, Console& console)
+{
+SocketDescriptor udpSocket;
+//! [AsyncSocketSendToSnippet]
+// Assuming an already created (and running) AsyncEventLoop named `eventLoop`
+// ...
+// Create an UDP socket associated to the event loop
+SC_TRY(eventLoop.createAsyncUDPSocket(SocketFlags::AddressFamilyIPV4, udpSocket));
+SocketIPAddress collector;
+SC_TRY(collector.fromAddressPort("127.0.0.1", 5070));
+
+// Datagrams, together with the memory pointed by their spans, must be valid until callback is called
+AsyncSocketSendTo::Datagram datagrams[2];
+datagrams[0].address = collector;
+datagrams[0].data    = {"cpu=12", 6};
+datagrams[1].address = collector;
+datagrams[1].data    = {"mem=34", 6};
+
+AsyncSocketSendTo sendToAsync;
+sendToAsync.callback = [&](AsyncSocketSendTo::Result& res)
+{
+    if(res.isValid())
+    {
+        console.print("{} bytes have been sent", res.completionData.numBytes);
+    }
+};
+// Both datagrams are sent with a single syscall where supported (sendmmsg)
+SC_TRY(sendToAsync.start(eventLoop, udpSocket, datagrams));
+//! [AsyncSocketSendToSnippet]
+SC_TRY(eventLoop.run());
+return Result(true);
+}
+
+SC::Result snippetForSocketReceiveFrom(AsyncEventLoop& eventLoop, Console& console)
+{
+SocketDescriptor udpSocket;
+//! [AsyncSocketReceiveFromSnippet]
+// Assuming an already created (and running) AsyncEventLoop named `eventLoop`
+// ...
+// Create an UDP socket associated to the event loop, receiving datagrams sent to port 5070
+SocketIPAddress address;
+SC_TRY(address.fromAddressPort("127.0.0.1", 5070));
+SC_TRY(eventLoop.createAsyncUDPSocket(address.getAddressFamily(), udpSocket));
+SC_TRY(SocketServer(udpSocket).bind(address));
+
+// Memory for up to 16 datagrams received with a single completion
+char memory[16][1500];
+AsyncSocketReceiveFrom::Datagram datagrams[16];
+for (int idx = 0; idx < 16; ++idx)
+{
+    datagrams[idx].data = memory[idx];
+}
+AsyncSocketReceiveFrom receiveFromAsync;
+receiveFromAsync.callback = [&](AsyncSocketReceiveFrom::Result& res)
+{
+    for (const AsyncSocketReceiveFrom::Datagram& datagram : res.getDatagrams())
+    {
+        // datagram.address holds the address of the sender
+        console.print("Received a datagram of {} bytes", datagram.numBytes);
+    }
+    // Ask to reactivate the request to keep receiving datagrams
+    res.reactivateRequest(true);
+};
+SC_TRY(receiveFromAsync.start(eventLoop, udpSocket, datagrams));
+//! [AsyncSocketReceiveFromSnippet]
+SC_TRY(eventLoop.run());
+return Result(true);
+}
+
 SC::Result snippetForSocketClose(AsyncEventLoop& eventLoop, Console& console)
 {
 SocketDescriptor client;
@@ -1213,6 +2281,40 @@ SC_TRY(eventLoop.run());
 return Result(true);
 }
 
+SC::Result snippetForFileSend(AsyncEventLoop& eventLoop, Console& console, SocketDescriptor& client)
+{
+//! [AsyncFileSendSnippet]
+// Assuming an already created (and running) AsyncEventLoop named `eventLoop`
+// ...
+
+// Assuming an already connected socket named `client`, associated with the event loop
+// ...
+
+// Open the file to send
+FileDescriptor fd;
+FileDescriptor::OpenOptions options;
+options.blocking = false;
+SC_TRY(fd.open("MyFile.bin", FileDescriptor::ReadOnly, options));
+
+// Create the async file send request
+AsyncFileSend asyncFileSend;
+asyncFileSend.callback = [&](AsyncFileSend::Result& res)
+{
+    size_t sentBytes = 0;
+    if(res.get(sentBytes))
+    {
+        console.print("{} bytes sent, {} remaining", sentBytes, res.completionData.remainingBytes);
+        // Continue sending from where previous partial send stopped
+        res.reactivateRequest(res.completionData.remainingBytes > 0);
+    }
+};
+// Send 1 MB starting at offset 4096 in the file
+SC_TRY(asyncFileSend.start(eventLoop, fd, client, 4096, 1024 * 1024));
+//! [AsyncFileSendSnippet]
+SC_TRY(eventLoop.run());
+return Result(true);
+}
+
 SC::Result snippetForFileClose(AsyncEventLoop& eventLoop, Console& console)
 {
 //! [AsyncFileCloseSnippet]
@@ -1244,3 +2346,218 @@ return Result(true);
 }
 // clang-format on
 } // namespace SC
+
+void SC::AsyncTest::loopDNSResolver()
+{
+    // Ip address literals and localhost are resolved without any thread pool round-trip
+    SocketIPAddress addresses[AsyncDNSResolver::MaxAddresses];
+    size_t          numAddresses = 0;
+    SC_TEST_EXPECT(AsyncDNSResolver::resolveLocal("::1", 80, addresses, numAddresses) and numAddresses == 1);
+    SC_TEST_EXPECT(addresses[0].getAddressFamily() == SocketFlags::AddressFamilyIPV6);
+    SC_TEST_EXPECT(AsyncDNSResolver::resolveLocal("localhost", 80, addresses, numAddresses) and numAddresses == 2);
+    SC_TEST_EXPECT(addresses[0].getAddressFamily() == SocketFlags::AddressFamilyIPV4);
+    SC_TEST_EXPECT(addresses[1].getAddressFamily() == SocketFlags::AddressFamilyIPV6);
+    SC_TEST_EXPECT(not AsyncDNSResolver::resolveLocal("127.1", 80, addresses, numAddresses));
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(2));
+    AsyncEventLoop eventLoop;
+    SC_TEST_EXPECT(eventLoop.create(options));
+    AsyncDNSResolver resolver;
+    SC_TEST_EXPECT(resolver.create(eventLoop, threadPool));
+
+    // Short form of an ipv4 address is only understood by the system resolver, that is called on the thread pool
+    AsyncDNSResolver::Request request;
+    int                       numResolved = 0;
+    request.callback                      = [&](AsyncDNSResolver::Request& req)
+    {
+        SC_TEST_EXPECT(req.result);
+        SC_TEST_EXPECT(req.getAddresses().sizeInElements() > 0);
+        numResolved++;
+    };
+    SC_TEST_EXPECT(not resolver.lookup("127.1", 80, addresses, numAddresses));
+    SC_TEST_EXPECT(resolver.resolve(request, "127.1", 80));
+    SC_TEST_EXPECT(not request.isFree());
+    SC_TEST_EXPECT(not resolver.resolve(request, "127.1", 81)); // Resolution is still in progress
+    SC_TEST_EXPECT(eventLoop.run());
+    SC_TEST_EXPECT(numResolved == 1);
+    SC_TEST_EXPECT(request.isFree());
+
+    // Resolved addresses are cached, but callback is still invoked asynchronously
+    SC_TEST_EXPECT(resolver.lookup("127.1", 80, addresses, numAddresses) and numAddresses > 0);
+    SC_TEST_EXPECT(not resolver.lookup("127.1", 81, addresses, numAddresses));
+    SC_TEST_EXPECT(resolver.resolve(request, "127.1", 80));
+    SC_TEST_EXPECT(numResolved == 1);
+    SC_TEST_EXPECT(eventLoop.run());
+    SC_TEST_EXPECT(numResolved == 2);
+
+    // Expired entries are not returned
+    resolver.cacheTimeout = Time::Milliseconds(0);
+    SC_TEST_EXPECT(not resolver.lookup("127.1", 80, addresses, numAddresses));
+    SC_TEST_EXPECT(eventLoop.close());
+}
+
+void SC::AsyncTest::loopPost()
+{
+    AsyncEventLoop eventLoop;
+    SC_TEST_EXPECT(not eventLoop.post(Function<void()>())); // Invalid function
+    AsyncEventLoop::Options postOptions = options;
+    postOptions.postQueueCapacity       = 100;
+    SC_TEST_EXPECT(not eventLoop.create(postOptions)); // Capacity must be a power of two
+    postOptions.postQueueCapacity = 16;
+    SC_TEST_EXPECT(eventLoop.create(postOptions));
+
+    // Functions exceeding queue capacity are rejected, and the ones not executed are destroyed on close
+    int numCalls = 0;
+    for (size_t idx = 0; idx < postOptions.postQueueCapacity; ++idx)
+    {
+        SC_TEST_EXPECT(eventLoop.post([&numCalls] { numCalls++; }));
+    }
+    SC_TEST_EXPECT(not eventLoop.post([&numCalls] { numCalls++; }));
+    SC_TEST_EXPECT(eventLoop.runOnce());
+    SC_TEST_EXPECT(numCalls == static_cast<int>(postOptions.postQueueCapacity));
+    SC_TEST_EXPECT(eventLoop.post([&numCalls] { numCalls++; }));
+    SC_TEST_EXPECT(eventLoop.close());
+    SC_TEST_EXPECT(numCalls == static_cast<int>(postOptions.postQueueCapacity));
+
+    //! [AsyncEventLoopPostSnippet]
+    // Threads feed the event loop with functions that are executed on the thread calling eventLoop.run().
+    static constexpr int NumThreads = 4;
+    static constexpr int NumPosts   = 10000;
+
+    SC_TEST_EXPECT(eventLoop.create(options));
+    struct Context
+    {
+        int      numExecuted = 0; // No need for atomics, posted functions run on the event loop thread
+        uint64_t threadID    = 0;
+        bool     sameThread  = true;
+    } context;
+    context.threadID = Thread::CurrentThreadID();
+
+    Thread threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&eventLoop, &context](Thread&)
+            {
+                for (int idx = 0; idx < NumPosts; ++idx)
+                {
+                    auto func = [&context]
+                    {
+                        context.sameThread = context.sameThread and Thread::CurrentThreadID() == context.threadID;
+                        context.numExecuted++;
+                    };
+                    // Queue is bounded, so let the loop catch up when it's full
+                    while (not eventLoop.post(func))
+                    {
+                        Thread::Sleep(0);
+                    }
+                }
+            }));
+    }
+    // Pending posted functions keep run() alive
+    while (context.numExecuted < NumThreads * NumPosts)
+    {
+        SC_TEST_EXPECT(eventLoop.run());
+    }
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(context.numExecuted == NumThreads * NumPosts);
+    SC_TEST_EXPECT(context.sameThread);
+    SC_TEST_EXPECT(eventLoop.close());
+    //! [AsyncEventLoopPostSnippet]
+}
+
+void SC::AsyncTest::loopStats()
+{
+    // Bucket boundaries are consistent with bucket indices, and relative error is bounded by sub-buckets
+    for (uint32_t idx = 0; idx < AsyncLatencyHistogram::NumBuckets; ++idx)
+    {
+        const uint64_t lowerBound = AsyncLatencyHistogram::getBucketLowerBound(idx);
+        SC_TEST_EXPECT(AsyncLatencyHistogram::getBucketIndex(lowerBound) == idx);
+        if (idx + 1 < AsyncLatencyHistogram::NumBuckets)
+        {
+            const uint64_t nextLowerBound = AsyncLatencyHistogram::getBucketLowerBound(idx + 1);
+            SC_TEST_EXPECT(AsyncLatencyHistogram::getBucketIndex(nextLowerBound - 1) == idx);
+            SC_TEST_EXPECT(idx < 4 or (nextLowerBound - lowerBound) * 4 <= lowerBound);
+        }
+    }
+    SC_TEST_EXPECT(AsyncLatencyHistogram::getBucketIndex(~uint64_t(0)) == AsyncLatencyHistogram::NumBuckets - 1);
+
+    AsyncEventLoopStats::Snapshot snapshot;
+    {
+        // Record 1 to 1000 microseconds
+        AsyncLatencyHistogram histogram;
+        for (uint64_t idx = 1; idx <= 1000; ++idx)
+        {
+            histogram.record(idx * 1000);
+        }
+        AsyncLatencyHistogram::Snapshot& histogramSnapshot = snapshot.pollDuration;
+        histogram.takeSnapshot(histogramSnapshot);
+        SC_TEST_EXPECT(histogramSnapshot.count == 1000);
+        SC_TEST_EXPECT(histogramSnapshot.maximum == 1000 * 1000);
+        SC_TEST_EXPECT(histogramSnapshot.getMean() == 500500);
+        const uint64_t median = histogramSnapshot.getPercentile(50);
+        SC_TEST_EXPECT(median >= 500 * 1000 and median < 500 * 1000 * 5 / 4);
+        SC_TEST_EXPECT(histogramSnapshot.getPercentile(100) == 1000 * 1000);
+        SC_TEST_EXPECT(histogramSnapshot.getPercentile(0) >= 1000 and histogramSnapshot.getPercentile(0) < 1250);
+    }
+
+    //! [AsyncEventLoopStatsSnippet]
+    AsyncEventLoop eventLoop;
+    SC_TEST_EXPECT(eventLoop.create(options));
+
+    // Stats must outlive the event loop (or the call to disableStats)
+    AsyncEventLoopStats stats;
+    eventLoop.enableStats(stats);
+
+    AsyncLoopTimeout timeout1, timeout2;
+
+    int numCallbacks  = 0;
+    timeout1.callback = [&](AsyncLoopTimeout::Result& res)
+    {
+        numCallbacks++;
+        res.reactivateRequest(numCallbacks == 1);
+    };
+    timeout2.callback = [&](AsyncLoopTimeout::Result&)
+    {
+        numCallbacks++;
+        Thread::Sleep(20); // A slow callback delaying all other completions
+    };
+    SC_TEST_EXPECT(timeout1.start(eventLoop, Time::Milliseconds(1)));
+    SC_TEST_EXPECT(timeout2.start(eventLoop, Time::Milliseconds(2)));
+    SC_TEST_EXPECT(eventLoop.run());
+    SC_TEST_EXPECT(numCallbacks == 3);
+
+    // Snapshots can be taken from any thread, for example to periodically export them to a monitoring system
+    Thread thread;
+    SC_TEST_EXPECT(thread.start([&stats, &snapshot](Thread&) { stats.takeSnapshot(snapshot); }));
+    SC_TEST_EXPECT(thread.join());
+
+    const AsyncEventLoopStats::Snapshot::RequestStats& timeouts = snapshot.get(AsyncRequest::Type::LoopTimeout);
+    SC_TEST_EXPECT(timeouts.numStarted == 2);
+    SC_TEST_EXPECT(timeouts.numCompleted == 3);
+    SC_TEST_EXPECT(timeouts.numErrors == 0);
+    SC_TEST_EXPECT(timeouts.completionLatency.count == 3);
+    SC_TEST_EXPECT(timeouts.completionLatency.getPercentile(0) >= 1000 * 1000); // at least 1 ms
+    SC_TEST_EXPECT(timeouts.callbackDuration.count == 3);
+    SC_TEST_EXPECT(timeouts.callbackDuration.maximum >= 20 * 1000 * 1000); // the slow callback shows up here
+    SC_TEST_EXPECT(snapshot.dispatchDuration.maximum >= 20 * 1000 * 1000); // delaying the entire step
+    SC_TEST_EXPECT(snapshot.pollDuration.count > 0);
+    SC_TEST_EXPECT(snapshot.numSteps > 0);
+    SC_TEST_EXPECT(snapshot.maxSubmissions >= 2);
+    SC_TEST_EXPECT(snapshot.numActiveRequests == 0);
+    //! [AsyncEventLoopStatsSnippet]
+
+    // Nothing is recorded after disabling stats
+    eventLoop.disableStats();
+    SC_TEST_EXPECT(timeout2.start(eventLoop, Time::Milliseconds(1)));
+    SC_TEST_EXPECT(eventLoop.run());
+    SC_TEST_EXPECT(numCallbacks == 4);
+    stats.takeSnapshot(snapshot);
+    SC_TEST_EXPECT(snapshot.get(AsyncRequest::Type::LoopTimeout).numStarted == 2);
+    SC_TEST_EXPECT(snapshot.get(AsyncRequest::Type::LoopTimeout).numCompleted == 3);
+    SC_TEST_EXPECT(eventLoop.close());
+}
@@ -135,6 +135,13 @@ T& fieldOffset(R& object)
 /// Silence an `unused variable` or `unused parameter` warning
 #define SC_COMPILER_UNUSED(param) ((void)param)
 
+/// Hints the CPU to start loading in cache the memory at given address (no-op on MSVC)
+#if SC_COMPILER_MSVC
+#define SC_COMPILER_PREFETCH(address) ((void)(address))
+#else
+#define SC_COMPILER_PREFETCH(address) __builtin_prefetch(address)
+#endif
+
 /// Disables `unused-result` warning (due to ignoring a return value marked as `[[nodiscard]]`)
 #if SC_COMPILER_CLANG
 #define SC_COMPILER_WARNING_PUSH_UNUSED_RESULT                                                                         \
@@ -1,7 +1,7 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #include "HttpClient.h"
-#include "../Socket/SocketDescriptor.h" // DNSResolver
+#include "../Socket/SocketDescriptor.h"
 #include "HttpURLParser.h"
 
 #include "../Strings/SmallString.h"
@@ -10,18 +10,11 @@
 SC::Result SC::HttpClient::get(AsyncEventLoop& loop, StringView url)
 {
     eventLoop = &loop;
+    result    = Result(true);
 
-    SmallString<256> ipAddress;
-    uint16_t         port;
-    HttpURLParser    parser;
+    HttpURLParser parser;
     SC_TRY(parser.parse(url));
     SC_TRY_MSG(parser.protocol == "http", "Invalid protocol");
-    // TODO: Make DNS Resolution asynchronous
-    SC_TRY(SocketNetworking::resolveDNS(parser.hostname, ipAddress))
-    port = parser.port;
-    SocketIPAddress localHost;
-    SC_TRY(localHost.fromAddressPort(ipAddress.view(), port));
-    SC_TRY(eventLoop->createAsyncTCPSocket(localHost.getAddressFamily(), clientSocket));
 
     StringBuilder sb(content, StringEncoding::Ascii, StringBuilder::Clear);
 
@@ -29,10 +22,53 @@ SC::Result SC::HttpClient::get(AsyncEventLoop& loop, StringView url)
                      "User-agent: {}\r\n"
                      "Host: {}\r\n\r\n",
                      parser.path, "SC", "127.0.0.1"));
+
+    SocketIPAddress addresses[AsyncDNSResolver::MaxAddresses];
+    size_t          numAddresses = 0;
+    if (AsyncDNSResolver::resolveLocal(parser.hostname, parser.port, addresses, numAddresses))
+    {
+        return connect(addresses[0]);
+    }
+    if (dnsResolver == nullptr)
+    {
+        SC_TRY(SocketNetworking::resolveDNS(parser.hostname, parser.port, addresses, numAddresses));
+        return connect(addresses[0]);
+    }
+    dnsRequest.callback.bind<HttpClient, &HttpClient::onResolved>(*this);
+    return dnsResolver->resolve(dnsRequest, parser.hostname, parser.port);
+}
+
+SC::Result SC::HttpClient::connect(const SocketIPAddress& address)
+{
+    SC_TRY(eventLoop->createAsyncTCPSocket(address.getAddressFamily(), clientSocket));
     const char* dbgName = customDebugName.isEmpty() ? "HttpClient" : customDebugName.bytesIncludingTerminator();
     connectAsync.setDebugName(dbgName);
     connectAsync.callback.bind<HttpClient, &HttpClient::onConnected>(*this);
-    return connectAsync.start(*eventLoop, clientSocket, localHost);
+    return connectAsync.start(*eventLoop, clientSocket, address);
+}
+
+void SC::HttpClient::fail(Result res)
+{
+    if (clientSocket.isValid())
+    {
+        SC_TRUST_RESULT(clientSocket.close());
+    }
+    content.clear();
+    result = res;
+    callback(*this);
+}
+
+void SC::HttpClient::onResolved(AsyncDNSResolver::Request& request)
+{
+    auto res = request.result;
+    if (res)
+    {
+        res = connect(request.getAddresses()[0]);
+    }
+    if (not res)
+    {
+        fail(res);
+    }
 }
 
 SC::StringView SC::HttpClient::getResponse() const
@@ -40,9 +76,13 @@ SC::StringView SC::HttpClient::getResponse() const
     return StringView(content.toSpanConst(), false, StringEncoding::Ascii);
 }
 
-void SC::HttpClient::onConnected(AsyncSocketConnect::Result& result)
+void SC::HttpClient::onConnected(AsyncSocketConnect::Result& connectResult)
 {
-    SC_COMPILER_UNUSED(result);
+    if (not connectResult.isValid())
+    {
+        fail(connectResult.isValid());
+        return;
+    }
     const char* dbgName =
         customDebugName.isEmpty() ? "HttpClient::clientSocket" : customDebugName.bytesIncludingTerminator();
     sendAsync.setDebugName(dbgName);
@@ -51,13 +91,17 @@ void SC::HttpClient::onConnected(AsyncSocketConnect::Result& result)
     auto res = sendAsync.start(*eventLoop, clientSocket, content.toSpanConst());
     if (not res)
     {
-        // TODO: raise error
+        fail(res);
     }
 }
 
-void SC::HttpClient::onAfterSend(AsyncSocketSend::Result& result)
+void SC::HttpClient::onAfterSend(AsyncSocketSend::Result& sendResult)
 {
-    SC_COMPILER_UNUSED(result);
+    if (not sendResult.isValid())
+    {
+        fail(sendResult.isValid());
+        return;
+    }
     SC_ASSERT_RELEASE(content.resizeWithoutInitializing(content.capacity()));
 
     const char* dbgName =
@@ -68,13 +112,599 @@ void SC::HttpClient::onAfterSend(AsyncSocketSend::Result& result)
     auto res = receiveAsync.start(*eventLoop, clientSocket, content.toSpan());
     if (not res)
     {
-        // TODO: raise error
+        fail(res);
     }
 }
 
-void SC::HttpClient::onAfterRead(AsyncSocketReceive::Result& result)
+void SC::HttpClient::onAfterRead(AsyncSocketReceive::Result& receiveResult)
 {
-    SC_COMPILER_UNUSED(result);
+    Span<char> readData;
+    if (not receiveResult.get(readData))
+    {
+        fail(receiveResult.isValid());
+        return;
+    }
+    SC_ASSERT_RELEASE(content.resizeWithoutInitializing(readData.sizeInBytes()));
     SC_ASSERT_RELEASE(SocketClient(clientSocket).close());
     callback(*this);
 }
+
+// HttpClientPool::Request
+static bool equalsIgnoringAsciiCase(SC::StringView first, SC::StringView second)
+{
+    if (first.sizeInBytes() != second.sizeInBytes())
+        return false;
+    const char* a = first.bytesWithoutTerminator();
+    const char* b = second.bytesWithoutTerminator();
+    for (SC::size_t idx = 0; idx < first.sizeInBytes(); ++idx)
+    {
+        const char ca = (a[idx] >= 'A' and a[idx] <= 'Z') ? static_cast<char>(a[idx] - 'A' + 'a') : a[idx];
+        const char cb = (b[idx] >= 'A' and b[idx] <= 'Z') ? static_cast<char>(b[idx] - 'A' + 'a') : b[idx];
+        if (ca != cb)
+            return false;
+    }
+    return true;
+}
+
+bool SC::HttpClientPool::Request::findResponseHeader(StringView headerName, StringView& value) const
+{
+    const char* lineStart = responseHeaders.data();
+    const char* end       = lineStart + responseHeaders.size();
+    bool        isStatus  = true;
+    while (lineStart < end)
+    {
+        const char* lineEnd = lineStart;
+        while (lineEnd < end and *lineEnd != '\r')
+            lineEnd++;
+        if (lineEnd == lineStart)
+            break; // Empty line ending headers
+        const char* colon = lineStart;
+        while (colon < lineEnd and *colon != ':')
+            colon++;
+        const StringView name({lineStart, static_cast<size_t>(colon - lineStart)}, false, StringEncoding::Ascii);
+        if (not isStatus and colon < lineEnd and equalsIgnoringAsciiCase(name, headerName))
+        {
+            const char* valueStart = colon + 1;
+            while (valueStart < lineEnd and (*valueStart == ' ' or *valueStart == '\t'))
+                valueStart++;
+            value = StringView({valueStart, static_cast<size_t>(lineEnd - valueStart)}, false, StringEncoding::Ascii);
+            return true;
+        }
+        isStatus  = false;
+        lineStart = lineEnd + 2; // Skip CRLF
+    }
+    return false;
+}
+
+SC::StringView SC::HttpClientPool::Request::getResponseBody() const
+{
+    return StringView(responseBody.toSpanConst(), false, StringEncoding::Ascii);
+}
+
+// HttpClientPool
+SC::Result SC::HttpClientPool::start(AsyncEventLoop& loop, AsyncDNSResolver& resolver, uint32_t maxConnections)
+{
+    SC_TRY_MSG(eventLoop == nullptr, "HttpClientPool::start - Already started");
+    SC_TRY_MSG(maxConnections > 0, "HttpClientPool::start - maxConnections must be greater than zero");
+    SC_TRY_MSG(maxPipelinedRequests > 0 and maxPipelinedRequests <= MaxPipelinedRequests,
+               "HttpClientPool::start - Invalid maxPipelinedRequests");
+    SC_TRY(connections.resize(maxConnections));
+    // All slots are allocated upfront and never removed, so that a connection closed inside one of its own
+    // callbacks can be re-used without destroying the async request still being completed
+    for (uint32_t idx = 0; idx < maxConnections; ++idx)
+    {
+        SC_TRY_MSG(connections.allocate().isValid(), "HttpClientPool::start - Cannot allocate connection");
+    }
+    for (Connection& connection : connections)
+    {
+        connection.asyncConnect.callback.bind<HttpClientPool, &HttpClientPool::onConnected>(*this);
+        connection.asyncSend.callback.bind<HttpClientPool, &HttpClientPool::onAfterSend>(*this);
+        connection.asyncReceive.callback.bind<HttpClientPool, &HttpClientPool::onReceive>(*this);
+        connection.asyncConnect.setDebugName("HttpClientPool::connect");
+        connection.asyncSend.setDebugName("HttpClientPool::send");
+        connection.asyncReceive.setDebugName("HttpClientPool::receive");
+    }
+    for (AsyncDNSResolver::Request& dnsRequest : dnsRequests)
+    {
+        dnsRequest.callback = [this](AsyncDNSResolver::Request& request) { onResolved(request); };
+    }
+    eventLoop   = &loop;
+    dnsResolver = &resolver;
+    return Result(true);
+}
+
+SC::Result SC::HttpClientPool::close()
+{
+    SC_TRY_MSG(eventLoop != nullptr, "HttpClientPool::close - Not started");
+    for (const Connection& connection : connections)
+    {
+        SC_TRY_MSG(connection.state == ConnectionState::Free or connection.state == ConnectionState::Idle,
+                   "HttpClientPool::close - Requests are still being executed");
+    }
+    for (const Host& host : hosts)
+    {
+        SC_TRY_MSG(host.queue.isEmpty(), "HttpClientPool::close - Requests are still queued");
+    }
+    for (const AsyncDNSResolver::Request& dnsRequest : dnsRequests)
+    {
+        SC_TRY_MSG(dnsRequest.isFree(), "HttpClientPool::close - Hosts are still being resolved");
+    }
+    for (Connection& connection : connections)
+    {
+        if (connection.state == ConnectionState::Idle)
+        {
+            closeConnection(connection, Result(true));
+        }
+    }
+    connections.clear();
+    hosts.clear();
+    eventLoop   = nullptr;
+    dnsResolver = nullptr;
+    return Result(true);
+}
+
+SC::Result SC::HttpClientPool::findOrAddHost(StringView hostname, uint16_t port, size_t& hostIndex)
+{
+    for (hostIndex = 0; hostIndex < hosts.size(); ++hostIndex)
+    {
+        Host& host = hosts[hostIndex];
+        if (host.port != port or not equalsIgnoringAsciiCase(host.hostname.view(), hostname))
+            continue;
+        const Time::HighResolutionCounter now = eventLoop->getLoopTime();
+        if (host.resolved and host.numConnections == 0 and
+            now.isLaterThanOrEqualTo(host.resolveTime.offsetBy(dnsResolver->cacheTimeout)))
+        {
+            host.resolved = false; // Resolve again
+        }
+        return Result(true);
+    }
+    Host host;
+    SC_TRY(host.hostname.assign(hostname));
+    host.port = port;
+    SC_TRY(hosts.push_back(move(host)));
+    return Result(true);
+}
+
+bool SC::HttpClientPool::resolveHost(size_t hostIndex)
+{
+    Host& host = hosts[hostIndex];
+    if (host.resolved)
+        return true;
+    if (host.resolving)
+        return false;
+    SocketIPAddress addresses[AsyncDNSResolver::MaxAddresses];
+    size_t          numAddresses = 0;
+    if (dnsResolver->lookup(host.hostname.view(), host.port, addresses, numAddresses))
+    {
+        host.address     = addresses[0];
+        host.resolved    = true;
+        host.resolveTime = eventLoop->getLoopTime();
+        return true;
+    }
+    for (size_t idx = 0; idx < NumDNSRequests; ++idx)
+    {
+        if (not dnsRequests[idx].isFree())
+            continue;
+        Result res = dnsResolver->resolve(dnsRequests[idx], host.hostname.view(), host.port);
+        if (res)
+        {
+            dnsHostIndex[idx] = hostIndex;
+            host.resolving    = true;
+        }
+        else
+        {
+            failQueuedRequests(hostIndex, res);
+        }
+        return false;
+    }
+    return false; // Resolution will be started when one of the dns requests completes
+}
+
+void SC::HttpClientPool::failQueuedRequests(size_t hostIndex, Result result)
+{
+    // Requests executed again by their callback are queued after all failed ones have been completed
+    IntrusiveDoubleLinkedList<Request> failed;
+    failed.appendBack(hosts[hostIndex].queue);
+    callbackDepth++;
+    while (Request* request = failed.dequeueFront())
+    {
+        request->result = result;
+        request->callback(*request);
+    }
+    callbackDepth--;
+}
+
+SC::Result SC::HttpClientPool::execute(Request& request)
+{
+    SC_TRY_MSG(eventLoop != nullptr, "HttpClientPool::execute - Not started");
+    SC_TRY_MSG(request.next == nullptr and request.prev == nullptr, "HttpClientPool::execute - Already queued");
+    HttpURLParser urlParser;
+    SC_TRY(urlParser.parse(request.url));
+    SC_TRY_MSG(urlParser.protocol == "http", "HttpClientPool::execute - Invalid protocol");
+    SC_TRY(findOrAddHost(urlParser.hostname, urlParser.port, request.hostIndex));
+
+    StringBuilder sb(request.requestHeaders, StringEncoding::Ascii, StringBuilder::Clear);
+    SC_TRY(sb.append("{} {} HTTP/1.1\r\n"
+                     "Host: {}\r\n"
+                     "User-Agent: SC\r\n",
+                     request.method, urlParser.path, urlParser.host));
+    if (not request.body.empty() or request.method == "POST" or request.method == "PUT")
+    {
+        SC_TRY(sb.append("Content-Length: {}\r\n", request.body.sizeInBytes()));
+    }
+    SC_TRY(sb.append(request.headers));
+    SC_TRY(sb.append("\r\n"));
+    SC_TRY_MSG(request.requestHeaders.pop_back(), "HttpClientPool::execute - Cannot pop null terminator");
+
+    request.result     = Result(true);
+    request.statusCode = 0;
+    request.retried    = false;
+    request.responseHeaders.clear();
+    request.responseBody.clear();
+
+    hosts[request.hostIndex].queue.queueBack(request);
+    if (callbackDepth == 0)
+    {
+        dispatchAll();
+    }
+    return Result(true);
+}
+
+void SC::HttpClientPool::dispatch(size_t hostIndex)
+{
+    if (hosts[hostIndex].queue.isEmpty() or not resolveHost(hostIndex))
+        return;
+    Host& host = hosts[hostIndex];
+    while (not host.queue.isEmpty())
+    {
+        Connection* idle = nullptr;
+        Connection* free = nullptr;
+        Connection* idleOtherHost = nullptr;
+        for (Connection& connection : connections)
+        {
+            if (connection.state == ConnectionState::Idle)
+            {
+                if (connection.hostIndex == hostIndex)
+                {
+                    idle = &connection;
+                    break;
+                }
+                idleOtherHost = &connection;
+            }
+            else if (connection.state == ConnectionState::Free and free == nullptr)
+            {
+                free = &connection;
+            }
+        }
+        if (idle != nullptr)
+        {
+            Result res = sendRequests(*idle);
+            if (not res)
+            {
+                closeConnection(*idle, res);
+            }
+            continue;
+        }
+        if (host.numConnections >= maxConnectionsPerHost)
+            break; // Requests will be sent when one of the connections to this host becomes idle
+        if (free == nullptr and idleOtherHost != nullptr)
+        {
+            // Make room, closing a connection that is not being used
+            closeConnection(*idleOtherHost, Result(true));
+            free = idleOtherHost;
+        }
+        if (free == nullptr)
+            break; // Requests will be sent when any connection is closed
+        Connection& connection = *free;
+        connection.hostIndex   = hostIndex;
+        connection.state       = ConnectionState::Connecting;
+        host.numConnections++;
+        // Requests are assigned now, so that next iterations will not open more connections for them
+        for (uint32_t idx = 0; idx < maxPipelinedRequests and not host.queue.isEmpty(); ++idx)
+        {
+            connection.inFlight.queueBack(*host.queue.dequeueFront());
+        }
+        Result res = eventLoop->createAsyncTCPSocket(host.address.getAddressFamily(), connection.socket);
+        if (res)
+        {
+            res = connection.asyncConnect.start(*eventLoop, connection.socket, host.address);
+        }
+        if (not res)
+        {
+            closeConnection(connection, res);
+            continue;
+        }
+        numOpenedConnections++;
+    }
+}
+
+void SC::HttpClientPool::dispatchAll()
+{
+    for (size_t idx = 0; idx < hosts.size(); ++idx)
+    {
+        dispatch(idx);
+    }
+}
+
+SC::Result SC::HttpClientPool::sendRequests(Connection& connection)
+{
+    Host& host = hosts[connection.hostIndex];
+    if (connection.state == ConnectionState::Idle)
+    {
+        for (uint32_t idx = 0; idx < maxPipelinedRequests and not host.queue.isEmpty(); ++idx)
+        {
+            connection.inFlight.queueBack(*host.queue.dequeueFront());
+        }
+    }
+    size_t numBuffers = 0;
+    for (Request* request = connection.inFlight.peekFront(); request != nullptr; request = request->next)
+    {
+        connection.sendBuffers[numBuffers++] = request->requestHeaders.toSpanConst();
+        if (not request->body.empty())
+        {
+            connection.sendBuffers[numBuffers++] = request->body;
+        }
+    }
+    connection.state = ConnectionState::Sending;
+    resetResponseState(connection);
+    return connection.asyncSend.startVectored(*eventLoop, connection.socket, {connection.sendBuffers, numBuffers});
+}
+
+void SC::HttpClientPool::resetResponseState(Connection& connection)
+{
+    connection.parser      = HttpParser();
+    connection.parser.type = HttpParser::Type::Response;
+
+    connection.chunkedParser      = HttpChunkedParser();
+    connection.bodyBytesLeft      = 0;
+    connection.headersReceived    = false;
+    connection.chunkedBody        = false;
+    connection.bodyUntilClose     = false;
+    connection.closeAfterResponse = false;
+    connection.receivingResponse  = false;
+}
+
+void SC::HttpClientPool::completeRequest(Connection& connection, Result result)
+{
+    Request& request = *connection.inFlight.dequeueFront();
+    request.result   = result;
+    resetResponseState(connection);
+    // Requests executed by the callback are only queued, and they're dispatched after all responses have been
+    // processed, so that they can re-use this same connection
+    callbackDepth++;
+    request.callback(request);
+    callbackDepth--;
+}
+
+void SC::HttpClientPool::closeConnection(Connection& connection, Result result)
+{
+    // Some requests may have never been received by the server, if it closed a stale keep-alive connection.
+    // They're sent again once on a new connection, failing all others.
+    IntrusiveDoubleLinkedList<Request> retryQueue;
+    while (Request* request = connection.inFlight.peekFront())
+    {
+        const bool stale = connection.receivedAnyResponse and not connection.receivingResponse;
+        if (result or (stale and not request->retried))
+        {
+            request->retried = request->retried or not result;
+            retryQueue.queueBack(*connection.inFlight.dequeueFront());
+        }
+        else
+        {
+            completeRequest(connection, result);
+        }
+        connection.receivingResponse = false; // Only the first request can have received part of its response
+    }
+    Host& host = hosts[connection.hostIndex];
+    retryQueue.appendBack(host.queue);
+    host.queue.appendBack(retryQueue);
+
+    (void)connection.socket.close();
+    if (connection.state != ConnectionState::Free)
+    {
+        host.numConnections--;
+    }
+    connection.state               = ConnectionState::Free;
+    connection.receivedAnyResponse = false;
+}
+
+void SC::HttpClientPool::onResolved(AsyncDNSResolver::Request& request)
+{
+    const size_t hostIndex = dnsHostIndex[&request - dnsRequests];
+    Host&        host      = hosts[hostIndex];
+    host.resolving         = false;
+    if (request.result)
+    {
+        host.address     = request.getAddresses()[0];
+        host.resolved    = true;
+        host.resolveTime = eventLoop->getLoopTime();
+    }
+    else
+    {
+        failQueuedRequests(hostIndex, request.result);
+    }
+    dispatchAll();
+}
+
+void SC::HttpClientPool::onConnected(AsyncSocketConnect::Result& result)
+{
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    Connection& connection = SC_COMPILER_FIELD_OFFSET(Connection, asyncConnect, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    Result res = result.isValid();
+    if (res)
+    {
+        res = sendRequests(connection);
+    }
+    if (not res)
+    {
+        closeConnection(connection, res);
+        dispatchAll();
+    }
+}
+
+void SC::HttpClientPool::onAfterSend(AsyncSocketSend::Result& result)
+{
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    Connection& connection = SC_COMPILER_FIELD_OFFSET(Connection, asyncSend, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    // Responses are received only after sending all requests, as a socket can't be monitored by multiple requests
+    Result res = result.isValid();
+    if (res)
+    {
+        connection.state = ConnectionState::Receiving;
+        res = connection.asyncReceive.start(*eventLoop, connection.socket,
+                                            {connection.receiveBuffer, sizeof(connection.receiveBuffer)});
+    }
+    if (not res)
+    {
+        closeConnection(connection, res);
+        dispatchAll();
+    }
+}
+
+void SC::HttpClientPool::onReceive(AsyncSocketReceive::Result& result)
+{
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    Connection& connection = SC_COMPILER_FIELD_OFFSET(Connection, asyncReceive, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    Span<char> readData;
+    if (not result.get(readData))
+    {
+        closeConnection(connection, Result::Error("HttpClientPool - Receive failed"));
+        dispatchAll();
+        return;
+    }
+    if (readData.empty())
+    {
+        // Connection has been closed by the server
+        if (connection.bodyUntilClose)
+        {
+            completeRequest(connection, Result(true));
+        }
+        closeConnection(connection, Result::Error("HttpClientPool - Connection closed by server"));
+        dispatchAll();
+        return;
+    }
+    switch (processResponseData(connection, readData))
+    {
+    case ProcessResult::NeedsData: result.reactivateRequest(true); return;
+    case ProcessResult::Finished: connection.state = ConnectionState::Idle; break;
+    case ProcessResult::Close:
+        closeConnection(connection, Result(true)); // Requests not answered yet are sent on a new connection
+        break;
+    }
+    dispatchAll();
+}
+
+SC::HttpClientPool::ProcessResult SC::HttpClientPool::processResponseData(Connection& connection,
+                                                                            Span<const char> data)
+{
+    while (not data.empty())
+    {
+        Request* request = connection.inFlight.peekFront();
+        if (request == nullptr)
+            return ProcessResult::Close; // Data not belonging to any request
+
+        connection.receivingResponse = true;
+
+        size_t readBytes   = 0;
+        bool   responseEnd = false;
+        if (not connection.headersReceived)
+        {
+            HttpParser&      parser = connection.parser;
+            Span<const char> parsedData;
+            if (not parser.parse(data, readBytes, parsedData) or
+                not request->responseHeaders.append({data.data(), readBytes}))
+            {
+                completeRequest(connection, Result::Error("HttpClientPool - Invalid response headers"));
+                return ProcessResult::Close;
+            }
+            if (parser.state == HttpParser::State::Result and parser.result == HttpParser::Result::HeadersEnd)
+            {
+                onResponseHeaders(connection, *request);
+                responseEnd = not connection.chunkedBody and not connection.bodyUntilClose and
+                              connection.bodyBytesLeft == 0;
+            }
+        }
+        else
+        {
+            Span<const char> bodyData;
+            if (connection.chunkedBody)
+            {
+                if (not connection.chunkedParser.parse(data, readBytes, bodyData))
+                {
+                    completeRequest(connection, Result::Error("HttpClientPool - Invalid chunked body"));
+                    return ProcessResult::Close;
+                }
+                responseEnd = connection.chunkedParser.isFinished();
+            }
+            else
+            {
+                readBytes = data.sizeInBytes();
+                if (not connection.bodyUntilClose)
+                {
+                    readBytes = connection.bodyBytesLeft < readBytes ? static_cast<size_t>(connection.bodyBytesLeft)
+                                                                     : readBytes;
+                    connection.bodyBytesLeft -= readBytes;
+                    responseEnd = connection.bodyBytesLeft == 0;
+                }
+                bodyData = {data.data(), readBytes};
+            }
+            if (not request->responseBody.append(bodyData))
+            {
+                completeRequest(connection, Result::Error("HttpClientPool - Cannot allocate response body"));
+                return ProcessResult::Close;
+            }
+        }
+        (void)data.sliceStart(readBytes, data);
+        if (responseEnd)
+        {
+            const bool mustClose           = connection.closeAfterResponse;
+            connection.receivedAnyResponse = true;
+            completeRequest(connection, Result(true));
+            if (mustClose)
+                return ProcessResult::Close;
+        }
+    }
+    return connection.inFlight.isEmpty() ? ProcessResult::Finished : ProcessResult::NeedsData;
+}
+
+void SC::HttpClientPool::onResponseHeaders(Connection& connection, Request& request)
+{
+    request.statusCode         = connection.parser.statusCode;
+    connection.headersReceived = true;
+
+    // Persistent connections are the default since HTTP/1.1 only
+    StringView value;
+    const bool hasConnection = request.findResponseHeader("Connection", value);
+    if (StringView(request.responseHeaders.toSpanConst(), false, StringEncoding::Ascii).startsWith("HTTP/1.0"))
+    {
+        connection.closeAfterResponse = not hasConnection or not equalsIgnoringAsciiCase(value, "keep-alive");
+    }
+    else
+    {
+        connection.closeAfterResponse = hasConnection and equalsIgnoringAsciiCase(value, "close");
+    }
+
+    const uint32_t statusCode = request.statusCode;
+    if (request.method == "HEAD" or statusCode / 100 == 1 or statusCode == 204 or statusCode == 304)
+        return; // Response has no body, even if it declares a Content-Length
+    if (request.findResponseHeader("Transfer-Encoding", value))
+    {
+        connection.chunkedBody = value.endsWith("chunked");
+    }
+    if (not connection.chunkedBody)
+    {
+        if (request.findResponseHeader("Content-Length", value))
+        {
+            connection.bodyBytesLeft = connection.parser.contentLength;
+        }
+        else
+        {
+            // Body ends when the server closes the connection
+            connection.bodyUntilClose     = true;
+            connection.closeAfterResponse = true;
+        }
+    }
+}
@@ -2,12 +2,17 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 #include "../Async/Async.h"
+#include "../Containers/ArenaMap.h"
+#include "../Containers/IntrusiveDoubleLinkedList.h"
 #include "../Containers/SmallVector.h"
+#include "../Strings/SmallString.h"
 #include "../Strings/String.h"
+#include "HttpParser.h"
 namespace SC
 {
 /// @brief HTTP parser, client and server (see @ref library_http)
 struct HttpClient;
+struct HttpClientPool;
 } // namespace SC
 
 //! @defgroup group_http Http
@@ -22,33 +27,220 @@ struct SC::HttpClient
     /// @brief Setups this client to execute a `GET` request on the given url
     /// @param loop The AsyncEventLoop to use for monitoring network packets
     /// @param url The url to `GET`
-    /// @return Valid Result if dns resolution and creation of underlying client tcp socket succeeded
+    /// @return Valid Result if the url is valid and connection (or host resolution) has been started
     [[nodiscard]] Result get(AsyncEventLoop& loop, StringView url);
 
-    Delegate<HttpClient&> callback; ///< The callback that is called after `GET` operation succeeded
+    /// @brief The callback that is called after `GET` operation succeeded or failed (see HttpClient::getResult)
+    Delegate<HttpClient&> callback;
+
+    /// @brief Resolver used for host names that are not ip addresses or `localhost` (that are resolved directly).
+    /// When `nullptr` host names are resolved with SocketNetworking::resolveDNS, blocking the event loop thread.
+    AsyncDNSResolver* dnsResolver = nullptr;
 
     /// @brief Get the response StringView sent by the server
     [[nodiscard]] StringView getResponse() const;
 
+    /// @brief Get the result of last `GET` operation (host resolution, connection, send or receive errors)
+    [[nodiscard]] Result getResult() const { return result; }
+
     [[nodiscard]] Result setCustomDebugName(const StringView debugName)
     {
         return Result(customDebugName.assign(debugName));
     }
 
   private:
+    [[nodiscard]] Result connect(const SocketIPAddress& address);
+
+    void fail(Result res);
+    void onResolved(AsyncDNSResolver::Request& request);
     void onConnected(AsyncSocketConnect::Result& result);
     void onAfterSend(AsyncSocketSend::Result& result);
     void onAfterRead(AsyncSocketReceive::Result& result);
 
     SmallVector<char, 1024> content;
+    Result                  result = Result(true);
 
     String customDebugName;
 
     // TODO: can we find a way to put all async requests in a single tagged union when they're not used in parallel?
+    AsyncDNSResolver::Request dnsRequest;
+
     AsyncSocketConnect connectAsync;
     AsyncSocketSend    sendAsync;
     AsyncSocketReceive receiveAsync;
     SocketDescriptor   clientSocket;
     AsyncEventLoop*    eventLoop = nullptr;
 };
+
+/// @brief Http async client executing requests on persistent (keep-alive) connections, shared between requests
+/// to the same host. @n
+/// Host names are resolved asynchronously through an AsyncDNSResolver (that caches them), and requests exceeding the
+/// available connections are queued.
+/// Requests queued to the same host are pipelined on a single connection (up to
+/// HttpClientPool::maxPipelinedRequests), that is re-used as soon as all of their responses have been received.
+struct SC::HttpClientPool
+{
+    /// @brief A request executed by HttpClientPool. @n
+    /// The object (and all of the memory its StringView / Span point to) must be valid until its callback is called.
+    /// It can be executed again from inside its own callback.
+    struct Request
+    {
+        StringView       method = "GET"; ///< Http method (`GET`, `POST`, `PUT`, `DELETE` etc.)
+        StringView       url;            ///< Absolute url (only `http` protocol is supported)
+        StringView       headers;        ///< Additional headers, each one terminated by `\r\n` (can be empty)
+        Span<const char> body;           ///< Request body (sent with a `Content-Length` header when not empty)
+
+        Function<void(Request&)> callback; ///< Called when the response has been received (or on error)
+
+        Result result = Result(true); ///< Result of the request (valid when a response has been received)
+
+        uint32_t               statusCode = 0;  ///< Response status code
+        SmallVector<char, 512> responseHeaders; ///< Response status line and headers
+        Vector<char>           responseBody;    ///< Response body (already decoded, if chunked)
+
+        /// @brief Finds value of the first response header with a given name (compared case-insensitively)
+        /// @param headerName Name of the header to look for (for example `Content-Type`)
+        /// @param value A StringView, pointing at responseHeaders containing the header value
+        /// @return `true` if the header has been found
+        [[nodiscard]] bool findResponseHeader(StringView headerName, StringView& value) const;
+
+        /// @brief Get the response body as a StringView
+        [[nodiscard]] StringView getResponseBody() const;
+
+      private:
+        friend struct HttpClientPool;
+        friend struct IntrusiveDoubleLinkedList<Request>;
+
+        Request* next = nullptr;
+        Request* prev = nullptr;
+
+        SmallVector<char, 256> requestHeaders; // Request line and headers, serialized by HttpClientPool::execute
+
+        size_t hostIndex = 0;
+        bool   retried   = false; // Request has been sent again after finding a stale keep-alive connection
+    };
+
+    HttpClientPool() {}
+    HttpClientPool(const HttpClientPool&)            = delete;
+    HttpClientPool& operator=(const HttpClientPool&) = delete;
+
+    static constexpr uint32_t MaxPipelinedRequests = 16; ///< Upper limit for maxPipelinedRequests
+
+    uint32_t maxConnectionsPerHost = 4; ///< Maximum number of concurrent connections to the same host
+    uint32_t maxPipelinedRequests  = 8; ///< Maximum number of requests sent at once on a connection
+
+    /// @brief Starts the pool on the given AsyncEventLoop
+    /// @param loop The event loop to be used for all connections
+    /// @param dnsResolver The resolver for host names (addresses are resolved again after its cache timeout, when no
+    /// connection to the host is open)
+    /// @param maxConnections Maximum number of concurrent connections (to all hosts)
+    /// @return Valid Result if the pool has been started successfully
+    [[nodiscard]] Result start(AsyncEventLoop& loop, AsyncDNSResolver& dnsResolver, uint32_t maxConnections);
+
+    /// @brief Closes all connections. Must be called when no request is being executed.
+    /// @return Valid Result if all connections have been closed successfully
+    [[nodiscard]] Result close();
+
+    /// @brief Queues a request, that will be sent as soon as a connection to its host is available
+    /// @param request The request to execute (see HttpClientPool::Request for lifetime requirements)
+    /// @return Valid Result if the url is valid and the request has been queued (callback receives resolution errors)
+    [[nodiscard]] Result execute(Request& request);
+
+    /// @brief Returns total number of connections opened by the pool (re-used connections are counted once)
+    [[nodiscard]] uint32_t getNumOpenedConnections() const { return numOpenedConnections; }
+
+  private:
+    struct Host
+    {
+        SmallString<64> hostname;
+        uint16_t        port = 0;
+        SocketIPAddress address;
+
+        Time::HighResolutionCounter resolveTime;
+
+        bool resolved  = false;
+        bool resolving = false; // One of HttpClientPool::dnsRequests is resolving this host
+
+        IntrusiveDoubleLinkedList<Request> queue; // Requests waiting for a connection
+        uint32_t                           numConnections = 0;
+    };
+
+    enum class ConnectionState
+    {
+        Free,       // Slot not used by any connection
+        Connecting, // Connection is being established, with requests already assigned
+        Sending,    // Requests are being sent
+        Receiving,  // Waiting for responses to all sent requests
+        Idle,       // Connected, waiting for new requests to its host
+    };
+
+    struct Connection
+    {
+        ConnectionState state     = ConnectionState::Free;
+        size_t          hostIndex = 0;
+
+        SocketDescriptor   socket;
+        AsyncSocketConnect asyncConnect;
+        AsyncSocketSend    asyncSend;
+        AsyncSocketReceive asyncReceive;
+
+        IntrusiveDoubleLinkedList<Request> inFlight; // Sent requests, waiting for their response in order
+        Span<const char> sendBuffers[2 * MaxPipelinedRequests]; // Headers and body of every request in inFlight
+
+        char receiveBuffer[4096];
+
+        // State of the response being received for the request at front of inFlight
+        HttpParser        parser;
+        HttpChunkedParser chunkedParser;
+        uint64_t          bodyBytesLeft       = 0;
+        bool              headersReceived     = false;
+        bool              chunkedBody         = false;
+        bool              bodyUntilClose      = false; // Body without Content-Length, ending when server closes
+        bool              closeAfterResponse  = false;
+        bool              receivingResponse   = false; // Some data of current response has been received
+        bool              receivedAnyResponse = false; // A response has been received (connection is being re-used)
+    };
+
+    enum class ProcessResult
+    {
+        NeedsData, // Some responses have not been fully received yet
+        Finished,  // All responses to requests sent on the connection have been received
+        Close,     // Connection must be closed (after completing all responses it could deliver)
+    };
+
+    // At least two are needed, as a request is still in use while inside its own callback
+    static constexpr size_t NumDNSRequests = 4;
+
+    AsyncEventLoop*      eventLoop   = nullptr;
+    AsyncDNSResolver*    dnsResolver = nullptr;
+    ArenaMap<Connection> connections;
+    SmallVector<Host, 4> hosts;
+
+    AsyncDNSResolver::Request dnsRequests[NumDNSRequests];
+    size_t                    dnsHostIndex[NumDNSRequests] = {0};
+
+    uint32_t numOpenedConnections = 0;
+    int      callbackDepth        = 0; // Requests are only queued while inside a request callback
+
+    [[nodiscard]] Result findOrAddHost(StringView hostname, uint16_t port, size_t& hostIndex);
+    [[nodiscard]] bool   resolveHost(size_t hostIndex);
+
+    void dispatch(size_t hostIndex);
+    void dispatchAll();
+
+    [[nodiscard]] Result        sendRequests(Connection& connection);
+    [[nodiscard]] ProcessResult processResponseData(Connection& connection, Span<const char> data);
+
+    void onResponseHeaders(Connection& connection, Request& request);
+
+    void completeRequest(Connection& connection, Result result);
+    void failQueuedRequests(size_t hostIndex, Result result);
+    void closeConnection(Connection& connection, Result result);
+    void resetResponseState(Connection& connection);
+
+    void onResolved(AsyncDNSResolver::Request& request);
+    void onConnected(AsyncSocketConnect::Result& result);
+    void onAfterSend(AsyncSocketSend::Result& result);
+    void onReceive(AsyncSocketReceive::Result& result);
+};
 //! @}
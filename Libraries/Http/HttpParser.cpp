@@ -4,6 +4,17 @@
 #include "../Foundation/Span.h"
 #include "../Strings/StringView.h"
 
+#if SC_PLATFORM_ARM64
+#include <arm_neon.h>
+#define SC_HTTP_PARSER_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SC_HTTP_PARSER_SSE2 1
+#if SC_COMPILER_MSVC
+#include <intrin.h>
+#endif
+#endif
+
 // https://www.chiark.greenend.org.uk/~sgtatham/coroutines.html
 #if SC_COMPILER_MSVC
 #define SC_CAT(x, y)  SC_CAT2(x, y)
@@ -31,6 +42,54 @@
     }
 #define crReset(state) state = 0;
 
+// Returns the index of first delimiter found in data (or length when not found), comparing 16 bytes at time
+static SC::size_t findDelimiter(const char* data, SC::size_t length, char delimiter)
+{
+    SC::size_t idx = 0;
+#if SC_HTTP_PARSER_SSE2
+    const __m128i pattern = _mm_set1_epi8(delimiter);
+    for (; idx + 16 <= length; idx += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + idx));
+        const int     mask  = _mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+        if (mask != 0)
+        {
+#if SC_COMPILER_MSVC
+            unsigned long index;
+            _BitScanForward(&index, static_cast<unsigned long>(mask));
+            return idx + index;
+#else
+            return idx + static_cast<SC::size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+#endif
+        }
+    }
+#elif SC_HTTP_PARSER_NEON
+    const uint8x16_t pattern = vdupq_n_u8(static_cast<uint8_t>(delimiter));
+    for (; idx + 16 <= length; idx += 16)
+    {
+        const uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + idx)), pattern);
+        // Narrowing shift packs the 16 byte lanes comparison results into a 64 bit mask (4 bits for each lane)
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+        if (mask != 0)
+        {
+#if SC_COMPILER_MSVC
+            unsigned long index;
+            _BitScanForward64(&index, mask);
+            return idx + index / 4;
+#else
+            return idx + static_cast<SC::size_t>(__builtin_ctzll(mask)) / 4;
+#endif
+        }
+    }
+#endif
+    for (; idx < length; ++idx)
+    {
+        if (data[idx] == delimiter)
+            break;
+    }
+    return idx;
+}
+
 SC::Result SC::HttpParser::parse(Span<const char> data, size_t& readBytes, Span<const char>& parsedData)
 {
     if (state == State::Finished)
@@ -278,10 +337,25 @@ SC::Result SC::HttpParser::process(Span<const char>& data, size_t& readBytes, Sp
     const auto initialStart  = tokenStart;
     const auto initialLength = tokenLength;
     readBytes                = 0;
-    for (auto c : data)
+
+    const char*  bytes  = data.data();
+    const size_t length = data.sizeInBytes();
+    while (readBytes < length)
     {
+        if (scanDelimiter != 0 and vectorizedScanning)
+        {
+            // Fast path skipping all bytes before the delimiter, as they don't change parser state
+            const size_t skipped = findDelimiter(bytes + readBytes, length - readBytes, scanDelimiter);
+            tokenLength += skipped;
+            readBytes += skipped;
+            if (readBytes == length)
+            {
+                break;
+            }
+            scanDelimiter = 0;
+        }
         tokenLength++;
-        SC_TRY((this->*Func)(c)); // can modify start or length with spaces
+        SC_TRY((this->*Func)(bytes[readBytes])); // can modify start or length with spaces
         readBytes++;
         if (state == State::Result)
         {
@@ -296,6 +370,7 @@ SC::Result SC::HttpParser::process(Span<const char>& data, size_t& readBytes, Sp
         SC_TRY(data.sliceStartLength(startDelta, lengthDelta, parsedData));
         SC_TRY(data.sliceStart(readBytes, data));
         crReset(nestedParserCoroutine);
+        scanDelimiter = 0;
     }
     else
     {
@@ -365,7 +440,10 @@ bool SC::HttpParser::parseUrl(char currentChar)
     else
     {
         while (currentChar != ' ')
+        {
+            scanDelimiter = ' ';
             SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
+        }
         tokenLength--;
         state = State::Result;
     }
@@ -442,6 +520,14 @@ bool SC::HttpParser::parseHeaderName(char currentChar)
             }
         }
         matchIndex += 1;
+        scanDelimiter = ':';
+        for (size_t idx = 0; idx < numMatches; ++idx)
+        {
+            if (matchingHeader[idx] != 0)
+            {
+                scanDelimiter = 0; // Still matching a known header, so every char must be checked
+            }
+        }
         SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
     }
     state = State::Result;
@@ -473,6 +559,7 @@ bool SC::HttpParser::parseHeaderValue(char currentChar)
             state = State::Result;
             break;
         }
+        scanDelimiter = '\r';
         SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
     }
     SC_CO_FINISH(nestedParserCoroutine);
@@ -576,3 +663,95 @@ bool SC::HttpParser::parseHeadersEnd(char currentChar)
     SC_CO_FINISH(nestedParserCoroutine);
     return true;
 }
+
+// HttpChunkedParser
+SC::Result SC::HttpChunkedParser::parse(Span<const char> data, size_t& readBytes, Span<const char>& bodyData)
+{
+    readBytes = 0;
+    bodyData  = {};
+
+    const size_t dataSize = data.sizeInBytes();
+    while (readBytes < dataSize and state != State::Finished)
+    {
+        if (state == State::ChunkData)
+        {
+            const size_t available = dataSize - readBytes;
+            const size_t numBytes  = chunkBytesLeft < available ? static_cast<size_t>(chunkBytesLeft) : available;
+            SC_TRY(data.sliceStartLength(readBytes, numBytes, bodyData));
+            readBytes += numBytes;
+            chunkBytesLeft -= numBytes;
+            if (chunkBytesLeft == 0)
+            {
+                state = State::ChunkDataCR;
+            }
+            break; // Return every contiguous span of body data as soon as it's found
+        }
+        const char currentChar = data.data()[readBytes++];
+        switch (state)
+        {
+        case State::ChunkSize: {
+            int digit = -1;
+            if (currentChar >= '0' and currentChar <= '9')
+                digit = currentChar - '0';
+            else if (currentChar >= 'a' and currentChar <= 'f')
+                digit = currentChar - 'a' + 10;
+            else if (currentChar >= 'A' and currentChar <= 'F')
+                digit = currentChar - 'A' + 10;
+
+            if (digit >= 0)
+            {
+                SC_TRY_MSG(numSizeDigits < 16, "HttpChunkedParser - Chunk size too big");
+                chunkBytesLeft = (chunkBytesLeft << 4) | static_cast<uint64_t>(digit);
+                numSizeDigits++;
+                break;
+            }
+            SC_TRY_MSG(numSizeDigits > 0, "HttpChunkedParser - Missing chunk size");
+            if (currentChar == ';')
+                state = State::ChunkExtension;
+            else if (currentChar == '\r')
+                state = State::ChunkSizeEnd;
+            else
+                return Result::Error("HttpChunkedParser - Invalid chunk size");
+            break;
+        }
+        case State::ChunkExtension: {
+            if (currentChar == '\r')
+                state = State::ChunkSizeEnd;
+            break;
+        }
+        case State::ChunkSizeEnd: {
+            SC_TRY_MSG(currentChar == '\n', "HttpChunkedParser - Expected LF after chunk size");
+            numSizeDigits = 0;
+            state         = chunkBytesLeft == 0 ? State::TrailerStart : State::ChunkData;
+            break;
+        }
+        case State::ChunkDataCR: {
+            SC_TRY_MSG(currentChar == '\r', "HttpChunkedParser - Expected CR after chunk data");
+            state = State::ChunkDataLF;
+            break;
+        }
+        case State::ChunkDataLF: {
+            SC_TRY_MSG(currentChar == '\n', "HttpChunkedParser - Expected LF after chunk data");
+            state = State::ChunkSize;
+            break;
+        }
+        case State::TrailerStart: {
+            state = currentChar == '\r' ? State::TrailerEnd : State::TrailerLine;
+            break;
+        }
+        case State::TrailerLine: {
+            if (currentChar == '\n')
+                state = State::TrailerStart;
+            break;
+        }
+        case State::TrailerEnd: {
+            SC_TRY_MSG(currentChar == '\n', "HttpChunkedParser - Expected LF after trailers");
+            state = State::Finished;
+            break;
+        }
+        case State::ChunkData:
+        case State::Finished: break;
+        }
+    }
+    return Result(true);
+}
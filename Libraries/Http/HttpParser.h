@@ -7,6 +7,7 @@
 namespace SC
 {
 struct HttpParser;
+struct HttpChunkedParser;
 } // namespace SC
 
 //! @addtogroup group_http
@@ -62,6 +63,10 @@ struct SC::HttpParser
     };
     Type type = Type::Request; ///< Type of http stream (request or response)
 
+    /// Skip bytes that can't change parser state (in url and header values) with SSE2 / NEON scanning.
+    /// When `false` every byte goes through the per byte state machine, producing the same results.
+    bool vectorizedScanning = true;
+
     /// @brief Parse an incoming chunk of bytes, returning actually parsed span
     /// @param data Incoming chunk of bytes to be parsed
     /// @param readBytes Number of bytes actually read
@@ -84,6 +89,7 @@ struct SC::HttpParser
     int    topLevelCoroutine     = 0;
     int    nestedParserCoroutine = 0;
     bool   parsedContentLength   = false;
+    char   scanDelimiter         = 0; // When not zero, all bytes before it can be skipped (see process)
     size_t matchIndex            = 0;
 
     static constexpr size_t numMatches = 1;
@@ -107,4 +113,38 @@ struct SC::HttpParser
     [[nodiscard]] SC::Result process(Span<const char>& data, size_t& readBytes, Span<const char>& parsedData);
 };
 
+/// @brief Incremental decoder of an http body sent with `Transfer-Encoding: chunked`. @n
+/// Chunk sizes, extensions and trailers are consumed without being buffered, so that a body of any length can be
+/// decoded in constant memory.
+struct SC::HttpChunkedParser
+{
+    /// @brief Decodes an incoming slice of a chunked body, returning a span of body data found in it
+    /// @param data Incoming chunk of bytes to be decoded
+    /// @param readBytes Number of bytes of `data` actually consumed (the rest must be passed again to parse)
+    /// @param bodyData A sub-span of `data` pointing at decoded body bytes (can be empty)
+    /// @return Valid result if the chunked encoding is well formed
+    [[nodiscard]] SC::Result parse(Span<const char> data, size_t& readBytes, Span<const char>& bodyData);
+
+    /// @brief Returns `true` after the last chunk and trailers have been decoded
+    [[nodiscard]] bool isFinished() const { return state == State::Finished; }
+
+  private:
+    enum class State
+    {
+        ChunkSize,
+        ChunkExtension,
+        ChunkSizeEnd,
+        ChunkData,
+        ChunkDataCR,
+        ChunkDataLF,
+        TrailerStart,
+        TrailerLine,
+        TrailerEnd,
+        Finished,
+    };
+    State    state          = State::ChunkSize;
+    uint64_t chunkBytesLeft = 0;
+    size_t   numSizeDigits  = 0;
+};
+
 //! @}
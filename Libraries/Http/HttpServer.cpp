@@ -5,18 +5,208 @@
 #include "../Strings/StringBuilder.h"
 
 // HttpServerBase::Request
+static char toLowerAscii(char c) { return (c >= 'A' and c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+static bool equalsAsciiCaseInsensitive(SC::StringView first, SC::StringView second)
+{
+    if (first.sizeInBytes() != second.sizeInBytes())
+        return false;
+    const char* a = first.bytesWithoutTerminator();
+    const char* b = second.bytesWithoutTerminator();
+    for (SC::size_t idx = 0; idx < first.sizeInBytes(); ++idx)
+    {
+        if (toLowerAscii(a[idx]) != toLowerAscii(b[idx]))
+            return false;
+    }
+    return true;
+}
+
+// FNV-1a hash of lowercased header name, so that names differing only by case end up in the same slot
+static SC::uint32_t hashHeaderName(SC::StringView name)
+{
+    SC::uint32_t hash  = 2166136261u;
+    const char*  bytes = name.bytesWithoutTerminator();
+    for (SC::size_t idx = 0; idx < name.sizeInBytes(); ++idx)
+    {
+        hash = (hash ^ static_cast<SC::uint8_t>(toLowerAscii(bytes[idx]))) * 16777619u;
+    }
+    return hash;
+}
+
+// Must be kept in sync with HttpServerBase::Request::HeaderType
+static constexpr SC::StringView knownHeaderNames[] = {
+    "Host",   "Content-Length",  "Content-Type", "Transfer-Encoding", "Connection",
+    "Accept", "Accept-Encoding", "Cookie",       "User-Agent",
+};
+static_assert(sizeof(knownHeaderNames) / sizeof(knownHeaderNames[0]) ==
+                  static_cast<SC::size_t>(SC::HttpServerBase::Request::HeaderType::Count),
+              "knownHeaderNames");
+
+static bool findKnownHeader(SC::StringView headerName, SC::size_t& knownIndex)
+{
+    for (knownIndex = 0; knownIndex < sizeof(knownHeaderNames) / sizeof(knownHeaderNames[0]); ++knownIndex)
+    {
+        if (equalsAsciiCaseInsensitive(headerName, knownHeaderNames[knownIndex]))
+            return true;
+    }
+    return false;
+}
+
+SC::StringView SC::HttpServerBase::Request::headerView(const Header& header) const
+{
+    return StringView({headerBuffer.data() + header.start, header.length}, false, StringEncoding::Ascii);
+}
+
 bool SC::HttpServerBase::Request::find(HttpParser::Result result, StringView& res) const
 {
+    const size_t resultIndex = static_cast<size_t>(result);
+    if (resultIndex < sizeof(headerIndex.results) / sizeof(headerIndex.results[0]))
+    {
+        const uint16_t indexEntry = headerIndex.results[resultIndex];
+        if (indexEntry == 0)
+            return false;
+        res = headerView(headerOffsets[indexEntry - 1]);
+        return true;
+    }
     size_t found;
     if (headerOffsets.find([result](const auto& it) { return it.result == result; }, &found))
     {
-        const Header& header = headerOffsets[found];
-        res = StringView({headerBuffer.data() + header.start, header.length}, false, StringEncoding::Ascii);
+        res = headerView(headerOffsets[found]);
         return true;
     }
     return false;
 }
 
+bool SC::HttpServerBase::Request::headerValueAt(uint16_t indexEntry, StringView& value) const
+{
+    // indexEntry is (name index + 1), that is where its value is stored
+    if (indexEntry >= headerOffsets.size() or headerOffsets[indexEntry].result != HttpParser::Result::HeaderValue)
+        return false;
+    value = headerView(headerOffsets[indexEntry]);
+    return true;
+}
+
+bool SC::HttpServerBase::Request::findHashedHeader(StringView headerName, uint32_t hash, uint16_t& slot) const
+{
+    // Table is never full (see indexHeader), so an empty slot always ends probing
+    slot = static_cast<uint16_t>(hash & (NumHashedHeaders - 1));
+    while (headerIndex.hashedHeaders[slot] != 0)
+    {
+        if (equalsAsciiCaseInsensitive(headerView(headerOffsets[headerIndex.hashedHeaders[slot] - 1]), headerName))
+            return true;
+        slot = static_cast<uint16_t>((slot + 1) & (NumHashedHeaders - 1));
+    }
+    return false;
+}
+
+bool SC::HttpServerBase::Request::findHeaderLinear(StringView headerName, StringView& value) const
+{
+    const size_t numHeaders = headerOffsets.size();
+    for (size_t idx = 0; idx + 1 < numHeaders; ++idx)
+    {
+        const Header& name = headerOffsets[idx];
+        if (name.result == HttpParser::Result::HeaderName and equalsAsciiCaseInsensitive(headerView(name), headerName))
+        {
+            return headerValueAt(static_cast<uint16_t>(idx + 1), value);
+        }
+    }
+    return false;
+}
+
+bool SC::HttpServerBase::Request::findHeader(HeaderType headerType, StringView& value) const
+{
+    const size_t knownIndex = static_cast<size_t>(headerType);
+    if (knownIndex >= static_cast<size_t>(HeaderType::Count))
+        return false;
+    const uint16_t indexEntry = headerIndex.knownHeaders[knownIndex];
+    if (indexEntry != 0)
+        return headerValueAt(indexEntry, value);
+    return headerIndex.overflow and findHeaderLinear(knownHeaderNames[knownIndex], value);
+}
+
+bool SC::HttpServerBase::Request::findHeader(StringView headerName, StringView& value) const
+{
+    size_t knownIndex;
+    if (findKnownHeader(headerName, knownIndex))
+        return findHeader(static_cast<HeaderType>(knownIndex), value);
+    uint16_t slot;
+    if (findHashedHeader(headerName, hashHeaderName(headerName), slot))
+        return headerValueAt(headerIndex.hashedHeaders[slot], value);
+    return headerIndex.overflow and findHeaderLinear(headerName, value);
+}
+
+void SC::HttpServerBase::Request::indexHeader(size_t offsetIndex)
+{
+    const Header& header = headerOffsets[offsetIndex];
+    if (offsetIndex + 1 > 0xffff)
+    {
+        headerIndex.overflow = true;
+        return;
+    }
+    const uint16_t indexEntry  = static_cast<uint16_t>(offsetIndex + 1);
+    const size_t   resultIndex = static_cast<size_t>(header.result);
+    if (resultIndex < sizeof(headerIndex.results) / sizeof(headerIndex.results[0]))
+    {
+        headerIndex.results[resultIndex] = indexEntry;
+        return;
+    }
+    if (header.result != HttpParser::Result::HeaderName)
+        return;
+
+    // Only first header with a given name is indexed, as it's the one returned by lookups
+    const StringView headerName = headerView(header);
+    size_t           knownIndex;
+    if (findKnownHeader(headerName, knownIndex))
+    {
+        if (headerIndex.knownHeaders[knownIndex] == 0)
+            headerIndex.knownHeaders[knownIndex] = indexEntry;
+        return;
+    }
+    uint16_t slot;
+    if (findHashedHeader(headerName, hashHeaderName(headerName), slot))
+        return;
+    // Keeping the table at most three quarters full bounds probing length
+    if (headerIndex.numHashedHeaders >= NumHashedHeaders * 3 / 4)
+    {
+        headerIndex.overflow = true;
+        return;
+    }
+    headerIndex.hashedHeaders[slot] = indexEntry;
+    headerIndex.numHashedHeaders++;
+}
+
+bool SC::HttpServerBase::Request::wantsKeepAlive() const
+{
+    StringView connection;
+    if (findHeader(HeaderType::Connection, connection))
+    {
+        if (equalsAsciiCaseInsensitive(connection, "close"))
+            return false;
+        if (equalsAsciiCaseInsensitive(connection, "keep-alive"))
+            return true;
+    }
+    // Persistent connections are the default since HTTP/1.1 only
+    StringView version;
+    return find(HttpParser::Result::Version, version) and version != "HTTP/1.0";
+}
+
+void SC::HttpServerBase::Request::reset()
+{
+    headersEndReceived = false;
+    parsedSuccessfully = true;
+
+    bodyEndReceived    = false;
+    chunkedBody        = false;
+    bodyBytesLeft      = 0;
+
+    parser        = HttpParser();
+    chunkedParser = HttpChunkedParser();
+    url           = StringView();
+    headerBuffer.clear();
+    headerOffsets.clear();
+    headerIndex = HeaderIndex();
+}
+
 // HttpServerBase::Response
 SC::Result SC::HttpServerBase::Response::startResponse(int code)
 {
@@ -44,6 +234,17 @@ SC::Result SC::HttpServerBase::Response::addHeader(StringView headerName, String
 
 SC::Result SC::HttpServerBase::Response::end(StringView sv)
 {
+    if (not keepAlive and not chunkedBody)
+    {
+        SC_TRY(addHeader("Connection", "close"));
+    }
+    if (chunkedBody)
+    {
+        SC_TRY(write(sv.toCharSpan()));
+        SC_TRY(outputBuffer.append(StringView("0\r\n\r\n").toCharSpan())); // Last chunk
+        responseEnded = true;
+        return Result(true);
+    }
     StringBuilder sb(outputBuffer, StringEncoding::Ascii);
     SC_TRY(sb.append("Content-Length: {}\r\n\r\n", sv.sizeInBytes()));
     SC_TRY(sb.append(sv));
@@ -51,24 +252,73 @@ SC::Result SC::HttpServerBase::Response::end(StringView sv)
     return Result(outputBuffer.pop_back()); // pop null terminator
 }
 
-// HttpServer
+SC::Result SC::HttpServerBase::Response::startChunkedBody()
+{
+    if (not keepAlive)
+    {
+        SC_TRY(addHeader("Connection", "close"));
+    }
+    StringBuilder sb(outputBuffer, StringEncoding::Ascii);
+    SC_TRY(sb.append("Transfer-Encoding: chunked\r\n\r\n"));
+    chunkedBody = true;
+    return Result(outputBuffer.pop_back()); // pop null terminator
+}
 
-SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& client)
+SC::Result SC::HttpServerBase::Response::write(Span<const char> data)
 {
-    bool& parsedSuccessfully = client.request.parsedSuccessfully;
-    if (client.request.headerBuffer.size() > maxHeaderSize)
+    SC_TRY_MSG(chunkedBody and not responseEnded, "Response::write - Chunked body has not been started");
+    if (data.empty())
     {
-        parsedSuccessfully = false;
-        return Result::Error("Header size exceeded limit");
+        return Result(true); // An empty chunk would end the body
     }
-    SC_TRY(client.request.headerBuffer.append(readData));
-    size_t readBytes;
-    while (client.request.parsedSuccessfully and not readData.empty())
+    // Chunk size in hexadecimal followed by CRLF
+    char   chunkSize[2 * sizeof(size_t) + 2];
+    size_t start   = sizeof(chunkSize);
+    size_t size    = data.sizeInBytes();
+    chunkSize[--start] = '\n';
+    chunkSize[--start] = '\r';
+    do
+    {
+        chunkSize[--start] = "0123456789abcdef"[size & 0xf];
+        size >>= 4;
+    } while (size != 0);
+    SC_TRY(outputBuffer.append({chunkSize + start, sizeof(chunkSize) - start}));
+    SC_TRY(outputBuffer.append(data));
+    SC_TRY(outputBuffer.append(StringView("\r\n").toCharSpan()));
+    return Result(true);
+}
+
+void SC::HttpServerBase::Response::reset()
+{
+    outputBuffer.clear();
+    responseEnded = false;
+    chunkedBody   = false;
+    keepAlive     = true;
+}
+
+// HttpServerBase
+
+SC::Result SC::HttpServerBase::parse(Span<const char> readData, size_t& consumedBytes, ClientChannel& client)
+{
+    consumedBytes = 0;
+
+    Request& request = client.request;
+    bool&    parsedSuccessfully = request.parsedSuccessfully;
+    while (parsedSuccessfully and not readData.empty())
     {
-        HttpParser&      parser = client.request.parser;
+        HttpParser&      parser = request.parser;
         Span<const char> parsedData;
+        size_t           readBytes = 0;
         parsedSuccessfully &= parser.parse(readData, readBytes, parsedData);
+        // Only bytes consumed by the parser belong to this request, as following ones can be pipelined requests
+        parsedSuccessfully &= request.headerBuffer.append({readData.data(), readBytes});
         parsedSuccessfully &= readData.sliceStart(readBytes, readData);
+        consumedBytes += readBytes;
+        if (request.headerBuffer.size() > maxHeaderSize)
+        {
+            parsedSuccessfully = false;
+            return Result::Error("Header size exceeded limit");
+        }
         if (parser.state == HttpParser::State::Finished)
             break;
         if (parser.state == HttpParser::State::Result)
@@ -77,11 +327,21 @@ SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& c
             header.result = parser.result;
             header.start  = static_cast<uint32_t>(parser.tokenStart);
             header.length = static_cast<uint32_t>(parser.tokenLength);
-            parsedSuccessfully &= client.request.headerOffsets.push_back(header);
+            parsedSuccessfully &= request.headerOffsets.push_back(header);
+            if (parsedSuccessfully)
+            {
+                request.indexHeader(request.headerOffsets.size() - 1);
+            }
             if (parser.result == HttpParser::Result::HeadersEnd)
             {
-                client.request.headersEndReceived = true;
-                SC_TRY(client.request.find(HttpParser::Result::Url, client.request.url));
+                request.headersEndReceived = true;
+                SC_TRY(request.find(HttpParser::Result::Url, request.url));
+                StringView transferEncoding;
+                request.chunkedBody =
+                    request.findHeader(Request::HeaderType::TransferEncoding, transferEncoding) and transferEncoding.endsWith("chunked");
+                request.bodyBytesLeft     = request.chunkedBody ? 0 : parser.contentLength;
+                request.bodyEndReceived   = not request.chunkedBody and request.bodyBytesLeft == 0;
+                client.response.keepAlive = request.wantsKeepAlive();
                 onClient(client);
                 break;
             }
@@ -90,21 +350,92 @@ SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& c
     return Result(parsedSuccessfully);
 }
 
+SC::Result SC::HttpServerBase::parseBody(Span<const char> readData, size_t& consumedBytes, ClientChannel& client)
+{
+    consumedBytes = 0;
+
+    Request& request = client.request;
+    while (not request.bodyEndReceived and not readData.empty())
+    {
+        Span<const char> bodyData;
+        size_t           readBytes;
+        if (request.chunkedBody)
+        {
+            SC_TRY(request.chunkedParser.parse(readData, readBytes, bodyData));
+            request.bodyEndReceived = request.chunkedParser.isFinished();
+        }
+        else
+        {
+            const size_t available = readData.sizeInBytes();
+            readBytes = request.bodyBytesLeft < available ? static_cast<size_t>(request.bodyBytesLeft) : available;
+            SC_TRY(readData.sliceStartLength(0, readBytes, bodyData));
+            request.bodyBytesLeft -= readBytes;
+            request.bodyEndReceived = request.bodyBytesLeft == 0;
+        }
+        SC_TRY(readData.sliceStart(readBytes, readData));
+        consumedBytes += readBytes;
+        // Body is handed out as it's received, so that it doesn't need to be accumulated
+        if (onClientBody.isValid() and (not bodyData.empty() or request.bodyEndReceived))
+        {
+            onClientBody(client, bodyData);
+        }
+    }
+    return Result(true);
+}
+
 // HttpServer
-SC::Result SC::HttpServer::start(AsyncEventLoop& eventLoop, uint32_t maxConnections, StringView address, uint16_t port)
+SC::Result SC::HttpServer::start(AsyncEventLoop& loop, uint32_t maxConnections, StringView address, uint16_t port)
 {
     SC_TRY(requestClients.resize(maxConnections));
     SC_TRY(requests.resize(maxConnections));
     SocketIPAddress nativeAddress;
     SC_TRY(nativeAddress.fromAddressPort(address, port));
-    SC_TRY(eventLoop.createAsyncTCPSocket(nativeAddress.getAddressFamily(), serverSocket));
-    SC_TRY(SocketServer(serverSocket).listen(nativeAddress));
+    SC_TRY(loop.createAsyncTCPSocket(nativeAddress.getAddressFamily(), serverSocket));
+    SocketServer socketServer(serverSocket);
+    if (reusePort)
+    {
+        SC_TRY(socketServer.enableReusePort());
+    }
+    SC_TRY(socketServer.listen(nativeAddress));
+    stopping  = false;
+    eventLoop = &loop;
     asyncAccept.setDebugName("HttpServer");
     asyncAccept.callback.bind<HttpServer, &HttpServer::onNewClient>(*this);
-    return asyncAccept.start(eventLoop, serverSocket);
+    SC_TRY(asyncAccept.start(loop, serverSocket));
+    if (idleTimeout.ms > 0)
+    {
+        // Idle connections are looked for periodically instead of arming a timeout for each one of them
+        asyncIdleCheck.setDebugName("HttpServer::idleCheck");
+        asyncIdleCheck.callback.bind<HttpServer, &HttpServer::onIdleCheck>(*this);
+        const int64_t checkInterval = idleTimeout.ms > 4 ? idleTimeout.ms / 4 : 1;
+        SC_TRY(asyncIdleCheck.start(loop, Time::Milliseconds(checkInterval)));
+    }
+    return Result(true);
 }
 
-SC::Result SC::HttpServer::stop() { return asyncAccept.stop(); }
+SC::Result SC::HttpServer::stop()
+{
+    stopping = true;
+    SC_TRY(asyncAccept.stop());
+    if (idleTimeout.ms > 0)
+    {
+        SC_TRY(asyncIdleCheck.stop());
+    }
+    // Connections waiting for a request are closed now, the other ones after sending their response
+    for (RequestClient& requestClient : requestClients)
+    {
+        if (requestClient.receiving)
+        {
+            closeClient(requestClient);
+        }
+        else
+        {
+            // Responses not ended yet will tell the client that the connection is going to be closed
+            requests.get(requestClient.key.cast_to<ClientChannel>())->response.keepAlive = false;
+        }
+    }
+    return Result(true);
+}
 
 void SC::HttpServer::onNewClient(AsyncSocketAccept::Result& result)
 {
@@ -114,28 +445,131 @@ void SC::HttpServer::onNewClient(AsyncSocketAccept::Result& result)
         // TODO: Invoke an error
         return;
     }
-    bool succeeded = true;
+    result.reactivateRequest(true);
 
-    // TODO: do proper error handling
     auto key1 = requests.allocate();
-    succeeded &= key1.isValid();
     auto key2 = requestClients.allocate();
-    succeeded &= key2.isValid() and key1 == key2;
-    if (succeeded)
+    if (not key1.isValid() or not key2.isValid() or not(key1 == key2))
     {
-        RequestClient& client = *requestClients.get(key2);
-        ClientChannel& req    = *requests.get(key1);
-        client.key            = key2;
-        client.socket         = move(acceptedClient);
+        // Too many connections, the accepted socket is closed going out of scope
+        if (key1.isValid())
+        {
+            SC_ASSERT_RELEASE(requests.remove(key1));
+        }
+        if (key2.isValid())
+        {
+            SC_ASSERT_RELEASE(requestClients.remove(key2));
+        }
+        return;
+    }
+    RequestClient& requestClient = *requestClients.get(key2);
+    requestClient.key            = key2;
+    requests.get(key1)->key      = key1;
+    requestClient.socket         = move(acceptedClient);
+    requestClient.lastActivity   = eventLoop->getLoopTime();
 
-        auto& buffer = req.request.headerBuffer;
-        succeeded &= buffer.resizeWithoutInitializing(buffer.capacity());
-        client.asyncReceive.setDebugName(client.debugName.bytesIncludingTerminator());
-        client.asyncReceive.callback.bind<HttpServer, &HttpServer::onReceive>(*this);
-        succeeded &= client.asyncReceive.start(*asyncAccept.getEventLoop(), client.socket, buffer.toSpan());
-        SC_ASSERT_RELEASE(succeeded);
+    const char* debugName = requestClient.debugName.bytesIncludingTerminator();
+    requestClient.asyncReceive.setDebugName(debugName);
+    requestClient.asyncClose.setDebugName(debugName);
+    requestClient.asyncReceive.callback.bind<HttpServer, &HttpServer::onReceive>(*this);
+    for (AsyncSocketSend& asyncSend : requestClient.asyncSend)
+    {
+        asyncSend.setDebugName(debugName);
+        asyncSend.callback = [this, &requestClient](AsyncSocketSend::Result& res) { onAfterSend(requestClient, res); };
     }
-    result.reactivateRequest(true);
+    requestClient.asyncClose.callback.bind<HttpServer, &HttpServer::onAfterClose>(*this);
+
+    Span<char> receiveBuffer  = {requestClient.receiveBuffer, sizeof(requestClient.receiveBuffer)};
+    requestClient.receiving = requestClient.asyncReceive.start(*eventLoop, requestClient.socket, receiveBuffer);
+    if (not requestClient.receiving)
+    {
+        closeClient(requestClient);
+    }
+}
+
+SC::HttpServer::ProcessResult SC::HttpServer::processPendingData(RequestClient& requestClient)
+{
+    ClientChannel&    client      = *requests.get(requestClient.key.cast_to<ClientChannel>());
+    Request&          request     = client.request;
+    Response&         response    = client.response;
+    Span<const char>& pendingData = requestClient.pendingData;
+    while (true)
+    {
+        if (not request.headersEndReceived)
+        {
+            // Pipelined requests are not handled when stopping, as previous response could not say `Connection: close`
+            if (pendingData.empty() or stopping)
+            {
+                return stopping ? ProcessResult::Close : ProcessResult::NeedsData;
+            }
+            size_t       consumedBytes = 0;
+            const Result parseResult   = HttpServerBase::parse(pendingData, consumedBytes, client);
+            if (not parseResult)
+            {
+                return processError(client, parseResult);
+            }
+            SC_ASSERT_RELEASE(pendingData.sliceStart(consumedBytes, pendingData));
+            continue;
+        }
+        // Response is sent while still receiving body only when exceeding highwaterMark, to keep memory bounded
+        if (not response.outputBuffer.isEmpty() and (response.mustBeFlushed() or request.bodyEndReceived))
+        {
+            AsyncSocketSend& asyncSend = requestClient.asyncSend[requestClient.sendIndex];
+            requestClient.sendIndex    = requestClient.sendIndex == 0 ? 1 : 0;
+
+            auto         outspan    = response.outputBuffer.toSpan();
+            const Result sendResult = asyncSend.start(*eventLoop, requestClient.socket, outspan);
+            if (not sendResult)
+            {
+                return processError(client, sendResult);
+            }
+            return ProcessResult::Sending;
+        }
+        if (not request.bodyEndReceived)
+        {
+            if (pendingData.empty())
+            {
+                return stopping ? ProcessResult::Close : ProcessResult::NeedsData;
+            }
+            size_t       consumedBytes = 0;
+            const Result parseResult   = HttpServerBase::parseBody(pendingData, consumedBytes, client);
+            if (not parseResult)
+            {
+                return processError(client, parseResult);
+            }
+            SC_ASSERT_RELEASE(pendingData.sliceStart(consumedBytes, pendingData));
+            continue;
+        }
+        if (not requestClient.responseSent)
+        {
+            // Callbacks returned without ending the response, that will be sent by HttpServer::flushResponse
+            requestClient.waitingResponse = true;
+            return ProcessResult::Waiting;
+        }
+        // Both request and response are complete, so next (eventually pipelined) request can be handled
+        request.reset();
+        response.reset();
+        requestClient.responseSent = false;
+    }
+}
+
+SC::HttpServer::ProcessResult SC::HttpServer::processError(ClientChannel& client, Result error)
+{
+    if (onClientError.isValid())
+    {
+        onClientError(client, error);
+    }
+    return ProcessResult::Close;
+}
+
+SC::Result SC::HttpServer::flushResponse(ClientChannel& client)
+{
+    RequestClient* requestClient = requestClients.get(client.key.cast_to<RequestClient>());
+    SC_TRY_MSG(requestClient != nullptr and requestClient->waitingResponse,
+               "HttpServer::flushResponse - Client is not waiting for a response");
+    requestClient->waitingResponse = false;
+    continueProcessing(*requestClient);
+    return Result(true);
 }
 
 void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
@@ -144,46 +578,228 @@ void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
     RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncReceive, result.getAsync());
     SC_COMPILER_WARNING_POP
     SC_ASSERT_RELEASE(&requestClient.asyncReceive == &result.getAsync());
-    ClientChannel& client = *requests.get(requestClient.key.cast_to<ClientChannel>());
-    Span<char>     readData;
-    if (not result.get(readData))
+    requestClient.receiving = false;
+
+    Span<char> readData;
+    if (not result.get(readData) or readData.empty())
+    {
+        // Connection has been closed by the peer or it's broken
+        closeClient(requestClient);
+        return;
+    }
+    requestClient.lastActivity = eventLoop->getLoopTime();
+    requestClient.pendingData  = readData;
+    switch (processPendingData(requestClient))
+    {
+    case ProcessResult::NeedsData:
+        requestClient.receiving = true;
+        result.reactivateRequest(true);
+        break;
+    case ProcessResult::Sending:
+    case ProcessResult::Waiting: break;
+    case ProcessResult::Close: closeClient(requestClient); break;
+    }
+}
+
+void SC::HttpServer::onAfterSend(RequestClient& requestClient, AsyncSocketSend::Result& result)
+{
+    ClientChannel& client   = *requests.get(requestClient.key.cast_to<ClientChannel>());
+    Response&      response = client.response;
+    if (not result.isValid())
+    {
+        (void)processError(client, result.isValid());
+        closeClient(requestClient);
+        return;
+    }
+    if (response.responseEnded and (not response.keepAlive or stopping))
     {
-        // TODO: Invoke on error
+        closeClient(requestClient);
         return;
     }
-    if (not HttpServerBase::parse(readData, client))
+    requestClient.lastActivity = eventLoop->getLoopTime();
+    response.outputBuffer.clear();
+    if (response.responseEnded)
+    {
+        requestClient.responseSent = true;
+    }
+    else if (onClientResponseFlushed.isValid())
+    {
+        onClientResponseFlushed(client);
+    }
+    continueProcessing(requestClient);
+}
+
+void SC::HttpServer::continueProcessing(RequestClient& requestClient)
+{
+    // Continue with request body or pipelined requests that have already been received, before receiving again
+    switch (processPendingData(requestClient))
     {
-        // TODO: Invoke on error
+    case ProcessResult::NeedsData: {
+        Span<char> receiveBuffer = {requestClient.receiveBuffer, sizeof(requestClient.receiveBuffer)};
+        requestClient.receiving  = requestClient.asyncReceive.start(*eventLoop, requestClient.socket, receiveBuffer);
+        if (not requestClient.receiving)
+        {
+            closeClient(requestClient);
+        }
+    }
+    break;
+    case ProcessResult::Sending:
+    case ProcessResult::Waiting: break;
+    case ProcessResult::Close: closeClient(requestClient); break;
+    }
+}
+
+void SC::HttpServer::closeClient(RequestClient& requestClient)
+{
+    if (requestClient.closing)
         return;
+    requestClient.closing = true;
+    if (requestClient.receiving)
+    {
+        requestClient.receiving = false;
+        SC_TRUST_RESULT(requestClient.asyncReceive.stop());
     }
-    if (client.response.mustBeFlushed())
+    // Slots are released in onAfterClose, after the stopped receive has been processed by the event loop
+    if (not requestClient.asyncClose.start(*eventLoop, requestClient.socket))
     {
-        requestClient.asyncSend.setDebugName(requestClient.debugName.bytesIncludingTerminator());
+        SC_TRUST_RESULT(requestClient.socket.close());
+        SC_ASSERT_RELEASE(requests.remove(requestClient.key.cast_to<ClientChannel>()));
+        SC_ASSERT_RELEASE(requestClients.remove(requestClient.key));
+    }
+}
+
+void SC::HttpServer::onAfterClose(AsyncSocketClose::Result& result)
+{
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncClose, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    requestClient.socket.detach(); // Already closed by AsyncSocketClose
+    auto key = requestClient.key;
+    SC_ASSERT_RELEASE(requests.remove(key.cast_to<ClientChannel>()));
+    SC_ASSERT_RELEASE(requestClients.remove(key));
+}
+
+void SC::HttpServer::onIdleCheck(AsyncLoopTimeout::Result& result)
+{
+    const Time::HighResolutionCounter now = eventLoop->getLoopTime();
+    for (RequestClient& requestClient : requestClients)
+    {
+        // Connections sending a response are not idle, even if the peer is slow in receiving it
+        if (requestClient.receiving and now.isLaterThanOrEqualTo(requestClient.lastActivity.offsetBy(idleTimeout)))
+        {
+            closeClient(requestClient);
+        }
+    }
+    result.reactivateRequest(true);
+}
+
+// HttpShardedServer
+SC::Result SC::HttpShardedServer::start(Span<Shard> newShards, uint32_t maxConnectionsPerShard, StringView newAddress,
+                                        uint16_t newPort)
+{
+    SC_TRY_MSG(shards.empty(), "HttpShardedServer::start - Already started");
+    SC_TRY_MSG(not newShards.empty(), "HttpShardedServer::start - No shards");
+    maxConnections = maxConnectionsPerShard;
+    address        = newAddress;
+    port           = newPort;
 
-        auto outspan = client.response.outputBuffer.toSpan();
-        requestClient.asyncSend.callback.bind<HttpServer, &HttpServer::onAfterSend>(*this);
-        auto res = requestClient.asyncSend.start(*asyncAccept.getEventLoop(), requestClient.socket, outspan);
+    Result res = Result(true);
+    for (size_t idx = 0; idx < newShards.sizeInElements(); ++idx)
+    {
+        Shard& shard = newShards[idx];
+        shard.index  = static_cast<uint32_t>(idx);
+        shard.parent = this;
+        // Event loop is created on the shard thread, as io_uring SINGLE_ISSUER requires submitting from it
+        res = shard.thread.start([this, &shard](Thread& thread)
+                                 {
+                                     thread.setThreadName(SC_NATIVE_STR("HttpShardedServer"));
+                                     runShard(shard);
+                                 });
         if (not res)
         {
-            // TODO: Invoke on error
-            return;
+            newShards = {newShards.data(), idx};
+            break;
+        }
+        shard.startedEvent.wait();
+        if (not shard.startResult)
+        {
+            res = shard.startResult;
+            SC_TRUST_RESULT(shard.thread.join());
+            newShards = {newShards.data(), idx};
+            break;
         }
     }
-    else
+    shards = newShards;
+    if (not res)
     {
-        result.reactivateRequest(true);
+        // Stop all shards that have been successfully started so far
+        SC_TRUST_RESULT(stop());
     }
+    return res;
 }
 
-void SC::HttpServer::onAfterSend(AsyncSocketSend::Result& result)
+void SC::HttpShardedServer::runShard(Shard& shard)
 {
-    if (result.isValid())
+    shard.runResult   = Result(true);
+    shard.startResult = shard.eventLoop.create(eventLoopOptions);
+    if (shard.startResult)
     {
-        SC_COMPILER_WARNING_PUSH_OFFSETOF
-        RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncSend, result.getAsync());
-        SC_COMPILER_WARNING_POP
-        auto clientKey = requestClient.key.cast_to<ClientChannel>();
-        requests.get(clientKey)->response.outputBuffer.clear();
+        shard.server.reusePort = true;
+        shard.server.onClient  = [this, &shard](HttpServer::ClientChannel& client) { onClient(shard, client); };
+        if (onClientBody.isValid())
+        {
+            shard.server.onClientBody = [this, &shard](HttpServer::ClientChannel& client, Span<const char> data)
+            { onClientBody(shard, client, data); };
+        }
+        if (onClientResponseFlushed.isValid())
+        {
+            shard.server.onClientResponseFlushed = [this, &shard](HttpServer::ClientChannel& client)
+            { onClientResponseFlushed(shard, client); };
+        }
+        if (onClientError.isValid())
+        {
+            shard.server.onClientError = [this, &shard](HttpServer::ClientChannel& client, Result error)
+            { onClientError(shard, client, error); };
+        }
+        shard.startResult      = shard.server.start(shard.eventLoop, maxConnections, address, port);
+    }
+    if (shard.startResult)
+    {
+        shard.stopWakeUp.callback = [&shard](AsyncLoopWakeUp::Result& result)
+        {
+            SC_TRUST_RESULT(result.getAsync().stop());
+            SC_TRUST_RESULT(shard.server.stop());
+        };
+        shard.startResult         = shard.stopWakeUp.start(shard.eventLoop);
+    }
+    const bool started = shard.startResult;
+    shard.startedEvent.signal(); // After this point parameters passed to HttpShardedServer::start are not valid
+    if (started)
+    {
+        // Run until listening socket is stopped and in-flight requests are finished
+        shard.runResult = shard.eventLoop.run();
+    }
+    SC_TRUST_RESULT(shard.eventLoop.close());
+}
+
+SC::Result SC::HttpShardedServer::stop()
+{
+    Result res = Result(true);
+    for (Shard& shard : shards)
+    {
+        if (not shard.stopWakeUp.wakeUp())
+        {
+            res = Result::Error("HttpShardedServer::stop - Cannot wake up shard");
+        }
+    }
+    for (Shard& shard : shards)
+    {
+        SC_TRY(shard.thread.join());
+        if (not shard.runResult)
+        {
+            res = shard.runResult;
+        }
     }
-    // TODO: Close socket and dispose resources
+    shards = {};
+    return res;
 }
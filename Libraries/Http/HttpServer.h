@@ -9,11 +9,13 @@
 #include "../Containers/SmallVector.h"
 #include "../Socket/SocketDescriptor.h"
 #include "../Strings/SmallString.h"
+#include "../Threading/Threading.h"
 
 namespace SC
 {
 struct HttpServerBase;
 struct HttpServer;
+struct HttpShardedServer;
 } // namespace SC
 
 //! @addtogroup group_http
@@ -36,6 +38,11 @@ struct SC::HttpServerBase
     {
         bool headersEndReceived = false; ///< All headers have been received
         bool parsedSuccessfully = true;  ///< Request headers have been parsed successfully
+        bool bodyEndReceived    = false; ///< All body bytes have been received (`true` also for requests without body)
+        bool chunkedBody        = false; ///< Body is sent with `Transfer-Encoding: chunked`
+
+        uint64_t          bodyBytesLeft = 0; ///< Body bytes still to be received (when not chunked)
+        HttpChunkedParser chunkedParser;     ///< Decoder of chunked body
 
         HttpParser parser; ///< The parser used to parse headers
         StringView url;    ///< The url extracted from parsed headers
@@ -43,11 +50,71 @@ struct SC::HttpServerBase
         SmallVector<char, 255>  headerBuffer;  ///< Buffer containing all headers
         SmallVector<Header, 16> headerOffsets; ///< Headers, defined as offsets in headerBuffer
 
+        /// @brief Commonly used headers, directly indexed while parsing
+        enum class HeaderType : uint8_t
+        {
+            Host = 0,         ///< Host header
+            ContentLength,    ///< Content-Length header
+            ContentType,      ///< Content-Type header
+            TransferEncoding, ///< Transfer-Encoding header
+            Connection,       ///< Connection header
+            Accept,           ///< Accept header
+            AcceptEncoding,   ///< Accept-Encoding header
+            Cookie,           ///< Cookie header
+            UserAgent,        ///< User-Agent header
+            Count             ///< Number of header types
+        };
+
         /// @brief Finds a specific HttpParser::Result in the list of parsed header
         /// @param result The result to look for (Method, Url etc.)
         /// @param res A StringView, pointing at headerBuffer containing the found result
         /// @return `true` if the result has been found
         [[nodiscard]] bool find(HttpParser::Result result, StringView& res) const;
+
+        /// @brief Finds value of the first header of a given type
+        /// @param headerType The header to look for
+        /// @param value A StringView, pointing at headerBuffer containing the header value
+        /// @return `true` if the header has been found
+        [[nodiscard]] bool findHeader(HeaderType headerType, StringView& value) const;
+
+        /// @brief Finds value of the first header with a given name (compared case-insensitively)
+        /// @param headerName Name of the header to look for (for example `Connection`)
+        /// @param value A StringView, pointing at headerBuffer containing the header value
+        /// @return `true` if the header has been found
+        [[nodiscard]] bool findHeader(StringView headerName, StringView& value) const;
+
+        /// @brief Checks if the client asks to keep connection open after the response (HTTP/1.1 default)
+        [[nodiscard]] bool wantsKeepAlive() const;
+
+        /// @brief Resets parser and parsed headers, to receive next request on the same connection
+        void reset();
+
+      private:
+        friend struct HttpServerBase;
+
+        // Index of parsed entries in headerOffsets, built once while parsing so that lookups don't need to scan
+        // all headers. Entries store (headerOffsets index + 1), with zero meaning 'not found'.
+        static constexpr size_t NumHashedHeaders = 32; // Must be a power of two
+
+        struct HeaderIndex
+        {
+            static constexpr size_t NumKnownHeaders = static_cast<size_t>(HeaderType::Count);
+
+            uint16_t results[3]                      = {0}; // Method, Url and Version
+            uint16_t knownHeaders[NumKnownHeaders]   = {0};
+            uint16_t hashedHeaders[NumHashedHeaders] = {0}; // Other header names (open addressing, linear probing)
+            size_t   numHashedHeaders                = 0;
+            bool     overflow                        = false; // Too many headers to index, lookups must also scan
+        };
+        HeaderIndex headerIndex;
+
+        [[nodiscard]] StringView headerView(const Header& header) const;
+
+        [[nodiscard]] bool findHashedHeader(StringView headerName, uint32_t hash, uint16_t& slot) const;
+        [[nodiscard]] bool findHeaderLinear(StringView headerName, StringView& value) const;
+        [[nodiscard]] bool headerValueAt(uint16_t indexEntry, StringView& value) const;
+
+        void indexHeader(size_t offsetIndex);
     };
 
     struct Response
@@ -57,11 +124,28 @@ struct SC::HttpServerBase
         bool   responseEnded = false;
         size_t highwaterMark = 255;
 
+        bool chunkedBody = false; ///< Body is sent with `Transfer-Encoding: chunked`
+
+        /// Keep connection open for next request after sending the response.
+        /// Initialized with Request::wantsKeepAlive before calling onClient, that can set it to `false`.
+        /// When `false` a `Connection: close` header is added by Response::end or Response::startChunkedBody.
+        bool keepAlive = true;
+
         [[nodiscard]] Result startResponse(int code);
         [[nodiscard]] Result addHeader(StringView headerName, StringView headerValue);
         [[nodiscard]] Result end(StringView sv);
 
+        /// @brief Ends headers, starting a body sent with `Transfer-Encoding: chunked` through Response::write.
+        /// Response::end sends the last chunk.
+        [[nodiscard]] Result startChunkedBody();
+
+        /// @brief Appends data to a chunked body as a single chunk, that is sent when exceeding highwaterMark
+        [[nodiscard]] Result write(Span<const char> data);
+
         [[nodiscard]] bool mustBeFlushed() const { return responseEnded or outputBuffer.size() > highwaterMark; }
+
+        /// @brief Clears output buffer and state, to send next response on the same connection
+        void reset();
     };
 
     uint32_t maxHeaderSize = 8 * 1024;
@@ -69,15 +153,33 @@ struct SC::HttpServerBase
     {
         Request  request;
         Response response;
+
+      private:
+        friend struct HttpServer;
+        ArenaMapKey<ClientChannel> key;
     };
     ArenaMap<ClientChannel>        requests;
-    Function<void(ClientChannel&)> onClient;
+    Function<void(ClientChannel&)> onClient; ///< Called when all headers of a request have been received
+
+    /// @brief Called with every slice of request body as soon as it's received, without accumulating it. @n
+    /// Chunked bodies are already decoded. Last call has Request::bodyEndReceived set (and its data can be empty).
+    Function<void(ClientChannel&, Span<const char>)> onClientBody;
+
+    /// @brief Called after some response data has been sent, if the response has not been ended yet. @n
+    /// Writing more data (or ending the response) from here streams a response of any size in constant memory.
+    Function<void(ClientChannel&)> onClientResponseFlushed;
+
+    /// @brief Called with the reason of the failure (invalid request, failed send etc.) before closing a connection
+    Function<void(ClientChannel&, Result)> onClientError;
 
   protected:
-    [[nodiscard]] Result parse(Span<const char> readData, ClientChannel& res);
+    [[nodiscard]] Result parse(Span<const char> readData, size_t& consumedBytes, ClientChannel& res);
+    [[nodiscard]] Result parseBody(Span<const char> readData, size_t& consumedBytes, ClientChannel& res);
 };
 
-/// @brief Http server using Async library
+/// @brief Http server using Async library. @n
+/// Connections are kept open after a response when the client asks so (HTTP/1.1 default), and pipelined requests
+/// already received are parsed and answered in order once the previous response has been sent.
 struct SC::HttpServer : public HttpServerBase
 {
     HttpServer() {}
@@ -92,10 +194,24 @@ struct SC::HttpServer : public HttpServerBase
     /// @return Valid Result if http listening has been started successfully
     [[nodiscard]] Result start(AsyncEventLoop& loop, uint32_t maxConnections, StringView address, uint16_t port);
 
-    /// @brief Stops the http server
+    /// @brief Stops accepting new connections and closes connections waiting for a request.
+    /// Responses being sent are completed, closing their connection afterwards.
     /// @return Valid Result if server has been stopped successfully
     [[nodiscard]] Result stop();
 
+    /// @brief Sends a response written after returning from callbacks (for example after some asynchronous work).
+    /// A request whose response has not been ended when callbacks return keeps its connection waiting for it,
+    /// and this function must be called every time new data has been written to its response (or it has been ended).
+    /// @param client The client that has been passed to callbacks
+    /// @return Valid Result if client was waiting for its response and sending it has been started
+    [[nodiscard]] Result flushResponse(ClientChannel& client);
+
+    /// @brief Listen with SocketServer::enableReusePort, so that multiple servers can share address and port
+    bool reusePort = false;
+
+    /// @brief Closes connections not receiving or sending any data for this time (zero disables idle timeout)
+    Time::Milliseconds idleTimeout = Time::Milliseconds(30000);
+
   private:
     struct RequestClient
     {
@@ -104,16 +220,114 @@ struct SC::HttpServer : public HttpServerBase
         SocketDescriptor   socket;
         SmallString<50>    debugName;
         AsyncSocketReceive asyncReceive;
-        AsyncSocketSend    asyncSend;
+        AsyncSocketSend    asyncSend[2]; // A request can't be restarted by its own callback, so pipelined responses
+        AsyncSocketClose   asyncClose;   // alternate between two of them
+        uint8_t            sendIndex = 0;
+
+        char             receiveBuffer[1024];
+        Span<const char> pendingData; // Received data not parsed yet (request body or pipelined requests)
+
+        Time::HighResolutionCounter lastActivity;
+
+        bool receiving       = false;
+        bool responseSent    = false; // Response has been ended and fully sent
+        bool waitingResponse = false; // Request has been received but its response must still be written
+        bool closing         = false;
     };
     ArenaMap<RequestClient> requestClients;
     SocketDescriptor        serverSocket;
 
+    AsyncEventLoop*   eventLoop = nullptr; // Set by start (stopped requests don't refer to their loop anymore)
     AsyncSocketAccept asyncAccept;
+    AsyncLoopTimeout  asyncIdleCheck;
+
+    bool stopping = false;
+
+    enum class ProcessResult
+    {
+        NeedsData, // All pending data has been parsed, more must be received
+        Sending,   // A response is being sent
+        Waiting,   // Response must still be written, see HttpServer::flushResponse
+        Close,     // Connection must be closed
+    };
+
+    [[nodiscard]] ProcessResult processPendingData(RequestClient& requestClient);
+    [[nodiscard]] ProcessResult processError(ClientChannel& client, Result error);
+
+    void continueProcessing(RequestClient& requestClient);
+
+    void closeClient(RequestClient& requestClient);
 
     void onNewClient(AsyncSocketAccept::Result& result);
     void onReceive(AsyncSocketReceive::Result& result);
-    void onAfterSend(AsyncSocketSend::Result& result);
+    void onAfterSend(RequestClient& requestClient, AsyncSocketSend::Result& result);
+    void onAfterClose(AsyncSocketClose::Result& result);
+    void onIdleCheck(AsyncLoopTimeout::Result& result);
+};
+
+/// @brief Http server running one HttpServer per thread, all listening on the same address and port. @n
+/// Every shard owns its own thread, SC::AsyncEventLoop, connections and listening socket (bound with
+/// `SO_REUSEPORT`), with the kernel load balancing incoming connections among them.
+/// Shards do not share any state, so request handling doesn't need any cross-thread locking.
+/// @note HttpShardedServer::onClient is called concurrently on the threads of different shards.
+/// @note `SO_REUSEPORT` connection load balancing is only available on Linux (Windows is not supported)
+struct SC::HttpShardedServer
+{
+    /// @brief A thread running an HttpServer on its own AsyncEventLoop
+    struct Shard
+    {
+        uint32_t       index = 0; ///< Index of this shard in the Span passed to HttpShardedServer::start
+        AsyncEventLoop eventLoop; ///< Event loop of this shard, to be used only from the shard thread
+        HttpServer     server;    ///< Server of this shard, to be used only from the shard thread
+
+      private:
+        friend struct HttpShardedServer;
+        HttpShardedServer* parent = nullptr;
+
+        Thread          thread;
+        EventObject     startedEvent;
+        AsyncLoopWakeUp stopWakeUp;
+        Result          startResult = Result(true);
+        Result          runResult   = Result(true);
+    };
+
+    /// @brief Called on the thread of the shard receiving the request (see HttpServerBase::onClient)
+    Function<void(Shard&, HttpServer::ClientChannel&)> onClient;
+
+    /// @brief Called on the thread of the shard receiving the request body (see HttpServerBase::onClientBody)
+    Function<void(Shard&, HttpServer::ClientChannel&, Span<const char>)> onClientBody;
+
+    /// @brief Called on the thread of the shard sending the response (see HttpServerBase::onClientResponseFlushed)
+    Function<void(Shard&, HttpServer::ClientChannel&)> onClientResponseFlushed;
+
+    /// @brief Called on the thread of the shard closing a connection on error (see HttpServerBase::onClientError)
+    Function<void(Shard&, HttpServer::ClientChannel&, Result)> onClientError;
+
+    /// @brief Options used to create the AsyncEventLoop of every shard
+    AsyncEventLoop::Options eventLoopOptions;
+
+    /// @brief Starts one thread for each shard, each one listening on the given address and port
+    /// @param shards Caller provided shards, that must be valid until HttpShardedServer::stop returns
+    /// @param maxConnectionsPerShard Maximum number of concurrent connections handled by each shard
+    /// @param address The address of local interface where to listen to
+    /// @param port The local port where to start listening to
+    /// @return Valid Result if all shards have been started successfully
+    [[nodiscard]] Result start(Span<Shard> shards, uint32_t maxConnectionsPerShard, StringView address,
+                               uint16_t port);
+
+    /// @brief Stops accepting connections and waits for all shard threads to finish in-flight requests
+    /// @return Valid Result if all shards have been stopped successfully
+    [[nodiscard]] Result stop();
+
+  private:
+    Span<Shard> shards;
+
+    // Used by shard threads only during HttpShardedServer::start
+    uint32_t   maxConnections = 0;
+    StringView address;
+    uint16_t   port = 0;
+
+    void runShard(Shard& shard);
 };
 
 //! @}
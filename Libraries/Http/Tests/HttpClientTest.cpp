@@ -2,7 +2,10 @@
 // SPDX-License-Identifier: MIT
 #include "../HttpClient.h"
 #include "../../Socket/SocketDescriptor.h"
+#include "../../Strings/StringBuilder.h"
 #include "../../Testing/Testing.h"
+#include "../../Threading/ThreadPool.h"
+#include "../HttpServer.h"
 
 namespace SC
 {
@@ -14,6 +17,364 @@ struct SC::HttpClientTest : public SC::TestCase
     HttpClientTest(SC::TestReport& report) : TestCase(report, "HttpClientTest")
     {
         if (test_section("sample")) {}
+        if (test_section("client get"))
+        {
+            clientGet();
+        }
+        if (test_section("pool keep-alive"))
+        {
+            poolKeepAlive();
+        }
+        if (test_section("pool concurrent"))
+        {
+            poolConcurrent();
+        }
+        if (test_section("pool stale connection"))
+        {
+            poolStaleConnection();
+        }
+        if (test_section("pool dns resolution"))
+        {
+            poolDNSResolution();
+        }
+    }
+
+    // Responds with the url, followed by the request body (streamed back with a chunked response)
+    void startEchoServer(HttpServer& server, AsyncEventLoop& eventLoop, uint16_t port)
+    {
+        server.onClient = [this](HttpServer::ClientChannel& client)
+        {
+            SC_TEST_EXPECT(client.response.startResponse(200));
+            if (client.request.bodyEndReceived)
+            {
+                SC_TEST_EXPECT(client.response.end(client.request.url));
+                return;
+            }
+            SC_TEST_EXPECT(client.response.startChunkedBody());
+            SC_TEST_EXPECT(client.response.write(client.request.url.toCharSpan()));
+        };
+        server.onClientBody = [this](HttpServer::ClientChannel& client, Span<const char> data)
+        {
+            SC_TEST_EXPECT(client.response.write(data));
+            if (client.request.bodyEndReceived)
+            {
+                SC_TEST_EXPECT(client.response.end(""));
+            }
+        };
+        SC_TEST_EXPECT(server.start(eventLoop, 8, "127.0.0.1", port));
+    }
+
+    void startResolver(AsyncDNSResolver& resolver, AsyncEventLoop& eventLoop, ThreadPool& threadPool)
+    {
+        SC_TEST_EXPECT(threadPool.create(1));
+        SC_TEST_EXPECT(resolver.create(eventLoop, threadPool));
+    }
+
+    void clientGet()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        startEchoServer(server, eventLoop, 6163);
+
+        struct Context
+        {
+            HttpClientTest& test;
+            HttpServer&     server;
+            int             numResponses;
+            int             numErrors;
+        } context = {*this, server, 0, 0};
+
+        // Without a dnsResolver, short form of 127.0.0.1 is resolved by the blocking system resolver
+        HttpClient client;
+        client.callback = [&context](HttpClient& result)
+        {
+            context.test.checkClientResponse(result, "/blocking");
+            context.numResponses++;
+            context.test.stopServer(context.server);
+        };
+        SC_TEST_EXPECT(client.get(eventLoop, "http://127.1:6163/blocking"));
+
+        // Connection errors are delivered to the callback
+        HttpClient refusedClient;
+        refusedClient.callback = [&context](HttpClient& result) { context.numErrors += result.getResult() ? 0 : 1; };
+        SC_TEST_EXPECT(refusedClient.get(eventLoop, "http://127.0.0.1:6164/refused"));
+
+        // Resolution errors are delivered to the callback (`.invalid` domain is reserved to never be resolved)
+        ThreadPool       threadPool;
+        AsyncDNSResolver resolver;
+        startResolver(resolver, eventLoop, threadPool);
+        HttpClient unresolvedClient;
+        unresolvedClient.dnsResolver = &resolver;
+        unresolvedClient.callback = [&context](HttpClient& result) { context.numErrors += result.getResult() ? 0 : 1; };
+        SC_TEST_EXPECT(unresolvedClient.get(eventLoop, "http://unresolved.invalid/"));
+
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(context.numResponses == 1);
+        SC_TEST_EXPECT(context.numErrors == 2);
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void checkClientResponse(HttpClient& client, StringView expectedBody)
+    {
+        SC_TEST_EXPECT(client.getResult());
+        SC_TEST_EXPECT(client.getResponse().startsWith("HTTP/1.1 200 OK\r\n"));
+        SC_TEST_EXPECT(client.getResponse().endsWith(expectedBody));
+    }
+
+    void poolKeepAlive()
+    {
+        // Every request is executed from the callback of the previous one, re-using the same connection
+        constexpr int  NumRequests = 20;
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        startEchoServer(server, eventLoop, 6157);
+
+        ThreadPool       threadPool;
+        AsyncDNSResolver resolver;
+        startResolver(resolver, eventLoop, threadPool);
+
+        HttpClientPool pool;
+        SC_TEST_EXPECT(pool.start(eventLoop, resolver, 4));
+
+        struct Context
+        {
+            HttpClientTest& test;
+            HttpClientPool& pool;
+            HttpServer&     server;
+            int             numResponses;
+        } context = {*this, pool, server, 0};
+
+        HttpClientPool::Request request;
+        request.url      = "http://localhost:6157/keep-alive";
+        request.callback = [&context](HttpClientPool::Request& req)
+        {
+            HttpClientTest& test = context.test;
+            test.checkResponse(req, "/keep-alive");
+            context.numResponses++;
+            if (context.numResponses < NumRequests)
+            {
+                test.executeRequest(context.pool, req);
+            }
+            else
+            {
+                test.stopServer(context.server);
+            }
+        };
+        SC_TEST_EXPECT(pool.execute(request));
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(context.numResponses == NumRequests);
+        SC_TEST_EXPECT(pool.getNumOpenedConnections() == 1);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void poolConcurrent()
+    {
+        // Requests exceeding connections limit are queued and pipelined, with responses matching their requests
+        constexpr int  NumRequests = 16;
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        startEchoServer(server, eventLoop, 6158);
+
+        ThreadPool       threadPool;
+        AsyncDNSResolver resolver;
+        startResolver(resolver, eventLoop, threadPool);
+
+        HttpClientPool pool;
+        pool.maxConnectionsPerHost = 2;
+        pool.maxPipelinedRequests  = 4;
+        SC_TEST_EXPECT(pool.start(eventLoop, resolver, 4));
+
+        struct Context
+        {
+            HttpClientTest& test;
+            HttpServer&     server;
+            int             numResponses;
+        } context = {*this, server, 0};
+
+        HttpClientPool::Request requests[NumRequests];
+        SmallString<64>         urls[NumRequests];
+        SmallString<64>         bodies[NumRequests];
+        for (int idx = 0; idx < NumRequests; ++idx)
+        {
+            SC_TEST_EXPECT(StringBuilder(urls[idx]).format("http://localhost:6158/item/{}", idx));
+            HttpClientPool::Request& request = requests[idx];
+            request.url                      = urls[idx].view();
+            if (idx % 2 == 1)
+            {
+                SC_TEST_EXPECT(StringBuilder(bodies[idx]).format("-body-{}", idx * 100));
+                request.method = "POST";
+                request.body   = bodies[idx].view().toCharSpan();
+            }
+            request.callback = [&context](HttpClientPool::Request& req)
+            {
+                context.test.checkEcho(req);
+                if (++context.numResponses == NumRequests)
+                {
+                    context.test.stopServer(context.server);
+                }
+            };
+            SC_TEST_EXPECT(pool.execute(request));
+        }
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(context.numResponses == NumRequests);
+        SC_TEST_EXPECT(pool.getNumOpenedConnections() == 2);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void poolStaleConnection()
+    {
+        // Server closes the idle keep-alive connection, so the second request is sent again on a new one
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        server.idleTimeout = Time::Milliseconds(20);
+        startEchoServer(server, eventLoop, 6159);
+
+        ThreadPool       threadPool;
+        AsyncDNSResolver resolver;
+        startResolver(resolver, eventLoop, threadPool);
+
+        HttpClientPool pool;
+        SC_TEST_EXPECT(pool.start(eventLoop, resolver, 4));
+
+        AsyncLoopTimeout        timeout;
+        HttpClientPool::Request request;
+
+        struct Context
+        {
+            HttpClientTest&          test;
+            AsyncEventLoop&          eventLoop;
+            HttpClientPool&          pool;
+            HttpServer&              server;
+            AsyncLoopTimeout&        timeout;
+            HttpClientPool::Request& request;
+            int                      numResponses;
+        } context = {*this, eventLoop, pool, server, timeout, request, 0};
+
+        request.url      = "http://localhost:6159/stale";
+        request.callback = [&context](HttpClientPool::Request& req)
+        {
+            context.test.checkResponse(req, "/stale");
+            if (++context.numResponses == 1)
+            {
+                context.test.startTimeout(context.timeout, context.eventLoop, Time::Milliseconds(200));
+            }
+            else
+            {
+                context.test.stopServer(context.server);
+            }
+        };
+        timeout.callback = [&context](AsyncLoopTimeout::Result&)
+        { context.test.executeRequest(context.pool, context.request); };
+        SC_TEST_EXPECT(pool.execute(request));
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(context.numResponses == 2);
+        SC_TEST_EXPECT(pool.getNumOpenedConnections() == 2);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void poolDNSResolution()
+    {
+        // Host names not resolvable locally are resolved on the thread pool, without blocking the loop
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        startEchoServer(server, eventLoop, 6160);
+
+        ThreadPool       threadPool;
+        AsyncDNSResolver resolver;
+        startResolver(resolver, eventLoop, threadPool);
+
+        HttpClientPool pool;
+        SC_TEST_EXPECT(pool.start(eventLoop, resolver, 4));
+
+        struct Context
+        {
+            HttpClientTest& test;
+            HttpServer&     server;
+            int             numResponses;
+            int             numErrors;
+        } context = {*this, server, 0, 0};
+
+        // Short form of 127.0.0.1 is understood only by the system resolver
+        HttpClientPool::Request requests[2];
+        for (HttpClientPool::Request& request : requests)
+        {
+            request.url      = "http://127.1:6160/resolved";
+            request.callback = [&context](HttpClientPool::Request& req)
+            {
+                context.test.checkResponse(req, "/resolved");
+                if (++context.numResponses == 2)
+                {
+                    context.test.stopServer(context.server);
+                }
+            };
+            SC_TEST_EXPECT(pool.execute(request));
+        }
+
+        // Resolution errors are delivered to the callback of all requests queued to the host
+        SmallString<320> invalidUrl;
+        StringBuilder    sb(invalidUrl);
+        SC_TEST_EXPECT(sb.append("http://"));
+        for (size_t idx = 0; idx <= AsyncDNSResolver::MaxHostLength; ++idx)
+        {
+            SC_TEST_EXPECT(sb.append("a"));
+        }
+        SC_TEST_EXPECT(sb.append(".com/"));
+        HttpClientPool::Request invalidRequest;
+        invalidRequest.url      = invalidUrl.view();
+        invalidRequest.callback = [&context](HttpClientPool::Request& req) { context.numErrors += req.result ? 0 : 1; };
+        SC_TEST_EXPECT(pool.execute(invalidRequest));
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(context.numResponses == 2);
+        SC_TEST_EXPECT(context.numErrors == 1);
+        SC_TEST_EXPECT(pool.getNumOpenedConnections() == 1);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void executeRequest(HttpClientPool& pool, HttpClientPool::Request& request)
+    {
+        SC_TEST_EXPECT(pool.execute(request));
+    }
+
+    void stopServer(HttpServer& server) { SC_TEST_EXPECT(server.stop()); }
+
+    void startTimeout(AsyncLoopTimeout& timeout, AsyncEventLoop& eventLoop, Time::Milliseconds ms)
+    {
+        SC_TEST_EXPECT(timeout.start(eventLoop, ms));
+    }
+
+    void checkResponse(HttpClientPool::Request& request, StringView expectedBody)
+    {
+        SC_TEST_EXPECT(request.result);
+        SC_TEST_EXPECT(request.statusCode == 200);
+        SC_TEST_EXPECT(request.getResponseBody() == expectedBody);
+    }
+
+    void checkEcho(HttpClientPool::Request& request)
+    {
+        // Expected body is the path of the url followed by the request body
+        SmallString<64> expected;
+        StringView      path = request.url.sliceStart(StringView("http://localhost:6158").sizeInBytes());
+        StringView      body(request.body, false, StringEncoding::Ascii);
+        SC_TEST_EXPECT(StringBuilder(expected).format("{}{}", path, body));
+        checkResponse(request, expected.view());
+        StringView value;
+        if (request.body.empty())
+        {
+            SC_TEST_EXPECT(request.findResponseHeader("content-length", value));
+        }
+        else
+        {
+            SC_TEST_EXPECT(request.findResponseHeader("Transfer-Encoding", value) and value == "chunked");
+        }
     }
 };
 
@@ -226,6 +226,44 @@ struct SC::HttpParserTest : public SC::TestCase
             SC_TEST_EXPECT(numMatches[static_cast<int>(HttpParser::Result::HeadersEnd)] == 1);
             SC_TEST_EXPECT(numMatches[static_cast<int>(HttpParser::Result::Body)] == 1);
         }
+        if (test_section("chunked body"))
+        {
+            const StringView chunkedBody = "4\r\nWiki\r\n"
+                                           "6;name=value\r\npedia \r\n"
+                                           "E\r\nin \r\n\r\nchunks.\r\n"
+                                           "0\r\n"
+                                           "Trailer: value\r\n"
+                                           "\r\n";
+            // Feed the decoder with slices of different lengths, including one character at time
+            for (size_t length = 1; length <= chunkedBody.sizeInBytes(); length += 7)
+            {
+                HttpChunkedParser parser;
+                Vector<char>      body;
+                size_t            position = 0;
+                while (position < chunkedBody.sizeInBytes() and not parser.isFinished())
+                {
+                    const size_t     sliceLength = min(length, chunkedBody.sizeInBytes() - position);
+                    const auto       sv          = chunkedBody.sliceStartLengthBytes(position, sliceLength);
+                    size_t           readBytes   = 0;
+                    Span<const char> bodyData;
+                    SC_TEST_EXPECT(parser.parse(sv.toCharSpan(), readBytes, bodyData));
+                    SC_TEST_EXPECT(body.append(bodyData));
+                    position += readBytes;
+                }
+                SC_TEST_EXPECT(parser.isFinished());
+                SC_TEST_EXPECT(position == chunkedBody.sizeInBytes());
+                SC_TEST_EXPECT(StringView(body.toSpanConst(), false, StringEncoding::Ascii) ==
+                               "Wikipedia in \r\n\r\nchunks.");
+            }
+            // Chunk data not followed by CRLF
+            HttpChunkedParser invalid;
+            size_t            readBytes;
+            Span<const char>  bodyData;
+            Span<const char>  invalidBody = StringView("4\r\nWikiXX").toCharSpan();
+            SC_TEST_EXPECT(invalid.parse(invalidBody, readBytes, bodyData));
+            SC_TEST_EXPECT(invalidBody.sliceStart(readBytes, invalidBody));
+            SC_TEST_EXPECT(not invalid.parse(invalidBody, readBytes, bodyData));
+        }
     }
 };
 
@@ -76,6 +76,402 @@ struct SC::HttpServerTest : public SC::TestCase
             SC_TEST_EXPECT(numTries == wantedNumTries);
             SC_TEST_EXPECT(eventLoop.close());
         }
+        if (test_section("request header index"))
+        {
+            requestHeaderIndex();
+        }
+        if (test_section("server keep-alive"))
+        {
+            serverKeepAlive();
+        }
+        if (test_section("server idle timeout"))
+        {
+            serverIdleTimeout();
+        }
+        if (test_section("server streaming"))
+        {
+            serverStreaming();
+        }
+        if (test_section("server deferred response"))
+        {
+            serverDeferredResponse();
+        }
+        if (test_section("server client error"))
+        {
+            serverClientError();
+        }
+#if !SC_PLATFORM_WINDOWS
+        if (test_section("server sharded"))
+        {
+            serverSharded();
+        }
+#endif
+    }
+
+    // Raw requests sent on a single connection, collecting everything received until the server closes it
+    struct RawClient
+    {
+        SocketDescriptor   socket;
+        AsyncSocketConnect asyncConnect;
+        AsyncSocketSend    asyncSend;
+        AsyncSocketReceive asyncReceive;
+        StringView         requests;
+
+        char                    receiveBuffer[64];
+        SmallVector<char, 1024> received;
+        bool                    closedByServer = false;
+
+        StringView view() const { return StringView(received.toSpanConst(), false, StringEncoding::Ascii); }
+    };
+
+    void startRawClient(AsyncEventLoop& eventLoop, HttpServer& server, RawClient& client, uint16_t port,
+                        StringView requests)
+    {
+        client.requests = requests;
+        SocketIPAddress address;
+        SC_TEST_EXPECT(address.fromAddressPort("127.0.0.1", port));
+        SC_TEST_EXPECT(eventLoop.createAsyncTCPSocket(address.getAddressFamily(), client.socket));
+        client.asyncConnect.callback = [this, &client](AsyncSocketConnect::Result& res)
+        {
+            SC_TEST_EXPECT(res.isValid());
+            AsyncEventLoop& loop = *res.getAsync().getEventLoop();
+            SC_TEST_EXPECT(client.asyncSend.start(loop, client.socket, client.requests.toCharSpan()));
+        };
+        client.asyncSend.callback = [this, &client](AsyncSocketSend::Result& res)
+        {
+            SC_TEST_EXPECT(res.isValid());
+            AsyncEventLoop& loop = *res.getAsync().getEventLoop();
+            SC_TEST_EXPECT(client.asyncReceive.start(loop, client.socket, client.receiveBuffer));
+        };
+        client.asyncReceive.callback = [&server, &client](AsyncSocketReceive::Result& res)
+        {
+            Span<char> data;
+            if (res.get(data) and not data.empty())
+            {
+                client.closedByServer = not client.received.append(Span<const char>(data));
+                res.reactivateRequest(not client.closedByServer);
+            }
+            else
+            {
+                client.closedByServer = true;
+                SC_TRUST_RESULT(server.stop());
+            }
+        };
+        SC_TEST_EXPECT(client.asyncConnect.start(eventLoop, client.socket, address));
+    }
+
+    void respondWithUrl(HttpServer::ClientChannel& client)
+    {
+        SC_TEST_EXPECT(client.response.startResponse(200));
+        SC_TEST_EXPECT(client.response.end(client.request.url));
+    }
+
+    void requestHeaderIndex()
+    {
+        struct Parser : public HttpServerBase
+        {
+            using HttpServerBase::parse;
+        } parser;
+        parser.onClient = [](HttpServerBase::ClientChannel&) {};
+
+        HttpServerBase::ClientChannel client;
+
+        String        request;
+        StringBuilder sb(request);
+        SC_TEST_EXPECT(sb.append("GET /index.html HTTP/1.1\r\n"
+                                 "host: localhost\r\n"
+                                 "CONTENT-TYPE: text/plain\r\n"
+                                 "X-Request-Id: first\r\n"
+                                 "Accept: */*\r\n"
+                                 "x-request-id: second\r\n"));
+        // Unknown headers beyond index capacity must still be found
+        for (int idx = 0; idx < 40; ++idx)
+        {
+            SC_TEST_EXPECT(sb.append("X-Custom-{}: {}\r\n", idx, idx * 2));
+        }
+        SC_TEST_EXPECT(sb.append("\r\n"));
+        size_t consumedBytes = 0;
+        SC_TEST_EXPECT(parser.parse(request.view().toCharSpan(), consumedBytes, client));
+        SC_TEST_EXPECT(client.request.headersEndReceived);
+        SC_TEST_EXPECT(consumedBytes == request.view().sizeInBytes());
+
+        using HeaderType = HttpServerBase::Request::HeaderType;
+        const auto& req  = client.request;
+        StringView  value;
+        SC_TEST_EXPECT(req.find(HttpParser::Result::Method, value) and value == "GET");
+        SC_TEST_EXPECT(req.find(HttpParser::Result::Url, value) and value == "/index.html");
+        SC_TEST_EXPECT(req.find(HttpParser::Result::Version, value) and value == "HTTP/1.1");
+        SC_TEST_EXPECT(req.findHeader(HeaderType::Host, value) and value == "localhost");
+        SC_TEST_EXPECT(req.findHeader("Host", value) and value == "localhost");
+        SC_TEST_EXPECT(req.findHeader(HeaderType::ContentType, value) and value == "text/plain");
+        SC_TEST_EXPECT(req.findHeader(HeaderType::Accept, value) and value == "*/*");
+        SC_TEST_EXPECT(not req.findHeader(HeaderType::Cookie, value));
+        SC_TEST_EXPECT(not req.findHeader("Content-Length", value));
+        SC_TEST_EXPECT(req.findHeader("x-REQUEST-id", value) and value == "first");
+        SC_TEST_EXPECT(req.findHeader("X-Custom-0", value) and value == "0");
+        SC_TEST_EXPECT(req.findHeader("x-custom-39", value) and value == "78");
+        SC_TEST_EXPECT(not req.findHeader("X-Custom-40", value));
+
+        client.request.reset();
+        SC_TEST_EXPECT(not client.request.findHeader("X-Request-Id", value));
+        SC_TEST_EXPECT(not client.request.find(HttpParser::Result::Url, value));
+        SC_TEST_EXPECT(parser.parse(StringView("GET / HTTP/1.1\r\nX-Request-Id: third\r\n\r\n").toCharSpan(),
+                                    consumedBytes, client));
+        SC_TEST_EXPECT(client.request.findHeader("X-Request-Id", value) and value == "third");
+        SC_TEST_EXPECT(not client.request.findHeader("X-Custom-0", value));
+    }
+
+    void serverKeepAlive()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        SC_TEST_EXPECT(server.start(eventLoop, 10, "127.0.0.1", 6154));
+
+        int numRequests = 0;
+        server.onClient = [this, &numRequests](HttpServer::ClientChannel& client)
+        {
+            numRequests++;
+            respondWithUrl(client);
+        };
+        // Three pipelined requests sent at once, with the last one asking to close the connection
+        RawClient client;
+        startRawClient(eventLoop, server, client, 6154,
+                     "GET /first HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"
+                     "POST /second HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 4\r\n\r\nBODY"
+                     "GET /third HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n");
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+
+        SC_TEST_EXPECT(numRequests == 3);
+        SC_TEST_EXPECT(client.closedByServer);
+        StringView first, second, third;
+        SC_TEST_EXPECT(client.view().splitAfter("\r\n\r\n/first", first));
+        SC_TEST_EXPECT(first.splitAfter("\r\n\r\n/second", second));
+        SC_TEST_EXPECT(second.splitAfter("\r\n\r\n/third", third));
+        SC_TEST_EXPECT(third.isEmpty());
+        // Only the last response tells that the connection is going to be closed
+        StringView firstHeaders, secondHeaders;
+        SC_TEST_EXPECT(client.view().splitBefore("\r\n\r\n/first", firstHeaders));
+        SC_TEST_EXPECT(first.splitBefore("\r\n\r\n/second", secondHeaders));
+        SC_TEST_EXPECT(not firstHeaders.containsString("Connection"));
+        SC_TEST_EXPECT(not secondHeaders.containsString("Connection"));
+        SC_TEST_EXPECT(second.containsString("Connection: close\r\n"));
+    }
+
+    void serverIdleTimeout()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        server.idleTimeout = Time::Milliseconds(50);
+        SC_TEST_EXPECT(server.start(eventLoop, 10, "127.0.0.1", 6155));
+
+        server.onClient = [this](HttpServer::ClientChannel& client) { respondWithUrl(client); };
+
+        // A keep-alive connection must be closed by the server when no other request follows
+        RawClient client;
+        startRawClient(eventLoop, server, client, 6155, "GET /idle HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+        Time::HighResolutionCounter end;
+        end.snap();
+        SC_TEST_EXPECT(client.closedByServer);
+        SC_TEST_EXPECT(client.view().endsWith("\r\n\r\n/idle"));
+        SC_TEST_EXPECT(end.subtractApproximate(start).inRoundedUpperMilliseconds().ms >= 50);
+    }
+
+    void serverStreaming()
+    {
+        constexpr int    NumChunks = 10;
+        constexpr size_t ChunkSize = 1000;
+
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        SC_TEST_EXPECT(server.start(eventLoop, 10, "127.0.0.1", 6156));
+
+        struct Context
+        {
+            SmallString<32> upload;
+            int             numBodyCalls = 0;
+            int             numChunks    = 0;
+            char            chunk[ChunkSize];
+        } context;
+        memset(context.chunk, 'x', ChunkSize);
+
+        server.onClient = [this, &context](HttpServer::ClientChannel& client)
+        {
+            SC_TEST_EXPECT(client.response.startResponse(200));
+            if (client.request.url == "/download")
+            {
+                // Streamed one chunk at time, from onClientResponseFlushed
+                SC_TEST_EXPECT(client.request.bodyEndReceived);
+                SC_TEST_EXPECT(client.response.startChunkedBody());
+                SC_TEST_EXPECT(client.response.write(context.chunk));
+                context.numChunks = 1;
+            }
+            else
+            {
+                SC_TEST_EXPECT(client.request.url == "/upload");
+                SC_TEST_EXPECT(client.request.chunkedBody);
+                SC_TEST_EXPECT(not client.request.bodyEndReceived);
+            }
+        };
+        server.onClientBody = [this, &context](HttpServer::ClientChannel& client, Span<const char> data)
+        {
+            context.numBodyCalls++;
+            SC_TEST_EXPECT(StringBuilder(context.upload).append(StringView(data, false, StringEncoding::Ascii)));
+            if (client.request.bodyEndReceived)
+            {
+                SC_TEST_EXPECT(client.response.end(context.upload.view()));
+            }
+        };
+        server.onClientResponseFlushed = [this, &context](HttpServer::ClientChannel& client)
+        {
+            // Every chunk is sent before writing next one, so memory usage doesn't depend on response size
+            SC_TEST_EXPECT(client.response.outputBuffer.isEmpty());
+            if (context.numChunks++ < NumChunks)
+            {
+                SC_TEST_EXPECT(client.response.write(context.chunk));
+            }
+            else
+            {
+                SC_TEST_EXPECT(client.response.end(""));
+            }
+        };
+        RawClient client;
+        startRawClient(eventLoop, server, client, 6156,
+                       "POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                       "5\r\nHello\r\n7\r\n, World\r\n0\r\n\r\n"
+                       "GET /download HTTP/1.1\r\nConnection: close\r\n\r\n");
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+        SC_TEST_EXPECT(client.closedByServer);
+        SC_TEST_EXPECT(context.upload.view() == "Hello, World");
+        SC_TEST_EXPECT(context.numBodyCalls == 3); // Two chunks and body end
+
+        StringView download;
+        SC_TEST_EXPECT(client.view().splitAfter("\r\n\r\nHello, World", download));
+        SC_TEST_EXPECT(download.splitAfter("Transfer-Encoding: chunked\r\n\r\n", download));
+        HttpChunkedParser parser;
+        size_t            numBytes = 0;
+        Span<const char>  data     = download.toCharSpan();
+        while (not data.empty())
+        {
+            size_t           readBytes;
+            Span<const char> bodyData;
+            SC_TEST_EXPECT(parser.parse(data, readBytes, bodyData));
+            SC_TEST_EXPECT(data.sliceStart(readBytes, data));
+            numBytes += bodyData.sizeInBytes();
+        }
+        SC_TEST_EXPECT(parser.isFinished());
+        SC_TEST_EXPECT(numBytes == NumChunks * ChunkSize);
+    }
+
+    void serverDeferredResponse()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        SC_TEST_EXPECT(server.start(eventLoop, 10, "127.0.0.1", 6161));
+
+        struct Context
+        {
+            HttpServer&                server;
+            AsyncEventLoop&            eventLoop;
+            AsyncLoopTimeout           timeout;
+            HttpServer::ClientChannel* client = nullptr;
+        } context = {server, eventLoop};
+
+        // Responses are ended after returning from onClient, simulating some asynchronous work
+        server.onClient = [this, &context](HttpServer::ClientChannel& client)
+        {
+            SC_TEST_EXPECT(not context.server.flushResponse(client)); // Still inside a callback
+            context.client = &client;
+            SC_TEST_EXPECT(context.timeout.start(context.eventLoop, Time::Milliseconds(1)));
+        };
+        context.timeout.callback = [this, &context](AsyncLoopTimeout::Result&)
+        {
+            respondWithUrl(*context.client);
+            SC_TEST_EXPECT(context.server.flushResponse(*context.client));
+        };
+        RawClient client;
+        startRawClient(eventLoop, server, client, 6161,
+                       "GET /first HTTP/1.1\r\n\r\n"
+                       "GET /second HTTP/1.1\r\nConnection: close\r\n\r\n");
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+        SC_TEST_EXPECT(client.closedByServer);
+        StringView second;
+        SC_TEST_EXPECT(client.view().splitAfter("\r\n\r\n/first", second));
+        SC_TEST_EXPECT(second.endsWith("Connection: close\r\nContent-Length: 7\r\n\r\n/second"));
+    }
+
+    void serverClientError()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpServer server;
+        SC_TEST_EXPECT(server.start(eventLoop, 10, "127.0.0.1", 6162));
+
+        int numErrors   = 0;
+        server.onClient = [this](HttpServer::ClientChannel& client) { respondWithUrl(client); };
+        server.onClientError = [this, &numErrors](HttpServer::ClientChannel&, Result error)
+        {
+            numErrors++;
+            SC_TEST_EXPECT(not error);
+        };
+        // Connection is closed after answering the valid request, when parsing the invalid pipelined one
+        RawClient client;
+        startRawClient(eventLoop, server, client, 6162, "GET /valid HTTP/1.1\r\n\r\n\x01INVALID\r\n\r\n");
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+        SC_TEST_EXPECT(client.closedByServer);
+        SC_TEST_EXPECT(numErrors == 1);
+        SC_TEST_EXPECT(client.view().endsWith("\r\n\r\n/valid"));
+    }
+
+    void serverSharded()
+    {
+        constexpr int NumShards  = 2;
+        constexpr int NumClients = 6;
+
+        HttpShardedServer        server;
+        HttpShardedServer::Shard shards[NumShards];
+        Atomic<int>              numRequests = 0;
+        server.onClient = [this, &numRequests](HttpShardedServer::Shard& shard, HttpServer::ClientChannel& client)
+        {
+            // Called concurrently on shard threads
+            SC_TEST_EXPECT(shard.index < NumShards);
+            numRequests.fetch_add(1);
+            SC_TEST_EXPECT(client.response.startResponse(200));
+            SC_TEST_EXPECT(client.response.addHeader("Connection", "Closed"));
+            SC_TEST_EXPECT(client.response.end("<html>This is a sharded server</html>"));
+        };
+        SC_TEST_EXPECT(server.start(shards, 10, "127.0.0.1", 6153));
+
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create());
+        HttpClient clients[NumClients];
+        int        numResponses = 0;
+        for (int idx = 0; idx < NumClients; ++idx)
+        {
+            clients[idx].callback = [this, &numResponses](HttpClient& result)
+            {
+                SC_TEST_EXPECT(result.getResponse().containsString("This is a sharded server"));
+                numResponses++;
+            };
+            SC_TEST_EXPECT(clients[idx].get(eventLoop, "http://localhost:6153/index.html"));
+        }
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(eventLoop.close());
+        SC_TEST_EXPECT(server.stop());
+        SC_TEST_EXPECT(numResponses == NumClients);
+        SC_TEST_EXPECT(numRequests.load() == NumClients);
     }
 };
 
@@ -113,34 +113,57 @@ SC::Result SC::SocketServer::close() { return socket.close(); }
 
 SC::Result SC::SocketServer::listen(SocketIPAddress nativeAddress, uint32_t numberOfWaitingConnections)
 {
-    SC_TRY(SocketNetworking::isNetworkingInited());
-    SC_TRY_MSG(socket.isValid(), "Invalid socket");
+    SC_TRY(bind(nativeAddress));
     SocketDescriptor::Handle listenSocket;
     SC_TRUST_RESULT(socket.get(listenSocket, Result::Error("invalid listen socket")));
+    if (::listen(listenSocket, static_cast<int>(numberOfWaitingConnections)) == SOCKET_ERROR)
+    {
+        SC_TRUST_RESULT(socket.close());
+        return Result::Error("Could not listen");
+    }
+    return Result(true);
+}
+
+SC::Result SC::SocketServer::bind(SocketIPAddress nativeAddress)
+{
+    SC_TRY(SocketNetworking::isNetworkingInited());
+    SC_TRY_MSG(socket.isValid(), "Invalid socket");
+    SocketDescriptor::Handle serverSocket;
+    SC_TRUST_RESULT(socket.get(serverSocket, Result::Error("invalid bind socket")));
 
     // TODO: Expose SO_REUSEADDR as an option?
     int value = 1;
 #if SC_PLATFORM_WINDOWS
-    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&value), sizeof(value));
+    setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&value), sizeof(value));
 #elif !SC_PLATFORM_EMSCRIPTEN
-    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+    setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
 #else
     SC_COMPILER_UNUSED(value);
 #endif
-    if (::bind(listenSocket, &nativeAddress.handle.reinterpret_as<const struct sockaddr>(),
+    if (::bind(serverSocket, &nativeAddress.handle.reinterpret_as<const struct sockaddr>(),
                nativeAddress.sizeOfHandle()) == SOCKET_ERROR)
     {
         SC_TRUST_RESULT(socket.close());
         return Result::Error("Could not bind socket to port");
     }
-    if (::listen(listenSocket, static_cast<int>(numberOfWaitingConnections)) == SOCKET_ERROR)
-    {
-        SC_TRUST_RESULT(socket.close());
-        return Result::Error("Could not listen");
-    }
     return Result(true);
 }
 
+SC::Result SC::SocketServer::enableReusePort()
+{
+    SC_TRY_MSG(socket.isValid(), "Invalid socket");
+#if SC_PLATFORM_WINDOWS || SC_PLATFORM_EMSCRIPTEN
+    return Result::Error("SocketServer::enableReusePort - SO_REUSEPORT is not supported");
+#else
+    SocketDescriptor::Handle listenSocket;
+    SC_TRUST_RESULT(socket.get(listenSocket, Result::Error("invalid listen socket")));
+    int value = 1;
+    SC_TRY_MSG(::setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)) == 0,
+               "SocketServer::enableReusePort - setsockopt failed");
+    return Result(true);
+#endif
+}
+
 SC::Result SC::SocketServer::accept(SocketFlags::AddressFamily addressFamily, SocketDescriptor& newClient)
 {
     SC_TRY_MSG(not newClient.isValid(), "destination socket already in use");
@@ -356,3 +379,49 @@ SC::Result SC::SocketNetworking::resolveDNS(StringView host, String& ipAddress)
     freeaddrinfo(res); // Free the linked list
     return Result(true);
 }
+
+SC::Result SC::SocketNetworking::resolveDNS(StringView host, uint16_t port, Span<SocketIPAddress> addresses,
+                                            size_t& numAddresses)
+{
+    numAddresses = 0;
+
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family   = AF_UNSPEC;   // Use either IPv4 or IPv6
+    hints.ai_socktype = SOCK_STREAM; // Avoid duplicated results for every socket type
+
+    SmallString<256> buffer;
+    StringConverter  converter(buffer);
+    StringView       nullTerminated;
+    SC_TRY(converter.convertNullTerminateFastPath(host, nullTerminated));
+    const int status = getaddrinfo(nullTerminated.bytesIncludingTerminator(), NULL, &hints, &res);
+    if (status != 0)
+    {
+        return Result::Error("SocketNetworking::resolveDNS: getaddrinfo error");
+    }
+    for (struct addrinfo* p = res; p != NULL and numAddresses < addresses.sizeInElements(); p = p->ai_next)
+    {
+        SocketIPAddress& address = addresses[numAddresses];
+        if (p->ai_family == AF_INET)
+        {
+            sockaddr_in& ipv4 = address.handle.reinterpret_as<sockaddr_in>();
+            memcpy(&ipv4, p->ai_addr, sizeof(sockaddr_in));
+            ipv4.sin_port         = htons(port);
+            address.addressFamily = SocketFlags::AddressFamilyIPV4;
+        }
+        else if (p->ai_family == AF_INET6)
+        {
+            sockaddr_in6& ipv6 = address.handle.reinterpret_as<sockaddr_in6>();
+            memcpy(&ipv6, p->ai_addr, sizeof(sockaddr_in6));
+            ipv6.sin6_port        = htons(port);
+            address.addressFamily = SocketFlags::AddressFamilyIPV6;
+        }
+        else
+        {
+            continue;
+        }
+        numAddresses++;
+    }
+    freeaddrinfo(res);
+    return Result(numAddresses > 0);
+}
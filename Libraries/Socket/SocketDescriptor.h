@@ -125,7 +125,7 @@ struct SC::SocketIPAddress
 
     /// @brief Get Address family of this ip address (IPV4 or IPV6)
     /// @return The Ip Address Family of the given Socket
-    [[nodiscard]] SocketFlags::AddressFamily getAddressFamily() { return addressFamily; }
+    [[nodiscard]] SocketFlags::AddressFamily getAddressFamily() const { return addressFamily; }
 
     /// @brief Builds this SocketIPAddress parsing given address string and port
     /// @param interfaceAddress A valid IPV4 or IPV6 address expressed as a string
@@ -135,6 +135,7 @@ struct SC::SocketIPAddress
 
     friend struct SocketServer;
     friend struct SocketClient;
+    friend struct SocketNetworking;
 
     uint32_t sizeOfHandle() const;
 
@@ -233,6 +234,18 @@ struct SC::SocketServer
     /// @return Valid Result if this socket has successfully been put in listening mode (bind + listen)
     [[nodiscard]] Result listen(SocketIPAddress nativeAddress, uint32_t numberOfWaitingConnections = 511);
 
+    /// @brief Binds the socket to a specific address / port combination, without listening for connections.
+    /// Used by datagram (UDP) sockets to receive datagrams sent to the given address / port.
+    /// @param nativeAddress The interface ip address and port to bind to
+    /// @return Valid Result if this socket has successfully been bound
+    [[nodiscard]] Result bind(SocketIPAddress nativeAddress);
+
+    /// @brief Allows multiple sockets to listen on the same address / port combination (`SO_REUSEPORT`).
+    /// On Linux the kernel load balances incoming connections among all of them, allowing each thread to accept
+    /// connections on its own listening socket. Must be called before SocketServer::listen.
+    /// @return Valid Result if the option has been set (it's not supported on Windows)
+    [[nodiscard]] Result enableReusePort();
+
     /// @brief Accepts a new client, blocking while waiting for it
     /// @param[in] addressFamily The address family of the SocketDescriptor that will be created
     /// @param[out] newClient The SocketDescriptor that will be accepted
@@ -343,6 +356,15 @@ struct SC::SocketNetworking
     /// @snippet Libraries/Socket/Tests/SocketDescriptorTest.cpp resolveDNSSnippet
     [[nodiscard]] static Result resolveDNS(StringView host, String& ipAddress);
 
+    /// @brief Resolve an host string to all of its ip addresses, of any family (blocking until DNS response arrives)
+    /// @param[in] host The host string (example.com)
+    /// @param[in] port The port assigned to all resolved addresses
+    /// @param[out] addresses Receives resolved addresses, in the order returned by the system resolver
+    /// @param[out] numAddresses Number of addresses written to `addresses` (additional ones are discarded)
+    /// @return Valid Result if at least one ip address for the passed host has been successfully resolved
+    [[nodiscard]] static Result resolveDNS(StringView host, uint16_t port, Span<SocketIPAddress> addresses,
+                                           size_t& numAddresses);
+
     /// @brief Initializes Winsock2 on Windows (WSAStartup)
     /// @return Valid Result if Winsock2 has been successfully initialized
     [[nodiscard]] static Result initNetworking();
@@ -55,6 +55,11 @@ void SC::SocketDescriptorTest::resolveDNS()
     SC_TEST_EXPECT(SocketNetworking::resolveDNS("localhost", ipAddress));
     SC_TEST_EXPECT(ipAddress.view() == "127.0.0.1");
     //! [resolveDNSSnippet]
+
+    SocketIPAddress addresses[4];
+    size_t          numAddresses = 0;
+    SC_TEST_EXPECT(SocketNetworking::resolveDNS("localhost", 80, addresses, numAddresses));
+    SC_TEST_EXPECT(numAddresses > 0);
 }
 
 void SC::SocketDescriptorTest::socketDescriptor()
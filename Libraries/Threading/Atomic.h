@@ -6,12 +6,17 @@
 #if _MSC_VER
 extern "C"
 {
-    long    _InterlockedExchangeAdd(long volatile* Addend, long Value);
     char    _InterlockedExchange8(char volatile* Target, char Value);
+    char    _InterlockedCompareExchange8(char volatile* Destination, char Exchange, char Comparand);
+    long    _InterlockedCompareExchange(long volatile* Destination, long Exchange, long Comparand);
+    __int64 _InterlockedCompareExchange64(__int64 volatile* Destination, __int64 Exchange, __int64 Comparand);
     void    __dmb(unsigned int _Type);
     void    __iso_volatile_store8(volatile __int8*, __int8);
+    void    __iso_volatile_store32(volatile __int32*, __int32);
+    void    __iso_volatile_store64(volatile __int64*, __int64);
     __int8  __iso_volatile_load8(const volatile __int8*);
     __int32 __iso_volatile_load32(const volatile __int32*);
+    __int64 __iso_volatile_load64(const volatile __int64*);
     void    _ReadWriteBarrier(void);
 
 #ifdef __clang__
@@ -44,18 +49,6 @@ extern "C"
 #else
 #error Unsupported hardware
 #endif
-
-#define SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(_Order_var)                                                   \
-    switch (_Order_var)                                                                                                \
-    {                                                                                                                  \
-    case memory_order_relaxed: break;                                                                                  \
-    case memory_order_consume:                                                                                         \
-    case memory_order_acquire:                                                                                         \
-    case memory_order_seq_cst: SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER(); break;                                      \
-    case memory_order_release:                                                                                         \
-    case memory_order_acq_rel:                                                                                         \
-    default: break;                                                                                                    \
-    }
 }
 #endif
 
@@ -83,112 +76,314 @@ typedef enum memory_order
 } memory_order;
 
 #endif
-/// @brief Atomic variables (only for `int` and `bool` for now).
-/// @n
-/// Example:
-/// @code{.cpp}
-/// Atomic<bool> test = true;
-///
-/// SC_TEST_EXPECT(test.load());
-/// test.exchange(false);
-/// SC_TEST_EXPECT(not test.load());
-/// @endcode
-template <typename T>
-struct Atomic;
+
+/// @brief Size of a cache line, used to pad data accessed by different threads to avoid false sharing
+static constexpr size_t CacheLineSize = 64;
+
+/// @brief Issues a memory fence with the given memory order
+inline void atomic_thread_fence(memory_order order)
+{
+#if _MSC_VER
+    if (order != memory_order_relaxed)
+    {
+        // Interlocked operations are full memory barriers on all supported architectures
+        volatile long dummy = 0;
+        (void)_InterlockedCompareExchange(&dummy, 0, 0);
+    }
+#else
+    __atomic_thread_fence(order);
+#endif
+}
+
+namespace detail
+{
+#if _MSC_VER
+// Loads, stores and compare exchange of 1, 4 and 8 bytes values (other operations are built on compare exchange)
+template <int Size>
+struct AtomicIntrinsics;
+
+template <>
+struct AtomicIntrinsics<1>
+{
+    using Type = char;
+    static Type load(const volatile Type* ptr)
+    {
+        return __iso_volatile_load8(reinterpret_cast<const volatile __int8*>(ptr));
+    }
+    static void store(volatile Type* ptr, Type value)
+    {
+        __iso_volatile_store8(reinterpret_cast<volatile __int8*>(ptr), value);
+    }
+    static Type exchange(volatile Type* ptr, Type value) { return _InterlockedExchange8(ptr, value); }
+    static Type compareExchange(volatile Type* ptr, Type desired, Type expected)
+    {
+        return _InterlockedCompareExchange8(ptr, desired, expected);
+    }
+};
 
 template <>
-struct Atomic<int32_t>
+struct AtomicIntrinsics<4>
+{
+    using Type = long;
+    static Type load(const volatile Type* ptr)
+    {
+        return __iso_volatile_load32(reinterpret_cast<const volatile __int32*>(ptr));
+    }
+    static void store(volatile Type* ptr, Type value)
+    {
+        __iso_volatile_store32(reinterpret_cast<volatile __int32*>(ptr), value);
+    }
+    static Type compareExchange(volatile Type* ptr, Type desired, Type expected)
+    {
+        return _InterlockedCompareExchange(ptr, desired, expected);
+    }
+    static Type exchange(volatile Type* ptr, Type value)
+    {
+        Type expected = load(ptr);
+        for (Type previous; (previous = compareExchange(ptr, value, expected)) != expected; expected = previous) {}
+        return expected;
+    }
+};
+
+template <>
+struct AtomicIntrinsics<8>
+{
+    using Type = __int64;
+    static Type load(const volatile Type* ptr) { return __iso_volatile_load64(ptr); }
+    static void store(volatile Type* ptr, Type value) { __iso_volatile_store64(ptr, value); }
+    static Type compareExchange(volatile Type* ptr, Type desired, Type expected)
+    {
+        return _InterlockedCompareExchange64(ptr, desired, expected);
+    }
+    static Type exchange(volatile Type* ptr, Type value)
+    {
+        Type expected = load(ptr);
+        for (Type previous; (previous = compareExchange(ptr, value, expected)) != expected; expected = previous) {}
+        return expected;
+    }
+};
+
+// Reinterprets bits of a value (pointer, bool or integer) as another type of the same size
+template <typename To, typename From>
+To atomicBitCast(From from)
+{
+    static_assert(sizeof(To) == sizeof(From), "atomicBitCast - Types must have the same size");
+    union
+    {
+        From from;
+        To   to;
+    } bits;
+    bits.from = from;
+    return bits.to;
+}
+#else
+// Failure order of compare exchange can't be a release and can't be stronger than success order
+constexpr int atomicFailureOrder(memory_order order)
+{
+    return order == memory_order_acq_rel ? __ATOMIC_ACQUIRE : order == memory_order_release ? __ATOMIC_RELAXED : order;
+}
+#endif
+
+/// Load, store, exchange and compare exchange operations shared by all Atomic types
+template <typename T>
+struct AtomicBase
 {
-    Atomic(int32_t value) : value(value) {}
+    static_assert(sizeof(T) == 1 or sizeof(T) == 4 or sizeof(T) == 8, "Atomic supports only 1, 4 or 8 bytes types");
 
-    int32_t fetch_add(int32_t val)
+    AtomicBase(T value) : value(value) {}
+
+    /// @brief Atomically reads the value
+    T load(memory_order order = memory_order_seq_cst) const
     {
 #if _MSC_VER
-        int32_t res;
-        res = _InterlockedExchangeAdd(reinterpret_cast<volatile long*>(&value), val);
+        const T res = atomicBitCast<T>(Intrinsics::load(storage()));
+        if (order != memory_order_relaxed)
+        {
+            SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+        }
         return res;
 #else
-        return __atomic_fetch_add(&value, val, __ATOMIC_SEQ_CST);
+        return __atomic_load_n(&value, order);
 #endif
     }
 
-    int32_t load() const
+    /// @brief Atomically writes the value
+    void store(T desired, memory_order order = memory_order_seq_cst)
     {
-        int32_t res;
 #if _MSC_VER
-        res = __iso_volatile_load32(reinterpret_cast<volatile const int*>(&value));
-        SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+        if (order == memory_order_seq_cst)
+        {
+            (void)exchange(desired);
+            return;
+        }
+        if (order != memory_order_relaxed)
+        {
+            SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+        }
+        Intrinsics::store(storage(), atomicBitCast<Storage>(desired));
 #else
-        __atomic_load(&value, &res, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&value, desired, order);
 #endif
-        return res;
     }
 
-    int32_t load(memory_order mem) const
+    /// @brief Atomically replaces the value, returning the previous one
+    T exchange(T desired, memory_order order = memory_order_seq_cst)
     {
-        int32_t res;
 #if _MSC_VER
-        res = __iso_volatile_load32(reinterpret_cast<volatile const int*>(&value));
-        SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(mem);
+        (void)order;
+        return atomicBitCast<T>(Intrinsics::exchange(storage(), atomicBitCast<Storage>(desired)));
 #else
-        __atomic_load(&value, &res, mem);
+        return __atomic_exchange_n(&value, desired, order);
+#endif
+    }
+
+    /// @brief Atomically replaces the value with desired if it's equal to expected
+    /// @param expected Value to compare with. It receives current value if the exchange fails.
+    /// @param desired Value to be written if value equals expected
+    /// @param order Memory order of the operation (failure uses the strongest allowed order not exceeding it)
+    /// @return `true` if value has been replaced
+    bool compare_exchange_strong(T& expected, T desired, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        (void)order;
+        const Storage comparand = atomicBitCast<Storage>(expected);
+        const Storage previous  = Intrinsics::compareExchange(storage(), atomicBitCast<Storage>(desired), comparand);
+        expected                = atomicBitCast<T>(previous);
+        return previous == comparand;
+#else
+        return __atomic_compare_exchange_n(&value, &expected, desired, false, order, atomicFailureOrder(order));
+#endif
+    }
+
+    /// @brief Like compare_exchange_strong, but it can spuriously fail (cheaper on some architectures inside loops)
+    bool compare_exchange_weak(T& expected, T desired, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        return compare_exchange_strong(expected, desired, order);
+#else
+        return __atomic_compare_exchange_n(&value, &expected, desired, true, order, atomicFailureOrder(order));
 #endif
-        return res;
     }
 
-  private:
-    volatile int32_t value;
+  protected:
+#if _MSC_VER
+    using Intrinsics = AtomicIntrinsics<sizeof(T)>;
+    using Storage    = typename Intrinsics::Type;
+
+    volatile Storage*       storage() { return reinterpret_cast<volatile Storage*>(&value); }
+    const volatile Storage* storage() const { return reinterpret_cast<const volatile Storage*>(&value); }
+
+    // Read-modify-write operations are compare exchange loops (full memory barriers)
+    template <typename Operation>
+    T modify(Operation operation)
+    {
+        T expected = load(memory_order_relaxed);
+        while (not compare_exchange_weak(expected, operation(expected))) {}
+        return expected;
+    }
+#endif
+    alignas(sizeof(T)) T value;
 };
+} // namespace detail
 
-template <>
-struct Atomic<bool>
+/// @brief Atomic variables for integers (8, 32 and 64 bits), `bool` and pointers, with explicit memory orders.
+/// @n
+/// All operations default to `memory_order_seq_cst`, and accept weaker memory orders (`memory_order_acquire`,
+/// `memory_order_release`, `memory_order_relaxed` etc.) to write efficient lock-free data structures.
+/// @n
+/// Example:
+/// @snippet Libraries/Threading/Tests/AtomicTest.cpp atomicSnippet
+template <typename T>
+struct Atomic : public detail::AtomicBase<T>
 {
-    Atomic(bool value) : value(value) {}
+    Atomic(T value = T()) : detail::AtomicBase<T>(value) {}
 
-    bool exchange(bool desired)
+    /// @brief Atomically adds val, returning the previous value
+    T fetch_add(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        return static_cast<bool>(_InterlockedExchange8(reinterpret_cast<volatile char*>(&value), desired));
+        (void)order;
+        return this->modify([val](T current) { return static_cast<T>(current + val); });
 #else
-        bool res;
-        __atomic_exchange(&value, &desired, &res, __ATOMIC_SEQ_CST);
-        return res;
+        return __atomic_fetch_add(&this->value, val, order);
 #endif
     }
 
-    bool load() const
+    /// @brief Atomically subtracts val, returning the previous value
+    T fetch_sub(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        char res = __iso_volatile_load8(reinterpret_cast<volatile const char*>(&value));
-        SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
-        return reinterpret_cast<bool&>(res);
+        (void)order;
+        return this->modify([val](T current) { return static_cast<T>(current - val); });
 #else
-        bool res;
-        __atomic_load(&value, &res, __ATOMIC_SEQ_CST);
-        return res;
+        return __atomic_fetch_sub(&this->value, val, order);
 #endif
     }
 
-    bool load(memory_order mem) const
+    /// @brief Atomically computes bitwise and with val, returning the previous value
+    T fetch_and(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        char res = __iso_volatile_load8(reinterpret_cast<volatile const char*>(&value));
-        SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(mem);
-        return reinterpret_cast<bool&>(res);
+        (void)order;
+        return this->modify([val](T current) { return static_cast<T>(current & val); });
 #else
-        bool res;
-        __atomic_load(&value, &res, mem);
-        return res;
+        return __atomic_fetch_and(&this->value, val, order);
+#endif
+    }
+
+    /// @brief Atomically computes bitwise or with val, returning the previous value
+    T fetch_or(T val, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        (void)order;
+        return this->modify([val](T current) { return static_cast<T>(current | val); });
+#else
+        return __atomic_fetch_or(&this->value, val, order);
+#endif
+    }
+
+    /// @brief Atomically computes bitwise xor with val, returning the previous value
+    T fetch_xor(T val, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        (void)order;
+        return this->modify([val](T current) { return static_cast<T>(current ^ val); });
+#else
+        return __atomic_fetch_xor(&this->value, val, order);
+#endif
+    }
+};
+
+/// @brief Atomic bool (supporting load, store, exchange and compare exchange)
+template <>
+struct Atomic<bool> : public detail::AtomicBase<bool>
+{
+    Atomic(bool value = false) : detail::AtomicBase<bool>(value) {}
+};
+
+/// @brief Atomic pointer, where fetch_add / fetch_sub move the pointer by a number of elements
+template <typename T>
+struct Atomic<T*> : public detail::AtomicBase<T*>
+{
+    Atomic(T* value = nullptr) : detail::AtomicBase<T*>(value) {}
+
+    /// @brief Atomically moves the pointer forward by val elements, returning the previous value
+    T* fetch_add(ssize_t val, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        (void)order;
+        return this->modify([val](T* current) { return current + val; });
+#else
+        return __atomic_fetch_add(&this->value, val * static_cast<ssize_t>(sizeof(T)), order);
 #endif
     }
 
-  private:
-    volatile bool value;
+    /// @brief Atomically moves the pointer backward by val elements, returning the previous value
+    T* fetch_sub(ssize_t val, memory_order order = memory_order_seq_cst) { return fetch_add(-val, order); }
 };
 
 } // namespace SC
 
-#undef SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER
 #undef SC_COMPILER_MSVC_DISABLE_DEPRECATED_WARNING
 #undef SC_COMPILER_MSVC_RESTORE_DEPRECATED_WARNING
 #undef SC_COMPILER_MSVC_COMPILER_BARRIER
@@ -0,0 +1,37 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../../Foundation/Compiler.h"
+
+#if _MSC_VER
+extern "C"
+{
+#if defined(_M_IX86) || defined(_M_X64)
+    void _mm_pause(void);
+#else
+    void __yield(void);
+#endif
+}
+#endif
+
+namespace SC
+{
+namespace detail
+{
+// Hints the cpu that the thread is busy waiting
+inline void cpuRelax()
+{
+#if _MSC_VER
+#if defined(_M_IX86) || defined(_M_X64)
+    _mm_pause();
+#else
+    __yield();
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+} // namespace detail
+} // namespace SC
@@ -5,6 +5,16 @@
 #include <errno.h> // errno
 #include <pthread.h>
 #include <unistd.h> // usleep
+#if SC_PLATFORM_LINUX
+#include <linux/futex.h> // FUTEX_WAIT_PRIVATE
+#include <sys/syscall.h> // SYS_futex
+#elif SC_PLATFORM_APPLE
+// Used also by libc++ to implement std::atomic::wait (available since macOS 10.12)
+extern "C" int __ulock_wait(uint32_t operation, void* address, uint64_t value, uint32_t timeout);
+extern "C" int __ulock_wake(uint32_t operation, void* address, uint64_t wakeValue);
+#else
+#include <sched.h> // sched_yield
+#endif
 SC::Mutex::Mutex() { pthread_mutex_init(&mutex.reinterpret_as<pthread_mutex_t>(), 0); }
 SC::Mutex::~Mutex() { pthread_mutex_destroy(&mutex.reinterpret_as<pthread_mutex_t>()); }
 void SC::Mutex::lock() { pthread_mutex_lock(&mutex.reinterpret_as<pthread_mutex_t>()); }
@@ -19,6 +29,36 @@ void SC::ConditionVariable::wait(Mutex& mutex)
 void SC::ConditionVariable::signal() { pthread_cond_signal(&condition.reinterpret_as<pthread_cond_t>()); }
 void SC::ConditionVariable::broadcast() { pthread_cond_broadcast(&condition.reinterpret_as<pthread_cond_t>()); }
 
+#if SC_PLATFORM_LINUX
+void SC::Futex::wait(uint32_t expected)
+{
+    ::syscall(SYS_futex, &value, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+void SC::Futex::wakeOne() { ::syscall(SYS_futex, &value, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0); }
+void SC::Futex::wakeAll() { ::syscall(SYS_futex, &value, FUTEX_WAKE_PRIVATE, 0x7fffffff, nullptr, nullptr, 0); }
+#elif SC_PLATFORM_APPLE
+// Values of UL_COMPARE_AND_WAIT, ULF_WAKE_ALL and ULF_NO_ERRNO from xnu sys/ulock.h
+static constexpr uint32_t ULockCompareAndWait = 1;
+static constexpr uint32_t ULockWakeAll        = 0x100;
+static constexpr uint32_t ULockNoErrno        = 0x1000000;
+
+void SC::Futex::wait(uint32_t expected)
+{
+    ::__ulock_wait(ULockCompareAndWait | ULockNoErrno, &value, expected, 0);
+}
+void SC::Futex::wakeOne() { ::__ulock_wake(ULockCompareAndWait | ULockNoErrno, &value, 0); }
+void SC::Futex::wakeAll() { ::__ulock_wake(ULockCompareAndWait | ULockWakeAll | ULockNoErrno, &value, 0); }
+#else
+// No wait on address primitive, so waiting just yields (allowed as spurious wake up)
+void SC::Futex::wait(uint32_t expected)
+{
+    if (load(memory_order_relaxed) == expected)
+        ::sched_yield();
+}
+void SC::Futex::wakeOne() {}
+void SC::Futex::wakeAll() {}
+#endif
+
 struct SC::Thread::Internal
 {
     using NativeHandle       = pthread_t;
@@ -4,6 +4,7 @@
 #include <Windows.h>
 
 #include "../Threading.h"
+#pragma comment(lib, "Synchronization.lib") // WaitOnAddress
 
 SC::Mutex::Mutex() { ::InitializeCriticalSection(&mutex.reinterpret_as<CRITICAL_SECTION>()); }
 SC::Mutex::~Mutex() { ::InitializeCriticalSection(&mutex.reinterpret_as<CRITICAL_SECTION>()); }
@@ -23,6 +24,13 @@ void SC::ConditionVariable::wait(Mutex& mutex)
 void SC::ConditionVariable::signal() { ::WakeConditionVariable(&condition.reinterpret_as<CONDITION_VARIABLE>()); }
 void SC::ConditionVariable::broadcast() { ::WakeAllConditionVariable(&condition.reinterpret_as<CONDITION_VARIABLE>()); }
 
+void SC::Futex::wait(uint32_t expected)
+{
+    ::WaitOnAddress(&value, &expected, sizeof(expected), INFINITE);
+}
+void SC::Futex::wakeOne() { ::WakeByAddressSingle(&value); }
+void SC::Futex::wakeAll() { ::WakeByAddressAll(&value); }
+
 struct SC::Thread::Internal
 {
     using NativeHandle       = HANDLE;
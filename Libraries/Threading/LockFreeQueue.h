@@ -0,0 +1,314 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Compiler.h"
+#include "../Foundation/Span.h"
+#include "Atomic.h"
+
+namespace SC
+{
+template <typename T, size_t N>
+struct SPSCQueue;
+template <typename T>
+struct SequencedQueueBase;
+template <typename T, size_t N>
+struct MPSCQueue;
+template <typename T, size_t N>
+struct MPMCQueue;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief Bounded lock-free queue with a single producer thread and a single consumer thread. @n
+/// Items are stored inline in a ring buffer of `N` (power of two) elements, without any allocation.
+/// Producer and consumer positions live in different cache lines (each one caching the last seen position of the
+/// other thread), so that they don't invalidate each other cache lines unless the queue is empty or full.
+/// @tparam T Type of the items (default constructible and move assignable)
+/// @tparam N Capacity of the queue (must be a power of two)
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/LockFreeQueueTest.cpp spscQueueSnippet
+template <typename T, SC::size_t N>
+struct SC::SPSCQueue
+{
+    static_assert(N >= 2 and (N & (N - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+    /// @brief Pushes an item (only from the producer thread)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(const T& item)
+    {
+        T copy = item;
+        return tryPush(move(copy));
+    }
+
+    /// @brief Pushes an item (only from the producer thread)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(T&& item)
+    {
+        const size_t tail = producer.tail.load(memory_order_relaxed);
+        if (tail - producer.cachedHead == N)
+        {
+            producer.cachedHead = consumer.head.load(memory_order_acquire);
+            if (tail - producer.cachedHead == N)
+                return false;
+        }
+        items[tail & (N - 1)] = move(item);
+        producer.tail.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+    /// @brief Pops the oldest item (only from the consumer thread)
+    /// @return `false` if the queue is empty
+    [[nodiscard]] bool tryPop(T& item)
+    {
+        const size_t head = consumer.head.load(memory_order_relaxed);
+        if (head == consumer.cachedTail)
+        {
+            consumer.cachedTail = producer.tail.load(memory_order_acquire);
+            if (head == consumer.cachedTail)
+                return false;
+        }
+        item = move(items[head & (N - 1)]);
+        consumer.head.store(head + 1, memory_order_release);
+        return true;
+    }
+
+    /// @brief Returns the maximum number of items in the queue
+    [[nodiscard]] static constexpr size_t capacity() { return N; }
+
+  private:
+    struct alignas(CacheLineSize) Producer
+    {
+        Atomic<size_t> tail       = 0; // Next position to write
+        size_t         cachedHead = 0; // Last read consumer.head
+    } producer;
+
+    struct alignas(CacheLineSize) Consumer
+    {
+        Atomic<size_t> head       = 0; // Next position to read
+        size_t         cachedTail = 0; // Last read producer.tail
+    } consumer;
+
+    alignas(CacheLineSize) T items[N];
+};
+
+/// @brief Ring of cells shared by SC::MPSCQueue and SC::MPMCQueue, implementing their producers side. @n
+/// Every cell holds a sequence number telling if it can be written or read at a given position, so that producers
+/// only contend with a compare exchange on the enqueue position, living in its own cache line.
+/// @tparam T Type of the items (default constructible and move assignable)
+template <typename T>
+struct SC::SequencedQueueBase
+{
+    /// @brief A slot of the queue (to be provided by the caller of MPSCQueue::create or MPMCQueue::create)
+    struct Cell
+    {
+        Atomic<size_t> sequence; // Position + 1 when the cell can be read, position when it can be written
+        T              item;
+    };
+
+    SequencedQueueBase(const SequencedQueueBase&)            = delete;
+    SequencedQueueBase& operator=(const SequencedQueueBase&) = delete;
+
+    /// @brief Pushes an item (from any thread)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(const T& item)
+    {
+        T copy = item;
+        return tryPush(move(copy));
+    }
+
+    /// @brief Pushes an item (from any thread)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(T&& item)
+    {
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        Cell*  cell;
+        for (;;)
+        {
+            cell                  = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(memory_order_acquire);
+            const ssize_t diff    = static_cast<ssize_t>(sequence - position);
+            if (diff == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // Slot still holds the item pushed one round earlier
+            }
+            else
+            {
+                position = enqueuePosition.load(memory_order_relaxed);
+            }
+        }
+        cell->item = move(item);
+        cell->sequence.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    /// @brief Returns the maximum number of items in the queue
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+
+  protected:
+    SequencedQueueBase() = default;
+
+    [[nodiscard]] bool initialize(Cell* newCells, size_t newCapacity)
+    {
+        if (newCapacity < 2 or (newCapacity & (newCapacity - 1)) != 0)
+            return false;
+        for (size_t idx = 0; idx < newCapacity; ++idx)
+        {
+            newCells[idx].sequence.store(idx, memory_order_relaxed);
+        }
+        cells = newCells;
+        mask  = newCapacity - 1;
+        enqueuePosition.store(0, memory_order_relaxed);
+        return true;
+    }
+
+    Cell*  cells = nullptr; // Only written by create, so it can share its cache line with mask
+    size_t mask  = 0;       // Capacity - 1
+
+    alignas(CacheLineSize) Atomic<size_t> enqueuePosition;
+};
+
+/// @brief Bounded lock-free queue with multiple producer threads and a single consumer thread, using caller provided
+/// cells (see MPSCQueue::create). @n
+/// Same design of SC::MPMCQueue, where the consumer doesn't need a compare exchange to claim items.
+/// @note An item whose slot has been claimed by a producer that is still writing it, holds back consumption of the
+/// following items until the producer finishes writing it.
+/// @tparam T Type of the items (default constructible and move assignable)
+template <typename T>
+struct SC::MPSCQueue<T, 0> : public SequencedQueueBase<T>
+{
+    using typename SequencedQueueBase<T>::Cell;
+
+    MPSCQueue() = default;
+
+    /// @brief Uses the given cells (that must outlive the queue) for items. Must be called before any push or pop.
+    /// @param cells Default constructed cells, in a number that must be a power of two
+    /// @return `false` if the number of cells is not a power of two
+    [[nodiscard]] bool create(Span<Cell> cells)
+    {
+        dequeuePosition = 0;
+        return this->initialize(cells.data(), cells.sizeInElements());
+    }
+
+    /// @brief Pops the oldest item (only from the consumer thread)
+    /// @return `false` if the queue is empty
+    [[nodiscard]] bool tryPop(T& item)
+    {
+        Cell& cell = this->cells[dequeuePosition & this->mask];
+        if (cell.sequence.load(memory_order_acquire) != dequeuePosition + 1)
+        {
+            return false; // Slot has not been written yet
+        }
+        item = move(cell.item);
+        cell.sequence.store(dequeuePosition + this->mask + 1, memory_order_release);
+        dequeuePosition++;
+        return true;
+    }
+
+  private:
+    alignas(CacheLineSize) size_t dequeuePosition = 0; // Owned by the consumer thread
+};
+
+/// @brief Bounded lock-free queue with multiple producer threads and a single consumer thread. @n
+/// Items are stored inline in a ring buffer of `N` (power of two) elements, without any allocation.
+/// Use `N == 0` to choose capacity at runtime, with cells provided by the caller.
+/// @tparam T Type of the items (default constructible and move assignable)
+/// @tparam N Capacity of the queue (must be a power of two, or zero)
+template <typename T, SC::size_t N>
+struct SC::MPSCQueue : public MPSCQueue<T, 0>
+{
+    static_assert(N >= 2 and (N & (N - 1)) == 0, "MPSCQueue capacity must be a power of two");
+
+    MPSCQueue() { (void)MPSCQueue<T, 0>::create(inlineCells); }
+
+  private:
+    using MPSCQueue<T, 0>::create;
+
+    alignas(CacheLineSize) typename MPSCQueue<T, 0>::Cell inlineCells[N];
+};
+
+/// @brief Bounded lock-free queue with multiple producer and consumer threads, using caller provided cells
+/// (see MPMCQueue::create). @n
+/// Consumers contend with a compare exchange on the dequeue position, living in a cache line separate from the
+/// enqueue position of producers.
+/// @tparam T Type of the items (default constructible and move assignable)
+template <typename T>
+struct SC::MPMCQueue<T, 0> : public SequencedQueueBase<T>
+{
+    using typename SequencedQueueBase<T>::Cell;
+
+    MPMCQueue() = default;
+
+    /// @brief Uses the given cells (that must outlive the queue) for items. Must be called before any push or pop.
+    /// @param cells Default constructed cells, in a number that must be a power of two
+    /// @return `false` if the number of cells is not a power of two
+    [[nodiscard]] bool create(Span<Cell> cells)
+    {
+        dequeuePosition.store(0, memory_order_relaxed);
+        return this->initialize(cells.data(), cells.sizeInElements());
+    }
+
+    /// @brief Pops the oldest item (from any thread)
+    /// @return `false` if the queue is empty
+    [[nodiscard]] bool tryPop(T& item)
+    {
+        size_t position = dequeuePosition.load(memory_order_relaxed);
+        Cell*  cell;
+        for (;;)
+        {
+            cell                  = &this->cells[position & this->mask];
+            const size_t sequence = cell->sequence.load(memory_order_acquire);
+            const ssize_t diff    = static_cast<ssize_t>(sequence - (position + 1));
+            if (diff == 0)
+            {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // Slot has not been written yet
+            }
+            else
+            {
+                position = dequeuePosition.load(memory_order_relaxed);
+            }
+        }
+        item = move(cell->item);
+        cell->sequence.store(position + this->mask + 1, memory_order_release);
+        return true;
+    }
+
+  private:
+    alignas(CacheLineSize) Atomic<size_t> dequeuePosition;
+};
+
+/// @brief Bounded lock-free queue with multiple producer and consumer threads. @n
+/// Items are stored inline in a ring buffer of `N` (power of two) elements, without any allocation.
+/// Every slot holds a sequence number telling if it can be written or read at a given position, so that threads
+/// only contend with a compare exchange on the producers (or consumers) position, living in separate cache lines.
+/// Use `N == 0` to choose capacity at runtime, with cells provided by the caller.
+/// @tparam T Type of the items (default constructible and move assignable)
+/// @tparam N Capacity of the queue (must be a power of two, or zero)
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/LockFreeQueueTest.cpp mpmcQueueSnippet
+template <typename T, SC::size_t N>
+struct SC::MPMCQueue : public MPMCQueue<T, 0>
+{
+    static_assert(N >= 2 and (N & (N - 1)) == 0, "MPMCQueue capacity must be a power of two");
+
+    MPMCQueue() { (void)MPMCQueue<T, 0>::create(inlineCells); }
+
+  private:
+    using MPMCQueue<T, 0>::create;
+
+    alignas(CacheLineSize) typename MPMCQueue<T, 0>::Cell inlineCells[N];
+};
+
+//! @}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #include "../Atomic.h"
 #include "../../Testing/Testing.h"
+#include "../Threading.h"
 
 namespace SC
 {
@@ -10,6 +11,8 @@ struct AtomicTest;
 
 struct SC::AtomicTest : public SC::TestCase
 {
+    inline void atomicSnippet();
+
     AtomicTest(SC::TestReport& report) : TestCase(report, "AtomicTest")
     {
         using namespace SC;
@@ -21,6 +24,12 @@ struct SC::AtomicTest : public SC::TestCase
             SC_TEST_EXPECT(test.load());
             test.exchange(false);
             SC_TEST_EXPECT(not test.load());
+
+            bool expected = true;
+            SC_TEST_EXPECT(not test.compare_exchange_strong(expected, true));
+            SC_TEST_EXPECT(not expected);
+            SC_TEST_EXPECT(test.compare_exchange_strong(expected, true, memory_order_acq_rel));
+            SC_TEST_EXPECT(test.load(memory_order_acquire));
         }
         if (test_section("atomic<int32>"))
         {
@@ -29,10 +38,99 @@ struct SC::AtomicTest : public SC::TestCase
             SC_TEST_EXPECT(test.load(memory_order_relaxed) == 10);
             SC_TEST_EXPECT(test.fetch_add(1) == 10);
             SC_TEST_EXPECT(test.load() == 11);
+            SC_TEST_EXPECT(test.fetch_sub(12, memory_order_release) == 11);
+            SC_TEST_EXPECT(test.load(memory_order_acquire) == -1);
+        }
+        if (test_section("atomic<int8>"))
+        {
+            Atomic<int8_t> test;
+
+            SC_TEST_EXPECT(test.load() == 0);
+            test.store(0x0f, memory_order_release);
+            SC_TEST_EXPECT(test.fetch_and(0x3c) == 0x0f);
+            SC_TEST_EXPECT(test.fetch_or(0x40) == 0x0c);
+            SC_TEST_EXPECT(test.fetch_xor(0x04, memory_order_relaxed) == 0x4c);
+            SC_TEST_EXPECT(test.exchange(-1) == 0x48);
+            SC_TEST_EXPECT(test.load() == -1);
+        }
+        if (test_section("atomic<int64/uint64>"))
+        {
+            Atomic<int64_t> test = 1;
+
+            test.store(0x100000000, memory_order_relaxed);
+            SC_TEST_EXPECT(test.fetch_add(0x100000000, memory_order_acq_rel) == 0x100000000);
+            SC_TEST_EXPECT(test.load() == 0x200000000);
+
+            Atomic<uint64_t> bits = 0xffffffff00000000ull;
+
+            uint64_t expected = 0;
+            SC_TEST_EXPECT(not bits.compare_exchange_strong(expected, 1));
+            SC_TEST_EXPECT(expected == 0xffffffff00000000ull);
+            while (not bits.compare_exchange_weak(expected, expected | 0xff, memory_order_relaxed)) {}
+            SC_TEST_EXPECT(bits.fetch_xor(0xffffffffffffffffull) == 0xffffffff000000ffull);
+            SC_TEST_EXPECT(bits.load() == 0x00000000ffffff00ull);
+        }
+        if (test_section("atomic<T*>"))
+        {
+            int values[4] = {1, 2, 3, 4};
+
+            Atomic<int*> test;
+            SC_TEST_EXPECT(test.load() == nullptr);
+            test.store(values);
+            SC_TEST_EXPECT(test.fetch_add(3) == values);
+            SC_TEST_EXPECT(*test.load() == 4);
+            SC_TEST_EXPECT(test.fetch_sub(2, memory_order_relaxed) == values + 3);
+            SC_TEST_EXPECT(test.exchange(nullptr) == values + 1);
+
+            int* expected = nullptr;
+            SC_TEST_EXPECT(test.compare_exchange_strong(expected, values + 2));
+            SC_TEST_EXPECT(*test.load(memory_order_acquire) == 3);
+        }
+        if (test_section("atomic threads"))
+        {
+            atomicSnippet();
         }
     }
 };
 
+void SC::AtomicTest::atomicSnippet()
+{
+    //! [atomicSnippet]
+    static constexpr int NumThreads    = 4;
+    static constexpr int NumIncrements = 10000;
+
+    struct Context
+    {
+        Atomic<int32_t> counter;  // Incremented concurrently by all threads
+        Atomic<bool>    start;    // Released by the main thread
+        int32_t         data = 0; // Published by the main thread through start
+    } context;
+
+    Thread threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                while (not context.start.load(memory_order_acquire)) {}
+                // Reading data is safe after the acquire load observing the release store
+                const int32_t increment = context.data;
+                for (int idx = 0; idx < NumIncrements; ++idx)
+                {
+                    context.counter.fetch_add(increment, memory_order_relaxed);
+                }
+            }));
+    }
+    context.data = 1;
+    context.start.store(true, memory_order_release);
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(context.counter.load() == NumThreads * NumIncrements);
+    //! [atomicSnippet]
+}
+
 namespace SC
 {
 void runAtomicTest(SC::TestReport& report) { AtomicTest test(report); }
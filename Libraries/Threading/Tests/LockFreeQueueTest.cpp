@@ -0,0 +1,240 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../LockFreeQueue.h"
+#include "../../Testing/Testing.h"
+#include "../Threading.h"
+
+namespace SC
+{
+struct LockFreeQueueTest;
+}
+
+struct SC::LockFreeQueueTest : public SC::TestCase
+{
+    inline void spscQueueSnippet();
+    inline void mpmcQueueSnippet();
+
+    LockFreeQueueTest(SC::TestReport& report) : TestCase(report, "LockFreeQueueTest")
+    {
+        if (test_section("SPSCQueue"))
+        {
+            SPSCQueue<int, 4> queue;
+            SC_TEST_EXPECT(queue.capacity() == 4);
+
+            int value = 0;
+            SC_TEST_EXPECT(not queue.tryPop(value));
+            for (int idx = 0; idx < 4; ++idx)
+            {
+                SC_TEST_EXPECT(queue.tryPush(idx));
+            }
+            SC_TEST_EXPECT(not queue.tryPush(4)); // full
+            SC_TEST_EXPECT(queue.tryPop(value) and value == 0);
+            SC_TEST_EXPECT(queue.tryPush(4)); // wraps around
+            for (int idx = 1; idx < 5; ++idx)
+            {
+                SC_TEST_EXPECT(queue.tryPop(value) and value == idx);
+            }
+            SC_TEST_EXPECT(not queue.tryPop(value));
+        }
+        if (test_section("SPSCQueue threads"))
+        {
+            spscQueueSnippet();
+        }
+        if (test_section("MPSCQueue"))
+        {
+            MPSCQueue<int, 4> queue;
+            SC_TEST_EXPECT(queue.capacity() == 4);
+
+            int value = 0;
+            SC_TEST_EXPECT(not queue.tryPop(value));
+            for (int round = 0; round < 3; ++round)
+            {
+                for (int idx = 0; idx < 4; ++idx)
+                {
+                    SC_TEST_EXPECT(queue.tryPush(round * 4 + idx));
+                }
+                SC_TEST_EXPECT(not queue.tryPush(-1)); // full
+                for (int idx = 0; idx < 4; ++idx)
+                {
+                    SC_TEST_EXPECT(queue.tryPop(value) and value == round * 4 + idx);
+                }
+                SC_TEST_EXPECT(not queue.tryPop(value));
+            }
+        }
+        if (test_section("MPMCQueue"))
+        {
+            MPMCQueue<int, 4> queue;
+            SC_TEST_EXPECT(queue.capacity() == 4);
+
+            int value = 0;
+            SC_TEST_EXPECT(not queue.tryPop(value));
+            for (int round = 0; round < 3; ++round)
+            {
+                for (int idx = 0; idx < 4; ++idx)
+                {
+                    SC_TEST_EXPECT(queue.tryPush(round * 4 + idx));
+                }
+                SC_TEST_EXPECT(not queue.tryPush(-1)); // full
+                for (int idx = 0; idx < 4; ++idx)
+                {
+                    SC_TEST_EXPECT(queue.tryPop(value) and value == round * 4 + idx);
+                }
+                SC_TEST_EXPECT(not queue.tryPop(value));
+            }
+        }
+        if (test_section("runtime capacity"))
+        {
+            // Zero capacity queues use cells provided by the caller, in a number chosen at runtime
+            MPSCQueue<int, 0>::Cell mpscCells[8];
+            MPSCQueue<int, 0>       mpscQueue;
+            SC_TEST_EXPECT(not mpscQueue.create({mpscCells, 3})); // not a power of two
+            SC_TEST_EXPECT(mpscQueue.create(mpscCells));
+            SC_TEST_EXPECT(mpscQueue.capacity() == 8);
+            MPMCQueue<int, 0>::Cell mpmcCells[2];
+            MPMCQueue<int, 0>       mpmcQueue;
+            SC_TEST_EXPECT(mpmcQueue.create(mpmcCells));
+            SC_TEST_EXPECT(mpmcQueue.capacity() == 2);
+
+            int value = 0;
+            for (int round = 0; round < 3; ++round)
+            {
+                for (int idx = 0; idx < 8; ++idx)
+                {
+                    SC_TEST_EXPECT(mpscQueue.tryPush(round * 8 + idx));
+                }
+                SC_TEST_EXPECT(not mpscQueue.tryPush(-1)); // full
+                SC_TEST_EXPECT(mpmcQueue.tryPush(round) and mpmcQueue.tryPush(round + 1));
+                SC_TEST_EXPECT(not mpmcQueue.tryPush(-1)); // full
+                for (int idx = 0; idx < 8; ++idx)
+                {
+                    SC_TEST_EXPECT(mpscQueue.tryPop(value) and value == round * 8 + idx);
+                }
+                SC_TEST_EXPECT(mpmcQueue.tryPop(value) and value == round);
+                SC_TEST_EXPECT(mpmcQueue.tryPop(value) and value == round + 1);
+                SC_TEST_EXPECT(not mpscQueue.tryPop(value));
+                SC_TEST_EXPECT(not mpmcQueue.tryPop(value));
+            }
+        }
+        if (test_section("MPMCQueue threads"))
+        {
+            mpmcQueueSnippet();
+        }
+    }
+};
+
+void SC::LockFreeQueueTest::spscQueueSnippet()
+{
+    //! [spscQueueSnippet]
+    static constexpr uint32_t NumItems = 100000;
+
+    struct Context
+    {
+        SPSCQueue<uint32_t, 64> queue;
+        uint64_t                sum   = 0;
+        bool                    order = true;
+    } context;
+
+    // Consumer thread pops items in the same order they have been pushed
+    Thread consumer;
+    SC_TEST_EXPECT(consumer.start(
+        [&context](Thread&)
+        {
+            uint32_t expected = 0;
+            while (expected < NumItems)
+            {
+                uint32_t item;
+                if (context.queue.tryPop(item))
+                {
+                    context.order = context.order and item == expected;
+                    context.sum += item;
+                    expected++;
+                }
+                else
+                {
+                    Thread::Sleep(0);
+                }
+            }
+        }));
+
+    // Producer (this thread) retries when the queue is full
+    for (uint32_t idx = 0; idx < NumItems; ++idx)
+    {
+        while (not context.queue.tryPush(idx))
+        {
+            Thread::Sleep(0);
+        }
+    }
+    SC_TEST_EXPECT(consumer.join());
+    SC_TEST_EXPECT(context.order);
+    SC_TEST_EXPECT(context.sum == uint64_t(NumItems) * (NumItems - 1) / 2);
+    //! [spscQueueSnippet]
+}
+
+void SC::LockFreeQueueTest::mpmcQueueSnippet()
+{
+    //! [mpmcQueueSnippet]
+    static constexpr uint32_t NumProducers = 3;
+    static constexpr uint32_t NumConsumers = 3;
+    static constexpr uint32_t NumItems     = 30000; // For each producer
+
+    struct Context
+    {
+        MPMCQueue<uint32_t, 128> queue;
+        Atomic<uint32_t>         numPopped;
+        Atomic<uint64_t>         sum;
+    } context;
+
+    Thread producers[NumProducers];
+    Thread consumers[NumConsumers];
+    for (uint32_t idx = 0; idx < NumProducers; ++idx)
+    {
+        SC_TEST_EXPECT(producers[idx].start(
+            [&context](Thread&)
+            {
+                for (uint32_t item = 1; item <= NumItems; ++item)
+                {
+                    while (not context.queue.tryPush(item))
+                    {
+                        Thread::Sleep(0);
+                    }
+                }
+            }));
+    }
+    for (Thread& thread : consumers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                while (context.numPopped.load(memory_order_relaxed) < NumProducers * NumItems)
+                {
+                    uint32_t item;
+                    if (context.queue.tryPop(item))
+                    {
+                        context.sum.fetch_add(item, memory_order_relaxed);
+                        context.numPopped.fetch_add(1, memory_order_relaxed);
+                    }
+                    else
+                    {
+                        Thread::Sleep(0);
+                    }
+                }
+            }));
+    }
+    for (Thread& thread : producers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    for (Thread& thread : consumers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    // Every item pushed by every producer has been popped exactly once
+    SC_TEST_EXPECT(context.numPopped.load() == NumProducers * NumItems);
+    SC_TEST_EXPECT(context.sum.load() == uint64_t(NumProducers) * NumItems * (NumItems + 1) / 2);
+    //! [mpmcQueueSnippet]
+}
+
+namespace SC
+{
+void runLockFreeQueueTest(SC::TestReport& report) { LockFreeQueueTest test(report); }
+} // namespace SC
@@ -0,0 +1,243 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../../Testing/Testing.h"
+#include "../../Time/Time.h"
+#include "../ThreadPool.h"
+
+namespace SC
+{
+struct ThreadPoolBenchmarkTest;
+}
+
+struct SC::ThreadPoolBenchmarkTest : public SC::TestCase
+{
+    static constexpr size_t NumWorkers  = 4;
+    static constexpr size_t NumBatches  = 40;
+    static constexpr size_t BatchSize   = 512;
+    static constexpr size_t NumChildren = BatchSize / NumWorkers;
+
+    // Thread pool with a single FIFO protected by a mutex (the design preceding the work-stealing ThreadPool)
+    struct MutexThreadPool
+    {
+        struct Task
+        {
+            Function<void()> function;
+            Task*            next = nullptr;
+        };
+
+        [[nodiscard]] Result create(size_t workerThreads)
+        {
+            for (size_t idx = 0; idx < workerThreads; ++idx)
+            {
+                SC_TRY(threads[idx].start([this](Thread&) { run(); }));
+            }
+            numThreads = workerThreads;
+            return Result(true);
+        }
+
+        [[nodiscard]] Result destroy()
+        {
+            mutex.lock();
+            stopRequested = true;
+            taskAvailable.broadcast();
+            mutex.unlock();
+            for (size_t idx = 0; idx < numThreads; ++idx)
+            {
+                SC_TRY(threads[idx].join());
+            }
+            return Result(true);
+        }
+
+        [[nodiscard]] Result queueTask(Task& task)
+        {
+            mutex.lock();
+            task.next = nullptr;
+            if (taskHead == nullptr)
+                taskHead = &task;
+            else
+                taskTail->next = &task;
+            taskTail = &task;
+            taskAvailable.broadcast();
+            mutex.unlock();
+            return Result(true);
+        }
+
+        [[nodiscard]] Result waitForAllTasks()
+        {
+            mutex.lock();
+            while (taskHead != nullptr or numRunningTasks != 0)
+            {
+                taskCompleted.wait(mutex);
+            }
+            mutex.unlock();
+            return Result(true);
+        }
+
+      private:
+        Thread threads[NumWorkers];
+        size_t numThreads = 0;
+
+        Task*  taskHead        = nullptr;
+        Task*  taskTail        = nullptr;
+        size_t numRunningTasks = 0;
+        bool   stopRequested   = false;
+
+        Mutex             mutex;
+        ConditionVariable taskAvailable;
+        ConditionVariable taskCompleted;
+
+        void run()
+        {
+            mutex.lock();
+            for (;;)
+            {
+                while (not stopRequested and taskHead == nullptr)
+                {
+                    taskAvailable.wait(mutex);
+                }
+                if (stopRequested)
+                    break;
+                Task* task = taskHead;
+                taskHead   = task->next;
+                numRunningTasks++;
+                mutex.unlock();
+                task->function();
+                mutex.lock();
+                numRunningTasks--;
+                taskCompleted.signal();
+            }
+            mutex.unlock();
+        }
+    };
+
+    ThreadPoolBenchmarkTest(SC::TestReport& report) : TestCase(report, "ThreadPoolBenchmarkTest")
+    {
+        if (test_section("queue throughput"))
+        {
+            ThreadPool threadPool;
+            SC_TEST_EXPECT(threadPool.create(NumWorkers));
+            const int64_t workStealingMs = benchmarkQueue(threadPool);
+            SC_TEST_EXPECT(threadPool.destroy());
+
+            MutexThreadPool mutexPool;
+            SC_TEST_EXPECT(mutexPool.create(NumWorkers));
+            const int64_t mutexMs = benchmarkQueue(mutexPool);
+            SC_TEST_EXPECT(mutexPool.destroy());
+            report.console.print("ThreadPool queue {} tasks: work-stealing = {} ms, mutex = {} ms\n",
+                                 static_cast<int64_t>(NumBatches * BatchSize), workStealingMs, mutexMs);
+        }
+        if (test_section("nested throughput"))
+        {
+            ThreadPool threadPool;
+            SC_TEST_EXPECT(threadPool.create(NumWorkers));
+            const int64_t workStealingMs = benchmarkNested(threadPool);
+            SC_TEST_EXPECT(threadPool.destroy());
+
+            MutexThreadPool mutexPool;
+            SC_TEST_EXPECT(mutexPool.create(NumWorkers));
+            const int64_t mutexMs = benchmarkNested(mutexPool);
+            SC_TEST_EXPECT(mutexPool.destroy());
+            report.console.print("ThreadPool nested {} tasks: work-stealing = {} ms, mutex = {} ms\n",
+                                 static_cast<int64_t>(NumBatches * BatchSize), workStealingMs, mutexMs);
+        }
+    }
+
+    // Small amount of work, so that scheduling overhead dominates
+    static void work(uint32_t& value)
+    {
+        for (int idx = 0; idx < 64; ++idx)
+        {
+            value = value * 1664525u + 1013904223u;
+        }
+    }
+
+    // Tasks queued from the main thread, waiting for all of them after every batch
+    template <typename Pool>
+    int64_t benchmarkQueue(Pool& pool)
+    {
+        typename Pool::Task tasks[BatchSize];
+        uint32_t            values[BatchSize] = {0};
+        for (size_t idx = 0; idx < BatchSize; ++idx)
+        {
+            uint32_t* value     = &values[idx];
+            tasks[idx].function = [value]() { work(*value); };
+        }
+
+        bool queuedAll = true;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        for (size_t batch = 0; batch < NumBatches; ++batch)
+        {
+            for (typename Pool::Task& task : tasks)
+            {
+                queuedAll = queuedAll and pool.queueTask(task);
+            }
+            SC_TEST_EXPECT(pool.waitForAllTasks());
+        }
+        Time::HighResolutionCounter end;
+        end.snap();
+        SC_TEST_EXPECT(queuedAll);
+        return end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+    }
+
+    // Tasks queued by other tasks, running on worker threads
+    template <typename Pool>
+    int64_t benchmarkNested(Pool& pool)
+    {
+        typename Pool::Task parents[NumWorkers];
+        typename Pool::Task children[NumWorkers][NumChildren];
+        uint32_t            values[NumWorkers][NumChildren] = {{0}};
+
+        struct Context
+        {
+            Pool*                pool      = nullptr;
+            typename Pool::Task* children  = nullptr;
+            bool                 queuedAll = true;
+        } contexts[NumWorkers];
+        for (size_t idx = 0; idx < NumWorkers; ++idx)
+        {
+            Context& context      = contexts[idx];
+            context.pool          = &pool;
+            context.children      = children[idx];
+            parents[idx].function = [&context]()
+            {
+                for (size_t child = 0; child < NumChildren; ++child)
+                {
+                    context.queuedAll = context.queuedAll and context.pool->queueTask(context.children[child]);
+                }
+            };
+            for (size_t child = 0; child < NumChildren; ++child)
+            {
+                uint32_t* value               = &values[idx][child];
+                children[idx][child].function = [value]() { work(*value); };
+            }
+        }
+
+        bool queuedAll = true;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        for (size_t batch = 0; batch < NumBatches; ++batch)
+        {
+            for (typename Pool::Task& task : parents)
+            {
+                queuedAll = queuedAll and pool.queueTask(task);
+            }
+            SC_TEST_EXPECT(pool.waitForAllTasks());
+        }
+        Time::HighResolutionCounter end;
+        end.snap();
+        for (const Context& context : contexts)
+        {
+            queuedAll = queuedAll and context.queuedAll;
+        }
+        SC_TEST_EXPECT(queuedAll);
+        return end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+    }
+};
+
+namespace SC
+{
+void runThreadPoolBenchmarkTest(SC::TestReport& report) { ThreadPoolBenchmarkTest test(report); }
+} // namespace SC
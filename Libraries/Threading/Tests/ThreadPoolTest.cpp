@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #include "../ThreadPool.h"
 #include "../../Testing/Testing.h"
+#include "../Atomic.h"
 
 namespace SC
 {
@@ -12,6 +13,11 @@ struct SC::ThreadPoolTest : public SC::TestCase
 {
     inline void testThreadPool();
     inline void testThreadPoolErrors();
+    inline void testThreadPoolNestedTasks();
+    inline void testThreadPoolOverflow();
+    inline void testTaskGroup();
+    inline void testParallelFor();
+    inline void testParallelReduce();
 
     ThreadPoolTest(SC::TestReport& report) : TestCase(report, "ThreadPoolTest")
     {
@@ -24,6 +30,31 @@ struct SC::ThreadPoolTest : public SC::TestCase
         {
             testThreadPoolErrors();
         }
+
+        if (test_section("ThreadPool nested tasks"))
+        {
+            testThreadPoolNestedTasks();
+        }
+
+        if (test_section("ThreadPool overflow"))
+        {
+            testThreadPoolOverflow();
+        }
+
+        if (test_section("TaskGroup"))
+        {
+            testTaskGroup();
+        }
+
+        if (test_section("parallelFor"))
+        {
+            testParallelFor();
+        }
+
+        if (test_section("parallelReduce"))
+        {
+            testParallelReduce();
+        }
     }
 };
 
@@ -106,6 +137,266 @@ void SC::ThreadPoolTest::testThreadPoolErrors()
     SC_TEST_EXPECT(not threadPool.queueTask(tasks[1]));
 }
 
+void SC::ThreadPoolTest::testThreadPoolNestedTasks()
+{
+    // Tasks queued from a worker thread go to its own deque (and to the injection queue when it's full), and they
+    // get stolen by other workers
+    static const size_t numTasks = ThreadPool::WorkerQueueCapacity * 4;
+
+    SC::ThreadPool::Task tasks[numTasks];
+    SC::ThreadPool::Task rootTask;
+
+    SC::ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    struct Context
+    {
+        SC::ThreadPool&       threadPool;
+        SC::ThreadPool::Task* tasks;
+        Atomic<int32_t>       numExecuted;
+        Atomic<int32_t>       numQueued;
+    } context = {threadPool, tasks, 0, 0};
+
+    for (size_t idx = 0; idx < numTasks; idx++)
+    {
+        tasks[idx].function = [&context]() { context.numExecuted.fetch_add(1); };
+    }
+    rootTask.function = [&context]()
+    {
+        for (size_t idx = 0; idx < numTasks; idx++)
+        {
+            if (context.threadPool.queueTask(context.tasks[idx]))
+            {
+                context.numQueued.fetch_add(1);
+            }
+        }
+    };
+    SC_TEST_EXPECT(threadPool.queueTask(rootTask));
+    SC_TEST_EXPECT(threadPool.waitForTask(rootTask));
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(context.numQueued.load() == static_cast<int32_t>(numTasks));
+    SC_TEST_EXPECT(context.numExecuted.load() == static_cast<int32_t>(numTasks));
+
+    // All tasks have been freed and can be queued again
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[0]));
+    SC_TEST_EXPECT(threadPool.waitForTask(tasks[0]));
+    SC_TEST_EXPECT(context.numExecuted.load() == static_cast<int32_t>(numTasks + 1));
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::ThreadPoolTest::testThreadPoolOverflow()
+{
+    // Tasks not fitting the injection queue are kept in an overflow list
+    static const size_t numTasks = ThreadPool::InjectionQueueCapacity * 2;
+
+    SC::ThreadPool::Task tasks[numTasks];
+    Atomic<int32_t>      numExecuted = 0;
+
+    SC::ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(2));
+
+    Atomic<bool> blocked = true;
+    tasks[0].function    = [&blocked]()
+    {
+        while (blocked.load())
+        {
+            SC::Thread::Sleep(1);
+        }
+    };
+    tasks[1].function = tasks[0].function;
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[0]));
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[1]));
+    bool allQueued = true;
+    for (size_t idx = 2; idx < numTasks; idx++)
+    {
+        tasks[idx].function = [&numExecuted]() { numExecuted.fetch_add(1); };
+        allQueued           = allQueued and threadPool.queueTask(tasks[idx]);
+    }
+    SC_TEST_EXPECT(allQueued);
+    blocked.exchange(false);
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(numExecuted.load() == static_cast<int32_t>(numTasks - 2));
+
+    // Tasks still queued when destroying the pool are not executed, but they're freed
+    blocked.exchange(true);
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[0]));
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[1]));
+    for (size_t idx = 2; idx < numTasks; idx++)
+    {
+        allQueued = allQueued and threadPool.queueTask(tasks[idx]);
+    }
+    SC_TEST_EXPECT(allQueued);
+    SC::Thread thread;
+    SC_TEST_EXPECT(thread.start(
+        [&blocked](SC::Thread&)
+        {
+            SC::Thread::Sleep(50);
+            blocked.exchange(false);
+        }));
+    SC_TEST_EXPECT(threadPool.destroy());
+    SC_TEST_EXPECT(thread.join());
+    SC_TEST_EXPECT(numExecuted.load() == static_cast<int32_t>(numTasks - 2));
+    SC::ThreadPool threadPool2;
+    SC_TEST_EXPECT(threadPool2.create(1));
+    SC_TEST_EXPECT(threadPool2.queueTask(tasks[numTasks - 1]));
+    SC_TEST_EXPECT(threadPool2.waitForAllTasks());
+    SC_TEST_EXPECT(numExecuted.load() == static_cast<int32_t>(numTasks - 1));
+}
+
+void SC::ThreadPoolTest::testTaskGroup()
+{
+    //! [taskGroupSnippet]
+    static const size_t numParents  = 4;
+    static const size_t numChildren = 16;
+
+    SC::ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    struct Parent
+    {
+        SC::ThreadPool&      threadPool;
+        SC::ThreadPool::Task task;
+        SC::ThreadPool::Task children[numChildren];
+        size_t               values[numChildren];
+        bool                 spawnedAll;
+    };
+    Parent parents[numParents] = {{threadPool}, {threadPool}, {threadPool}, {threadPool}};
+
+    SC::TaskGroup group(threadPool);
+    for (Parent& parent : parents)
+    {
+        // 1. Every parent task spawns its children in a nested group and waits for them
+        parent.task.function = [&parent]()
+        {
+            SC::TaskGroup nested(parent.threadPool);
+            parent.spawnedAll = true;
+            for (size_t idx = 0; idx < numChildren; ++idx)
+            {
+                size_t* value                 = &parent.values[idx];
+                parent.children[idx].function = [value, idx]() { *value = idx * 10; };
+                parent.spawnedAll             = parent.spawnedAll and nested.spawn(parent.children[idx]);
+            }
+            parent.spawnedAll = parent.spawnedAll and nested.wait();
+        };
+        SC_TEST_EXPECT(group.spawn(parent.task));
+    }
+    // 2. Wait for all parents (and so for all of their children)
+    SC_TEST_EXPECT(group.wait());
+
+    bool allGood = true;
+    for (const Parent& parent : parents)
+    {
+        allGood = allGood and parent.spawnedAll;
+        for (size_t idx = 0; idx < numChildren; ++idx)
+        {
+            allGood = allGood and parent.values[idx] == idx * 10;
+        }
+    }
+    SC_TEST_EXPECT(allGood);
+    //! [taskGroupSnippet]
+
+    // Spawning a task that is already in use fails
+    SC::ThreadPool::Task task;
+    task.function = []() { SC::Thread::Sleep(20); };
+    SC_TEST_EXPECT(group.spawn(task));
+    SC_TEST_EXPECT(not group.spawn(task));
+    SC_TEST_EXPECT(group.wait());
+}
+
+void SC::ThreadPoolTest::testParallelFor()
+{
+    //! [parallelForSnippet]
+    static const size_t numValues = 10000;
+
+    SC::ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    uint32_t values[numValues] = {0};
+    // Every index is visited exactly once, in chunks of at least 64 indices
+    SC_TEST_EXPECT(threadPool.parallelFor(0, numValues, 64,
+                                          [&values](size_t chunkBegin, size_t chunkEnd)
+                                          {
+                                              for (size_t idx = chunkBegin; idx < chunkEnd; ++idx)
+                                              {
+                                                  values[idx] += static_cast<uint32_t>(idx * 2);
+                                              }
+                                          }));
+    //! [parallelForSnippet]
+    bool allGood = true;
+    for (size_t idx = 0; idx < numValues; ++idx)
+    {
+        allGood = allGood and values[idx] == idx * 2;
+    }
+    SC_TEST_EXPECT(allGood);
+
+    // Nested parallelFor, called from worker threads
+    static const size_t numRows = 8;
+    static const size_t numCols = numValues / numRows;
+    SC_TEST_EXPECT(threadPool.parallelFor(0, numRows, 1,
+                                          [&](size_t rowBegin, size_t rowEnd)
+                                          {
+                                              for (size_t row = rowBegin; row < rowEnd; ++row)
+                                              {
+                                                  uint32_t* rowValues = values + row * numCols;
+                                                  allGood             = threadPool.parallelFor(
+                                                      0, numCols, 0,
+                                                      [rowValues](size_t colBegin, size_t colEnd)
+                                                      {
+                                                          for (size_t col = colBegin; col < colEnd; ++col)
+                                                          {
+                                                              rowValues[col] += 1;
+                                                          }
+                                                      }) and
+                                                      allGood;
+                                              }
+                                          }));
+    for (size_t idx = 0; idx < numValues; ++idx)
+    {
+        allGood = allGood and values[idx] == idx * 2 + 1;
+    }
+    SC_TEST_EXPECT(allGood);
+
+    // Empty ranges and grains larger than the range
+    size_t numCalls = 0;
+    SC_TEST_EXPECT(threadPool.parallelFor(10, 10, 0, [&numCalls](size_t, size_t) { numCalls++; }));
+    SC_TEST_EXPECT(numCalls == 0);
+    SC_TEST_EXPECT(threadPool.parallelFor(0, 10, 100,
+                                          [&numCalls](size_t chunkBegin, size_t chunkEnd)
+                                          { numCalls += chunkBegin == 0 and chunkEnd == 10 ? 1 : 100; }));
+    SC_TEST_EXPECT(numCalls == 1);
+    SC_TEST_EXPECT(not threadPool.parallelFor(10, 0, 0, [](size_t, size_t) {}));
+}
+
+void SC::ThreadPoolTest::testParallelReduce()
+{
+    //! [parallelReduceSnippet]
+    static const size_t numValues = 100000;
+
+    SC::ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    // Sum of all indices, accumulated in one partial sum for each participating thread
+    uint64_t sum = 0;
+    SC_TEST_EXPECT(threadPool.parallelReduce(
+        0, numValues, 0, uint64_t(0), sum,
+        [](size_t chunkBegin, size_t chunkEnd, uint64_t& partial)
+        {
+            for (size_t idx = chunkBegin; idx < chunkEnd; ++idx)
+            {
+                partial += idx;
+            }
+        },
+        [](uint64_t& result, const uint64_t& partial) { result += partial; }));
+    SC_TEST_EXPECT(sum == uint64_t(numValues) * (numValues - 1) / 2);
+    //! [parallelReduceSnippet]
+
+    // Empty range gives identity
+    SC_TEST_EXPECT(threadPool.parallelReduce(
+        0, 0, 0, uint64_t(0), sum, [](size_t, size_t, uint64_t& partial) { partial = 42; },
+        [](uint64_t& result, const uint64_t& partial) { result += partial; }));
+    SC_TEST_EXPECT(sum == 0);
+}
+
 namespace SC
 {
 void runThreadPoolTest(SC::TestReport& report) { ThreadPoolTest test(report); }
@@ -0,0 +1,181 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../../Testing/Testing.h"
+#include "../../Time/Time.h"
+#include "../Threading.h"
+
+namespace SC
+{
+struct ThreadingBenchmarkTest;
+}
+
+struct SC::ThreadingBenchmarkTest : public SC::TestCase
+{
+    static constexpr int NumThreads    = 4;
+    static constexpr int NumIterations = 50000; // For each thread
+    static constexpr int WriteEvery    = 20;    // One write every WriteEvery reads in read mostly benchmark
+
+    // Adapts SC::Mutex to the shared locking interface used by the read mostly benchmark
+    struct SharedMutex
+    {
+        Mutex mutex;
+
+        void lock() { mutex.lock(); }
+        void unlock() { mutex.unlock(); }
+        void lockShared() { mutex.lock(); }
+        void unlockShared() { mutex.unlock(); }
+    };
+
+    ThreadingBenchmarkTest(SC::TestReport& report) : TestCase(report, "ThreadingBenchmarkTest")
+    {
+        if (test_section("lock contention"))
+        {
+            const int64_t mutexMs      = benchmarkContention<Mutex>();
+            const int64_t futexMutexMs = benchmarkContention<FutexMutex>();
+            const int64_t spinLockMs   = benchmarkContention<SpinLock>();
+            report.console.print("Lock contention {} threads x {} increments: Mutex = {} ms, FutexMutex = {} ms, "
+                                 "SpinLock = {} ms\n",
+                                 static_cast<int>(NumThreads), static_cast<int>(NumIterations), mutexMs,
+                                 futexMutexMs, spinLockMs);
+        }
+        if (test_section("read mostly"))
+        {
+            const int64_t mutexMs  = benchmarkReadMostly<SharedMutex>();
+            const int64_t rwLockMs = benchmarkReadMostly<RWLock>();
+            report.console.print("Read mostly {} threads x {} lookups: Mutex = {} ms, RWLock = {} ms\n",
+                                 static_cast<int>(NumThreads), static_cast<int>(NumIterations), mutexMs, rwLockMs);
+        }
+        if (test_section("barrier phases"))
+        {
+            const int64_t barrierMs = benchmarkBarrier();
+            report.console.print("Barrier {} threads x {} phases: {} ms\n", static_cast<int>(NumThreads),
+                                 static_cast<int>(NumIterations / 10), barrierMs);
+        }
+    }
+
+    // Many threads incrementing a counter inside a very short critical section
+    template <typename Lock>
+    int64_t benchmarkContention()
+    {
+        struct Context
+        {
+            Lock    lock;
+            int64_t counter = 0;
+        } context;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        Thread threads[NumThreads];
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.start(
+                [&context](Thread&)
+                {
+                    for (int idx = 0; idx < NumIterations; ++idx)
+                    {
+                        context.lock.lock();
+                        context.counter++;
+                        context.lock.unlock();
+                    }
+                }));
+        }
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.join());
+        }
+        Time::HighResolutionCounter end;
+        end.snap();
+        SC_TEST_EXPECT(context.counter == int64_t(NumThreads) * NumIterations);
+        return end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+    }
+
+    // Lookups in a small table shared by all threads, with occasional updates
+    template <typename Lock>
+    int64_t benchmarkReadMostly()
+    {
+        static constexpr int TableSize = 64;
+        struct Context
+        {
+            Lock    lock;
+            int64_t table[TableSize] = {0};
+            int64_t numWrites        = 0;
+        } context;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        Thread threads[NumThreads];
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.start(
+                [&context](Thread&)
+                {
+                    int64_t sum = 0;
+                    for (int idx = 0; idx < NumIterations; ++idx)
+                    {
+                        if (idx % WriteEvery == 0)
+                        {
+                            context.lock.lock();
+                            context.table[idx % TableSize]++;
+                            context.numWrites++;
+                            context.lock.unlock();
+                        }
+                        else
+                        {
+                            context.lock.lockShared();
+                            sum += context.table[idx % TableSize];
+                            context.lock.unlockShared();
+                        }
+                    }
+                    (void)sum;
+                }));
+        }
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.join());
+        }
+        Time::HighResolutionCounter end;
+        end.snap();
+        SC_TEST_EXPECT(context.numWrites == int64_t(NumThreads) * (NumIterations / WriteEvery));
+        return end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+    }
+
+    // Threads synchronizing on a barrier at every phase, measuring the cost of blocking and waking up
+    int64_t benchmarkBarrier()
+    {
+        static constexpr int NumPhases = NumIterations / 10;
+        struct Context
+        {
+            Barrier     barrier{NumThreads};
+            Atomic<int> numLastArrived;
+        } context;
+
+        Time::HighResolutionCounter start;
+        start.snap();
+        Thread threads[NumThreads];
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.start(
+                [&context](Thread&)
+                {
+                    for (int phase = 0; phase < NumPhases; ++phase)
+                    {
+                        if (context.barrier.arriveAndWait())
+                            context.numLastArrived.fetch_add(1, memory_order_relaxed);
+                    }
+                }));
+        }
+        for (Thread& thread : threads)
+        {
+            SC_TEST_EXPECT(thread.join());
+        }
+        Time::HighResolutionCounter end;
+        end.snap();
+        SC_TEST_EXPECT(context.numLastArrived.load() == NumPhases);
+        return end.subtractApproximate(start).inRoundedUpperMilliseconds().ms;
+    }
+};
+
+namespace SC
+{
+void runThreadingBenchmarkTest(SC::TestReport& report) { ThreadingBenchmarkTest test(report); }
+} // namespace SC
@@ -13,6 +13,12 @@ struct SC::ThreadingTest : public SC::TestCase
     inline void testThread();
     inline void testEventObject();
     inline void testMutex();
+    inline void testSpinLock();
+    inline void testFutexMutex();
+    inline void testRWLock();
+    inline void testSemaphore();
+    inline void testLatch();
+    inline void testBarrier();
 
     ThreadingTest(SC::TestReport& report) : TestCase(report, "ThreadingTest")
     {
@@ -28,6 +34,30 @@ struct SC::ThreadingTest : public SC::TestCase
         {
             testMutex();
         }
+        if (test_section("SpinLock"))
+        {
+            testSpinLock();
+        }
+        if (test_section("FutexMutex"))
+        {
+            testFutexMutex();
+        }
+        if (test_section("RWLock"))
+        {
+            testRWLock();
+        }
+        if (test_section("Semaphore"))
+        {
+            testSemaphore();
+        }
+        if (test_section("Latch"))
+        {
+            testLatch();
+        }
+        if (test_section("Barrier"))
+        {
+            testBarrier();
+        }
     }
 };
 
@@ -109,6 +139,316 @@ void SC::ThreadingTest::testMutex()
     //! [mutexSnippet]
 }
 
+void SC::ThreadingTest::testSpinLock()
+{
+    //! [spinLockSnippet]
+    static constexpr int NumThreads    = 4;
+    static constexpr int NumIncrements = 10000;
+
+    SpinLock lock;
+    int      counter = 0;
+    Thread   threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&](Thread&)
+            {
+                for (int idx = 0; idx < NumIncrements; ++idx)
+                {
+                    lock.lock();
+                    counter++; // Very short critical section
+                    lock.unlock();
+                }
+            }));
+    }
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(counter == NumThreads * NumIncrements);
+    //! [spinLockSnippet]
+    SC_TEST_EXPECT(lock.tryLock());
+    SC_TEST_EXPECT(not lock.tryLock());
+    lock.unlock();
+}
+
+void SC::ThreadingTest::testFutexMutex()
+{
+    static constexpr int NumThreads = 4;
+    static constexpr int NumItems   = 2000; // For each producer
+
+    // Producers and consumers exchanging items through a single slot
+    struct Context
+    {
+        FutexMutex             mutex;
+        FutexConditionVariable slotEmpty;
+        FutexConditionVariable slotFull;
+
+        bool     full     = false;
+        int      slot     = 0;
+        uint64_t consumed = 0;
+    } context;
+
+    SC_TEST_EXPECT(context.mutex.tryLock());
+    SC_TEST_EXPECT(not context.mutex.tryLock());
+    context.mutex.unlock();
+
+    Thread producers[NumThreads / 2];
+    Thread consumers[NumThreads / 2];
+    for (Thread& thread : producers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                for (int idx = 1; idx <= NumItems; ++idx)
+                {
+                    context.mutex.lock();
+                    while (context.full)
+                        context.slotEmpty.wait(context.mutex);
+                    context.slot = idx;
+                    context.full = true;
+                    context.mutex.unlock();
+                    context.slotFull.signal();
+                }
+            }));
+    }
+    for (Thread& thread : consumers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                for (int idx = 0; idx < NumItems; ++idx)
+                {
+                    context.mutex.lock();
+                    while (not context.full)
+                        context.slotFull.wait(context.mutex);
+                    context.consumed += static_cast<uint64_t>(context.slot);
+                    context.full = false;
+                    context.mutex.unlock();
+                    context.slotEmpty.signal();
+                }
+            }));
+    }
+    for (Thread& thread : producers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    for (Thread& thread : consumers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(context.consumed == uint64_t(NumThreads / 2) * NumItems * (NumItems + 1) / 2);
+}
+
+void SC::ThreadingTest::testRWLock()
+{
+    //! [rwLockSnippet]
+    static constexpr int NumReaders = 3;
+    static constexpr int NumWriters = 2;
+    static constexpr int NumWrites  = 2000;
+
+    struct Context
+    {
+        RWLock lock;
+        int    values[2] = {0, 0}; // Writers keep both values equal
+        bool   consistent = true;
+
+        Atomic<int> writersDone;
+    } context;
+
+    Thread readers[NumReaders];
+    Thread writers[NumWriters];
+    for (Thread& thread : writers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                for (int idx = 0; idx < NumWrites; ++idx)
+                {
+                    context.lock.lock(); // Exclusive access
+                    context.values[0]++;
+                    context.values[1]++;
+                    context.lock.unlock();
+                }
+                context.writersDone.fetch_add(1);
+            }));
+    }
+    for (Thread& thread : readers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                bool consistent = true;
+                while (context.writersDone.load() < NumWriters)
+                {
+                    context.lock.lockShared(); // Shared with other readers
+                    consistent = consistent and context.values[0] == context.values[1];
+                    context.lock.unlockShared();
+                }
+                context.lock.lock();
+                context.consistent = context.consistent and consistent;
+                context.lock.unlock();
+            }));
+    }
+    for (Thread& thread : writers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    for (Thread& thread : readers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(context.consistent);
+    SC_TEST_EXPECT(context.values[0] == NumWriters * NumWrites);
+    //! [rwLockSnippet]
+
+    RWLock& lock = context.lock;
+    SC_TEST_EXPECT(lock.tryLockShared());
+    SC_TEST_EXPECT(lock.tryLockShared());
+    SC_TEST_EXPECT(not lock.tryLock());
+    lock.unlockShared();
+    lock.unlockShared();
+    SC_TEST_EXPECT(lock.tryLock());
+    SC_TEST_EXPECT(not lock.tryLockShared());
+    lock.unlock();
+}
+
+void SC::ThreadingTest::testSemaphore()
+{
+    //! [semaphoreSnippet]
+    static constexpr int NumThreads = 4;
+    static constexpr int NumSlots   = 2;
+
+    // Semaphore limiting to NumSlots the threads concurrently using a resource
+    struct Context
+    {
+        Semaphore   semaphore{NumSlots};
+        Atomic<int> numUsers;
+        Atomic<int> maxUsers;
+    } context;
+
+    Thread threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&context](Thread&)
+            {
+                for (int idx = 0; idx < 100; ++idx)
+                {
+                    context.semaphore.acquire();
+                    const int users = context.numUsers.fetch_add(1) + 1;
+                    int       max   = context.maxUsers.load();
+                    while (users > max and not context.maxUsers.compare_exchange_weak(max, users)) {}
+                    context.numUsers.fetch_sub(1);
+                    context.semaphore.release();
+                }
+            }));
+    }
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(context.maxUsers.load() <= NumSlots);
+    //! [semaphoreSnippet]
+    Semaphore& semaphore = context.semaphore;
+    SC_TEST_EXPECT(semaphore.tryAcquire());
+    SC_TEST_EXPECT(semaphore.tryAcquire());
+    SC_TEST_EXPECT(not semaphore.tryAcquire());
+
+    // Releasing from another thread unblocks acquire
+    Thread releaser;
+    SC_TEST_EXPECT(releaser.start(
+        [&](Thread&)
+        {
+            Thread::Sleep(10);
+            semaphore.release(2);
+        }));
+    semaphore.acquire();
+    semaphore.acquire();
+    SC_TEST_EXPECT(releaser.join());
+    SC_TEST_EXPECT(not semaphore.tryAcquire());
+}
+
+void SC::ThreadingTest::testLatch()
+{
+    //! [latchSnippet]
+    static constexpr int NumThreads = 4;
+
+    Latch       initialized(NumThreads);
+    Atomic<int> numInitialized;
+
+    Thread threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&](Thread&)
+            {
+                numInitialized.fetch_add(1);
+                initialized.countDown();
+            }));
+    }
+    initialized.wait(); // Returns after all threads have called countDown
+    SC_TEST_EXPECT(initialized.tryWait());
+    SC_TEST_EXPECT(numInitialized.load() == NumThreads);
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    //! [latchSnippet]
+    Latch latch(2);
+    SC_TEST_EXPECT(not latch.tryWait());
+    latch.countDown();
+    SC_TEST_EXPECT(not latch.tryWait());
+    latch.arriveAndWait();
+    SC_TEST_EXPECT(latch.tryWait());
+}
+
+void SC::ThreadingTest::testBarrier()
+{
+    //! [barrierSnippet]
+    static constexpr int NumThreads = 4;
+    static constexpr int NumPhases  = 100;
+
+    // Each phase reads values written by all threads in the previous phase
+    struct Context
+    {
+        Barrier     barrier{NumThreads};
+        int         values[NumThreads] = {0};
+        bool        consistent[NumThreads];
+        Atomic<int> numLastArrived;
+    } context;
+
+    Thread threads[NumThreads];
+    for (int idx = 0; idx < NumThreads; ++idx)
+    {
+        SC_TEST_EXPECT(threads[idx].start(
+            [&context, idx](Thread&)
+            {
+                context.consistent[idx] = true;
+                for (int phase = 0; phase < NumPhases; ++phase)
+                {
+                    context.values[idx] = phase;
+                    if (context.barrier.arriveAndWait())
+                    {
+                        context.numLastArrived.fetch_add(1);
+                    }
+                    for (int other = 0; other < NumThreads; ++other)
+                    {
+                        context.consistent[idx] = context.consistent[idx] and context.values[other] == phase;
+                    }
+                    context.barrier.arriveAndWait(); // Wait for all threads to read before writing again
+                }
+            }));
+    }
+    for (int idx = 0; idx < NumThreads; ++idx)
+    {
+        SC_TEST_EXPECT(threads[idx].join());
+        SC_TEST_EXPECT(context.consistent[idx]);
+    }
+    SC_TEST_EXPECT(context.numLastArrived.load() == NumPhases);
+    //! [barrierSnippet]
+}
+
 namespace SC
 {
 void runThreadingTest(SC::TestReport& report) { ThreadingTest test(report); }
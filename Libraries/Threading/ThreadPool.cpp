@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: MIT
 #include "ThreadPool.h"
 #include "../Foundation/Deferred.h"
+#include "../Foundation/Memory.h"
+#include "Internal/CpuRelax.h"
+#include "LockFreeQueue.h"
 
 #if SC_PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
@@ -10,125 +13,197 @@
 #include <pthread.h>
 #endif
 
+// Chase-Lev work-stealing deque with a fixed capacity (tasks not fitting go to the injection queue)
 struct SC::ThreadPool::WorkerThread
 {
+    static constexpr size_t Mask      = WorkerQueueCapacity - 1;
+    static constexpr int    SpinCount = 64; // Attempts at finding a task before parking the thread
+    static_assert((WorkerQueueCapacity & Mask) == 0, "WorkerQueueCapacity must be a power of two");
+
+    alignas(CacheLineSize) Atomic<ssize_t> top;    // Oldest task, where other workers steal from
+    alignas(CacheLineSize) Atomic<ssize_t> bottom; // Newest task, where only the owner pushes and pops
+
+    Atomic<Task*> tasks[WorkerQueueCapacity];
+
+    ThreadPool* threadPool  = nullptr;
+    uint32_t    randomState = 1; // Used to pick the first worker to steal from
+
+    static thread_local WorkerThread* current; // Worker executing on current thread (if any)
+
+    // Called only by the owner thread
+    [[nodiscard]] bool push(Task& task)
+    {
+        const ssize_t b = bottom.load(memory_order_relaxed);
+        const ssize_t t = top.load(memory_order_acquire);
+        if (b - t >= static_cast<ssize_t>(WorkerQueueCapacity))
+        {
+            return false;
+        }
+        tasks[static_cast<size_t>(b) & Mask].store(&task, memory_order_relaxed);
+        bottom.store(b + 1, memory_order_release);
+        return true;
+    }
+
+    // Called only by the owner thread
+    [[nodiscard]] Task* pop()
+    {
+        const ssize_t b = bottom.load(memory_order_relaxed) - 1;
+        bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        ssize_t t    = top.load(memory_order_relaxed);
+        Task*         task = nullptr;
+        if (t <= b)
+        {
+            task = tasks[static_cast<size_t>(b) & Mask].load(memory_order_relaxed);
+            if (t == b)
+            {
+                // Last task left, racing with thieves for it
+                if (not top.compare_exchange_strong(t, t + 1))
+                {
+                    task = nullptr;
+                }
+                bottom.store(b + 1, memory_order_relaxed);
+            }
+        }
+        else
+        {
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Called by any thread
+    [[nodiscard]] Task* steal()
+    {
+        ssize_t t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        const ssize_t b = bottom.load(memory_order_acquire);
+        if (t < b)
+        {
+            Task* task = tasks[static_cast<size_t>(t) & Mask].load(memory_order_relaxed);
+            if (top.compare_exchange_strong(t, t + 1))
+            {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
 #if SC_PLATFORM_WINDOWS
     static DWORD WINAPI execute(void* arg)
 #else
     static void* execute(void* arg)
 #endif
     {
-        ThreadPool& threadPool = *reinterpret_cast<ThreadPool*>(arg);
+        WorkerThread& worker     = *reinterpret_cast<WorkerThread*>(arg);
+        ThreadPool&   threadPool = *worker.threadPool;
+        current                  = &worker;
         for (;;)
         {
-            // 1. Loop forever, trying to grab new tasks
-            Task* task;
-            if (not waitForAvailableTask(threadPool, task))
+            // 1. Spin for a while trying to grab new tasks
+            Task* task = nullptr;
+            bool  stop = false;
+            for (int spin = 0; spin < SpinCount and task == nullptr; ++spin)
             {
-                return 0; // Stop was requested, terminate the infinite loop (and so the thread)
+                stop = threadPool.stopRequested.load(memory_order_acquire);
+                if (stop)
+                    break;
+                task = threadPool.findTask(&worker);
+                if (task == nullptr)
+                {
+                    detail::cpuRelax();
+                }
             }
 
             // 2. Execute the task
             if (task != nullptr)
             {
-                task->function();
+                threadPool.executeTask(*task);
+                continue;
             }
 
-            // 3. Signal completion of the task
-            signalCompletedTask(threadPool, task);
-        }
-    }
-
-    /// @return true if the a new task is available, false if the thread was requested to stop
-    [[nodiscard]] static bool waitForAvailableTask(ThreadPool& threadPool, Task*& task)
-    {
-        // Function is entirely protected by the mutex
-        threadPool.poolMutex.lock();
-        auto deferUnlock = MakeDeferred([&threadPool] { threadPool.poolMutex.unlock(); });
-
-        // 1. Check for new task (or for the stop message)
-        while (not threadPool.stopRequested and threadPool.taskHead == nullptr)
-        {
-            threadPool.taskAvailable.wait(threadPool.poolMutex);
-        }
-
-        // 2. If a stop has been requested let execute stop the infinite loop
-        if (threadPool.stopRequested)
-        {
-            // Flag the task as completed to unblock waitForTask and return false to signal stopping the infinite loop
-            threadPool.numWorkerThreads--;
-            threadPool.taskCompleted.signal();
-            return false;
-        }
-
-        // 3. Grab oldest task
-        task = threadPool.taskHead;
-        threadPool.numRunningTasks++;
-
-        // 4. Update the head of the FIFO
-        if (task)
-        {
-            if (task->next == nullptr)
+            // 3. Park the thread until a new task is queued (or stop is requested)
+            if (not stop)
             {
-                // This was the last task available, now the FIFO is empty
-                threadPool.taskHead = nullptr;
-                threadPool.taskTail = nullptr;
+                threadPool.poolMutex.lock();
+                threadPool.numSleepingWorkers.fetch_add(1);
+                while (not threadPool.stopRequested.load() and threadPool.numQueuedTasks.load() == 0)
+                {
+                    threadPool.taskAvailable.wait(threadPool.poolMutex);
+                }
+                threadPool.numSleepingWorkers.fetch_sub(1);
+                stop = threadPool.stopRequested.load(memory_order_relaxed);
+                threadPool.poolMutex.unlock();
             }
-            else
+
+            // 4. Stop was requested, terminate the infinite loop (and so the thread)
+            if (stop)
             {
-                threadPool.taskHead = task->next;
+                threadPool.poolMutex.lock();
+                threadPool.numRunningWorkers--;
+                threadPool.taskCompleted.broadcast();
+                threadPool.poolMutex.unlock();
+                current = nullptr;
+                return 0;
             }
         }
-        return true;
-    }
-
-    static void signalCompletedTask(ThreadPool& threadPool, Task* task)
-    {
-        // Function is entirely protected by the mutex
-        threadPool.poolMutex.lock();
-        if (task)
-        {
-            task->threadPool = nullptr; // free the task
-            task->next       = nullptr;
-        }
-        threadPool.numRunningTasks--;
-        if (not threadPool.stopRequested) // stopRequested handling happens in waitForAvailableTask
-        {
-            threadPool.taskCompleted.signal();
-        }
-        threadPool.poolMutex.unlock();
     }
 };
 
+thread_local SC::ThreadPool::WorkerThread* SC::ThreadPool::WorkerThread::current = nullptr;
+
 SC::Result SC::ThreadPool::create(size_t workerThreads)
 {
     SC_TRY_MSG(numWorkerThreads == 0, "Cannot create already inited threadpool");
     SC_TRY_MSG(workerThreads > 0, "Cannot create threadpool with 0 worker threads");
 
-    // Creating threads and detaching them, as they will take care themselves of monitoring the incoming tasks.
+    // 1. Allocate queues in a single block aligned to cache line size, to avoid false sharing
+    const size_t workersSize = sizeof(WorkerThread) * workerThreads;
+    memory = Memory::allocate(workersSize + sizeof(InjectionQueue) + CacheLineSize);
+    SC_TRY_MSG(memory != nullptr, "ThreadPool::create - Cannot allocate queues");
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<size_t>(memory) + CacheLineSize - 1) &
+                                            ~(CacheLineSize - 1));
+    workers       = reinterpret_cast<WorkerThread*>(aligned);
+    injection     = new (aligned + workersSize, PlacementNew()) InjectionQueue();
+    for (size_t idx = 0; idx < workerThreads; idx++)
+    {
+        WorkerThread* worker = new (workers + idx, PlacementNew()) WorkerThread();
+        worker->threadPool   = this;
+        worker->randomState  = static_cast<uint32_t>(idx * 2654435761u + 1);
+    }
+    numWorkerThreads  = workerThreads;
+    numRunningWorkers = workerThreads;
+
+    // 2. Creating threads and detaching them, as they will take care themselves of monitoring the incoming tasks.
     for (size_t idx = 0; idx < workerThreads; idx++)
     {
         // Not using SC::Thread to avoid needing to store Function memory
 #if SC_PLATFORM_WINDOWS
         DWORD  threadID;
-        HANDLE thread = ::CreateThread(0, 512 * 1024, &WorkerThread::execute, this, CREATE_SUSPENDED, &threadID);
-        if (thread == nullptr)
+        HANDLE thread = ::CreateThread(0, 512 * 1024, &WorkerThread::execute, workers + idx, 0, &threadID);
+        const bool created = thread != nullptr;
+        if (created)
         {
-            return Result::Error("ThreadPool::create - CreateThread failed");
+            ::CloseHandle(thread);
         }
-        ::ResumeThread(thread);
-        ::CloseHandle(thread);
 #else
-        pthread_t thread;
-        const int res = ::pthread_create(&thread, nullptr, &WorkerThread::execute, this);
-        if (res != 0)
+        pthread_t  thread;
+        const bool created = ::pthread_create(&thread, nullptr, &WorkerThread::execute, workers + idx) == 0;
+        if (created)
         {
-            return Result::Error("ThreadPool::create - pthread_create failed");
+            ::pthread_detach(thread);
         }
-        ::pthread_detach(thread);
 #endif
+        if (not created)
+        {
+            // Stop threads that have been already created
+            poolMutex.lock();
+            numRunningWorkers -= workerThreads - idx;
+            poolMutex.unlock();
+            (void)destroy();
+            return Result::Error("ThreadPool::create - Cannot create worker thread");
+        }
     }
-    numWorkerThreads = workerThreads;
     return Result(true);
 }
 
@@ -141,104 +216,341 @@ SC::Result SC::ThreadPool::destroy()
         {
             return Result(true); // this was already destroyed
         }
-        // 1. Free tasks that have not been executed yet
-        while (taskHead)
+        // 1. Request all threads to stop and wait for them to exit (after completing their running task)
+        stopRequested.store(true);
+        taskAvailable.broadcast();
+        while (numRunningWorkers != 0)
         {
-            Task* task           = taskHead->next;
-            taskHead->next       = nullptr;
-            taskHead->threadPool = nullptr;
-            taskHead             = task;
+            taskCompleted.wait(poolMutex);
         }
-        taskTail = nullptr;
-
-        // 2. Request all threads to stop
-        stopRequested = true;
-        taskAvailable.broadcast();
     }
 
-    // 3. Wait for all tasks to stop
-    Result res = waitForAllTasks();
+    // 2. Free tasks that have not been executed yet
+    releaseQueues();
 
-    // 4. Reset the stop flag
-    stopRequested = false;
-    return res;
+    // 3. Release queues memory and reset the stop flag
+    Memory::release(memory);
+    memory           = nullptr;
+    workers          = nullptr;
+    injection        = nullptr;
+    numWorkerThreads = 0;
+    stopRequested.store(false);
+    return Result(true);
 }
 
-SC::Result SC::ThreadPool::waitForAllTasks()
+void SC::ThreadPool::releaseQueues()
 {
-    // Function is entirely protected by the mutex
-    poolMutex.lock();
-    auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
-    if (numWorkerThreads == 0)
-    {
-        return Result(true);
-    }
+    // No worker thread is running anymore, so it's safe popping from all of their queues
     for (;;)
     {
-        const bool runningWithPendingTasks    = not stopRequested and (taskHead != nullptr or numRunningTasks != 0);
-        const bool stoppingWithRunningThreads = stopRequested and numWorkerThreads != 0;
-        if (runningWithPendingTasks or stoppingWithRunningThreads)
+        Task* task = nullptr;
+        for (size_t idx = 0; idx < numWorkerThreads and task == nullptr; ++idx)
         {
-            taskCompleted.wait(poolMutex);
+            task = workers[idx].pop();
         }
-        else
+        if (task == nullptr and not injection->tryPop(task))
         {
+            poolMutex.lock();
+            task = taskHead;
+            if (task != nullptr)
+            {
+                taskHead = task->next;
+                numOverflowTasks.fetch_sub(1);
+            }
+            poolMutex.unlock();
+        }
+        if (task == nullptr)
             break;
+        TaskGroup* group = task->group;
+        task->next       = nullptr;
+        task->group      = nullptr;
+        task->threadPool.store(nullptr);
+        numQueuedTasks.fetch_sub(1);
+        numPendingTasks.fetch_sub(1);
+        if (group != nullptr)
+        {
+            group->numPendingTasks.fetch_sub(1);
         }
     }
+    taskTail = nullptr;
+
+    // Unblock waitForTask / waitForAllTasks waiting on the tasks that have just been freed
+    poolMutex.lock();
+    taskCompleted.broadcast();
+    poolMutex.unlock();
+}
+
+SC::Result SC::ThreadPool::waitForAllTasks()
+{
+    if (numWorkerThreads == 0 or numPendingTasks.load() == 0)
+    {
+        return Result(true);
+    }
+    poolMutex.lock();
+    auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
+    numWaitingThreads.fetch_add(1);
+    while (numPendingTasks.load() != 0)
+    {
+        taskCompleted.wait(poolMutex);
+    }
+    numWaitingThreads.fetch_sub(1);
     return Result(true);
 }
 
 SC::Result SC::ThreadPool::waitForTask(Task& task)
 {
     SC_TRY_MSG(numWorkerThreads > 0, "Cannot wait for tasks on an uninitialized threadpool");
-
-    // Function is entirely protected by the mutex
+    if (task.threadPool.load() != this)
+    {
+        return Result(true); // The task being waited has been flagged as completed
+    }
     poolMutex.lock();
     auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
+    numWaitingThreads.fetch_add(1);
+    while (task.threadPool.load() == this)
+    {
+        taskCompleted.wait(poolMutex);
+    }
+    numWaitingThreads.fetch_sub(1);
+    return Result(true);
+}
 
-    for (;;)
+SC::Result SC::ThreadPool::queueTask(Task& task) { return queueTask(task, nullptr); }
+
+SC::Result SC::ThreadPool::queueTask(Task& task, TaskGroup* group)
+{
+    SC_TRY_MSG(numWorkerThreads > 0, "Cannot queue tasks on an uninitialized threadpool");
+    ThreadPool* taskThreadPool = task.threadPool.load(memory_order_acquire);
+    SC_TRY_MSG(taskThreadPool != this, "Trying to queue a task that has already been queued");
+    SC_TRY_MSG(taskThreadPool == nullptr, "Trying to queue a task that is already in use by another threadpool");
+
+    task.next  = nullptr;
+    task.group = group;
+    task.threadPool.store(this, memory_order_relaxed);
+    numPendingTasks.fetch_add(1);
+    // Counted before being pushed, so that a parking worker cannot miss it (it may just spin a bit longer)
+    numQueuedTasks.fetch_add(1);
+    if (not pushTask(task))
     {
-        if (task.threadPool == nullptr)
+        poolMutex.lock();
+        if (taskHead == nullptr)
         {
-            break; // The task being waited has been flagged as completed
+            taskHead = &task;
         }
-        if (taskHead != nullptr or numRunningTasks != 0)
+        else
         {
-            taskCompleted.wait(poolMutex);
+            taskTail->next = &task;
         }
-        else
+        taskTail = &task;
+        numOverflowTasks.fetch_add(1);
+        poolMutex.unlock();
+    }
+    const bool wakeWorker  = numSleepingWorkers.load() > 0;
+    const bool wakeWaiters = numWaitingThreads.load() > 0;
+    if (wakeWorker or wakeWaiters)
+    {
+        poolMutex.lock();
+        if (wakeWorker)
+        {
+            taskAvailable.signal();
+        }
+        if (wakeWaiters)
         {
-            break; // all tasks have completed (including the task being waited)
+            taskCompleted.broadcast(); // TaskGroup::wait executes tasks while waiting
         }
+        poolMutex.unlock();
     }
     return Result(true);
 }
 
-SC::Result SC::ThreadPool::queueTask(Task& task)
+bool SC::ThreadPool::pushTask(Task& task)
 {
-    SC_TRY_MSG(numWorkerThreads > 0, "Cannot queue tasks on an uninitialized threadpool");
+    // Tasks queued by a task go to its worker deque, where they're likely to find a warm cache
+    WorkerThread* worker = WorkerThread::current;
+    if (worker != nullptr and worker->threadPool == this and worker->push(task))
+    {
+        return true;
+    }
+    return injection->tryPush(&task);
+}
 
-    // Function is entirely protected by the mutex
-    poolMutex.lock();
-    auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
+SC::ThreadPool::Task* SC::ThreadPool::findTask(WorkerThread* worker)
+{
+    // 1. Newest task queued by the worker itself
+    Task* task = worker != nullptr ? worker->pop() : nullptr;
+
+    // 2. Oldest task queued from outside worker threads
+    if (task == nullptr and not injection->tryPop(task) and numOverflowTasks.load(memory_order_acquire) > 0)
+    {
+        poolMutex.lock();
+        task = taskHead;
+        if (task != nullptr)
+        {
+            taskHead = task->next;
+            numOverflowTasks.fetch_sub(1);
+        }
+        poolMutex.unlock();
+    }
+
+    // 3. Oldest task of another worker, starting from a random one to spread contention
+    if (task == nullptr)
+    {
+        size_t start = 0;
+        if (worker != nullptr)
+        {
+            uint32_t& state = worker->randomState;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            start = state;
+        }
+        const size_t numWorkers = numWorkerThreads;
+        start                   = start % numWorkers;
+        for (size_t idx = 0; idx < numWorkers and task == nullptr; ++idx)
+        {
+            WorkerThread& victim = workers[(start + idx) % numWorkers];
+            if (&victim != worker)
+            {
+                task = victim.steal();
+            }
+        }
+    }
+    if (task != nullptr)
+    {
+        numQueuedTasks.fetch_sub(1);
+    }
+    return task;
+}
+
+void SC::ThreadPool::executeTask(Task& task)
+{
+    task.function();
+
+    // Task can be re-used (or destroyed) by its owner as soon as it's flagged as completed
+    TaskGroup* group = task.group;
+    task.next        = nullptr;
+    task.group       = nullptr;
+    task.threadPool.store(nullptr);
+    numPendingTasks.fetch_sub(1);
+    if (group != nullptr)
+    {
+        group->numPendingTasks.fetch_sub(1);
+    }
+    if (numWaitingThreads.load() > 0)
+    {
+        poolMutex.lock();
+        taskCompleted.broadcast();
+        poolMutex.unlock();
+    }
+}
+
+bool SC::ThreadPool::runPendingTask()
+{
+    WorkerThread* worker = WorkerThread::current;
+    Task*         task   = findTask(worker != nullptr and worker->threadPool == this ? worker : nullptr);
+    if (task == nullptr)
+    {
+        return false;
+    }
+    executeTask(*task);
+    return true;
+}
+
+SC::Result SC::ThreadPool::parallelChunks(size_t begin, size_t end, size_t grainSize,
+                                          Function<void(size_t, size_t, size_t)>& chunk, size_t* numSlots)
+{
+    SC_TRY_MSG(numWorkerThreads > 0, "Cannot run parallel tasks on an uninitialized threadpool");
+    SC_TRY_MSG(begin <= end, "ThreadPool - Invalid range");
+    const size_t rangeSize = end - begin;
+    if (grainSize == 0)
+    {
+        grainSize = rangeSize / (numWorkerThreads * 8);
+        grainSize = grainSize > 0 ? grainSize : 1;
+    }
+    const size_t numGrains = (rangeSize + grainSize - 1) / grainSize;
+    size_t       numTasks  = numWorkerThreads < MaxParallelTasks ? numWorkerThreads : MaxParallelTasks;
+    if (numGrains <= numTasks)
+    {
+        numTasks = numGrains > 0 ? numGrains - 1 : 0; // Calling thread processes one of the grains
+    }
+    if (numSlots != nullptr)
+    {
+        *numSlots = numTasks + 1;
+    }
+
+    struct Context
+    {
+        Function<void(size_t, size_t, size_t)>& chunk;
+
+        Atomic<size_t> next;
+        size_t         end;
+        size_t         grainSize;
+        size_t         numParticipants;
 
-    SC_TRY_MSG(task.threadPool != this, "Trying to queue a task that has already been queued");
-    SC_TRY_MSG(task.threadPool == nullptr, "Trying to queue a task that is already in use by another threadpool");
+        // Claims chunks of half of the remaining range for each participant (but at least grainSize)
+        void run(size_t slot)
+        {
+            for (;;)
+            {
+                size_t chunkBegin = next.load(memory_order_relaxed);
+                size_t chunkEnd;
+                do
+                {
+                    if (chunkBegin >= end)
+                        return;
+                    size_t length = (end - chunkBegin) / (2 * numParticipants);
+                    length        = length > grainSize ? length - length % grainSize : grainSize;
+                    chunkEnd      = end - chunkBegin > length ? chunkBegin + length : end;
+                    if (next.compare_exchange_weak(chunkBegin, chunkEnd, memory_order_relaxed))
+                        break;
+                } while (true);
+                chunk(chunkBegin, chunkEnd, slot);
+            }
+        }
+    } context = {chunk, begin, end, grainSize, numTasks + 1};
 
-    task.threadPool = this;
-    if (taskHead == nullptr)
+    // Caller runs chunks too, on the last slot, and then helps executing other queued tasks while waiting
+    Task      tasks[MaxParallelTasks];
+    TaskGroup group(*this);
+    for (size_t idx = 0; idx < numTasks; ++idx)
     {
-        // FIFO was empty, replace head and tail with the task
-        taskHead = &task;
-        taskTail = taskHead;
+        tasks[idx].function = [&context, idx]() { context.run(idx); };
+        SC_TRY(group.spawn(tasks[idx]));
     }
-    else
+    context.run(numTasks);
+    return group.wait();
+}
+
+// TaskGroup
+SC::Result SC::TaskGroup::spawn(ThreadPool::Task& task)
+{
+    numPendingTasks.fetch_add(1);
+    Result res = threadPool.queueTask(task, this);
+    if (not res)
     {
-        // FIFO was not empty, append task to the tail
-        taskTail->next = &task;
-        taskTail       = &task;
+        numPendingTasks.fetch_sub(1);
+    }
+    return res;
+}
+
+SC::Result SC::TaskGroup::wait()
+{
+    while (numPendingTasks.load() != 0)
+    {
+        // Execute any task (including the ones of this group) instead of blocking a worker thread
+        if (threadPool.runPendingTask())
+            continue;
+
+        // All remaining tasks of the group are being executed by other threads
+        threadPool.poolMutex.lock();
+        threadPool.numWaitingThreads.fetch_add(1);
+        while (numPendingTasks.load() != 0 and
+               threadPool.numQueuedTasks.load() == 0)
+        {
+            threadPool.taskCompleted.wait(threadPool.poolMutex);
+        }
+        threadPool.numWaitingThreads.fetch_sub(1);
+        threadPool.poolMutex.unlock();
     }
-    taskAvailable.broadcast();
     return Result(true);
 }
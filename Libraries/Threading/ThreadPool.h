@@ -1,12 +1,16 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "Atomic.h"
 #include "Threading.h"
 
 namespace SC
 {
 struct ThreadPool;
 struct ThreadPoolTask;
+struct TaskGroup;
+template <typename T, size_t N>
+struct MPMCQueue;
 } // namespace SC
 
 //! @addtogroup group_threading
@@ -21,15 +25,21 @@ struct SC::ThreadPoolTask
     Function<void()> function; ///< Function that will be executed during the task
   private:
     friend struct ThreadPool;
-    ThreadPool*     threadPool = nullptr;
-    ThreadPoolTask* next       = nullptr;
+    Atomic<ThreadPool*> threadPool;      // Pool executing the task (reset to nullptr when task is completed)
+    ThreadPoolTask*     next  = nullptr; // Next task in the overflow list of ThreadPool
+    TaskGroup*          group = nullptr; // Group notified when the task is completed (if spawned by a TaskGroup)
 };
 
-/// @brief Simple thread pool that executes tasks in a fixed number of worker threads.
+/// @brief Work-stealing thread pool that executes tasks in a fixed number of worker threads.
+///
+/// Every worker owns a lock-free (Chase-Lev) deque, where it pushes tasks queued from inside the tasks it executes,
+/// and pops them in LIFO order. Tasks queued from other threads go to a lock-free global injection queue.
+/// Workers without tasks steal the oldest ones from other workers, spinning for a while before parking on a
+/// condition variable, so that enqueuing and dequeuing never contend on a single mutex.
 ///
 /// This class is not copyable / moveable due to it containing Mutex and Condition variable.
-/// Additionally, this class does not allocate any memory by itself, and expects the caller to supply
-/// SC::ThreadPool::Task objects.
+/// Additionally, the only memory allocated by this class is a fixed size buffer for the queues (during
+/// ThreadPool::create), as it expects the caller to supply SC::ThreadPool::Task objects.
 ///
 /// @warning The caller is responsible of keeping Task address stable until the it will be completed.
 /// If it's not already completed the task must still be valid during ThreadPool::destroy or ThreadPool destructor.
@@ -41,9 +51,15 @@ struct SC::ThreadPool
 {
     using Task = ThreadPoolTask;
 
+    static constexpr size_t WorkerQueueCapacity    = 256;  ///< Tasks queued by a worker thread to its own deque
+    static constexpr size_t InjectionQueueCapacity = 1024; ///< Tasks queued from other threads without locking
+
     ThreadPool() = default;
     ~ThreadPool() { (void)destroy(); }
 
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
     /// @brief Create a thread pool with the requested number of worker threads
     [[nodiscard]] Result create(size_t workerThreads);
 
@@ -60,20 +76,138 @@ struct SC::ThreadPool
     /// @brief Blocks execution until all queued and pending tasks will be fully completed
     [[nodiscard]] Result waitForTask(Task& task);
 
+    /// @brief Maximum number of tasks spawned by parallelFor / parallelReduce (in addition to the calling thread)
+    static constexpr size_t MaxParallelTasks = 32;
+
+    /// @brief Calls `body(chunkBegin, chunkEnd)` on disjoint chunks covering `[begin, end)`, in parallel on worker
+    /// threads and on the calling thread. @n
+    /// Chunks are claimed dynamically by every participating thread, starting large and shrinking (down to
+    /// grainSize) as the range is consumed, so that faster threads process more of them.
+    /// It can be called from inside a task (nested parallelism), as waiting threads execute queued tasks.
+    /// @param begin First index of the range
+    /// @param end One past the last index of the range
+    /// @param grainSize Minimum number of indices in a chunk (`0` picks one from the range and number of workers)
+    /// @param body Function or lambda with a `void(size_t chunkBegin, size_t chunkEnd)` signature
+    /// @return Valid Result if the thread pool has been created
+    ///
+    /// Example:
+    /// @snippet Libraries/Threading/Tests/ThreadPoolTest.cpp parallelForSnippet
+    template <typename Body>
+    [[nodiscard]] Result parallelFor(size_t begin, size_t end, size_t grainSize, Body&& body)
+    {
+        Function<void(size_t, size_t, size_t)> chunk = [&body](size_t chunkBegin, size_t chunkEnd, size_t)
+        { body(chunkBegin, chunkEnd); };
+        return parallelChunks(begin, end, grainSize, chunk);
+    }
+
+    /// @brief Reduces `[begin, end)` in parallel, accumulating chunks into one partial result for each
+    /// participating thread, that are finally combined (in the order of the participants) into result. @n
+    /// Partial results are default constructed and assigned `identity`. As chunks are claimed dynamically, the
+    /// operation should be associative and commutative to get deterministic results.
+    /// @param begin First index of the range
+    /// @param end One past the last index of the range
+    /// @param grainSize Minimum number of indices in a chunk (`0` picks one from the range and number of workers)
+    /// @param identity Neutral element of combine, initial value of partial results and of result
+    /// @param result Receives `identity` combined with all partial results
+    /// @param body Function or lambda with a `void(size_t chunkBegin, size_t chunkEnd, T& partial)` signature
+    /// @param combine Function or lambda with a `void(T& result, const T& partial)` signature
+    /// @return Valid Result if the thread pool has been created
+    ///
+    /// Example:
+    /// @snippet Libraries/Threading/Tests/ThreadPoolTest.cpp parallelReduceSnippet
+    template <typename T, typename Body, typename Combine>
+    [[nodiscard]] Result parallelReduce(size_t begin, size_t end, size_t grainSize, const T& identity, T& result,
+                                        Body&& body, Combine&& combine)
+    {
+        T partials[MaxParallelTasks + 1];
+        for (T& partial : partials)
+        {
+            partial = identity;
+        }
+        struct Context
+        {
+            Body& body;
+            T*    partials;
+        } context = {body, partials};
+
+        Function<void(size_t, size_t, size_t)> chunk = [&context](size_t chunkBegin, size_t chunkEnd, size_t slot)
+        { context.body(chunkBegin, chunkEnd, context.partials[slot]); };
+        size_t numSlots = 0;
+        SC_TRY(parallelChunks(begin, end, grainSize, chunk, &numSlots));
+        result = identity;
+        for (size_t idx = 0; idx < numSlots; ++idx)
+        {
+            combine(result, partials[idx]);
+        }
+        return Result(true);
+    }
+
   private:
-    Task* taskHead = nullptr; // Head of the FIFO linked list containing all threads
-    Task* taskTail = nullptr; // Tail of the FIFO linked list containing all threads
+    friend struct TaskGroup;
+    struct WorkerThread;
+    using InjectionQueue = MPMCQueue<Task*, InjectionQueueCapacity>;
+
+    void*           memory    = nullptr; // Holds workers and injection queue, allocated during ThreadPool::create
+    WorkerThread*   workers   = nullptr; // One for each worker thread
+    InjectionQueue* injection = nullptr; // Tasks queued from outside worker threads
 
-    size_t numRunningTasks  = 0; // How many tasks are running in this moment
-    size_t numWorkerThreads = 0; // How many worker threads exist in this pool (== 0 means uninitialized threadpool)
+    // Tasks not fitting in a full worker deque or injection queue are appended to a FIFO linked list
+    Task*          taskHead = nullptr; // Head of the overflow FIFO linked list (protected by poolMutex)
+    Task*          taskTail = nullptr; // Tail of the overflow FIFO linked list (protected by poolMutex)
+    Atomic<size_t> numOverflowTasks;   // How many tasks are in the overflow list
 
-    Mutex             poolMutex;     // Protects all ThreadPool members access from worker threads
+    alignas(CacheLineSize) Atomic<size_t> numQueuedTasks; // Tasks queued but not yet grabbed by a worker
+    Atomic<size_t> numPendingTasks;    // Tasks queued or running (not completed yet)
+    Atomic<size_t> numSleepingWorkers; // Workers parked waiting on taskAvailable
+    Atomic<size_t> numWaitingThreads;  // Threads parked waiting on taskCompleted
+    Atomic<bool>   stopRequested;      // Signals background threads to end their task processing loop
+
+    size_t numRunningWorkers = 0; // Worker threads that have not exited yet (protected by poolMutex)
+    size_t numWorkerThreads  = 0; // How many worker threads exist in this pool (== 0 means uninitialized)
+
+    Mutex             poolMutex;     // Protects overflow list and parking / waking of threads
     ConditionVariable taskAvailable; // Signals to worker threads that there is a new queued task available
     ConditionVariable taskCompleted; // Signals to threadpool that there is a new task that was completed
 
-    bool stopRequested = false; // Signals background threads to end their infinite task processing loop
+    [[nodiscard]] Result queueTask(Task& task, TaskGroup* group);
+    [[nodiscard]] bool   runPendingTask();
+    [[nodiscard]] Result parallelChunks(size_t begin, size_t end, size_t grainSize,
+                                        Function<void(size_t, size_t, size_t)>& chunk, size_t* numSlots = nullptr);
 
-    struct WorkerThread;
+    [[nodiscard]] bool pushTask(Task& task);
+
+    [[nodiscard]] Task* findTask(WorkerThread* worker);
+
+    void executeTask(Task& task);
+    void releaseQueues();
+};
+
+/// @brief Group of tasks queued on a ThreadPool, that can be waited together (fork / join). @n
+/// Tasks can spawn other tasks in the same (or in a nested) group and wait for them, as the waiting thread
+/// executes queued tasks of the pool instead of blocking, so that nested joins cannot starve worker threads.
+///
+/// @warning Spawned tasks must be valid until TaskGroup::wait returns (that is also called by the destructor).
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadPoolTest.cpp taskGroupSnippet
+struct SC::TaskGroup
+{
+    TaskGroup(ThreadPool& threadPool) : threadPool(threadPool) {}
+    ~TaskGroup() { (void)wait(); }
+
+    TaskGroup(const TaskGroup&)            = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// @brief Queues a task (that should not be already in use) as part of this group
+    [[nodiscard]] Result spawn(ThreadPool::Task& task);
+
+    /// @brief Executes queued tasks of the pool until all tasks spawned in this group are completed
+    [[nodiscard]] Result wait();
+
+  private:
+    friend struct ThreadPool;
+    ThreadPool&    threadPool;
+    Atomic<size_t> numPendingTasks; // Spawned tasks not completed yet
 };
 
 //! @}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #include "Threading.h"
 #include "../Foundation/Assert.h"
+#include "Internal/CpuRelax.h"
 
 #if SC_PLATFORM_WINDOWS
 #include "Internal/ThreadingWindows.inl"
@@ -67,3 +68,220 @@ void SC::EventObject::signal()
     mutex.unlock();
     cond.signal();
 }
+
+void SC::SpinLock::lockContended()
+{
+    constexpr uint32_t MaxSpinBackoff = 64; // Pause instructions in a row, before starting to yield
+
+    uint32_t backoff = 1;
+    do
+    {
+        // Spin reading the lock (that stays in cache) and try exchanging it only after it looks free
+        while (locked.load(memory_order_relaxed))
+        {
+            if (backoff <= MaxSpinBackoff)
+            {
+                for (uint32_t idx = 0; idx < backoff; ++idx)
+                {
+                    detail::cpuRelax();
+                }
+                backoff *= 2;
+            }
+            else
+            {
+                Thread::Sleep(0);
+            }
+        }
+    } while (locked.exchange(true, memory_order_acquire));
+}
+
+void SC::FutexMutex::lockContended()
+{
+    constexpr int SpinCount = 100; // Attempts at acquiring the mutex before blocking
+
+    for (int idx = 0; idx < SpinCount; ++idx)
+    {
+        uint32_t expected = state.load(memory_order_relaxed);
+        if (expected == LockedWithWaiters)
+            break; // Other threads are already blocked, so just join them
+        if (expected == Unlocked and state.compare_exchange_weak(expected, Locked, memory_order_acquire))
+            return;
+        detail::cpuRelax();
+    }
+    // Marking the mutex as having waiters makes unlock wake one of them (it could be a spurious wake up when
+    // acquiring it right away, as this thread can't know if it was the last one waiting)
+    while (state.exchange(LockedWithWaiters, memory_order_acquire) != Unlocked)
+    {
+        state.wait(LockedWithWaiters);
+    }
+}
+
+void SC::FutexConditionVariable::wait(FutexMutex& mutex)
+{
+    const uint32_t current = sequence.load(memory_order_relaxed);
+    mutex.unlock();
+    sequence.wait(current);
+    // Other threads could be waiting for the mutex too, so lock it as if it had waiters
+    while (mutex.state.exchange(FutexMutex::LockedWithWaiters, memory_order_acquire) != FutexMutex::Unlocked)
+    {
+        mutex.state.wait(FutexMutex::LockedWithWaiters);
+    }
+}
+
+void SC::FutexConditionVariable::signal()
+{
+    sequence.fetch_add(1, memory_order_relaxed);
+    sequence.wakeOne();
+}
+
+void SC::FutexConditionVariable::broadcast()
+{
+    sequence.fetch_add(1, memory_order_relaxed);
+    sequence.wakeAll();
+}
+
+bool SC::RWLock::tryLock()
+{
+    uint32_t current = state.load(memory_order_relaxed);
+    while ((current & (WriterLocked | ReadersMask)) == 0)
+    {
+        // Waiting flags are kept, so that unlock will wake up other waiting threads
+        if (state.compare_exchange_weak(current, current | WriterLocked, memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+void SC::RWLock::lock()
+{
+    uint32_t current = state.load(memory_order_relaxed);
+    for (;;)
+    {
+        if ((current & (WriterLocked | ReadersMask)) == 0)
+        {
+            if (state.compare_exchange_weak(current, current | WriterLocked, memory_order_acquire))
+                return;
+            continue;
+        }
+        if ((current & WriterWaiting) == 0 and
+            not state.compare_exchange_weak(current, current | WriterWaiting, memory_order_relaxed))
+            continue;
+        state.wait(current | WriterWaiting);
+        current = state.load(memory_order_relaxed);
+    }
+}
+
+void SC::RWLock::unlock()
+{
+    // Clearing all waiting flags, as all waiting threads are woken up to compete again for the lock
+    if ((state.exchange(0, memory_order_release) & (WriterWaiting | ReadersWaiting)) != 0)
+        state.wakeAll();
+}
+
+bool SC::RWLock::tryLockShared()
+{
+    uint32_t current = state.load(memory_order_relaxed);
+    while ((current & (WriterLocked | WriterWaiting)) == 0)
+    {
+        SC_ASSERT_RELEASE((current & ReadersMask) != ReadersMask);
+        if (state.compare_exchange_weak(current, current + 1, memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+void SC::RWLock::lockShared()
+{
+    uint32_t current = state.load(memory_order_relaxed);
+    for (;;)
+    {
+        if ((current & (WriterLocked | WriterWaiting)) == 0)
+        {
+            SC_ASSERT_RELEASE((current & ReadersMask) != ReadersMask);
+            if (state.compare_exchange_weak(current, current + 1, memory_order_acquire))
+                return;
+            continue;
+        }
+        if ((current & ReadersWaiting) == 0 and
+            not state.compare_exchange_weak(current, current | ReadersWaiting, memory_order_relaxed))
+            continue;
+        state.wait(current | ReadersWaiting);
+        current = state.load(memory_order_relaxed);
+    }
+}
+
+void SC::RWLock::unlockShared()
+{
+    const uint32_t current = state.fetch_sub(1, memory_order_release) - 1;
+    // Last reader leaving wakes the waiting writer (together with readers blocked by it)
+    if ((current & ReadersMask) == 0 and (current & WriterWaiting) != 0)
+        state.wakeAll();
+}
+
+bool SC::Semaphore::tryAcquire()
+{
+    uint32_t current = count.load(memory_order_relaxed);
+    while (current > 0)
+    {
+        if (count.compare_exchange_weak(current, current - 1, memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+void SC::Semaphore::acquire()
+{
+    while (not tryAcquire())
+    {
+        numWaiters.fetch_add(1);
+        count.wait(0);
+        numWaiters.fetch_sub(1, memory_order_relaxed);
+    }
+}
+
+void SC::Semaphore::release(uint32_t update)
+{
+    count.fetch_add(update); // Sequentially consistent with numWaiters, to avoid missing a waiter
+    if (numWaiters.load() > 0)
+    {
+        if (update == 1)
+            count.wakeOne();
+        else
+            count.wakeAll();
+    }
+}
+
+void SC::Latch::countDown(uint32_t update)
+{
+    const uint32_t previous = count.fetch_sub(update, memory_order_release);
+    SC_ASSERT_RELEASE(previous >= update);
+    if (previous == update)
+        count.wakeAll();
+}
+
+void SC::Latch::wait()
+{
+    uint32_t current;
+    while ((current = count.load(memory_order_acquire)) != 0)
+    {
+        count.wait(current);
+    }
+}
+
+bool SC::Barrier::arriveAndWait()
+{
+    const uint32_t current = phase.load(memory_order_acquire);
+    if (remaining.fetch_sub(1, memory_order_acq_rel) == 1)
+    {
+        // Threads can't arrive at next phase before it's started, so resetting remaining here is safe
+        remaining.store(numThreads, memory_order_relaxed);
+        phase.fetch_add(1, memory_order_release);
+        phase.wakeAll();
+        return true;
+    }
+    while (phase.load(memory_order_acquire) == current)
+    {
+        phase.wait(current);
+    }
+    return false;
+}
@@ -4,6 +4,7 @@
 #include "../Foundation/AlignedStorage.h"
 #include "../Foundation/Function.h"
 #include "../Foundation/Result.h"
+#include "Atomic.h"
 #include "Internal/Optional.h" // UniqueOptional
 
 namespace SC
@@ -12,6 +13,14 @@ struct Thread;
 struct ConditionVariable;
 struct Mutex;
 struct EventObject;
+struct Futex;
+struct SpinLock;
+struct FutexMutex;
+struct FutexConditionVariable;
+struct RWLock;
+struct Semaphore;
+struct Latch;
+struct Barrier;
 } // namespace SC
 
 //! @defgroup group_threading Threading
@@ -187,4 +196,238 @@ struct SC::EventObject
     ConditionVariable cond;
 };
 
+/// @brief A 32 bit atomic word that threads can wait on, until woken up by another thread. @n
+/// It's the building block of all the synchronization primitives that don't wrap an OS object
+/// (SC::FutexMutex, SC::FutexConditionVariable, SC::RWLock, SC::Semaphore, SC::Latch and SC::Barrier).
+/// Waiting and waking are system calls (`futex` on Linux, `WaitOnAddress` on Windows and `ulock` on Apple), so
+/// primitives built on it enter the kernel only when they really need to block or to wake a blocked thread.
+struct SC::Futex : public Atomic<uint32_t>
+{
+    Futex(uint32_t value = 0) : Atomic<uint32_t>(value) {}
+
+    /// @brief Blocks calling thread while value is equal to expected, until wakeOne or wakeAll are called.
+    /// @note It can return spuriously, so callers must check again the value in a loop
+    void wait(uint32_t expected);
+
+    /// @brief Wakes up at most one thread blocked in Futex::wait
+    void wakeOne();
+
+    /// @brief Wakes up all threads blocked in Futex::wait
+    void wakeAll();
+};
+
+/// @brief A lock busy waiting in user space, for very short critical sections. @n
+/// Waiting threads spin with exponential backoff, re-trying only after the lock looks free, and they start yielding
+/// their time slice when the lock is held for longer.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp spinLockSnippet
+struct SC::SpinLock
+{
+    SpinLock() = default;
+
+    SpinLock(const SpinLock&)            = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+
+    void lock()
+    {
+        if (not locked.exchange(true, memory_order_acquire))
+            return;
+        lockContended();
+    }
+
+    /// @brief Acquires the lock only if it's not held by any other thread
+    /// @return `true` if the lock has been acquired
+    [[nodiscard]] bool tryLock()
+    {
+        return not locked.load(memory_order_relaxed) and not locked.exchange(true, memory_order_acquire);
+    }
+
+    void unlock() { locked.store(false, memory_order_release); }
+
+  private:
+    Atomic<bool> locked;
+
+    void lockContended();
+};
+
+/// @brief A mutex implemented on top of SC::Futex, taking a system call only to block or to wake a blocked thread.
+/// @n
+/// It's smaller and faster than SC::Mutex, especially when uncontended, and it spins for a short while before
+/// blocking. Use SC::FutexConditionVariable with it.
+struct SC::FutexMutex
+{
+    FutexMutex() = default;
+
+    FutexMutex(const FutexMutex&)            = delete;
+    FutexMutex& operator=(const FutexMutex&) = delete;
+
+    void lock()
+    {
+        uint32_t expected = Unlocked;
+        if (not state.compare_exchange_strong(expected, Locked, memory_order_acquire))
+            lockContended();
+    }
+
+    /// @brief Acquires the mutex only if it's not held by any other thread
+    /// @return `true` if the mutex has been acquired
+    [[nodiscard]] bool tryLock()
+    {
+        uint32_t expected = Unlocked;
+        return state.compare_exchange_strong(expected, Locked, memory_order_acquire);
+    }
+
+    void unlock()
+    {
+        if (state.exchange(Unlocked, memory_order_release) == LockedWithWaiters)
+            state.wakeOne();
+    }
+
+  private:
+    friend struct FutexConditionVariable;
+    static constexpr uint32_t Unlocked          = 0;
+    static constexpr uint32_t Locked            = 1;
+    static constexpr uint32_t LockedWithWaiters = 2;
+
+    Futex state;
+
+    void lockContended();
+};
+
+/// @brief A condition variable implemented on top of SC::Futex, to be used with SC::FutexMutex
+struct SC::FutexConditionVariable
+{
+    FutexConditionVariable() = default;
+
+    FutexConditionVariable(const FutexConditionVariable&)            = delete;
+    FutexConditionVariable& operator=(const FutexConditionVariable&) = delete;
+
+    /// @brief Atomically unlocks the mutex and waits for signal or broadcast, locking the mutex again before returning
+    /// @note It can return spuriously, so callers must check again their condition in a loop
+    void wait(FutexMutex& mutex);
+
+    void signal();
+    void broadcast();
+
+  private:
+    Futex sequence; // Incremented by every signal / broadcast
+};
+
+/// @brief A reader-writer lock, allowing multiple readers or a single writer to access a shared resource. @n
+/// Writers have priority, so new readers block when a writer is waiting, to avoid starving writers.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp rwLockSnippet
+struct SC::RWLock
+{
+    RWLock() = default;
+
+    RWLock(const RWLock&)            = delete;
+    RWLock& operator=(const RWLock&) = delete;
+
+    /// @brief Acquires the lock for exclusive (write) access
+    void lock();
+
+    /// @brief Releases the exclusive (write) access
+    void unlock();
+
+    /// @brief Acquires the lock for shared (read) access
+    void lockShared();
+
+    /// @brief Releases the shared (read) access
+    void unlockShared();
+
+    /// @brief Acquires exclusive access only if the lock is not held by any other reader or writer
+    [[nodiscard]] bool tryLock();
+
+    /// @brief Acquires shared access only if the lock is not held (or waited) by a writer
+    [[nodiscard]] bool tryLockShared();
+
+  private:
+    static constexpr uint32_t WriterLocked   = 1u << 31;
+    static constexpr uint32_t WriterWaiting  = 1u << 30; // Blocks new readers
+    static constexpr uint32_t ReadersWaiting = 1u << 29;
+    static constexpr uint32_t ReadersMask    = ReadersWaiting - 1;
+
+    Futex state; // Number of readers and flags above
+};
+
+/// @brief A counting semaphore, blocking threads acquiring it while its count is zero.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp semaphoreSnippet
+struct SC::Semaphore
+{
+    Semaphore(uint32_t initialCount = 0) : count(initialCount) {}
+
+    Semaphore(const Semaphore&)            = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    /// @brief Decrements the count, blocking until it's greater than zero
+    void acquire();
+
+    /// @brief Decrements the count only if it's greater than zero
+    /// @return `true` if the count has been decremented
+    [[nodiscard]] bool tryAcquire();
+
+    /// @brief Increments the count, waking up threads blocked in Semaphore::acquire
+    void release(uint32_t update = 1);
+
+  private:
+    Futex            count;
+    Atomic<uint32_t> numWaiters;
+};
+
+/// @brief A single use countdown, blocking threads waiting on it until it reaches zero.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp latchSnippet
+struct SC::Latch
+{
+    Latch(uint32_t expected) : count(expected) {}
+
+    Latch(const Latch&)            = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    /// @brief Decrements the count, waking up all waiting threads when it reaches zero
+    void countDown(uint32_t update = 1);
+
+    /// @brief Returns `true` if count has reached zero
+    [[nodiscard]] bool tryWait() const { return count.load(memory_order_acquire) == 0; }
+
+    /// @brief Blocks until count reaches zero
+    void wait();
+
+    /// @brief Decrements the count and blocks until it reaches zero
+    void arriveAndWait(uint32_t update = 1)
+    {
+        countDown(update);
+        wait();
+    }
+
+  private:
+    Futex count;
+};
+
+/// @brief A reusable barrier, blocking a fixed number of threads until all of them have reached it.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp barrierSnippet
+struct SC::Barrier
+{
+    Barrier(uint32_t numThreads) : numThreads(numThreads), remaining(numThreads) {}
+
+    Barrier(const Barrier&)            = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    /// @brief Blocks until Barrier::arriveAndWait has been called by all threads, starting a new phase
+    /// @return `true` on exactly one of the threads (the last one arriving), `false` on the other ones
+    bool arriveAndWait();
+
+  private:
+    const uint32_t   numThreads;
+    Atomic<uint32_t> remaining;
+    Futex            phase; // Incremented when all threads have arrived
+};
+
 //! @}
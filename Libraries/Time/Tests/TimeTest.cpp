@@ -69,6 +69,7 @@ void SC::TimeTest::testHighResolutionCounterOffseBy()
     Time::Relative elapsed = end.subtractApproximate(start);
     SC_TEST_EXPECT(elapsed.inRoundedUpperMilliseconds().ms == 321);
     //! [highResolutionCounterOffsetBySnippet]
+    SC_TEST_EXPECT(end.subtractExact(start).toNanoseconds() == 321 * 1000 * 1000);
 }
 void SC::TimeTest::testHighResolutionCounterIsLaterOn()
 {
@@ -130,8 +130,15 @@ SC::Time::HighResolutionCounter SC::Time::HighResolutionCounter::offsetBy(Millis
     newCounter.part1 += other.ms * part2 / 1000;
 #else
     constexpr int32_t millisecondsToNanoseconds = 1e6;
+    constexpr int32_t secondsToNanoseconds      = 1e9;
     newCounter.part1 += other.ms / 1000;
     newCounter.part2 += (other.ms % 1000) * millisecondsToNanoseconds;
+    if (newCounter.part2 >= secondsToNanoseconds)
+    {
+        // Keep nanoseconds normalized, as isLaterThanOrEqualTo compares seconds first
+        newCounter.part1 += 1;
+        newCounter.part2 -= secondsToNanoseconds;
+    }
 #endif
     return newCounter;
 }
@@ -177,3 +184,14 @@ SC::Time::Relative SC::Time::HighResolutionCounter::subtractApproximate(HighReso
 #endif
     return res;
 }
+
+SC::int64_t SC::Time::HighResolutionCounter::toNanoseconds() const
+{
+    constexpr int64_t secondsToNanoseconds = 1000000000;
+#if SC_PLATFORM_WINDOWS
+    // Split whole seconds from the remainder, to avoid overflowing when multiplying ticks by nanoseconds
+    return (part1 / part2) * secondsToNanoseconds + ((part1 % part2) * secondsToNanoseconds) / part2;
+#else
+    return part1 * secondsToNanoseconds + part2;
+#endif
+}
@@ -159,6 +159,10 @@ struct SC::Time::HighResolutionCounter
     /// @return A HighResolutionCounter holding the time interval between the two HighResolutionCounter
     [[nodiscard]] HighResolutionCounter subtractExact(HighResolutionCounter other) const;
 
+    /// @brief Converts this HighResolutionCounter (or an interval obtained with subtractExact) to nanoseconds
+    /// @return Number of nanoseconds represented by this HighResolutionCounter
+    [[nodiscard]] int64_t toNanoseconds() const;
+
     int64_t part1;
     int64_t part2;
 
@@ -0,0 +1,493 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../../Libraries/Foundation/Compiler.h"
+#if SC_LANGUAGE_CPP_AT_LEAST_20
+#include "../../Libraries/Async/Async.h"
+#include "Internal/AsyncCoroutinesStd.h"
+
+namespace SC
+{
+struct AsyncCoroutine;
+struct AsyncCoroutinePool;
+struct AsyncCoroutineAwaiter;
+template <typename Derived, typename Request>
+struct AsyncRequestAwaiter;
+struct AsyncSleepAwaiter;
+struct AsyncSocketReceiveAwaiter;
+struct AsyncSocketSendAwaiter;
+struct AsyncFileReadAwaiter;
+} // namespace SC
+
+//! @defgroup group_async_coroutines Async Coroutines
+//! @copybrief library_async_coroutines (see @ref library_async_coroutines for more details)
+
+//! @addtogroup group_async_coroutines
+//! @{
+
+/// @brief Like SC_TRY, but returning the failed Result with `co_return` (to be used inside an SC::AsyncCoroutine)
+#define SC_CO_TRY(expression)                                                                                          \
+    {                                                                                                                  \
+        if (auto _exprResConv = SC::Result(expression))                                                                \
+            SC_LANGUAGE_LIKELY                                                                                         \
+            {                                                                                                          \
+                (void)0;                                                                                               \
+            }                                                                                                          \
+        else                                                                                                           \
+        {                                                                                                              \
+            co_return _exprResConv;                                                                                    \
+        }                                                                                                              \
+    }
+
+/// @brief Like SC_TRY_MSG, but returning the error with `co_return` (to be used inside an SC::AsyncCoroutine)
+#define SC_CO_TRY_MSG(expression, failedMessage)                                                                       \
+    if (not(expression))                                                                                               \
+        SC_LANGUAGE_UNLIKELY                                                                                           \
+        {                                                                                                              \
+            co_return SC::Result::Error(failedMessage);                                                                \
+        }
+
+/// @brief Base of all objects that can be awaited inside an SC::AsyncCoroutine.
+/// Awaiters live inside the coroutine frame, so awaiting them doesn't allocate any memory.
+struct SC::AsyncCoroutineAwaiter
+{
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  protected:
+    std::coroutine_handle<> coroutine;
+    Result                  returnCode = Result(true);
+
+  private:
+    friend struct AsyncCoroutinePool;
+    AsyncCoroutineAwaiter* next = nullptr; // Linked in AsyncCoroutinePool ready list
+};
+
+/// @brief Memory for coroutine frames of SC::AsyncCoroutine and scheduler resuming them on the event loop thread. @n
+/// Frames are fixed size slots carved out of caller provided memory, so that no coroutine allocates on the heap.
+/// When there is no free slot (or a frame doesn't fit it) the coroutine is not started at all and the returned
+/// SC::AsyncCoroutine is invalid.
+/// @n
+/// Coroutines are resumed by the pool after the completion callback of the awaited request has returned, when the
+/// request is free again, so that it can be started again right after being awaited.
+struct SC::AsyncCoroutinePool
+{
+    AsyncCoroutinePool() = default;
+    ~AsyncCoroutinePool() { (void)close(); }
+
+    AsyncCoroutinePool(const AsyncCoroutinePool&)            = delete;
+    AsyncCoroutinePool& operator=(const AsyncCoroutinePool&) = delete;
+
+    /// @brief Splits memory in frames of frameSize bytes and associates the pool with an event loop
+    /// @param eventLoop The event loop where requests awaited by coroutines are started
+    /// @param memory Memory that will be split in frames. It must be valid until AsyncCoroutinePool::close is called.
+    /// @param frameSize Size of each frame. It must fit the biggest coroutine frame (that is compiler dependent).
+    /// @return Valid Result if at least one frame fits memory
+    [[nodiscard]] Result create(AsyncEventLoop& eventLoop, Span<char> memory, size_t frameSize)
+    {
+        SC_TRY_MSG(loop == nullptr, "AsyncCoroutinePool::create - Already created");
+        frameSize = (frameSize + FrameAlignment - 1) & ~(FrameAlignment - 1);
+        SC_TRY_MSG(frameSize >= FrameAlignment, "AsyncCoroutinePool::create - Invalid frame size");
+
+        const size_t address = reinterpret_cast<size_t>(memory.data());
+        const size_t offset  = ((address + FrameAlignment - 1) & ~(FrameAlignment - 1)) - address;
+        SC_TRY_MSG(memory.sizeInBytes() >= offset + frameSize, "AsyncCoroutinePool::create - Memory is too small");
+        numFrames = (memory.sizeInBytes() - offset) / frameSize;
+        for (size_t idx = numFrames; idx > 0; --idx)
+        {
+            FreeFrame* frame = reinterpret_cast<FreeFrame*>(memory.data() + offset + (idx - 1) * frameSize);
+            frame->next      = freeFrames;
+            freeFrames       = frame;
+        }
+        numFreeFrames  = numFrames;
+        frameSizeBytes = frameSize;
+        loop           = &eventLoop;
+        resumer.callback.bind<AsyncCoroutinePool, &AsyncCoroutinePool::onResume>(*this);
+        return Result(true);
+    }
+
+    /// @brief Detaches the pool from the event loop
+    /// @return Error if some coroutine has not finished yet
+    [[nodiscard]] Result close()
+    {
+        if (loop == nullptr)
+            return Result(true);
+        SC_TRY_MSG(numFreeFrames == numFrames, "AsyncCoroutinePool::close - Coroutines are still running");
+        if (resumerActive)
+        {
+            SC_TRY(resumer.stop());
+            resumerActive = false;
+        }
+        loop       = nullptr;
+        freeFrames = nullptr;
+        numFrames  = 0;
+        return Result(true);
+    }
+
+    /// @brief Get the event loop associated with this pool
+    [[nodiscard]] AsyncEventLoop* getEventLoop() const { return loop; }
+
+    /// @brief Number of frames that can still be used to start coroutines
+    [[nodiscard]] size_t getNumFreeFrames() const { return numFreeFrames; }
+
+    /// @brief Awaits for given relative time to pass (see SC::AsyncLoopTimeout)
+    [[nodiscard]] AsyncSleepAwaiter sleep(Time::Milliseconds relativeTimeout);
+
+    /// @brief Awaits receiving data from a socket (see SC::AsyncSocketReceive)
+    /// @param socket The socket to receive data from
+    /// @param buffer Memory where received data will be written
+    /// @param data Slice of buffer that has been filled by received data (empty when the peer has disconnected)
+    [[nodiscard]] AsyncSocketReceiveAwaiter receive(const SocketDescriptor& socket, Span<char> buffer,
+                                                    Span<char>& data);
+
+    /// @brief Awaits sending data to a socket (see SC::AsyncSocketSend)
+    /// @param socket The socket to send data to
+    /// @param data The data to be sent
+    [[nodiscard]] AsyncSocketSendAwaiter send(const SocketDescriptor& socket, Span<const char> data);
+
+    /// @brief Awaits reading data from a file or pipe (see SC::AsyncFileRead)
+    /// @param file The file / pipe handle, associated with the event loop and opened for non-blocking IO
+    /// @param buffer Memory where read data will be written
+    /// @param data Slice of buffer that has been filled by read data (empty on end of file)
+    /// @param offset Offset from file start where to start reading (not supported on pipes)
+    [[nodiscard]] AsyncFileReadAwaiter read(FileDescriptor::Handle file, Span<char> buffer, Span<char>& data,
+                                            uint64_t offset = 0);
+
+  private:
+    friend struct AsyncCoroutine;
+    template <typename Derived, typename Request>
+    friend struct AsyncRequestAwaiter;
+
+    static constexpr size_t FrameAlignment = 2 * sizeof(void*);
+
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+    FreeFrame* freeFrames     = nullptr;
+    size_t     numFrames      = 0;
+    size_t     numFreeFrames  = 0;
+    size_t     frameSizeBytes = 0;
+
+    AsyncEventLoop* loop = nullptr;
+
+    // Awaiters whose request has completed, waiting to resume their coroutine
+    AsyncCoroutineAwaiter* readyHead = nullptr;
+    AsyncCoroutineAwaiter* readyTail = nullptr;
+
+    AsyncLoopTimeout resumer; // Zero timeout resuming ready coroutines on next loop step
+    bool             resumerActive = false;
+    bool             resuming      = false;
+
+    // The pool owning the frame is stored right after the frame itself, to find it on release
+    [[nodiscard]] static size_t poolOffset(size_t size)
+    {
+        return (size + alignof(AsyncCoroutinePool*) - 1) & ~(alignof(AsyncCoroutinePool*) - 1);
+    }
+
+    [[nodiscard]] void* allocateFrame(size_t size) noexcept
+    {
+        if (freeFrames == nullptr or poolOffset(size) + sizeof(AsyncCoroutinePool*) > frameSizeBytes)
+            return nullptr;
+        FreeFrame* frame = freeFrames;
+        freeFrames       = frame->next;
+        numFreeFrames--;
+        *reinterpret_cast<AsyncCoroutinePool**>(reinterpret_cast<char*>(frame) + poolOffset(size)) = this;
+        return frame;
+    }
+
+    static void releaseFrame(void* memory, size_t size) noexcept
+    {
+        AsyncCoroutinePool& pool =
+            **reinterpret_cast<AsyncCoroutinePool**>(reinterpret_cast<char*>(memory) + poolOffset(size));
+        FreeFrame* frame = reinterpret_cast<FreeFrame*>(memory);
+        frame->next      = pool.freeFrames;
+        pool.freeFrames  = frame;
+        pool.numFreeFrames++;
+    }
+
+    void resumeLater(AsyncCoroutineAwaiter& awaiter)
+    {
+        awaiter.next = nullptr;
+        if (readyTail == nullptr)
+            readyHead = &awaiter;
+        else
+            readyTail->next = &awaiter;
+        readyTail = &awaiter;
+        if (not resumerActive and not resuming)
+        {
+            resumerActive = true;
+            SC_ASSERT_RELEASE(resumer.start(*loop, Time::Milliseconds(0)));
+        }
+    }
+
+    void onResume(AsyncLoopTimeout::Result&)
+    {
+        resumerActive = false;
+        resuming      = true;
+        // Resumed coroutines can complete and make their awaiting coroutine ready to be resumed too
+        while (AsyncCoroutineAwaiter* awaiter = readyHead)
+        {
+            readyHead = awaiter->next;
+            if (readyHead == nullptr)
+                readyTail = nullptr;
+            awaiter->coroutine.resume();
+        }
+        resuming = false;
+    }
+};
+
+/// @brief Coroutine returning an SC::Result, whose frame is allocated from an SC::AsyncCoroutinePool. @n
+/// The first parameter of the coroutine function must be the SC::AsyncCoroutinePool where its frame is allocated
+/// (so coroutines must be free functions or static member functions).
+/// Coroutines start executing immediately and they can be awaited by other coroutines, to compose them.
+/// Destroying an AsyncCoroutine before it has finished detaches it (its frame is released when it finishes).
+///
+/// Example:
+/// @snippet LibrariesExtra/AsyncCoroutines/Tests/AsyncCoroutinesTest.cpp AsyncCoroutineSnippet
+struct SC::AsyncCoroutine
+{
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    AsyncCoroutine() = default;
+    AsyncCoroutine(AsyncCoroutine&& other) : handle(other.handle) { other.handle = nullptr; }
+    AsyncCoroutine& operator=(AsyncCoroutine&& other)
+    {
+        release();
+        handle       = other.handle;
+        other.handle = nullptr;
+        return *this;
+    }
+    ~AsyncCoroutine() { release(); }
+
+    /// @brief Returns `false` if the coroutine could not be started, as no frame was available in the pool
+    [[nodiscard]] bool isValid() const { return static_cast<bool>(handle); }
+
+    /// @brief Returns `true` if the coroutine has finished (or has not been started at all)
+    [[nodiscard]] bool isDone() const { return not handle or handle.done(); }
+
+    /// @brief Returns the Result returned by the coroutine with `co_return` (valid only after it has finished)
+    [[nodiscard]] Result getResult() const
+    {
+        if (not handle)
+            return Result::Error("AsyncCoroutine - Frame pool is exhausted");
+        SC_TRY_MSG(handle.done(), "AsyncCoroutine - Coroutine has not finished yet");
+        return handle.promise().result;
+    }
+
+    /// @brief Awaits an AsyncCoroutine from another AsyncCoroutine, returning its Result
+    struct Awaiter : public AsyncCoroutineAwaiter
+    {
+        [[nodiscard]] bool await_ready() const noexcept { return child.isDone(); }
+
+        void await_suspend(std::coroutine_handle<> parent) noexcept
+        {
+            coroutine                        = parent;
+            child.handle.promise().awaiting = this;
+        }
+
+        [[nodiscard]] Result await_resume() const { return child.getResult(); }
+
+      private:
+        friend struct AsyncCoroutine;
+        Awaiter(AsyncCoroutine& child) : child(child) {}
+
+        AsyncCoroutine& child;
+    };
+
+    [[nodiscard]] Awaiter operator co_await() noexcept { return Awaiter(*this); }
+
+    struct promise_type
+    {
+        template <typename... Args>
+        promise_type(AsyncCoroutinePool& pool, Args&...) : pool(pool)
+        {}
+
+        template <typename... Args>
+        static void* operator new(size_t size, AsyncCoroutinePool& pool, Args&...) noexcept
+        {
+            return pool.allocateFrame(size);
+        }
+
+        static void operator delete(void* memory, size_t size) noexcept
+        {
+            AsyncCoroutinePool::releaseFrame(memory, size);
+        }
+
+        static AsyncCoroutine get_return_object_on_allocation_failure() noexcept { return AsyncCoroutine(); }
+
+        AsyncCoroutine get_return_object() noexcept { return AsyncCoroutine(Handle::from_promise(*this)); }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(Handle coroutine) noexcept
+            {
+                promise_type& promise = coroutine.promise();
+                if (promise.awaiting)
+                    promise.pool.resumeLater(*promise.awaiting);
+                else if (promise.detached)
+                    coroutine.destroy();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(Result res) noexcept { result = res; }
+        void unhandled_exception() noexcept {}
+
+      private:
+        friend struct AsyncCoroutine;
+
+        AsyncCoroutinePool&    pool;
+        Result                 result   = Result(true);
+        AsyncCoroutineAwaiter* awaiting = nullptr; // Coroutine awaiting this one to finish
+        bool                   detached = false;
+    };
+
+  private:
+    AsyncCoroutine(Handle handle) : handle(handle) {}
+
+    Handle handle;
+
+    void release()
+    {
+        if (handle)
+        {
+            if (handle.done())
+                handle.destroy();
+            else
+                handle.promise().detached = true;
+            handle = nullptr;
+        }
+    }
+};
+
+/// @brief Awaits an SC::AsyncRequest, starting it when suspending the coroutine and resuming the coroutine after
+/// its completion callback. The request lives in the coroutine frame, so it doesn't need any allocation.
+/// @tparam Derived Awaiter defining `Result start()` and `void complete(Request::Result&)`
+/// @tparam Request Type of the SC::AsyncRequest being awaited
+template <typename Derived, typename Request>
+struct SC::AsyncRequestAwaiter : public AsyncCoroutineAwaiter
+{
+    [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle)
+    {
+        coroutine        = handle;
+        request.callback = [this](typename Request::Result& result)
+        {
+            static_cast<Derived&>(*this).complete(result);
+            pool.resumeLater(*this);
+        };
+        returnCode = static_cast<Derived&>(*this).start();
+        return returnCode; // Failing to start doesn't suspend the coroutine
+    }
+
+    [[nodiscard]] Result await_resume() const { return returnCode; }
+
+  protected:
+    AsyncRequestAwaiter(AsyncCoroutinePool& pool) : pool(pool) {}
+
+    AsyncCoroutinePool& pool;
+    Request             request;
+};
+
+/// @brief Awaiter returned by SC::AsyncCoroutinePool::sleep
+struct SC::AsyncSleepAwaiter : public AsyncRequestAwaiter<AsyncSleepAwaiter, AsyncLoopTimeout>
+{
+  private:
+    friend struct AsyncCoroutinePool;
+    friend struct AsyncRequestAwaiter<AsyncSleepAwaiter, AsyncLoopTimeout>;
+    AsyncSleepAwaiter(AsyncCoroutinePool& pool, Time::Milliseconds timeout) : AsyncRequestAwaiter(pool), timeout(timeout)
+    {}
+
+    Time::Milliseconds timeout;
+
+    [[nodiscard]] Result start() { return request.start(*pool.getEventLoop(), timeout); }
+    void                 complete(AsyncLoopTimeout::Result& result) { returnCode = result.isValid(); }
+};
+
+/// @brief Awaiter returned by SC::AsyncCoroutinePool::receive
+struct SC::AsyncSocketReceiveAwaiter : public AsyncRequestAwaiter<AsyncSocketReceiveAwaiter, AsyncSocketReceive>
+{
+  private:
+    friend struct AsyncCoroutinePool;
+    friend struct AsyncRequestAwaiter<AsyncSocketReceiveAwaiter, AsyncSocketReceive>;
+    AsyncSocketReceiveAwaiter(AsyncCoroutinePool& pool, const SocketDescriptor& socket, Span<char> buffer,
+                              Span<char>& data)
+        : AsyncRequestAwaiter(pool), socket(socket), buffer(buffer), data(data)
+    {}
+
+    const SocketDescriptor& socket;
+    Span<char>              buffer;
+    Span<char>&             data;
+
+    [[nodiscard]] Result start() { return request.start(*pool.getEventLoop(), socket, buffer); }
+    void                 complete(AsyncSocketReceive::Result& result) { returnCode = result.get(data); }
+};
+
+/// @brief Awaiter returned by SC::AsyncCoroutinePool::send
+struct SC::AsyncSocketSendAwaiter : public AsyncRequestAwaiter<AsyncSocketSendAwaiter, AsyncSocketSend>
+{
+  private:
+    friend struct AsyncCoroutinePool;
+    friend struct AsyncRequestAwaiter<AsyncSocketSendAwaiter, AsyncSocketSend>;
+    AsyncSocketSendAwaiter(AsyncCoroutinePool& pool, const SocketDescriptor& socket, Span<const char> data)
+        : AsyncRequestAwaiter(pool), socket(socket), data(data)
+    {}
+
+    const SocketDescriptor& socket;
+    Span<const char>        data;
+
+    [[nodiscard]] Result start() { return request.start(*pool.getEventLoop(), socket, data); }
+    void                 complete(AsyncSocketSend::Result& result) { returnCode = result.isValid(); }
+};
+
+/// @brief Awaiter returned by SC::AsyncCoroutinePool::read
+struct SC::AsyncFileReadAwaiter : public AsyncRequestAwaiter<AsyncFileReadAwaiter, AsyncFileRead>
+{
+  private:
+    friend struct AsyncCoroutinePool;
+    friend struct AsyncRequestAwaiter<AsyncFileReadAwaiter, AsyncFileRead>;
+    AsyncFileReadAwaiter(AsyncCoroutinePool& pool, FileDescriptor::Handle file, Span<char> buffer, Span<char>& data,
+                         uint64_t offset)
+        : AsyncRequestAwaiter(pool), data(data)
+    {
+        request.fileDescriptor = file;
+        request.buffer         = buffer;
+        request.offset         = offset;
+    }
+
+    Span<char>& data;
+
+    [[nodiscard]] Result start() { return request.start(*pool.getEventLoop()); }
+    void                 complete(AsyncFileRead::Result& result) { returnCode = result.get(data); }
+};
+
+inline SC::AsyncSleepAwaiter SC::AsyncCoroutinePool::sleep(Time::Milliseconds relativeTimeout)
+{
+    return AsyncSleepAwaiter(*this, relativeTimeout);
+}
+
+inline SC::AsyncSocketReceiveAwaiter SC::AsyncCoroutinePool::receive(const SocketDescriptor& socket,
+                                                                     Span<char> buffer, Span<char>& data)
+{
+    return AsyncSocketReceiveAwaiter(*this, socket, buffer, data);
+}
+
+inline SC::AsyncSocketSendAwaiter SC::AsyncCoroutinePool::send(const SocketDescriptor& socket,
+                                                               Span<const char> data)
+{
+    return AsyncSocketSendAwaiter(*this, socket, data);
+}
+
+inline SC::AsyncFileReadAwaiter SC::AsyncCoroutinePool::read(FileDescriptor::Handle file, Span<char> buffer,
+                                                             Span<char>& data, uint64_t offset)
+{
+    return AsyncFileReadAwaiter(*this, file, buffer, data, offset);
+}
+
+//! @}
+
+#endif
@@ -0,0 +1,88 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../../../Libraries/Foundation/Compiler.h"
+#if SC_COMPILER_ENABLE_STD_CPP
+#include <coroutine>
+#else
+// Minimal subset of <coroutine> needed by the compiler to lower coroutines, built on top of compiler builtins
+// (available on Clang, GCC and MSVC) so that coroutines can be used without the Standard C++ Library.
+namespace std
+{
+template <typename Ret, typename... Args>
+struct coroutine_traits
+{
+    using promise_type = typename Ret::promise_type;
+};
+
+template <typename Promise = void>
+struct coroutine_handle;
+
+template <>
+struct coroutine_handle<void>
+{
+    constexpr coroutine_handle() noexcept = default;
+    constexpr coroutine_handle(decltype(nullptr)) noexcept {}
+
+    static coroutine_handle from_address(void* address) noexcept
+    {
+        coroutine_handle handle;
+        handle.frame = address;
+        return handle;
+    }
+
+    constexpr void* address() const noexcept { return frame; }
+
+    constexpr explicit operator bool() const noexcept { return frame != nullptr; }
+
+    bool done() const noexcept { return __builtin_coro_done(frame); }
+
+    void operator()() const { resume(); }
+    void resume() const { __builtin_coro_resume(frame); }
+    void destroy() const { __builtin_coro_destroy(frame); }
+
+  protected:
+    void* frame = nullptr;
+};
+
+template <typename Promise>
+struct coroutine_handle : public coroutine_handle<>
+{
+    constexpr coroutine_handle() noexcept = default;
+    constexpr coroutine_handle(decltype(nullptr)) noexcept {}
+
+    static coroutine_handle from_address(void* address) noexcept
+    {
+        coroutine_handle handle;
+        handle.frame = address;
+        return handle;
+    }
+
+    static coroutine_handle from_promise(Promise& promise) noexcept
+    {
+        coroutine_handle handle;
+        handle.frame = __builtin_coro_promise(reinterpret_cast<char*>(&promise), __alignof(Promise), true);
+        return handle;
+    }
+
+    Promise& promise() const noexcept
+    {
+        return *reinterpret_cast<Promise*>(__builtin_coro_promise(frame, __alignof(Promise), false));
+    }
+};
+
+struct suspend_never
+{
+    constexpr bool await_ready() const noexcept { return true; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+
+struct suspend_always
+{
+    constexpr bool await_ready() const noexcept { return false; }
+    constexpr void await_suspend(coroutine_handle<>) const noexcept {}
+    constexpr void await_resume() const noexcept {}
+};
+} // namespace std
+#endif
@@ -0,0 +1,316 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../AsyncCoroutines.h"
+#include "../../../Libraries/Testing/Testing.h"
+#if SC_LANGUAGE_CPP_AT_LEAST_20
+#include "../../../Libraries/Socket/SocketDescriptor.h"
+#include "../../../Libraries/Strings/StringView.h"
+
+namespace SC
+{
+struct AsyncCoroutinesTest;
+}
+
+struct SC::AsyncCoroutinesTest : public SC::TestCase
+{
+    AsyncEventLoop::Options options;
+
+    static constexpr size_t FrameSize = 1024;
+
+    AsyncCoroutinesTest(SC::TestReport& report) : TestCase(report, "AsyncCoroutinesTest")
+    {
+        int numTestsToRun = 1;
+        if (AsyncEventLoop::tryLoadingLiburing())
+        {
+            // Run all tests on epoll backend first, and then re-run them on io_uring
+            options.apiType = AsyncEventLoop::Options::ApiType::ForceUseEpoll;
+            numTestsToRun   = 2;
+        }
+        for (int idx = 0; idx < numTestsToRun; ++idx)
+        {
+            if (test_section("sleep"))
+            {
+                sleep();
+            }
+            if (test_section("socket echo"))
+            {
+                socketEcho();
+            }
+            if (test_section("nested coroutines"))
+            {
+                nestedCoroutines();
+            }
+            if (test_section("pipe read"))
+            {
+                pipeRead();
+            }
+            if (test_section("frame pool exhaustion"))
+            {
+                framePoolExhaustion();
+            }
+            options.apiType = AsyncEventLoop::Options::ApiType::ForceUseIOURing;
+        }
+    }
+
+    static AsyncCoroutine sleepMany(AsyncCoroutinePool& pool, int& numSleeps)
+    {
+        for (int idx = 0; idx < 3; ++idx)
+        {
+            // The same request type can be awaited again right after having been awaited
+            SC_CO_TRY(co_await pool.sleep(Time::Milliseconds(1)));
+            numSleeps++;
+        }
+        co_return Result(true);
+    }
+
+    void sleep()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        char               memory[4 * FrameSize];
+        AsyncCoroutinePool pool;
+        SC_TEST_EXPECT(pool.create(eventLoop, memory, FrameSize));
+        const size_t numFrames = pool.getNumFreeFrames();
+        SC_TEST_EXPECT(numFrames >= 3);
+
+        int numSleeps[2] = {0, 0};
+        {
+            AsyncCoroutine first  = sleepMany(pool, numSleeps[0]);
+            AsyncCoroutine second = sleepMany(pool, numSleeps[1]);
+            SC_TEST_EXPECT(first.isValid() and second.isValid());
+            SC_TEST_EXPECT(not first.isDone()); // Suspended on first sleep
+            SC_TEST_EXPECT(not first.getResult());
+            SC_TEST_EXPECT(pool.getNumFreeFrames() == numFrames - 2);
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(first.isDone() and second.isDone());
+            SC_TEST_EXPECT(first.getResult() and second.getResult());
+        }
+        SC_TEST_EXPECT(numSleeps[0] == 3 and numSleeps[1] == 3);
+        SC_TEST_EXPECT(pool.getNumFreeFrames() == numFrames);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    //! [AsyncCoroutineSnippet]
+    // Coroutines take as first parameter the pool where their frame is allocated
+    static AsyncCoroutine echoServer(AsyncCoroutinePool& pool, const SocketDescriptor& socket, int numMessages)
+    {
+        char       buffer[16];
+        Span<char> data;
+        for (int idx = 0; idx < numMessages; ++idx)
+        {
+            // Awaiting returns the Result of the async request, that SC_CO_TRY returns in case of error
+            SC_CO_TRY(co_await pool.receive(socket, buffer, data));
+            SC_CO_TRY(co_await pool.send(socket, data));
+        }
+        co_return Result(true);
+    }
+
+    static AsyncCoroutine echoClient(AsyncCoroutinePool& pool, const SocketDescriptor& socket, int numMessages,
+                                     int& numEchoes)
+    {
+        char       buffer[16];
+        Span<char> data;
+        for (int idx = 0; idx < numMessages; ++idx)
+        {
+            const StringView message = "PING";
+            SC_CO_TRY(co_await pool.send(socket, message.toCharSpan()));
+            SC_CO_TRY(co_await pool.receive(socket, buffer, data));
+            SC_CO_TRY_MSG(StringView(data, false, StringEncoding::Ascii) == message, "Wrong echo");
+            numEchoes++;
+        }
+        co_return Result(true);
+    }
+    //! [AsyncCoroutineSnippet]
+
+    void socketEcho()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        SocketDescriptor client, serverSideClient;
+        createAndAssociateAsyncClientServerConnections(eventLoop, client, serverSideClient);
+
+        char               memory[4 * FrameSize];
+        AsyncCoroutinePool pool;
+        SC_TEST_EXPECT(pool.create(eventLoop, memory, FrameSize));
+        {
+            //! [AsyncCoroutinePoolSnippet]
+            int            numEchoes = 0;
+            AsyncCoroutine server    = echoServer(pool, serverSideClient, 5);
+            AsyncCoroutine clientCo  = echoClient(pool, client, 5, numEchoes);
+            SC_TEST_EXPECT(server.isValid() and clientCo.isValid());
+            SC_TEST_EXPECT(eventLoop.run()); // Returns when both coroutines are done
+            SC_TEST_EXPECT(server.getResult());
+            SC_TEST_EXPECT(clientCo.getResult());
+            SC_TEST_EXPECT(numEchoes == 5);
+            //! [AsyncCoroutinePoolSnippet]
+        }
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(client.close());
+        SC_TEST_EXPECT(serverSideClient.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    static AsyncCoroutine sleepThenFail(AsyncCoroutinePool& pool, bool fail)
+    {
+        SC_CO_TRY(co_await pool.sleep(Time::Milliseconds(1)));
+        co_return fail ? Result::Error("sleepThenFail") : Result(true);
+    }
+
+    static AsyncCoroutine parent(AsyncCoroutinePool& pool, int& numChildren)
+    {
+        AsyncCoroutine child = sleepThenFail(pool, false);
+        SC_CO_TRY(co_await child);
+        numChildren++;
+        // Awaiting an already finished coroutine doesn't suspend
+        SC_CO_TRY(co_await child);
+        SC_CO_TRY(co_await sleepThenFail(pool, false));
+        numChildren++;
+        SC_CO_TRY(co_await sleepThenFail(pool, true));
+        numChildren++;
+        co_return Result(true);
+    }
+
+    void nestedCoroutines()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        char               memory[4 * FrameSize];
+        AsyncCoroutinePool pool;
+        SC_TEST_EXPECT(pool.create(eventLoop, memory, FrameSize));
+        int numChildren = 0;
+        {
+            AsyncCoroutine coroutine = parent(pool, numChildren);
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(coroutine.isDone());
+            SC_TEST_EXPECT(StringView::fromNullTerminated(coroutine.getResult().message, StringEncoding::Ascii) == "sleepThenFail");
+        }
+        SC_TEST_EXPECT(numChildren == 2);
+
+        // Destroying a coroutine before it's done detaches it, releasing its frame when finished
+        const size_t numFrames = pool.getNumFreeFrames();
+        (void)sleepThenFail(pool, false);
+        SC_TEST_EXPECT(pool.getNumFreeFrames() == numFrames - 1);
+        SC_TEST_EXPECT(not pool.close());
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(pool.getNumFreeFrames() == numFrames);
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    static AsyncCoroutine readExactly(AsyncCoroutinePool& pool, FileDescriptor::Handle handle, Span<char> buffer,
+                                      size_t& numBytes)
+    {
+        while (numBytes < buffer.sizeInBytes())
+        {
+            Span<char> remaining, data;
+            SC_CO_TRY(buffer.sliceStart(numBytes, remaining));
+            SC_CO_TRY(co_await pool.read(handle, remaining, data));
+            numBytes += data.sizeInBytes();
+        }
+        co_return Result(true);
+    }
+
+    void pipeRead()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        PipeDescriptor pipe;
+        SC_TEST_EXPECT(pipe.createPipe());
+        SC_TEST_EXPECT(pipe.readPipe.setBlocking(false));
+        SC_TEST_EXPECT(eventLoop.associateExternallyCreatedFileDescriptor(pipe.readPipe));
+        FileDescriptor::Handle handle = FileDescriptor::Invalid;
+        SC_TEST_EXPECT(pipe.readPipe.get(handle, Result::Error("Invalid pipe")));
+
+        char               memory[2 * FrameSize];
+        AsyncCoroutinePool pool;
+        SC_TEST_EXPECT(pool.create(eventLoop, memory, FrameSize));
+        {
+            char           buffer[10];
+            size_t         numBytes  = 0;
+            AsyncCoroutine coroutine = readExactly(pool, handle, buffer, numBytes);
+            SC_TEST_EXPECT(pipe.writePipe.write(StringView("HELLO").toCharSpan()));
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(not coroutine.isDone());
+            SC_TEST_EXPECT(pipe.writePipe.write(StringView(" PIPE").toCharSpan()));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(coroutine.getResult());
+            SC_TEST_EXPECT(StringView({buffer, numBytes}, false, StringEncoding::Ascii) == "HELLO PIPE");
+        }
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(pipe.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void framePoolExhaustion()
+    {
+        AsyncEventLoop eventLoop;
+        SC_TEST_EXPECT(eventLoop.create(options));
+        AsyncCoroutinePool pool;
+        char               tooSmall[64];
+        SC_TEST_EXPECT(not pool.create(eventLoop, tooSmall, FrameSize));
+
+        char memory[FrameSize + 16];
+        SC_TEST_EXPECT(pool.create(eventLoop, memory, FrameSize));
+        SC_TEST_EXPECT(pool.getNumFreeFrames() == 1);
+        int numSleeps = 0;
+        {
+            AsyncCoroutine first  = sleepMany(pool, numSleeps);
+            AsyncCoroutine second = sleepMany(pool, numSleeps);
+            SC_TEST_EXPECT(first.isValid());
+            SC_TEST_EXPECT(not second.isValid()); // No frames left, coroutine has not been started
+            SC_TEST_EXPECT(second.isDone());
+            SC_TEST_EXPECT(not second.getResult());
+
+            int            numChildren = 0;
+            AsyncCoroutine third       = parent(pool, numChildren);
+            SC_TEST_EXPECT(not third.isValid());
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(first.getResult());
+        }
+        SC_TEST_EXPECT(numSleeps == 3);
+
+        // A frame size too small for a coroutine makes it fail to start
+        AsyncCoroutinePool smallPool;
+        SC_TEST_EXPECT(smallPool.create(eventLoop, tooSmall, 32));
+        {
+            AsyncCoroutine coroutine = sleepMany(smallPool, numSleeps);
+            SC_TEST_EXPECT(not coroutine.isValid());
+        }
+        SC_TEST_EXPECT(smallPool.close());
+        SC_TEST_EXPECT(pool.close());
+        SC_TEST_EXPECT(eventLoop.close());
+    }
+
+    void createAndAssociateAsyncClientServerConnections(AsyncEventLoop& eventLoop, SocketDescriptor& client,
+                                                        SocketDescriptor& serverSideClient)
+    {
+        SocketDescriptor serverSocket;
+        uint16_t         tcpPort        = 5060;
+        StringView       connectAddress = "::1";
+        SocketIPAddress  nativeAddress;
+        SC_TEST_EXPECT(nativeAddress.fromAddressPort(connectAddress, tcpPort));
+        SC_TEST_EXPECT(serverSocket.create(nativeAddress.getAddressFamily()));
+        SC_TEST_EXPECT(SocketServer(serverSocket).listen(nativeAddress, 0));
+
+        SC_TEST_EXPECT(SocketClient(client).connect(connectAddress, tcpPort));
+        SC_TEST_EXPECT(SocketServer(serverSocket).accept(nativeAddress.getAddressFamily(), serverSideClient));
+        SC_TEST_EXPECT(client.setBlocking(false));
+        SC_TEST_EXPECT(serverSideClient.setBlocking(false));
+
+        SC_TEST_EXPECT(eventLoop.associateExternallyCreatedTCPSocket(client));
+        SC_TEST_EXPECT(eventLoop.associateExternallyCreatedTCPSocket(serverSideClient));
+    }
+};
+
+namespace SC
+{
+void runAsyncCoroutinesTest(SC::TestReport& report) { AsyncCoroutinesTest test(report); }
+} // namespace SC
+#else
+namespace SC
+{
+// AsyncCoroutines needs C++20
+void runAsyncCoroutinesTest(SC::TestReport&) {}
+} // namespace SC
+#endif
@@ -41,6 +41,7 @@ void runHashingTest(TestReport& report);
 // Http
 void runHttpClientTest(TestReport& report);
 void runHttpParserTest(TestReport& report);
+void runHttpParserBenchmarkTest(TestReport& report);
 void runHttpServerTest(TestReport& report);
 void runHttpURLParserTest(TestReport& report);
 
@@ -76,11 +77,16 @@ void runTimeTest(TestReport& report);
 
 // Threading
 void runAtomicTest(TestReport& report);
+void runLockFreeQueueTest(TestReport& report);
 void runThreadingTest(TestReport& report);
+void runThreadingBenchmarkTest(TestReport& report);
 void runThreadPoolTest(TestReport& report);
+void runThreadPoolBenchmarkTest(TestReport& report);
 
 // Async
 void runAsyncTest(SC::TestReport& report);
+void runAsyncBenchmarkTest(SC::TestReport& report);
+void runAsyncCoroutinesTest(SC::TestReport& report);
 
 // Support
 void runDebugVisualizersTest(TestReport& report);
@@ -158,6 +164,7 @@ int main(int argc, const char* argv[])
 
     // Http tests
     runHttpParserTest(report);
+    runHttpParserBenchmarkTest(report);
     runHttpClientTest(report);
     runHttpServerTest(report);
     runHttpURLParserTest(report);
@@ -194,11 +201,16 @@ int main(int argc, const char* argv[])
 
     // Threading tests
     runAtomicTest(report);
+    runLockFreeQueueTest(report);
     runThreadingTest(report);
+    runThreadingBenchmarkTest(report);
     runThreadPoolTest(report);
+    runThreadPoolBenchmarkTest(report);
 
     // Async tests
     runAsyncTest(report);
+    runAsyncBenchmarkTest(report);
+    runAsyncCoroutinesTest(report);
 
     // DebugVisualizers tests
     runDebugVisualizersTest(report);